@@ -1,6 +1,6 @@
 CC=g++
 CC_FLAGS=-Wall -g -O3 -I@CMAKE_INSTALL_PREFIX@/include -L@CMAKE_INSTALL_PREFIX@/lib -DNDEBUG -funroll-loops -msse4.2
-CCLIB=-lsdsl -ldivsufsort -ldivsufsort64 
+CCLIB=-lsdsl -ldivsufsort -ldivsufsort64 -lpthread
 SOURCES=$(wildcard *.cpp)
 EXECS=$(SOURCES:.cpp=)
 
@@ -0,0 +1,32 @@
+#include <iostream>
+#include <cstdlib>
+#include <sdsl/bit_vectors.hpp>
+#include <sdsl/test_index_performance.hpp>
+
+using namespace std;
+using namespace sdsl;
+
+// Compares random rank and select queries on a bit_vector with rank_support_v
+// and select_support_mcl to the cache line aligned bit_vector_interleaved_cl
+// and to bit_vector_interleaved.
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        cout << "Usage: " << argv[0] << " size density [times]" << endl;
+        cout << " size    : length of the random bit vector" << endl;
+        cout << " density : probability of a one in percent" << endl;
+        return 1;
+    }
+    bit_vector::size_type size = atoll(argv[1]);
+    uint32_t density = atoi(argv[2]);
+    bit_vector::size_type times = argc > 3 ? atoll(argv[3]) : 20000000;
+    bit_vector b(size, 0);
+    srand(17);
+    for (bit_vector::size_type i=0; i < size; ++i) {
+        b[i] = (uint32_t)(rand()%100) < density;
+    }
+    util::verbose = true;
+    test_bit_vector_rank_select<bit_vector>(b, times);
+    test_bit_vector_rank_select<bit_vector_interleaved_cl<> >(b, times);
+    test_bit_vector_rank_select<bit_vector_interleaved<> >(b, times);
+}
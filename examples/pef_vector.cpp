@@ -0,0 +1,77 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <cstdlib>
+#include <sdsl/pef_vector.hpp>
+#include <sdsl/enc_vector.hpp>
+#include <sdsl/sd_vector.hpp>
+#include <sdsl/algorithms.hpp>
+#include <sdsl/test_index_performance.hpp>
+
+using namespace std;
+using namespace sdsl;
+
+template<class Vector>
+void print_size(const char* name, const Vector& v, uint64_t n)
+{
+    cout << "# " << name << " : " << 8.0*util::get_size_in_bytes(v)/n << " bits per element" << endl;
+}
+
+// Compares pef_vector to enc_vector<coder::elias_delta> on the Psi function of
+// a text and to sd_vector on a random posting list.
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " file [density]" << endl;
+        cout << " file    : text for the Psi function" << endl;
+        cout << " density : probability of a posting in percent" << endl;
+        return 1;
+    }
+    util::verbose = true;
+    {
+        ifstream in(argv[1]);
+        string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        int_vector<>::size_type n = text.size()+1; // add the sentinel
+        int_vector<> sa(n, 0, bit_magic::l1BP(n)+1);
+        algorithm::calculate_sa((const unsigned char*)text.c_str(), n, sa);
+        int_vector<> isa(n, 0, sa.get_int_width());
+        for (int_vector<>::size_type i=0; i < n; ++i)
+            isa[sa[i]] = i;
+        // Psi is increasing in the range of each character. Adding n for each
+        // character range makes it increasing for pef_vector.
+        vector<uint64_t> psi(n), psi_mono(n);
+        for (int_vector<>::size_type i=0, c=0; i < n; ++i) {
+            psi[i] = isa[(sa[i]+1)%n];
+            if (i > 0 and text[sa[i]] != text[sa[i-1]])
+                ++c;
+            psi_mono[i] = psi[i] + c*n;
+        }
+        enc_vector<coder::elias_delta, 32> ev(psi);
+        pef_vector<> pv(psi_mono);
+        print_size("Psi enc_vector<coder::elias_delta,32>", ev, n);
+        test_int_vector_random_access(ev, 10000000);
+        test_int_vector_sequential_access(ev, 100000000);
+        print_size("Psi pef_vector<>", pv, n);
+        test_int_vector_random_access(pv, 10000000);
+        test_int_vector_sequential_access(pv, 100000000);
+    }
+    {
+        uint32_t density = argc > 2 ? atoi(argv[2]) : 1;
+        bit_vector b(100000000, 0);
+        vector<uint64_t> postings;
+        srand(23);
+        for (bit_vector::size_type i=0; i < b.size(); ++i) {
+            if ((uint32_t)(rand()%100) < density) {
+                b[i] = 1;
+                postings.push_back(i);
+            }
+        }
+        sd_vector<> sv(b);
+        pef_vector<> pv(postings);
+        print_size("postings sd_vector<>", sv, postings.size());
+        test_next_geq_random_access(sv, b.size());
+        print_size("postings pef_vector<>", pv, postings.size());
+        test_next_geq_random_access(pv, b.size());
+        test_int_vector_sequential_access(pv, 100000000);
+    }
+}
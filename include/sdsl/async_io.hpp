@@ -0,0 +1,181 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file async_io.hpp
+    \brief async_io.hpp contains classes for sequential file I/O which overlaps disk access with computation.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_ASYNC_IO
+#define INCLUDED_SDSL_ASYNC_IO
+
+#include <stdint.h> // for uint64_t
+#include <pthread.h>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! A sequential reader for files which prefetches the next chunk in a background thread.
+/*! The reader holds two buffers of chunk_size bytes. While the caller consumes
+ *  the front buffer, a background thread reads the next chunk of the file into
+ *  the back buffer. If prefetching is disabled the chunks are read synchronously.
+ */
+class buffered_file_reader
+{
+    private:
+        int       m_fd;
+        uint64_t  m_chunk_size;  // size of each buffer in bytes
+        char*     m_buf[2];      // front and back buffer
+        uint64_t  m_buf_len[2];  // number of valid bytes in the buffers
+        uint8_t   m_cur;         // index of the front buffer
+        uint64_t  m_pos;         // read position in the front buffer
+        uint64_t  m_file_pos;    // file offset of the next chunk which is not requested yet
+        bool      m_prefetch;    // prefetch the next chunk in the background
+        bool      m_pending;     // a background read into the back buffer is in progress
+        pthread_t m_thread;
+
+        struct read_request {
+            int       fd;
+            char*     buf;
+            uint64_t  len;
+            uint64_t  offset;
+            uint64_t* read_bytes;
+        } m_request;
+
+        static void* read_chunk(void* request);
+        static uint64_t read_fully(int fd, char* buf, uint64_t len, uint64_t offset);
+        void request_next_chunk();
+        void wait_for_chunk();
+        bool next_chunk();
+
+        buffered_file_reader(const buffered_file_reader&);
+        buffered_file_reader& operator=(const buffered_file_reader&);
+    public:
+        buffered_file_reader();
+        ~buffered_file_reader();
+
+        //! Opens a file for reading.
+        /*! \param file_name  Name of the file.
+         *  \param chunk_size Number of bytes which are read from disk at once.
+         *  \param prefetch   If true, the next chunk is read in a background thread.
+         *  \return If the file could be opened.
+         */
+        bool open(const char* file_name, uint64_t chunk_size=(1ULL<<23), bool prefetch=false);
+
+        //! Returns true if a file is open.
+        bool is_open()const {
+            return m_fd != -1;
+        }
+
+        //! Reads up to len bytes into dest.
+        /*! \return The number of bytes read. It is smaller than len only at the end of the file.
+         */
+        uint64_t read(char* dest, uint64_t len);
+
+        //! Sets the read position to byte offset of the file.
+        bool seek(uint64_t offset);
+
+        //! Closes the file and waits for outstanding background reads.
+        void close();
+};
+
+//! A sequential writer for files which writes the previous chunk in a background thread.
+/*! The writer holds two buffers of chunk_size bytes. While the caller fills
+ *  the front buffer, a background thread writes the back buffer to disk.
+ *  If asynchronous writing is disabled full chunks are written synchronously.
+ */
+class buffered_file_writer
+{
+    private:
+        int       m_fd;
+        uint64_t  m_chunk_size;  // size of each buffer in bytes
+        char*     m_buf[2];      // front and back buffer
+        uint64_t  m_buf_len;     // number of bytes in the front buffer
+        uint8_t   m_cur;         // index of the front buffer
+        uint64_t  m_file_pos;    // file offset of the front buffer
+        bool      m_async;       // write full chunks in the background
+        bool      m_pending;     // a background write of the back buffer is in progress
+        bool      m_ok;          // false after a failed write
+        pthread_t m_thread;
+
+        struct write_request {
+            int         fd;
+            const char* buf;
+            uint64_t    len;
+            uint64_t    offset;
+            bool*       ok;
+        } m_request;
+
+        static void* write_chunk(void* request);
+        static bool write_fully(int fd, const char* buf, uint64_t len, uint64_t offset);
+        void wait_for_chunk();
+        void flush_chunk();
+
+        buffered_file_writer(const buffered_file_writer&);
+        buffered_file_writer& operator=(const buffered_file_writer&);
+    public:
+        buffered_file_writer();
+        ~buffered_file_writer();
+
+        //! Creates (or truncates) a file for writing.
+        /*! \param file_name  Name of the file.
+         *  \param chunk_size Number of bytes which are written to disk at once.
+         *  \param async      If true, full chunks are written in a background thread.
+         *  \return If the file could be opened.
+         */
+        bool open(const char* file_name, uint64_t chunk_size=(1ULL<<23), bool async=false);
+
+        //! Returns true if a file is open.
+        bool is_open()const {
+            return m_fd != -1;
+        }
+
+        //! Appends len bytes of src to the file.
+        /*! \return False if a previous write failed.
+         */
+        bool write(const char* src, uint64_t len);
+
+        //! Overwrites len bytes at byte offset of the file, e.g. to patch a header.
+        /*! The bytes have to be written by write before.
+         */
+        bool write_at(uint64_t offset, const char* src, uint64_t len);
+
+        //! Returns the number of bytes written so far.
+        uint64_t size()const {
+            return m_file_pos + m_buf_len;
+        }
+
+        //! Writes all buffered bytes and closes the file.
+        /*! \return If all bytes were written successfully.
+         */
+        bool close();
+};
+
+namespace util
+{
+//! Enables or disables background I/O for int_vector_file_buffers and int_vector_file_writers which are opened afterwards.
+/*! Background I/O is disabled by default, so no threads are created unless
+ *  a program opts in with set_file_buffer_prefetch(true).
+ */
+void set_file_buffer_prefetch(bool prefetch);
+
+//! Returns if int_vector_file_buffers and int_vector_file_writers read or write in the background.
+bool file_buffer_prefetch();
+}
+
+}// end namespace sdsl
+
+#endif // end file
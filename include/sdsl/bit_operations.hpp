@@ -0,0 +1,248 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file bit_operations.hpp
+    \brief bit_operations.hpp contains the bitwise operations AND, OR, XOR and ANDNOT for plain and compressed bit vectors.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_BIT_OPERATIONS
+#define INCLUDED_SDSL_BIT_OPERATIONS
+
+#include "int_vector.hpp"
+#include "rrr_vector.hpp"
+#include "sd_vector.hpp"
+#include "gap_vector.hpp"
+#include <vector>
+#include <algorithm> // for std::max, std::min
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! Bitwise operations on two bit vectors of the same type, which produce a bit vector of this type.
+/*! The compressed representations are not decompressed:
+ *   - sd_vector: AND and ANDNOT skip with the cursors of the operands
+ *     (select0 on the high part for long skips), OR and XOR merge the ones.
+ *   - gap_vector: AND and ANDNOT gallop (exponential search with select)
+ *     through the ones of the second operand.
+ *   - rrr_vector: the operands are processed block by block. Only blocks
+ *     which are neither empty nor full in both operands are decoded.
+ *     The result is written into a bit_vector and then compressed.
+ *   - bit_vector: word by word with loops which are vectorized by the compiler.
+ *
+ *  The length of the result is the maximum of the lengths of the operands;
+ *  missing bits of the shorter operand are zero. The result may be one of
+ *  the operands.
+ *
+ *  \par Example
+ *  \code
+ *  sd_vector<> docs_a(bv_a), docs_b(bv_b), both;
+ *  bit_operations::apply(docs_a, docs_b, bit_operations::AND, both);
+ *  \endcode
+ */
+class bit_operations
+{
+    private:
+        bit_operations(); // only static methods
+    public:
+        typedef bit_vector::size_type size_type;
+
+        enum operation {
+            AND    = 0, //!< a & b
+            OR     = 1, //!< a | b
+            XOR    = 2, //!< a ^ b
+            ANDNOT = 3  //!< a & ~b
+        };
+
+        //! Computes res = a op b for bit_vectors.
+        static void apply(const bit_vector& a, const bit_vector& b, operation op, bit_vector& res);
+
+        //! Computes res = a op b for sd_vectors.
+        template<class hi_bit_vector_type, class hi_select_1, class hi_select_0>
+        static void apply(const sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& a,
+                          const sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& b,
+                          operation op, sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& res);
+
+        //! Computes res = a op b for gap_vectors.
+        static void apply(const gap_vector<>& a, const gap_vector<>& b, operation op, gap_vector<>& res);
+
+        //! Computes res = a op b for rrr_vectors.
+        template<uint16_t block_size, class wt_type>
+        static void apply(const rrr_vector<block_size, wt_type>& a, const rrr_vector<block_size, wt_type>& b,
+                          operation op, rrr_vector<block_size, wt_type>& res);
+
+        //! Returns the smallest k >= j with select(k+1) >= x, or n if there is no such k.
+        /*! The search doubles the distance to j until it passes x and then
+         *  searches binary, i.e. it takes \f$\Order{\log d}\f$ select queries, where d is the distance
+         *  of j and the result.
+         *  \param select A select support with n arguments.
+         */
+        template<class Select>
+        static size_type gallop(const Select& select, size_type n, size_type j, size_type x) {
+            if (j >= n or select(j+1) >= x)
+                return j;
+            size_type lo = j, step = 1; // invariant: select(lo+1) < x
+            while (lo+step < n and select(lo+step+1) < x) {
+                lo   += step;
+                step <<= 1;
+            }
+            size_type hi = std::min(lo+step, n); // hi == n or select(hi+1) >= x
+            while (hi - lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (select(mid+1) < x)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            return hi;
+        }
+
+    private:
+        // Writes the len <= block_size bits of the block x at position pos of the zero bits of bv.
+        static void set_block(bit_vector& bv, size_type pos, uint32_t x, uint16_t len) {
+            bv.set_int(pos, x, len);
+        }
+
+        static void set_block(bit_vector& bv, size_type pos, uint64_t x, uint16_t len) {
+            bv.set_int(pos, x, len);
+        }
+
+        // Blocks of more than 64 bits are written in 64-bit pieces.
+        template<class Number>
+        static void set_block(bit_vector& bv, size_type pos, Number x, uint16_t len) {
+            for (uint16_t k=0; k < len; k += 64) {
+                bv.set_int(pos+k, (uint64_t)x, std::min(64, len-k));
+                x = x >> 64;
+            }
+        }
+};
+
+template<class hi_bit_vector_type, class hi_select_1, class hi_select_0>
+void bit_operations::apply(const sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& a,
+                           const sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& b,
+                           operation op, sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>& res)
+{
+    typedef sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0> sd_type;
+    std::vector<uint64_t> pos;
+    typename sd_type::cursor ca(&a), cb(&b);
+    if (op == AND) {
+        while (!ca.end() and !cb.end()) {
+            if (ca.value() < cb.value()) {
+                ca.skip_to(cb.value());
+            } else if (cb.value() < ca.value()) {
+                cb.skip_to(ca.value());
+            } else {
+                pos.push_back(ca.value());
+                ca.next(); cb.next();
+            }
+        }
+    } else if (op == ANDNOT) {
+        for (; !ca.end(); ca.next()) {
+            cb.skip_to(ca.value());
+            if (cb.end() or cb.value() != ca.value())
+                pos.push_back(ca.value());
+        }
+    } else { // merge for OR and XOR
+        while (!ca.end() or !cb.end()) {
+            if (cb.end() or (!ca.end() and ca.value() < cb.value())) {
+                pos.push_back(ca.value());
+                ca.next();
+            } else if (ca.end() or cb.value() < ca.value()) {
+                pos.push_back(cb.value());
+                cb.next();
+            } else {
+                if (op == OR)
+                    pos.push_back(ca.value());
+                ca.next(); cb.next();
+            }
+        }
+    }
+    sd_type tmp(pos.begin(), pos.end(), std::max(a.size(), b.size()));
+    res.swap(tmp);
+}
+
+inline void bit_operations::apply(const gap_vector<>& a, const gap_vector<>& b, operation op, gap_vector<>& res)
+{
+    gap_vector<>::select_1_type select_a(&a), select_b(&b);
+    size_type na = a.ones(), nb = b.ones();
+    std::vector<uint64_t> pos;
+    if (op == AND or op == ANDNOT) {
+        if (op == AND and na > nb) { // gallop through the longer list
+            std::swap(na, nb);
+            select_a.set_vector(&b);
+            select_b.set_vector(&a);
+        }
+        for (size_type i=1, j=0; i <= na; ++i) {
+            size_type x = select_a(i);
+            j = gallop(select_b, nb, j, x);
+            bool in_b = (j < nb and select_b(j+1) == x);
+            if (in_b == (op == AND))
+                pos.push_back(x);
+        }
+    } else { // merge for OR and XOR
+        size_type i = 1, j = 1;
+        while (i <= na or j <= nb) {
+            if (j > nb or (i <= na and select_a(i) < select_b(j))) {
+                pos.push_back(select_a(i++));
+            } else if (i > na or select_b(j) < select_a(i)) {
+                pos.push_back(select_b(j++));
+            } else {
+                if (op == OR)
+                    pos.push_back(select_a(i));
+                ++i; ++j;
+            }
+        }
+    }
+    gap_vector<> tmp(pos.begin(), pos.end(), std::max(a.size(), b.size()));
+    res.swap(tmp);
+}
+
+template<uint16_t block_size, class wt_type>
+void bit_operations::apply(const rrr_vector<block_size, wt_type>& a, const rrr_vector<block_size, wt_type>& b,
+                           operation op, rrr_vector<block_size, wt_type>& res)
+{
+    typedef rrr_vector<block_size, wt_type> rrr_type;
+    typedef typename rrr_type::block_reader reader_type;
+    typedef typename reader_type::value_type value_type;
+    size_type n = std::max(a.size(), b.size());
+    bit_vector bv(n, 0);
+    reader_type ra(&a), rb(&b);
+    for (size_type p=0; p < n; p += block_size, ra.next(), rb.next()) {
+        uint16_t oa = ra.ones(), ob = rb.ones();
+        value_type x;
+        if (op == AND) {
+            if (oa == 0 or ob == 0)
+                continue;
+            x = ra.bits() & rb.bits();
+        } else if (op == ANDNOT) {
+            if (oa == 0 or ob == block_size)
+                continue;
+            x = ra.bits() & ~rb.bits();
+        } else {
+            if (oa == 0 and ob == 0)
+                continue;
+            x = (op == OR) ? (ra.bits() | rb.bits()) : (ra.bits() ^ rb.bits());
+        }
+        if (x != (value_type)0)
+            set_block(bv, p, x, std::min((size_type)block_size, n-p));
+    }
+    rrr_type tmp(bv);
+    res.swap(tmp);
+}
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,323 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file bit_vector_dynamic.hpp
+    \brief bit_vector_dynamic.hpp contains a dynamic bit vector which supports insert, erase, rank and select.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_BIT_VECTOR_DYNAMIC
+#define INCLUDED_SDSL_BIT_VECTOR_DYNAMIC
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include <vector>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+template<uint8_t b=1>
+class rank_support_dynamic;  // in bit_vector_dynamic
+
+template<uint8_t b=1>
+class select_support_dynamic;  // in bit_vector_dynamic
+
+//! A dynamic bit vector which supports insert, erase, set, rank and select.
+/*! The bits are stored in leaves of 2048 bits, which are at least a quarter
+ *  full (except a single leaf). The leaves are the bottom level of a B+ tree
+ *  whose inner nodes store for each of their up to 32 children the number of
+ *  bits and ones in the subtree. The nodes and leaves are kept in two arrays
+ *  and referenced by their indexes, so that a copy of the vector is a copy
+ *  of the arrays and the nodes of one level are close in memory.
+ *
+ * \par Time complexity
+ *  All operations take \f$\Order{\log n}\f$ time; each level costs a scan of
+ *  at most 32 counters and the leaf level a scan of at most 32 words.
+ *
+ * \par Space complexity
+ *  Between 1 and 4 times n bits for the leaves plus about 2% for the nodes.
+ *
+ * The classes rank_support_dynamic and select_support_dynamic provide the
+ * rank and select interface of the static bit vectors. They do not store
+ * anything and are therefore always up to date.
+ */
+class bit_vector_dynamic
+{
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef size_type value_type;
+
+        typedef rank_support_dynamic<1> rank_1_type;
+        typedef rank_support_dynamic<0> rank_0_type;
+        typedef select_support_dynamic<1> select_1_type;
+        typedef select_support_dynamic<0> select_0_type;
+
+        static const uint32_t leaf_words = 32;              //!< Capacity of a leaf in 64-bit words.
+        static const uint32_t leaf_bits  = 64*leaf_words;   //!< Capacity of a leaf in bits.
+        static const uint32_t fanout     = 32;              //!< Maximal number of children of an inner node.
+    private:
+        struct leaf {
+            uint64_t bits[leaf_words];
+            uint32_t size;  // number of bits in the leaf
+            uint32_t ones;  // number of ones in the leaf
+        };
+        struct node {
+            uint64_t size[fanout+1];  // number of bits in the subtree of each child
+            uint64_t ones[fanout+1];  // number of ones in the subtree of each child
+            uint32_t child[fanout+1]; // index of each child; one extra entry for the split
+            uint32_t cnt;             // number of children
+        };
+
+        size_type             m_size;
+        size_type             m_ones;
+        uint32_t              m_height; // number of inner node levels; 0 if the root is a leaf
+        uint32_t              m_root;
+        std::vector<leaf>     m_leaves;
+        std::vector<node>     m_nodes;
+        std::vector<uint32_t> m_free_leaves; // indexes of unused leaves
+        std::vector<uint32_t> m_free_nodes;  // indexes of unused nodes
+
+        uint32_t new_leaf();
+        uint32_t new_node();
+        void     delete_leaf(uint32_t l);
+        void     delete_node(uint32_t n);
+        void     subtree_counts(uint32_t idx, uint32_t height, uint64_t& size, uint64_t& ones)const;
+        bool     insert(uint32_t idx, uint32_t height, size_type i, bool bit, uint32_t& sibling);
+        bool     erase(uint32_t idx, uint32_t height, size_type i);
+        void     rebalance(uint32_t n, uint32_t c, uint32_t height);
+        void     build(const bit_vector& bv);
+        void     copy_bits(bit_vector& bv, uint32_t idx, uint32_t height, size_type& pos)const;
+
+    public:
+        //! Constructs an empty bit vector.
+        bit_vector_dynamic();
+
+        //! Constructs a dynamic bit vector with the content of bv.
+        explicit bit_vector_dynamic(const bit_vector& bv);
+
+        //! Returns the number of bits.
+        size_type size()const {
+            return m_size;
+        }
+
+        //! Returns the number of ones.
+        size_type ones()const {
+            return m_ones;
+        }
+
+        //! Returns if the bit vector contains no bits.
+        bool empty()const {
+            return m_size == 0;
+        }
+
+        //! Accessing the i-th bit.
+        /*! \param i An index with \f$ 0 \leq i < size() \f$.
+         */
+        value_type operator[](size_type i)const;
+
+        //! Returns the number of ones in the prefix [0..i-1].
+        /*! \param i An index with \f$ 0 \leq i \leq size() \f$.
+         */
+        size_type rank(size_type i)const;
+
+        //! Returns the position of the i-th one (b=1) or zero (b=0).
+        /*! \param i An index with \f$ 1 \leq i \leq \f$ number of ones (zeros).
+         */
+        size_type select(size_type i, bool b=1)const;
+
+        //! Inserts bit before position i.
+        /*! \param i An index with \f$ 0 \leq i \leq size() \f$.
+         */
+        void insert(size_type i, bool bit);
+
+        //! Appends bit.
+        void push_back(bool bit) {
+            insert(m_size, bit);
+        }
+
+        //! Removes the i-th bit.
+        /*! \param i An index with \f$ 0 \leq i < size() \f$.
+         */
+        void erase(size_type i);
+
+        //! Sets the i-th bit to bit.
+        /*! \param i An index with \f$ 0 \leq i < size() \f$.
+         */
+        void set(size_type i, bool bit);
+
+        //! Removes all bits.
+        void clear();
+
+        //! Swap method
+        void swap(bit_vector_dynamic& v);
+
+        //! Equality operator; compares the content.
+        bool operator==(const bit_vector_dynamic& v)const;
+
+        bool operator!=(const bit_vector_dynamic& v)const {
+            return !(*this == v);
+        }
+
+        //! Returns the content as bit_vector.
+        bit_vector to_bit_vector()const;
+
+        //! Serializes the content as bit_vector.
+        size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in);
+};
+
+//! Rank support for bit_vector_dynamic
+/*! \tparam b Bit pattern of size one.
+ */
+template<uint8_t b>
+class rank_support_dynamic
+{
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef bit_vector_dynamic bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+        explicit rank_support_dynamic(const bit_vector_type* v=NULL) {
+            init(v);
+        }
+
+        void init(const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        //! Returns the number of b bits in the prefix [0..i-1].
+        size_type rank(size_type i)const {
+            size_type r = m_v->rank(i);
+            return b ? r : i - r;
+        }
+
+        const size_type operator()(size_type i)const {
+            return rank(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=NULL) {
+            m_v = v;
+        }
+
+        rank_support_dynamic& operator=(const rank_support_dynamic& rs) {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_dynamic&) { }
+
+        bool operator==(const rank_support_dynamic& rs)const {
+            if (this == &rs)
+                return true;
+            return rs.m_v == m_v;
+        }
+
+        bool operator!=(const rank_support_dynamic& rs)const {
+            return !(*this == rs);
+        }
+
+        void load(std::istream&, const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream&, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            structure_tree::add_size(child, 0);
+            return 0;
+        }
+};
+
+//! Select support for bit_vector_dynamic
+/*! \tparam b Bit pattern of size one.
+ */
+template<uint8_t b>
+class select_support_dynamic
+{
+    public:
+        typedef bit_vector::size_type size_type;
+        typedef bit_vector_dynamic bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+        explicit select_support_dynamic(const bit_vector_type* v=NULL) {
+            init(v);
+        }
+
+        void init(const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th b bit.
+        size_type select(size_type i)const {
+            return m_v->select(i, b);
+        }
+
+        const size_type operator()(size_type i)const {
+            return select(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=NULL) {
+            m_v = v;
+        }
+
+        select_support_dynamic& operator=(const select_support_dynamic& ss) {
+            if (this != &ss) {
+                set_vector(ss.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_dynamic&) { }
+
+        bool operator==(const select_support_dynamic& ss)const {
+            if (this == &ss)
+                return true;
+            return ss.m_v == m_v;
+        }
+
+        bool operator!=(const select_support_dynamic& ss)const {
+            return !(*this == ss);
+        }
+
+        void load(std::istream&, const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream&, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            structure_tree::add_size(child, 0);
+            return 0;
+        }
+};
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,424 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*!\file bit_vector_interleaved_cl.hpp
+   \brief bit_vector_interleaved_cl.hpp contains the sdsl::bit_vector_interleaved_cl class, and
+          classes which support rank and select for bit_vector_interleaved_cl.
+   \author Simon Gog
+*/
+#ifndef SDSL_BIT_VECTOR_INTERLEAVED_CL
+#define SDSL_BIT_VECTOR_INTERLEAVED_CL
+
+#include "int_vector.hpp"
+#include "bitmagic.hpp"
+#include "util.hpp"
+#include <cstring> // for memmove
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t b=1, uint32_t selectSampleRate=512>// forward declaration needed for friend declaration
+class rank_support_interleaved_cl;  // in bit_vector_interleaved_cl
+
+template<uint8_t b=1, uint32_t selectSampleRate=512>// forward declaration needed for friend declaration
+class select_support_interleaved_cl;  // in bit_vector_interleaved_cl
+
+//! A bit vector which stores rank and select information in cache line aligned blocks.
+/*!
+ * The bit vector is divided into lines of 448 bits. Each line is stored
+ * in one 64 byte cache line: the first word holds the number of ones before
+ * the line, the other 7 words hold the bits. The lines are followed by the
+ * select samples in the same aligned memory block: for every selectSampleRate-th
+ * one (zero) the index of the line which contains it.
+ *
+ * \par Time complexity
+ *  rank and access read a single cache line. select reads a sample and
+ *  interpolates the line of the answer between two consecutive samples;
+ *  if this does not hit the line after a few probes, it searches binary.
+ *  For uniformly distributed bits a select costs about two cache misses
+ *  for the line and one for the sample.
+ *
+ * \par Space complexity
+ *  \f$\frac{n}{7}\f$ bits for the counters plus \f$64\f$ bits per
+ *  selectSampleRate ones and zeros, i.e. 27% for the default sample rate.
+ *
+ * The lines are aligned on construction and on load, which moves the data
+ * if the new memory has a different alignment.
+ *
+ * \tparam selectSampleRate Every selectSampleRate-th one and zero is sampled.
+ */
+template<uint32_t selectSampleRate=512>
+class bit_vector_interleaved_cl
+{
+    public:
+        typedef bit_vector::size_type   size_type;
+        typedef size_type               value_type;
+
+        friend class rank_support_interleaved_cl<1,selectSampleRate>;
+        friend class rank_support_interleaved_cl<0,selectSampleRate>;
+        friend class select_support_interleaved_cl<1,selectSampleRate>;
+        friend class select_support_interleaved_cl<0,selectSampleRate>;
+
+        typedef rank_support_interleaved_cl<1,selectSampleRate>     rank_1_type;
+        typedef rank_support_interleaved_cl<0,selectSampleRate>     rank_0_type;
+        typedef select_support_interleaved_cl<1,selectSampleRate> select_1_type;
+        typedef select_support_interleaved_cl<0,selectSampleRate> select_0_type;
+
+        static const uint32_t line_words = 8;     //!< Words per line, i.e. 64 bytes.
+        static const uint32_t data_words = 7;     //!< Words of data per line.
+        static const uint32_t line_bits  = 448;   //!< Bits of data per line.
+    private:
+        size_type m_size;           /* size of the original bit vector */
+        size_type m_ones;           /* number of ones */
+        size_type m_lines;          /* number of lines; the last one is not full */
+        size_type m_offset;         /* index of the first line in m_data */
+        size_type m_select1_start;  /* index of the first select sample for ones relative to m_offset */
+        size_type m_select0_start;  /* index of the first select sample for zeros relative to m_offset */
+        int_vector<64> m_data;      /* lines and select samples; 7 words padding for the alignment */
+
+        const uint64_t* lines()const {
+            return m_data.data() + m_offset;
+        }
+
+        // Moves the lines to the first 64 byte boundary of m_data.
+        void align() {
+            if (m_data.size() == 0)
+                return;
+            size_type offset = ((64 - (((size_t)m_data.data()) & 63)) & 63) >> 3;
+            if (offset != m_offset) {
+                uint64_t* data = &m_data[0];
+                std::memmove(data + offset, data + m_offset, (m_data.size()-7)*sizeof(uint64_t));
+                m_offset = offset;
+            }
+        }
+
+        // Number of b bits before line l.
+        template<uint8_t bit>
+        size_type count_before(size_type l)const {
+            size_type ones = lines()[l*line_words];
+            return bit ? ones : l*line_bits - ones;
+        }
+
+        // Stores for every selectSampleRate-th b bit the index of the line containing it,
+        // followed by the index of the last line.
+        template<uint8_t bit>
+        void init_select_samples(uint64_t* samples, size_type args) {
+            size_type k = 0;
+            for (size_type l=0; l < m_lines; ++l) {
+                size_type after = (l+1 < m_lines) ? count_before<bit>(l+1) : args;
+                while (k*selectSampleRate < args and after > k*selectSampleRate) {
+                    samples[k++] = l;
+                }
+            }
+            samples[k] = m_lines-1;
+        }
+
+        void init(const bit_vector& bv) {
+            m_size   = bv.size();
+            m_ones   = 0;
+            m_offset = 0;
+            m_lines  = m_size/line_bits + 1; // the last line is not full
+            size_type ones  = util::get_one_bits(bv);
+            size_type zeros = m_size - ones;
+            m_select1_start = m_lines*line_words;
+            m_select0_start = m_select1_start + ones/selectSampleRate + 2;
+            size_type used  = m_select0_start + zeros/selectSampleRate + 2;
+            util::assign(m_data, int_vector<64>(used + 7, 0));
+            align();
+            uint64_t* data = &m_data[0] + m_offset;
+            const uint64_t* bvp = bv.data();
+            size_type words = (m_size+63)/64;
+            for (size_type l=0, i=0; l < m_lines; ++l) {
+                uint64_t* line = data + l*line_words;
+                line[0] = m_ones;
+                for (size_type w=1; w < line_words and i < words; ++w, ++i) {
+                    line[w] = bvp[i];
+                    if (64*(i+1) > m_size) // clear the bits after the end of bv
+                        line[w] &= bit_magic::Li1Mask[m_size&63];
+                    m_ones += bit_magic::b1Cnt(line[w]);
+                }
+            }
+            init_select_samples<1>(data + m_select1_start, m_ones);
+            init_select_samples<0>(data + m_select0_start, m_size - m_ones);
+        }
+
+        void copy(const bit_vector_interleaved_cl& v) {
+            m_size          = v.m_size;
+            m_ones          = v.m_ones;
+            m_lines         = v.m_lines;
+            m_offset        = v.m_offset;
+            m_select1_start = v.m_select1_start;
+            m_select0_start = v.m_select0_start;
+            m_data          = v.m_data;
+            align();
+        }
+
+    public:
+        bit_vector_interleaved_cl() {
+            init(bit_vector());
+        }
+
+        bit_vector_interleaved_cl(const bit_vector& bv) {
+            init(bv);
+        }
+
+        bit_vector_interleaved_cl(const bit_vector_interleaved_cl& v) {
+            copy(v);
+        }
+
+        bit_vector_interleaved_cl& operator=(const bit_vector_interleaved_cl& v) {
+            if (this != &v) {
+                copy(v);
+            }
+            return *this;
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+           \return The i-th bit of the original bit_vector
+           \par Time complexity
+           		\f$ \Order{1} \f$
+        */
+        value_type operator[](size_type i)const {
+            size_type r = i % line_bits;
+            return (lines()[(i/line_bits)*line_words + 1 + (r>>6)] >> (r&63)) & 1ULL;
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const {
+            return m_size;
+        }
+
+        //! Returns the number of ones.
+        size_type ones()const {
+            return m_ones;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += util::write_member(m_size, out, child, "size");
+            written_bytes += util::write_member(m_ones, out, child, "ones");
+            written_bytes += util::write_member(m_lines, out, child, "lines");
+            written_bytes += util::write_member(m_offset, out, child, "offset");
+            written_bytes += util::write_member(m_select1_start, out, child, "select1_start");
+            written_bytes += util::write_member(m_select0_start, out, child, "select0_start");
+            written_bytes += m_data.serialize(out, child, "data");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in) {
+            util::read_member(m_size, in);
+            util::read_member(m_ones, in);
+            util::read_member(m_lines, in);
+            util::read_member(m_offset, in);
+            util::read_member(m_select1_start, in);
+            util::read_member(m_select0_start, in);
+            m_data.load(in);
+            align();
+        }
+
+        void swap(bit_vector_interleaved_cl& bv) {
+            if (this != &bv) {
+                std::swap(m_size, bv.m_size);
+                std::swap(m_ones, bv.m_ones);
+                std::swap(m_lines, bv.m_lines);
+                std::swap(m_offset, bv.m_offset);
+                std::swap(m_select1_start, bv.m_select1_start);
+                std::swap(m_select0_start, bv.m_select0_start);
+                m_data.swap(bv.m_data);
+            }
+        }
+};
+
+//! Rank support for bit_vector_interleaved_cl which reads one cache line per query.
+template<uint8_t b, uint32_t selectSampleRate>
+class rank_support_interleaved_cl
+{
+    public:
+        typedef bit_vector::size_type       		              size_type;
+        typedef bit_vector_interleaved_cl<selectSampleRate>       bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        rank_support_interleaved_cl(const bit_vector_type* v=NULL) {
+            init(v);
+        }
+
+        void init(const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        //! Returns the number of b bits in the prefix [0..i-1].
+        size_type rank(size_type i) const {
+            size_type l = i / bit_vector_type::line_bits;
+            size_type r = i % bit_vector_type::line_bits;
+            const uint64_t* line = m_v->lines() + l*bit_vector_type::line_words;
+            size_type res = line[0];
+            ++line;
+            for (size_type w = r>>6; w > 0; --w, ++line)
+                res += bit_magic::b1Cnt(*line);
+            res += bit_magic::b1Cnt(*line & bit_magic::Li1Mask[r&63]);
+            return b ? res : i - res;
+        }
+
+        const size_type operator()(size_type i)const {
+            return rank(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=NULL) {
+            m_v = v;
+        }
+
+        rank_support_interleaved_cl& operator=(const rank_support_interleaved_cl& rs) {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_interleaved_cl&) { }
+
+        bool operator==(const rank_support_interleaved_cl& ss)const {
+            if (this == &ss)
+                return true;
+            return ss.m_v == m_v;
+        }
+
+        bool operator!=(const rank_support_interleaved_cl& rs)const {
+            return !(*this == rs);
+        }
+
+        void load(std::istream&, const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream&, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+};
+
+//! Select support for bit_vector_interleaved_cl which uses the select samples of the bit vector.
+template<uint8_t b, uint32_t selectSampleRate>
+class select_support_interleaved_cl
+{
+    public:
+        typedef bit_vector::size_type                       size_type;
+        typedef bit_vector_interleaved_cl<selectSampleRate> bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+
+        select_support_interleaved_cl(const bit_vector_type* v=NULL) {
+            init(v);
+        }
+
+        void init(const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        size_type select(size_type i) const {
+            const uint64_t* samples = m_v->lines() + (b ? m_v->m_select1_start : m_v->m_select0_start);
+            size_type k  = (i-1) / selectSampleRate;
+            size_type lb = samples[k], rb = samples[k+1]; // the i-th b bit is in a line in [lb..rb]
+            // Find the last line in [lb..rb] with less than i b bits before it. The first
+            // probes interpolate between the samples, then the search continues binary.
+            size_type l = lb + (((i-1) % selectSampleRate) * (rb-lb)) / selectSampleRate;
+            for (size_type probes=0; lb < rb; ++probes) { // invariant: count_before(lb) < i
+                size_type mid = (probes < 4) ? std::min(std::max(l, lb+1), rb) : lb + (rb-lb+1)/2;
+                if (m_v->template count_before<b>(mid) < i) {
+                    lb = mid;
+                    l  = mid+1;
+                } else {
+                    rb = mid-1;
+                    l  = mid-1;
+                }
+            }
+            i -= m_v->template count_before<b>(lb);
+            const uint64_t* line = m_v->lines() + lb*bit_vector_type::line_words + 1;
+            // count the b bits before each word of the line without branches
+            size_type before[bit_vector_type::data_words];
+            size_type cnt = 0, w = 0;
+            for (size_type k=0; k < bit_vector_type::data_words; ++k) {
+                before[k] = cnt;
+                w   += (cnt < i);
+                cnt += bit_magic::b1Cnt(b ? line[k] : ~line[k]);
+            }
+            --w; // the last word with less than i b bits before it
+            return lb*bit_vector_type::line_bits + 64*w + bit_magic::i1BP(b ? line[w] : ~line[w], i - before[w]);
+        }
+
+        const size_type operator()(size_type i)const {
+            return select(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=NULL) {
+            m_v = v;
+        }
+
+        select_support_interleaved_cl& operator=(const select_support_interleaved_cl& rs) {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_interleaved_cl&) { }
+
+        bool operator==(const select_support_interleaved_cl& ss)const {
+            if (this == &ss)
+                return true;
+            return ss.m_v == m_v;
+        }
+
+        bool operator!=(const select_support_interleaved_cl& rs)const {
+            return !(*this == rs);
+        }
+
+        void load(std::istream&, const bit_vector_type* v=NULL) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream&, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+};
+
+}
+
+#endif
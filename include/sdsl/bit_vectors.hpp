@@ -7,8 +7,11 @@
 
 #include "int_vector.hpp"
 #include "bit_vector_interleaved.hpp"
+#include "bit_vector_interleaved_cl.hpp"
 #include "rrr_vector.hpp"
 #include "sd_vector.hpp"
 #include "gap_vector.hpp"
+#include "bit_vector_dynamic.hpp"
+#include "bit_operations.hpp"
 
 #endif
@@ -28,6 +28,12 @@
 #include <xmmintrin.h>
 #endif
 
+// On x86 the bit_magic methods select POPCNT and BMI2 at runtime (see bit_magic::cpu),
+// unless they are enabled at compile time (e.g. by -msse4.2 or -mbmi2).
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDSL_BITMAGIC_X86
+#endif
+
 //! Namespace for the succinct data structure library.
 namespace sdsl
 {
@@ -52,6 +58,24 @@ class bit_magic
     private:
         bit_magic(); // This helper class can not be instantiated
     public:
+        //! CPU features which are used by the bit_magic methods.
+        struct cpu_features {
+            bool popcnt;    //!< POPCNT instruction, used by b1Cnt.
+            bool bmi2;      //!< BMI2 instructions.
+            bool fast_pdep; //!< BMI2 with a fast PDEP instruction, used by i1BP. Not set on AMD CPUs before Zen 3, which microcode PDEP.
+            bool avx2;      //!< AVX2 instructions with the vector registers enabled by the OS, used by read_ints.
+        };
+
+        //! Features of the CPU the program runs on; detected at program start.
+        /*! The features are checked by b1Cnt, i1BP and read_ints if the instructions are
+            not enabled at compile time. Clearing a feature forces the fallback
+            implementation, e.g. for benchmarks.
+         */
+        static cpu_features cpu;
+
+        //! Queries the features of the CPU with the cpuid instruction.
+        static cpu_features detect_cpu_features();
+
         //! 64bit mask with all bits set to 1.
         static const int64_t  All1Mask = -1LL;
 
@@ -251,6 +275,14 @@ class bit_magic
         //! Naive implementation of the b1Cnt function.
         static uint32_t b1CntNaive(uint64_t x);
 
+        //! Broadword implementation of the b1Cnt function.
+        static uint64_t b1CntBW(uint64_t x);
+
+        //! b1Cnt implementation using the POPCNT instruction.
+        /*! \pre cpu.popcnt is set or the code is compiled for SSE4.2.
+         */
+        static uint64_t b1CntPopcnt(uint64_t x);
+
         //! Count the number of consecutive and distinct 11 in the 64bit integer x.
         /*!
           	\param x 64bit integer to count the terminating sequence 11 of a fibonacci code.
@@ -315,6 +347,12 @@ class bit_magic
          */
         static uint32_t k1BP(uint64_t x, uint32_t j);
 
+        //! i1BP implementation using the PDEP instruction of BMI2.
+        /*! \pre cpu.bmi2 is set or the code is compiled for BMI2.
+            \sa i1BP
+         */
+        static uint32_t i1BPPdep(uint64_t x, uint32_t i);
+
 
 
         //! Naive implementation of i1BP.
@@ -395,6 +433,23 @@ class bit_magic
         //! TODO: Documentation for this function
         static uint64_t read_int_and_move(const uint64_t*& word, uint8_t& offset, const uint8_t len=64);
 
+        //! Reads n consecutive integers of length len which start at bit position offset of word.
+        /*! \param word   Pointer to the bit sequence.
+            \param offset Bit position of the first integer, counted from word.
+            \param len    Length of each integer in bits, len in [1..64].
+            \param n      Number of integers to read.
+            \param out    Array of at least n elements which holds the integers afterwards.
+            \par Details
+            Blocks of 64 integers are decoded by kernels which are unrolled for each length.
+            For the lengths 8, 16 and 32 AVX2 kernels are used if cpu.avx2 is set.
+         */
+        static void read_ints(const uint64_t* word, uint64_t offset, const uint8_t len, uint64_t n, uint64_t* out);
+
+        //! Writes the n integers of array in as integers of length len starting at bit position offset of word.
+        /*! \sa read_ints
+         */
+        static void write_ints(uint64_t* word, uint64_t offset, const uint8_t len, uint64_t n, const uint64_t* in);
+
         //! TODO: Documentation for this function
         static uint64_t readUnaryInt(const uint64_t* word, uint8_t offset=0);
 
@@ -903,12 +958,23 @@ inline uint16_t bit_magic::max_excess3(uint64_t x, uint16_t& b1Cnt)
     return (maxi[0]<maxi[4])?maxi[4]&0x7F:maxi[0]&0x7F;
 }
 
-// see page 11, Knuth TAOCP Vol 4 F1A
 inline uint64_t bit_magic::b1Cnt(uint64_t x)
 {
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) || defined(__POPCNT__)
     return __builtin_popcountll(x);
 #else
+#if defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+    if (cpu.popcnt) {
+        return b1CntPopcnt(x);
+    }
+#endif
+    return b1CntBW(x);
+#endif
+}
+
+// see page 11, Knuth TAOCP Vol 4 F1A
+inline uint64_t bit_magic::b1CntBW(uint64_t x)
+{
 #ifdef POPCOUNT_TL
     return B1CntBytes[x&0xFFULL] + B1CntBytes[(x>>8)&0xFFULL] +
            B1CntBytes[(x>>16)&0xFFULL] + B1CntBytes[(x>>24)&0xFFULL] +
@@ -920,6 +986,18 @@ inline uint64_t bit_magic::b1Cnt(uint64_t x)
     x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
     return (0x0101010101010101ull*x >> 56);
 #endif
+}
+
+inline uint64_t bit_magic::b1CntPopcnt(uint64_t x)
+{
+#if defined(__SSE4_2__) || defined(__POPCNT__)
+    return __builtin_popcountll(x);
+#elif defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+    uint64_t cnt;
+    __asm__("popcntq %1, %0" : "=r"(cnt) : "r"(x)); // the assembler knows POPCNT also without -msse4.2
+    return cnt;
+#else
+    return b1CntBW(x);
 #endif
 }
 
@@ -1071,7 +1149,7 @@ inline uint32_t bit_magic::k1BP(uint64_t x, uint32_t i)
 //	if ( i == 1 ){
 //		return __builtin_ctzll(x);
 //	}
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) || defined(SDSL_BITMAGIC_X86)
     uint64_t s = x, b;
     s = s-((s>>1) & 0x5555555555555555ULL);
     s = (s & 0x3333333333333333ULL) + ((s >> 2) & 0x3333333333333333ULL);
@@ -1100,9 +1178,30 @@ inline uint32_t bit_magic::k1BP(uint64_t x, uint32_t i)
 }
 
 
+inline uint32_t bit_magic::i1BPPdep(uint64_t x, uint32_t i)
+{
+    uint64_t b;
+#ifdef __BMI2__
+    b = __builtin_ia32_pdep_di(1ULL<<(i-1), x);
+#elif defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+    __asm__("pdepq %2, %1, %0" : "=r"(b) : "r"(1ULL<<(i-1)), "r"(x)); // deposit the i-th lowest bit at the i-th 1 of x
+#else
+    return i1BP2(x, i);
+#endif
+    return __builtin_ctzll(b);
+}
+
 inline uint32_t bit_magic::i1BP(uint64_t x, uint32_t i)
 {
-#ifdef __SSE4_2__
+#if defined(__BMI2__)
+    return i1BPPdep(x, i);
+#elif defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+    if (cpu.fast_pdep) {
+        return i1BPPdep(x, i);
+    }
+#endif
+#if defined(__SSE4_2__) || defined(SDSL_BITMAGIC_X86)
+    // ctz (bsf) is part of the x86 base instruction set, so this version needs no dispatch
 //__m64 v;
 //v = (__m64)x;
 //const __m64 mask_
@@ -1204,7 +1303,7 @@ inline uint32_t bit_magic::i1BPNaive(uint64_t x, uint32_t i)
 // http://www-graphics.stanford.edu/~seander/bithacks.html
 inline uint32_t bit_magic::l1BP(uint64_t x)
 {
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) || defined(SDSL_BITMAGIC_X86) // clz compiles to bsr or lzcnt
     if (x == 0)
         return 0;
     return 63 - __builtin_clzll(x);
@@ -1243,7 +1342,7 @@ inline uint32_t bit_magic::l1BPNaive(uint64_t x)
 // or page 10, Knuth TAOCP Vol 4 F1A
 inline uint32_t bit_magic::r1BP(uint64_t x)
 {
-#ifdef __SSE4_2__
+#if defined(__SSE4_2__) || defined(SDSL_BITMAGIC_X86) // ctz compiles to bsf or tzcnt
     if (x==0)
         return 0;
     return __builtin_ctzll(x);
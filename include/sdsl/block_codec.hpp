@@ -0,0 +1,147 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file block_codec.hpp
+    \brief block_codec.hpp contains a lightweight codec for the temporary files of the construction algorithms.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_BLOCK_CODEC
+#define INCLUDED_SDSL_BLOCK_CODEC
+
+#include <stdint.h> // for uint64_t
+#include <iostream>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! A fast, byte-aligned codec for blocks of integers and bytes.
+/*! Integer blocks are stored in the smallest of three representations:
+ *    - RAW:   bit-packed with the width of the largest value,
+ *    - VBYTE: each value as variable byte code (7 bits per byte),
+ *    - DELTA: the zigzag encoded difference to the previous value as variable byte code.
+ *  So a block never takes considerably more space than its bit-packed
+ *  representation. Small values (e.g. most LCP values) and increasing
+ *  sequences compress well, random values like suffix array entries are
+ *  usually stored RAW.
+ *
+ *  Byte blocks are run-length encoded with literal runs, which expands
+ *  incompressible data by less than 1%.
+ *
+ *  The codec keeps global counters of the raw and encoded bytes of all
+ *  blocks written through write_ints and write_bytes, see stats().
+ */
+class block_codec
+{
+    public:
+        enum int_block_type {
+            RAW   = 0,
+            VBYTE = 1,
+            DELTA = 2
+        };
+
+        //! Number of elements per block of a compressed int_vector (see int_vector::serialize_compressed).
+        static const uint64_t int_vector_block_size = 1ULL<<20;
+
+        //! Maximal size of an encoded block of n integers in bytes.
+        static uint64_t max_encoded_ints_size(uint64_t n) {
+            return 10*n + 16;
+        }
+
+        //! Maximal size of an encoded block of n bytes in bytes.
+        static uint64_t max_encoded_bytes_size(uint64_t n) {
+            return n + n/128 + 16;
+        }
+
+        //! Encodes the n integers in in into out.
+        /*! \param in  Array of n integers.
+         *  \param n   Number of integers.
+         *  \param out Array of at least max_encoded_ints_size(n) bytes.
+         *  \return Number of bytes written to out.
+         */
+        static uint64_t encode_ints(const uint64_t* in, uint64_t n, uint8_t* out);
+
+        //! Decodes n integers which were encoded by encode_ints.
+        /*! \return Number of bytes consumed from in.
+         */
+        static uint64_t decode_ints(const uint8_t* in, uint64_t n, uint64_t* out);
+
+        //! Run-length encodes the n bytes in in into out.
+        /*! \param out Array of at least max_encoded_bytes_size(n) bytes.
+         *  \return Number of bytes written to out.
+         */
+        static uint64_t encode_bytes(const uint8_t* in, uint64_t n, uint8_t* out);
+
+        //! Decodes n bytes which were encoded by encode_bytes.
+        /*! \param len Number of bytes which can be read from in.
+         *  \return Number of bytes consumed from in, or 0 if the input is corrupted,
+         *          i.e. a run exceeds the n bytes of out or the len bytes of in.
+         */
+        static uint64_t decode_bytes(const uint8_t* in, uint64_t len, uint64_t n, uint8_t* out);
+
+        //! Encodes the n integers of in and writes the block (with its length) to out.
+        /*! \param width Width of the integers in the uncompressed representation, used for stats().
+         *  \return Number of bytes written to out.
+         */
+        static uint64_t write_ints(std::ostream& out, const uint64_t* in, uint64_t n, uint8_t width=64);
+
+        //! Encodes the n integers of in and writes the block (with its length) to the memory out.
+        /*! \param out Array of at least sizeof(uint64_t)+max_encoded_ints_size(n) bytes.
+         *  \return Number of bytes written to out.
+         */
+        static uint64_t write_ints(uint8_t* out, const uint64_t* in, uint64_t n, uint8_t width=64);
+
+        //! Reads a block of n integers which was written by write_ints.
+        static bool read_ints(std::istream& in, uint64_t n, uint64_t* out);
+
+        //! Encodes the n bytes of in and writes the block (with its length) to out.
+        /*! \return Number of bytes written to out.
+         */
+        static uint64_t write_bytes(std::ostream& out, const uint8_t* in, uint64_t n);
+
+        //! Reads a block of n bytes which was written by write_bytes.
+        static bool read_bytes(std::istream& in, uint64_t n, uint8_t* out);
+
+        //! Statistics of all blocks written by write_ints and write_bytes.
+        struct statistics {
+            uint64_t raw_bytes;     //!< Size of the blocks before encoding.
+            uint64_t encoded_bytes; //!< Size of the blocks after encoding.
+        };
+
+        //! Returns the statistics of the written blocks.
+        static statistics stats();
+
+        //! Resets the statistics.
+        static void reset_stats();
+};
+
+namespace util
+{
+//! Enables or disables the compression of the temporary files of the construction algorithms.
+/*! Affects temp_write_read_buffer (e.g. in wt_int::construct), the buffered_char_queue of
+ *  construct_lcp_go and construct_lcp_goPHI, and the sa_ and lcp_ files which are written
+ *  by construct_csa, construct_lcp_kasai, construct_lcp_PHI and construct_lcp_semi_extern_PHI.
+ *  Compression is disabled by default.
+ */
+void set_temp_file_compression(bool compress);
+
+//! Returns if the temporary files of the construction algorithms are compressed.
+bool temp_file_compression();
+}
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,242 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file block_decoder.hpp
+    \brief block_decoder.hpp contains the sdsl::coder::block_decoder class, which decodes
+           sequences of self-delimiting codes with a table.
+	\author Simon Gog
+ */
+#ifndef SDSL_BLOCK_DECODER
+#define SDSL_BLOCK_DECODER
+
+#include "int_vector.hpp"
+#include "fibonacci_coder.hpp"
+#include "vbyte_coder.hpp"
+#include "pfor_coder.hpp"
+#include <vector>
+#include <cstring> // for memcpy
+
+namespace sdsl
+{
+
+namespace coder
+{
+
+//! Decodes a sequence of codes of a self-delimiting code (e.g. elias_delta or fibonacci) with a table.
+/*! The table is indexed by the next 12 bits of the bit stream and contains
+ *  all codes (up to 6) which lie completely in these 12 bits. Therefore
+ *  short codes, which dominate the difference sequences of enc_vector,
+ *  are decoded several at a time without a loop over the bits. Longer
+ *  codes are decoded with Coder::decode.
+ *
+ *  The table is built from Coder::encode on first use; it takes 32 kB.
+ *  The decoder of coder::fibonacci already works with 12-bit tables and
+ *  is used directly, as well as the decoder of coder::pfor, whose slots
+ *  are read with one access. coder::vbyte has its own block decoder.
+ *
+ *  \par Example
+ *  \code
+ *  std::vector<uint64_t> buf(n);
+ *  coder::block_decoder<coder::elias_delta>::decode<true>(z.data(), z.bit_size(), start, n, &buf[0]);
+ *  \endcode
+ */
+template<class Coder>
+class block_decoder
+{
+    public:
+        typedef uint64_t size_type;
+
+        static const uint32_t window     = 12; //!< Number of bits which are decoded with one table lookup.
+        static const uint32_t max_codes  = 6;  //!< Maximal number of codes in a table entry.
+        static const uint32_t value_bits = 9;  //!< Width of a value in a table entry.
+    private:
+        // An entry contains the number of codes (3 bits), their total length (4 bits)
+        // and the values of the codes (value_bits each).
+        struct table {
+            std::vector<uint64_t> entries;
+            table();
+        };
+
+        static const table& get_table() {
+            static table t;
+            return t;
+        }
+
+        // Returns the bits starting at bit position pos; at least window many if they exist.
+        static uint64_t read_bits(const uint64_t* data, size_type words, size_type pos) {
+            size_type idx = pos >> 6;
+            uint8_t offset = pos & 0x3F;
+            if (idx+1 < words) // (x << 1) << (63-offset) is 0 for offset = 0
+                return (data[idx] >> offset) | ((data[idx+1] << 1) << (63-offset));
+            return data[idx] >> offset;
+        }
+
+    public:
+        //! Decodes n codes starting at bit start_idx of data.
+        /*! \param data      The bit stream.
+         *  \param bit_size  Length of the bit stream; bits after it are not read.
+         *  \param start_idx Bit position of the first code.
+         *  \param n         Number of codes to decode.
+         *  \param out       Buffer for n values.
+         *  \param value     Start value of the prefix sums.
+         *  \tparam sumup    If true, out contains the prefix sums of the decoded values plus value.
+         */
+        template<bool sumup>
+        static void decode(const uint64_t* data, size_type bit_size, size_type start_idx, size_type n, uint64_t* out, uint64_t value=0) {
+            const uint64_t* entries = &(get_table().entries[0]);
+            size_type words = (bit_size+63) >> 6;
+            size_type pos = start_idx;
+            uint64_t* end = out + n;
+            while (out < end) {
+                uint64_t e = entries[read_bits(data, words, pos) & ((1ULL<<window)-1)];
+                uint32_t cnt = e & 0x7;
+                if (cnt > 0 and (size_type)(end-out) >= max_codes) {
+                    // write all max_codes values of the entry without branches and keep cnt of them
+                    pos += (e >> 3) & 0xF;
+                    e >>= 7;
+                    uint64_t x = value;
+                    for (uint32_t k=0; k < max_codes; ++k) {
+                        uint64_t y = (e >> (k*value_bits)) & ((1ULL<<value_bits)-1);
+                        out[k] = sumup ? (x += y) : y;
+                    }
+                    if (sumup)
+                        value = out[cnt-1];
+                    out += cnt;
+                } else if (cnt > 0) { // the last codes of the sequence
+                    e >>= 7;
+                    for (uint32_t k=0; k < cnt and out < end; ++k, e >>= value_bits) {
+                        uint64_t y = e & ((1ULL<<value_bits)-1);
+                        pos += Coder::encoding_length(y);
+                        *out++ = sumup ? (value += y) : y;
+                    }
+                } else { // a code which is longer than the window
+                    uint64_t y = Coder::template decode<false, false, uint64_t*>(data, pos, 1);
+                    pos += Coder::encoding_length(y);
+                    *out++ = sumup ? (value += y) : y;
+                }
+            }
+        }
+};
+
+//! Block decoder which forwards to Coder::decode.
+template<class Coder>
+class sequential_block_decoder
+{
+    public:
+        typedef uint64_t size_type;
+
+        //! \sa block_decoder::decode
+        template<bool sumup>
+        static void decode(const uint64_t* data, size_type, size_type start_idx, size_type n, uint64_t* out, uint64_t value=0) {
+            if (n == 0)
+                return;
+            Coder::template decode<false, true>(data, start_idx, n, out);
+            if (sumup) {
+                for (size_type k=0; k < n; ++k)
+                    out[k] = (value += out[k]);
+            }
+        }
+};
+
+template<>
+class block_decoder<fibonacci> : public sequential_block_decoder<fibonacci> {};
+
+template<uint8_t BitWidth>
+class block_decoder<pfor<BitWidth> > : public sequential_block_decoder<pfor<BitWidth> > {};
+
+//! Block decoder for coder::vbyte.
+/*! The stop bits of 8 bytes are tested at once. If all 8 bytes are
+ *  complete codes, i.e. values smaller than 128, they are written without a
+ *  loop over the bytes. Otherwise one code is decoded byte-wise.
+ */
+template<>
+class block_decoder<vbyte>
+{
+    public:
+        typedef uint64_t size_type;
+
+        //! \sa block_decoder::decode
+        template<bool sumup>
+        static void decode(const uint64_t* data, size_type bit_size, size_type start_idx, size_type n, uint64_t* out, uint64_t value=0) {
+            if (start_idx & 0x7) { // codes do not start at byte boundaries
+                sequential_block_decoder<vbyte>::decode<sumup>(data, bit_size, start_idx, n, out, value);
+                return;
+            }
+            const uint8_t* p     = (const uint8_t*)data + (start_idx>>3);
+            const uint8_t* p_end = (const uint8_t*)data + (bit_size>>3);
+            uint64_t* end = out + n;
+            while (out < end) {
+                uint64_t w = 0x80; // the bits of the data are little endian
+                if (p + 8 <= p_end and end - out >= 8)
+                    memcpy(&w, p, 8);
+                if ((w & 0x8080808080808080ULL) == 0) { // 8 values < 128
+                    for (uint32_t k=0; k < 8; ++k) {
+                        uint64_t y = (w >> (k<<3)) & 0x7F;
+                        out[k] = sumup ? (value += y) : y;
+                    }
+                    out += 8; p += 8;
+                } else {
+                    uint64_t y = 0, b;
+                    uint8_t shift = 0;
+                    do {
+                        b = *(p++);
+                        y |= (b & 0x7F) << shift;
+                        shift += 7;
+                    } while (b & 0x80);
+                    *out++ = sumup ? (value += y) : y;
+                }
+            }
+        }
+};
+
+template<class Coder>
+block_decoder<Coder>::table::table():entries(1<<window, 0)
+{
+    // first code of each window: value and length
+    std::vector<uint64_t> first_value(1<<window, 0);
+    std::vector<uint8_t>  first_len(1<<window, 0);
+    for (uint64_t x=1; x < (1ULL<<value_bits); ++x) {
+        uint8_t len = Coder::encoding_length(x);
+        if (len > window)
+            continue;
+        uint64_t code[2] = {0, 0};
+        uint64_t* z = code;
+        uint8_t offset = 0;
+        Coder::encode(x, z, offset);
+        for (uint64_t h=0; h < (1ULL << (window-len)); ++h) {
+            uint64_t w = code[0] | (h << len);
+            first_value[w] = x;
+            first_len[w]   = len;
+        }
+    }
+    for (uint64_t w=0; w < entries.size(); ++w) {
+        uint64_t e = 0, cnt = 0, len = 0;
+        while (cnt < max_codes) {
+            uint64_t rest = w >> len; // the bits after the window are zero
+            if (first_len[rest] == 0 or len + first_len[rest] > window)
+                break;
+            e   |= first_value[rest] << (7 + cnt*value_bits);
+            len += first_len[rest];
+            ++cnt;
+        }
+        entries[w] = e | (len << 3) | cnt;
+    }
+}
+
+} // end namespace coder
+} // end namespace sdsl
+
+#endif
@@ -0,0 +1,218 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file block_encoder.hpp
+    \brief block_encoder.hpp contains the sdsl::coder::block_encoder class, which encodes
+           the sample blocks of enc_vector and vlc_vector in parallel.
+	\author Simon Gog
+ */
+#ifndef SDSL_BLOCK_ENCODER
+#define SDSL_BLOCK_ENCODER
+
+#include "int_vector.hpp"
+#include "parallel.hpp"
+#include <vector>
+#include <algorithm> // for std::min
+
+namespace sdsl
+{
+
+namespace coder
+{
+
+//! Encodes a sequence, which is split into blocks of sample_dens values, with parallel_for.
+/*! The values are passed twice in their order: first to count(), which
+ *  determines the length of the codes of each block, and then to encode(),
+ *  which writes the codes of each block at the sum of the lengths of the
+ *  preceding blocks. The values are buffered in chunks of whole blocks and
+ *  the blocks of a chunk are processed concurrently. So the sequence does
+ *  not have to be in memory, e.g. if it is read from an int_vector_file_buffer.
+ *
+ *  The bit stream is identical to the one of a sequential encoding. A
+ *  thread writes the codes of its first word, which it may share with the
+ *  previous range of blocks, into a local word; these words are added to
+ *  the bit stream after the threads are joined.
+ *
+ *  \tparam Coder       The coder, e.g. coder::elias_delta.
+ *  \tparam differences If true, the first value of a block is a sample and
+ *                      the differences of the other values to their
+ *                      predecessors are encoded (enc_vector). Otherwise each
+ *                      value x is encoded as x+1 (vlc_vector).
+ *  \par Example
+ *  \code
+ *  coder::block_encoder<coder::elias_delta, true> enc(sample_dens, v.size());
+ *  for (size_type i=0; i < v.size(); ++i) enc.count(v[i]);
+ *  int_vector<> z(enc.count_end(), 0, 1);
+ *  enc.encode_begin(coder::elias_delta::raw_data(z));
+ *  for (size_type i=0; i < v.size(); ++i) enc.encode(v[i]);
+ *  enc.encode_end();
+ *  \endcode
+ */
+template<class Coder, bool differences>
+class block_encoder
+{
+    public:
+        typedef uint64_t size_type;
+
+        static const size_type chunk_size = (size_type)1<<20; //!< Number of values which are buffered, rounded down to whole blocks.
+    private:
+        size_type             m_sample_dens;
+        std::vector<uint64_t> m_buf;       // values of the current chunk
+        size_type             m_buf_size;  // number of values in m_buf
+        size_type             m_blocks;    // number of blocks in the previous chunks
+        std::vector<uint64_t> m_block_pos; // length of the codes of each block; after count_end() the start of each block
+        uint64_t*             m_z;         // bit stream
+        bool                  m_encode;    // false in the first, true in the second pass
+        std::vector<uint64_t> m_head;      // first word of the range of each thread
+        std::vector<uint64_t> m_head_word; // index of this word in the bit stream
+
+        block_encoder(const block_encoder&);
+        block_encoder& operator=(const block_encoder&);
+
+        // Processes the blocks in m_buf.
+        void process() {
+            size_type blocks = (m_buf_size + m_sample_dens - 1) / m_sample_dens;
+            if (blocks > 0) {
+                m_head.assign(util::thread_count(), 0);
+                m_head_word.assign(util::thread_count(), 0);
+                uint32_t ranges = parallel_for(blocks, *this, 1, std::max((size_type)1, ((size_type)1<<14)/m_sample_dens));
+                if (m_encode) {
+                    for (uint32_t t=0; t < ranges; ++t) {
+                        if (m_head[t])
+                            m_z[m_head_word[t]] |= m_head[t];
+                    }
+                }
+            }
+            m_blocks  += blocks;
+            m_buf_size = 0;
+        }
+
+        void push(uint64_t x) {
+            m_buf[m_buf_size++] = x;
+            if (m_buf_size == m_buf.size())
+                process();
+        }
+
+    public:
+        //! Constructor
+        /*! \param sample_dens Number of values in a block.
+         *  \param n           Number of values of the sequence.
+         */
+        block_encoder(size_type sample_dens, size_type n):
+            m_sample_dens(sample_dens),
+            m_buf(std::min(n, std::max((size_type)1, chunk_size/sample_dens)*sample_dens)),
+            m_buf_size(0), m_blocks(0),
+            m_block_pos((n + sample_dens - 1)/sample_dens + 1, 0),
+            m_z(NULL), m_encode(false) {}
+
+        //! Passes the next value of the sequence for the first pass.
+        void count(uint64_t x) {
+            push(x);
+        }
+
+        //! Ends the first pass.
+        /*! \return The length of the bit stream.
+         */
+        size_type count_end() {
+            process();
+            size_type sum = 0;
+            for (size_type k=0; k+1 < m_block_pos.size(); ++k) {
+                uint64_t len = m_block_pos[k];
+                m_block_pos[k] = sum;
+                sum += len;
+            }
+            m_block_pos.back() = sum;
+            m_blocks = 0;
+            return sum;
+        }
+
+        //! Start of the codes of block k in the bit stream; available after count_end().
+        size_type block_pos(size_type k)const {
+            return m_block_pos[k];
+        }
+
+        //! Starts the second pass.
+        /*! \param z Bit stream of count_end() bits, which are initialized with zero.
+         */
+        void encode_begin(uint64_t* z) {
+            m_z = z;
+            m_encode = true;
+        }
+
+        //! Passes the next value of the sequence for the second pass.
+        void encode(uint64_t x) {
+            push(x);
+        }
+
+        //! Ends the second pass.
+        void encode_end() {
+            process();
+            m_z = NULL;
+            m_encode = false;
+        }
+
+        //! Counts or encodes the blocks [begin..end-1] of the current chunk; called by parallel_for.
+        void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+            const uint64_t* v = &m_buf[0];
+            const size_type sd = m_sample_dens;
+            if (!m_encode) {
+                for (size_type k=begin; k < end; ++k) {
+                    size_type j = k*sd, j_end = std::min(j+sd, m_buf_size);
+                    uint64_t len = 0;
+                    if (differences) {
+                        for (++j; j < j_end; ++j)
+                            len += Coder::encoding_length(v[j]-v[j-1]);
+                    } else {
+                        for (; j < j_end; ++j)
+                            len += Coder::encoding_length(v[j]+1);
+                    }
+                    m_block_pos[m_blocks+k] = len;
+                }
+                return;
+            }
+            size_type pos  = m_block_pos[m_blocks+begin];
+            size_type word = pos >> 6;
+            uint64_t head[8] = {0, 0, 0, 0, 0, 0, 0, 0}; // long enough for a code which starts in head[0]
+            uint64_t* z = head;
+            uint8_t offset = pos & 0x3F;
+            bool in_head = true;
+            for (size_type j=begin*sd, j_end=std::min(end*sd, m_buf_size); j < j_end; ++j) {
+                if (differences) {
+                    if (j % sd == 0) // sample
+                        continue;
+                    Coder::encode(v[j]-v[j-1], z, offset);
+                } else {
+                    Coder::encode(v[j]+1, z, offset);
+                }
+                if (in_head and z != head) { // the code left the first word; continue in the bit stream
+                    size_type w = z - head;
+                    for (size_type i=1; i < w; ++i)
+                        m_z[word+i] = head[i];
+                    if (offset)
+                        m_z[word+w] = head[w];
+                    z = m_z + word + w;
+                    in_head = false;
+                }
+            }
+            m_head[thread]      = head[0];
+            m_head_word[thread] = word;
+        }
+};
+
+} // end namespace coder
+} // end namespace sdsl
+
+#endif
@@ -15,7 +15,7 @@
     along with this program.  If not, see http://www.gnu.org/licenses/ .
 */
 /*! \file coder.hpp
-    \brief coder.hpp contains the coder namespace and includes the header files of sdsl::coder::fibonacci, sdsl::coder::elias_delta, sdsl::coder::ternary, and sdsl::coder::run_length
+    \brief coder.hpp contains the coder namespace and includes the header files of sdsl::coder::fibonacci, sdsl::coder::elias_delta, sdsl::coder::ternary, sdsl::coder::vbyte, sdsl::coder::pfor, and sdsl::coder::run_length
 	\author Simon Gog
  */
 #ifndef SDSL_CODER
@@ -25,6 +25,8 @@
 #include "fibonacci_coder.hpp"
 #include "elias_delta_coder.hpp"
 #include "ternary_coder.hpp"
+#include "vbyte_coder.hpp"
+#include "pfor_coder.hpp"
 
 namespace sdsl
 {
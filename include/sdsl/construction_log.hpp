@@ -0,0 +1,122 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file construction_log.hpp
+    \brief construction_log.hpp contains a class which records time, memory and I/O of the phases of the construction algorithms.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCTION_LOG
+#define INCLUDED_SDSL_CONSTRUCTION_LOG
+
+#include <stdint.h> // for uint64_t
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! Resource usage of one phase of a construction.
+struct construction_phase {
+    std::string data_structure;  //!< E.g. "csa", "lcp" or "cst".
+    std::string action;          //!< E.g. "construct SA".
+    uint32_t    depth;           //!< Number of enclosing phases.
+    bool        complete;        //!< False if the phase was not ended explicitly, e.g. after an early return.
+    double      begin;           //!< Wall clock time in milliseconds since the log was cleared.
+    double      end;
+    double      user_time;       //!< User time in milliseconds.
+    double      sys_time;        //!< System time in milliseconds.
+    uint64_t    rss_begin;       //!< Resident set size in bytes.
+    uint64_t    rss_end;
+    uint64_t    peak_rss;        //!< Maximal resident set size during the phase.
+    uint64_t    heap_begin;      //!< Bytes allocated by memory_manager, i.e. by all int_vectors.
+    uint64_t    heap_end;
+    uint64_t    peak_heap;       //!< Maximal bytes allocated by memory_manager during the phase.
+    uint64_t    bytes_read;      //!< Bytes read by read system calls, including the page cache hits and a few KB of /proc reads of the log.
+    uint64_t    bytes_written;   //!< Bytes written by write system calls.
+    uint64_t    disk_read;       //!< Bytes fetched from the storage layer.
+    uint64_t    disk_written;    //!< Bytes sent to the storage layer.
+};
+
+//! Records the resource usage of the phases of the construction algorithms.
+/*! All construction methods (construct_csa, construct_cst, construct_bwt,
+ *  construct_isa and the construct_lcp_* variants) mark their phases by
+ *  write_R_output(..., "begin") and write_R_output(..., "end"). If the log is
+ *  enabled, each phase is recorded with its wall, user and system time, its
+ *  resident set size, the memory of the int_vectors and the bytes read and
+ *  written. The log can be exported as JSON timeline.
+ *
+ *  The peak RSS of a phase is the high water mark of the process (VmHWM) if
+ *  it increased during the phase and the larger RSS at its begin and end
+ *  otherwise. With reset_peak_rss() the high water mark is reset
+ *  (/proc/self/clear_refs) at each begin and end of a phase, which measures
+ *  the peak of each phase exactly but also changes VmHWM for the rest of the
+ *  application. I/O is read from /proc/self/io.
+ *
+ *  The log is not thread-safe; phases have to be recorded by one thread.
+ *
+ *  \par Example
+ *  \code
+ *  construction_log::enable();
+ *  cst_sada<> cst;
+ *  construct_cst("english.200MB", cst);
+ *  construction_log::store_json("english.200MB.timeline.json");
+ *  \endcode
+ */
+class construction_log
+{
+    private:
+        construction_log(); // only static methods
+    public:
+        //! Enables or disables the recording. Enabling clears the log.
+        static void enable(bool enable=true);
+
+        //! Returns if phases are recorded.
+        static bool enabled();
+
+        //! Enables or disables resetting the high water mark of the RSS of the process at each phase mark.
+        /*! Disabled by default, since it is visible to the whole process.
+         */
+        static void reset_peak_rss(bool reset=true);
+
+        //! Removes all recorded phases and restarts the clock.
+        static void clear();
+
+        //! Records the begin or end of a phase.
+        /*! Called by write_R_output.
+         *  \param data_structure Name of the data structure.
+         *  \param action         Name of the phase.
+         *  \param state          "begin" or "end". An end closes the innermost open phase with the
+         *                        same name and all phases which were opened after it.
+         */
+        static void record(const std::string& data_structure, const std::string& action, const std::string& state);
+
+        //! Returns the recorded phases in the order of their begin.
+        static const std::vector<construction_phase>& phases();
+
+        //! Writes the recorded phases as JSON object to out.
+        static void write_json(std::ostream& out);
+
+        //! Writes the recorded phases as JSON object to the file file_name.
+        /*! \return If the file was written successfully.
+         */
+        static bool store_json(const char* file_name);
+};
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,149 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file construction_workspace.hpp
+    \brief construction_workspace.hpp contains a class which manages the temporary files of the construction algorithms.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCTION_WORKSPACE
+#define INCLUDED_SDSL_CONSTRUCTION_WORKSPACE
+
+#include "typedefs.hpp"
+#include <stdint.h> // for uint64_t
+#include <string>
+#include <vector>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! Manages the files which are created during the construction of CSAs and CSTs.
+/*! The construction methods (construct_csa, construct_cst, construct_lcp_*,
+ *  construct_bwt, ...) exchange intermediate results through a tMSS file map
+ *  (e.g. "text", "sa", "isa", "lcp", "bwt") and skip every step whose result
+ *  is already registered. The workspace fills this file map.
+ *
+ *  A persistent workspace names the files by a hash of the content of the
+ *  input text (and optional parameters, like the direction of the text).
+ *  The artifacts "text", "sa", "isa", "lcp" and "bwt" of a finished
+ *  construction are recorded in a manifest file and are reused by every
+ *  later construction over the same input, also across processes. Files
+ *  which are not listed in the manifest, e.g. the remains of a construction
+ *  which was aborted, are never reused.
+ *
+ *  The disk budget limits the size of all reusable artifacts in the
+ *  directory. When a construction finishes, the artifacts of other inputs
+ *  are evicted in least recently used order until the budget is met. If
+ *  the artifacts of the current input alone exceed the budget, the largest
+ *  of them are not kept.
+ *
+ *  A workspace which is destroyed before finish() was called, e.g. since a
+ *  construction step threw an exception, removes all files which it
+ *  created and which are not in the manifest.
+ *
+ *  Between add_text and finish() a persistent workspace holds an exclusive
+ *  lock (flock) on the lock file of its input. A second construction over
+ *  the same input in the same directory waits until the first one finished
+ *  and then reuses its artifacts. The disk budget never evicts the
+ *  artifacts of an input which is locked by another construction.
+ *
+ *  \par Example
+ *  \code
+ *  construction_workspace ws("./tmp/", true, 50ULL<<30); // keep up to 50GB of artifacts
+ *  csa_wt<> csa;
+ *  construct_csa("corpus.txt", csa, ws);  // the second call reuses SA and BWT
+ *  \endcode
+ */
+class construction_workspace
+{
+    private:
+        std::string m_dir;
+        bool        m_persistent;
+        uint64_t    m_disk_budget;
+        std::string m_id;
+        tMSS        m_file_map;
+        tMSS        m_kept;     // artifacts which are recorded in the manifest
+        tMSS        m_reused;   // artifacts which were recorded before the construction started
+        bool        m_finished;
+        int         m_lock_fd;  // descriptor of the locked lock file of the input or -1
+
+        bool lock();
+        void unlock();
+
+        std::string manifest_file_name()const;
+        void read_manifest();
+        bool write_manifest()const;
+        void enforce_disk_budget();
+
+        construction_workspace(const construction_workspace&);
+        construction_workspace& operator=(const construction_workspace&);
+    public:
+        //! Keys of the artifacts which can be reused.
+        static const char* reusable_artifacts[];
+
+        //! Constructor
+        /*! \param dir         Directory of the files, with a trailing slash.
+         *  \param persistent  If true, artifacts are named by content hash and kept for later constructions.
+         *                     Otherwise all files are removed by finish().
+         *  \param disk_budget Maximal number of bytes of reusable artifacts in dir. 0 means unlimited.
+         */
+        construction_workspace(const std::string& dir="./", bool persistent=false, uint64_t disk_budget=0);
+
+        //! Destructor. Removes all files which were created and are not recorded in the manifest.
+        ~construction_workspace();
+
+        //! Registers the text of file_name for the construction.
+        /*! For a persistent workspace the content of the file is hashed. If the
+         *  text was already prepared by an earlier construction, all recorded
+         *  artifacts of it are registered in the file map. Otherwise the text
+         *  is stored in the serialized format expected by the construction methods.
+         *  \param file_name Name of the text file.
+         *  \param params    Additional parameters which distinguish the artifacts, e.g. "reversed".
+         *  \param reverse   If true, the reversed text is stored.
+         *  \return False if the text file cannot be read or the text cannot be stored.
+         */
+        bool add_text(const std::string& file_name, const std::string& params="", bool reverse=false);
+
+        //! File map which is passed to the construction methods.
+        tMSS& file_map() {
+            return m_file_map;
+        }
+
+        //! Directory of the files.
+        const std::string& dir()const {
+            return m_dir;
+        }
+
+        //! Identifier which is appended to the names of all files, e.g. "sa_<id>".
+        const std::string& id()const {
+            return m_id;
+        }
+
+        //! Returns true if the artifact key was computed by an earlier construction and is reused.
+        bool reused(const std::string& key)const;
+
+        //! Records the reusable artifacts in the manifest, removes all other files and enforces the disk budget.
+        void finish();
+
+        //! Name of the file of artifact key for the text with hash id in dir.
+        static std::string file_name(const std::string& dir, const std::string& key, const std::string& id) {
+            return dir + key + "_" + id;
+        }
+};
+
+}// end namespace sdsl
+
+#endif // end file
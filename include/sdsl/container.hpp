@@ -0,0 +1,292 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file container.hpp
+    \brief container.hpp contains an indexed file format which stores named data structures in separate sections.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_CONTAINER
+#define INCLUDED_SDSL_CONTAINER
+
+#include "memory_management.hpp"
+#include <stdint.h> // for uint64_t
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <iostream>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! Incremental 64-bit checksum of a byte sequence.
+/*! The bytes are processed in 64-bit words, so the checksum is cheap enough
+ *  to validate sections of several gigabytes. The result does not depend on
+ *  how the sequence is split into update calls.
+ */
+class checksum64
+{
+    private:
+        uint64_t m_hash;
+        uint64_t m_len;  // number of processed bytes
+        uint64_t m_tail; // bytes of the incomplete last word
+        void add_word(uint64_t w) {
+            m_hash = (m_hash ^ w) * 0x9E3779B97F4A7C15ULL;
+            m_hash ^= m_hash >> 29;
+        }
+    public:
+        checksum64():m_hash(0x84222325CBF29CE4ULL), m_len(0), m_tail(0) {}
+
+        //! Adds len bytes starting at data to the checksum.
+        void update(const char* data, uint64_t len);
+
+        //! The checksum of all bytes added so far.
+        uint64_t value()const;
+};
+
+//! Entry of the table of contents of a container.
+struct container_member {
+    std::string name;     //!< Name of the member.
+    uint64_t    offset;   //!< Offset of the section of the member in the file.
+    uint64_t    size;     //!< Size of the section in bytes.
+    uint64_t    checksum; //!< checksum64 of the section.
+};
+
+//! A std::streambuf which forwards all writes to another streambuf and computes their checksum.
+class checksum_streambuf : public std::streambuf
+{
+    private:
+        std::streambuf* m_sink;
+        checksum64      m_checksum;
+        uint64_t        m_written;
+        char            m_buf[1<<16];
+
+        bool flush_buffer();
+        checksum_streambuf(const checksum_streambuf&);
+        checksum_streambuf& operator=(const checksum_streambuf&);
+    protected:
+        virtual int_type overflow(int_type c);
+        virtual std::streamsize xsputn(const char* s, std::streamsize n);
+        virtual int sync();
+        // Reports the number of written bytes as position (tellp); seeking is not supported
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+    public:
+        explicit checksum_streambuf(std::streambuf* sink);
+
+        //! Number of bytes written through the streambuf.
+        uint64_t written()const {
+            return m_written + (pptr()-pbase());
+        }
+
+        //! Checksum of the bytes written through the streambuf. Flushes the buffer.
+        uint64_t checksum();
+};
+
+//! Writes data structures as named, 64-byte aligned sections into a container file.
+/*! A container file consists of
+ *    - a header of 64 bytes: magic number, format version, position, size
+ *      and checksum of the table of contents,
+ *    - the sections of the members, each aligned to 64 bytes, and
+ *    - the table of contents, which lists name, offset, size and checksum of each member.
+ *  Each section is written with the serialize method of the member, so a
+ *  section has the same layout as a file written by util::store_to_file_aligned,
+ *  i.e. all int_vectors of a member can be used in place in a mapped container.
+ *  \sa container_reader
+ *  \par Example
+ *  \code
+ *  container_writer out;
+ *  out.open("index.sdsl");
+ *  out.add(cst.csa, "csa");
+ *  out.add(cst.lcp, "lcp");
+ *  out.close();
+ *  \endcode
+ */
+class container_writer
+{
+    private:
+        std::ofstream                  m_out;
+        uint64_t                       m_pos;       // current write position
+        std::vector<container_member>  m_toc;
+        checksum_streambuf*            m_buf;       // streambuf of the open section
+        std::ostream*                  m_section;   // stream of the open section
+
+        container_writer(const container_writer&);
+        container_writer& operator=(const container_writer&);
+    public:
+        //! Format version written by the container_writer.
+        /*! Version 2 writes int_vectors in the aligned format (see util::set_aligned_serialization).
+         */
+        static const uint32_t version = 2;
+
+        container_writer();
+        ~container_writer();
+
+        //! Creates the container file file_name.
+        bool open(const char* file_name);
+
+        //! Returns true if the file is open.
+        bool is_open()const {
+            return m_out.is_open();
+        }
+
+        //! Starts a new section for member name.
+        /*! \return A stream which writes into the section or NULL if the file is
+         *          not open or a member with the same name was already added.
+         *  \sa end_member
+         */
+        std::ostream* begin_member(const std::string& name);
+
+        //! Finishes the section started by begin_member.
+        bool end_member();
+
+        //! Serializes t into the section name.
+        template<class T>
+        bool add(const T& t, const std::string& name) {
+            std::ostream* out = begin_member(name);
+            if (out == NULL) {
+                return false;
+            }
+            t.serialize(*out);
+            return end_member();
+        }
+
+        //! Writes a primitive-typed variable into the section name.
+        template<class T>
+        bool add_member(const T& t, const std::string& name);
+
+        //! Writes the table of contents and the header and closes the file.
+        /*! \return If all sections and the table of contents were written successfully.
+         */
+        bool close();
+};
+
+//! Reads the members of a container file written by container_writer on demand.
+/*! Opening a container reads and checks only the header and the table of
+ *  contents. Each member is loaded separately, e.g. a query which needs only
+ *  the CSA of a compressed suffix tree does not touch the sections of the LCP
+ *  array and the tree topology. In mapped mode the file is memory mapped, so
+ *  int_vectors of the loaded members are views of the file (see util::load_from_file_mapped).
+ *  Checksums of sections are only verified on request, as this requires
+ *  reading the whole section.
+ */
+class container_reader
+{
+    private:
+        typedef std::map<std::string, uint64_t> tNameMap;
+        std::ifstream                  m_file;
+        mm_file*                       m_mapping;
+        mm_streambuf*                  m_mapped_buf;
+        std::istream*                  m_mapped_in;
+        uint64_t                       m_file_size;
+        uint32_t                       m_version;
+        std::vector<container_member>  m_toc;
+        tNameMap                       m_index;   // name -> index in m_toc
+
+        bool read_toc(std::istream& in);
+        container_reader(const container_reader&);
+        container_reader& operator=(const container_reader&);
+    public:
+        container_reader();
+        ~container_reader();
+
+        //! Opens the container file_name and checks its header and table of contents.
+        /*! \param file_name Name of the container file.
+         *  \param mapped    If true, the file is memory mapped and members are loaded without copying.
+         *  \return False if the file cannot be opened, is not a container, has an
+         *          unsupported version or a corrupted table of contents.
+         */
+        bool open(const char* file_name, bool mapped=false);
+
+        //! Closes the file. Members which were loaded in mapped mode stay valid.
+        void close();
+
+        //! Returns true if a container is open.
+        bool is_open()const {
+            return m_mapping != NULL or m_file.is_open();
+        }
+
+        //! Format version of the open container.
+        uint32_t version()const {
+            return m_version;
+        }
+
+        //! The table of contents.
+        const std::vector<container_member>& members()const {
+            return m_toc;
+        }
+
+        //! Returns the entry of member name or NULL if the container has no such member.
+        const container_member* find(const std::string& name)const;
+
+        //! Returns a stream which is positioned at the begin of the section of member name.
+        /*! \return The stream or NULL if the container has no member name.
+         *  The stream is valid until the next call of seek or close.
+         */
+        std::istream* seek(const std::string& name);
+
+        //! Checks the checksum of the section of member name.
+        bool verify(const std::string& name);
+
+        //! Checks the checksums of all sections.
+        bool verify();
+
+        //! Checks that reading the section of member name through the stream returned by seek succeeded.
+        /*! \return False if the stream failed or its position left the section,
+         *          i.e. the section is truncated or corrupted.
+         */
+        bool section_ok(const std::string& name);
+
+        //! Loads t from the section name.
+        /*! \return False if the container has no member name, the stream failed
+         *          or t was not loaded from within its section.
+         */
+        template<class T>
+        bool load(T& t, const std::string& name) {
+            std::istream* in = seek(name);
+            if (in == NULL) {
+                return false;
+            }
+            t.load(*in);
+            return section_ok(name);
+        }
+
+        //! Reads a primitive-typed variable from the section name.
+        template<class T>
+        bool load_member(T& t, const std::string& name) {
+            std::istream* in = seek(name);
+            if (in == NULL) {
+                return false;
+            }
+            in->read((char*)&t, sizeof(t));
+            return section_ok(name);
+        }
+};
+
+template<class T>
+bool container_writer::add_member(const T& t, const std::string& name)
+{
+    std::ostream* out = begin_member(name);
+    if (out == NULL) {
+        return false;
+    }
+    out->write((const char*)&t, sizeof(t));
+    return end_member();
+}
+
+}// end namespace sdsl
+
+#endif // end file
@@ -29,6 +29,7 @@
 #include "testutils.hpp"
 #include "suffixarrays.hpp"
 #include "bwt_construct.hpp"
+#include "construction_workspace.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -41,8 +42,25 @@ namespace sdsl
 template<class Csa>
 static bool construct_csa(std::string file_name, Csa& csa)
 {
-    tMSS file_map;
-    return construct_csa(file_name, csa, file_map, true, "./","");
+    construction_workspace ws;
+    return construct_csa(file_name, csa, ws);
+}
+
+//! Constructs a CSA of the text in file_name in the construction workspace ws.
+/*! Intermediate results (SA, BWT, ...) which ws recorded for the same text
+ *  are reused. On success the workspace is finished, i.e. reusable results
+ *  are kept and all other files are removed. If an exception is thrown, the
+ *  destructor of ws removes the files of the construction.
+ */
+template<class Csa>
+static bool construct_csa(std::string file_name, Csa& csa, construction_workspace& ws)
+{
+    if (!ws.add_text(file_name)) {
+        return false;
+    }
+    bool res = construct_csa(csa, ws.file_map(), false, ws.dir(), ws.id());
+    ws.finish();
+    return res;
 }
 
 template<class Csa>
@@ -107,7 +125,7 @@ static bool construct_csa(Csa& csa, tMSS& file_map, bool delete_files=true, std:
         write_R_output("csa", "construct SA", "end", 1, 0);
         write_R_output("csa", "store SA", "begin", 1, 0);
 
-        if (!util::store_to_file(sa, sa_file_name.c_str())) {
+        if (!util::store_to_temp_file(sa, sa_file_name.c_str())) {
             throw std::ios_base::failure("#csa_construct: Cannot store SA to file system!");
             return false;
         } else {
@@ -139,8 +157,22 @@ static bool construct_csa(Csa& csa, tMSS& file_map, bool delete_files=true, std:
 template<class Csa>
 static bool construct_csa_of_reversed_text(std::string file_name, Csa& csa)
 {
-    tMSS file_map;
-    return construct_csa_of_reversed_text(file_name, csa, file_map, true, "./","");
+    construction_workspace ws;
+    return construct_csa_of_reversed_text(file_name, csa, ws);
+}
+
+//! Constructs a CSA of the reversed text in file_name in the construction workspace ws.
+/*! \sa construct_csa(std::string, Csa&, construction_workspace&)
+ */
+template<class Csa>
+static bool construct_csa_of_reversed_text(std::string file_name, Csa& csa, construction_workspace& ws)
+{
+    if (!ws.add_text(file_name, "", true)) {
+        return false;
+    }
+    bool res = construct_csa(csa, ws.file_map(), false, ws.dir(), ws.id());
+    ws.finish();
+    return res;
 }
 
 
@@ -525,6 +525,14 @@ class csa_wt
             return m_wavelet_tree.rank(i, c);
         }
 
+        //! Batch version of rank_bwt.
+        /*! out[k] contains rank_bwt(i[k], c[k]) afterwards. The memory accesses of
+         *  the n queries are overlapped if the wavelet tree supports batch queries.
+         */
+        void rank_bwt(const size_type* i, const char_type* c, size_type n, size_type* out)const {
+            m_wavelet_tree.rank(i, c, n, out);
+        }
+
         //! Calculates the ith occurrence of symbol c in the BWT of the original text.
         /*!
          *  \param i The ith occurrence. \f$i\in [1..rank(size(),c)]\f$.
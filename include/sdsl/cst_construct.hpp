@@ -28,6 +28,7 @@
 #include "util.hpp"
 #include "testutils.hpp"
 #include "lcp_construct.hpp"
+#include "construction_workspace.hpp"
 
 #include <iostream>
 #include <stdexcept>
@@ -52,8 +53,33 @@ namespace sdsl
 template<class Cst>
 bool construct_cst(std::string file_name, Cst& cst)
 {
-    tMSS file_map;
-    return construct_cst(file_name, cst, file_map, true, "./", false, "", "any");
+    construction_workspace ws;
+    return construct_cst(file_name, cst, ws);
+}
+
+//! Constructs a compressed suffix tree (cst) semi-external in the construction workspace ws
+/*!
+ *  \param file_name 		File name of the text, for which the cst should be build
+ *  \param cst		 		A reference to the cst object. cst will hold the result after the execution of the method.
+ *  \param ws				Workspace which holds the calculated files. Intermediate results (SA, ISA, LCP, BWT)
+ *							which ws recorded for the same text are reused.
+ *	\param build_only_bps   Boolean flag. If it is true, only the navigation part of the cst is build.
+ *  \param lcp_method		Specify, which lcp construction algorithm should be used, see above.
+ *
+ *  \par Details
+ *       On success the workspace is finished, i.e. reusable results are kept and all other
+ *       files are removed. If an exception is thrown, the destructor of ws removes the files
+ *       of the construction.
+ */
+template<class Cst>
+bool construct_cst(std::string file_name, Cst& cst, construction_workspace& ws, bool build_only_bps=false, std::string lcp_method="any")
+{
+    if (!ws.add_text(file_name)) {
+        return false;
+    }
+    bool res = construct_cst(cst, ws.file_map(), false, ws.dir(), build_only_bps, ws.id(), lcp_method);
+    ws.finish();
+    return res;
 }
 
 //! Constructs a compressed suffix tree (cst) semi-external
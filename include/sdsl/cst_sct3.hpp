@@ -35,6 +35,7 @@
 #include "select_support.hpp"
 #include "testutils.hpp"
 #include "util.hpp"
+#include "container.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cassert>
@@ -509,6 +510,20 @@ class cst_sct3
          */
         void load(std::istream& in);
 
+        //! Stores the members as separate sections of a container.
+        /*! The sections are named "csa", "lcp", "bp", "bp_support", "mark_child",
+         *  "mark_child_rank", "sigma" and "node_cnt". A query which needs only
+         *  the CSA can load the section "csa" on its own.
+         *  \return If all sections were written successfully.
+         */
+        bool store(container_writer& out)const;
+
+        //! Loads the suffix tree from the sections of a container.
+        /*! \return False if a section is missing, could not be read or was not read from within its bounds.
+         *  \sa store
+         */
+        bool load(container_reader& in);
+
         /*! \defgroup cst_sct3_tree_methods Tree methods of cst_sct3 */
         /* @{ */
 
@@ -1272,6 +1287,50 @@ void cst_sct3<Csa, Lcp, Bp_support, Rank_support>::load(std::istream& in)
 #endif
 }
 
+template<class Csa, class Lcp, class Bp_support, class Rank_support>
+bool cst_sct3<Csa, Lcp, Bp_support, Rank_support>::store(container_writer& out)const
+{
+    return out.add(m_csa, "csa")
+           and out.add(m_lcp, "lcp")
+           and out.add(m_bp, "bp")
+           and out.add(m_bp_support, "bp_support")
+           and out.add(m_first_child, "mark_child")
+           and out.add(m_first_child_rank, "mark_child_rank")
+           and out.add_member(m_sigma, "sigma")
+           and out.add_member(m_nodes, "node_cnt");
+}
+
+template<class Csa, class Lcp, class Bp_support, class Rank_support>
+bool cst_sct3<Csa, Lcp, Bp_support, Rank_support>::load(container_reader& in)
+{
+    if (!in.load(m_csa, "csa")) {
+        return false;
+    }
+    std::istream* lcp_in = in.seek("lcp");
+    if (lcp_in == NULL) {
+        return false;
+    }
+    load_lcp(m_lcp, *lcp_in, *this);
+    if (!in.section_ok("lcp") or !in.load(m_bp, "bp")) {
+        return false;
+    }
+    std::istream* bps_in = in.seek("bp_support");
+    if (bps_in == NULL) {
+        return false;
+    }
+    m_bp_support.load(*bps_in, &m_bp);
+    if (!in.section_ok("bp_support") or !in.load(m_first_child, "mark_child")) {
+        return false;
+    }
+    std::istream* rank_in = in.seek("mark_child_rank");
+    if (rank_in == NULL) {
+        return false;
+    }
+    m_first_child_rank.load(*rank_in, &m_first_child);
+    return in.section_ok("mark_child_rank")
+           and in.load_member(m_sigma, "sigma") and in.load_member(m_nodes, "node_cnt");
+}
+
 template<class Csa, class Lcp, class Bp_support, class Rank_support>
 cst_sct3<Csa, Lcp, Bp_support, Rank_support>& cst_sct3<Csa, Lcp, Bp_support, Rank_support>::operator=(const cst_sct3& cst)
 {
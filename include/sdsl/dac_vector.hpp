@@ -0,0 +1,417 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file dac_vector.hpp
+   \brief dac_vector.hpp contains the sdsl::dac_vector class, an implementation of
+          directly addressable variable-length codes.
+   \author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_DAC_VECTOR
+#define INCLUDED_SDSL_DAC_VECTOR
+
+#include "int_vector.hpp"
+#include "iterators.hpp"
+#include "util.hpp"
+#include "bitmagic.hpp"
+#include "rank_support_v5.hpp"
+#include <vector>
+#include <algorithm> // for std::min
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+//! An immutable vector of integers, which are represented by directly addressable codes (DACs).
+/*! The binary representation of an integer is split into chunks. Level 0
+ *  contains the lowest chunk of every integer, level l+1 the next chunk of
+ *  each integer which does not fit into levels 0..l. A bit vector marks for
+ *  each chunk of a level (except the last one) if the integer continues on
+ *  the next level; the position of the continuation is determined by a rank
+ *  query on this bit vector.
+ *
+ *  The widths of the levels are chosen at construction time. For b=0 they
+ *  minimize the size of the chunks and overflow bits for the value
+ *  distribution (dynamic programming over the number of integers exceeding
+ *  each bit length, see [1]). Otherwise all levels have width b.
+ *
+ *  Access to an integer of \f$ \ell \f$ levels takes \f$ \ell-1 \f$ rank
+ *  queries. decode() and the const_iterator process the levels one after
+ *  the other and need only one rank query per level for a whole range.
+ *
+ * \par References
+ *  [1] N. Brisaboa, S. Ladra, G. Navarro: ,,DACs: Bringing direct access
+ *      to variable-length codes'', Information Processing and Management,
+ *      Vol. 49, No. 1, 2013
+ *
+ *  \tparam b Width of the levels, or 0 for the optimal widths.
+ *  \tparam rank_support_type Rank support for the overflow bits.
+ *  @ingroup int_vector
+ */
+template<uint8_t b=0, class rank_support_type=rank_support_v5<> >
+class dac_vector
+{
+    public:
+        typedef uint64_t 							value_type;
+        typedef random_access_block_const_iterator<dac_vector> iterator;
+        typedef iterator							const_iterator;
+        typedef const value_type		 			reference;
+        typedef const value_type 					const_reference;
+        typedef const value_type*					const_pointer;
+        typedef ptrdiff_t 							difference_type;
+        typedef int_vector<>::size_type				size_type;
+        static  const uint32_t 						sample_dens	= 64; // Required by random_access_block_const_iterator
+
+    private:
+        size_type			m_size;
+        bit_vector			m_data;          // chunks of all levels; level l has width m_level_info[4l+3]
+        bit_vector			m_overflow;      // indicates, if the integer continues on the next level
+        rank_support_type	m_overflow_rank; // rank data structure for m_overflow
+        int_vector<64>		m_level_info;    // for level l: start in m_overflow, rank at this start, start in m_data, width
+        uint8_t				m_max_level;     // number of levels
+
+        void copy(const dac_vector& v) {
+            m_size			= v.m_size;
+            m_data			= v.m_data;
+            m_overflow		= v.m_overflow;
+            m_overflow_rank	= v.m_overflow_rank;
+            m_overflow_rank.set_vector(&m_overflow);
+            m_level_info	= v.m_level_info;
+            m_max_level		= v.m_max_level;
+        }
+
+        static uint8_t bit_length(uint64_t x) {
+            return x ? bit_magic::l1BP(x)+1 : 1;
+        }
+
+        // Chooses the level widths for cnt[k] integers of bit length k and allocates the levels.
+        void init_levels(const std::vector<size_type>& cnt);
+
+        // Appends the chunks of x; next[l] is the index of the next chunk in level l.
+        void append(uint64_t x, std::vector<size_type>& next) {
+            const uint64_t* p = m_level_info.data();
+            size_type idx = next[0]++;
+            m_data.set_int(idx*p[3], x, p[3]);
+            for (uint8_t level=1; level < m_max_level and (x = (p[3] < 64 ? x >> p[3] : 0)); ++level) {
+                m_overflow[p[0]+idx] = 1;
+                p += 4;
+                idx = next[level]++;
+                m_data.set_int(p[2]+idx*p[3], x, p[3]);
+            }
+        }
+
+        // Initializes the rank support and the ranks at the level starts.
+        void finish() {
+            util::init_support(m_overflow_rank, &m_overflow);
+            for (uint8_t level=0; level+1 < m_max_level; ++level)
+                m_level_info[4*level+1] = m_overflow_rank(m_level_info[4*level]);
+        }
+
+    public:
+        //! Default Constructor
+        dac_vector():m_size(0), m_max_level(0) {}
+
+        //! Copy constructor
+        dac_vector(const dac_vector& v) {
+            copy(v);
+        }
+
+        //! Constructor for a Container of unsigned integers.
+        template<class Container>
+        dac_vector(const Container& c):m_size(0), m_max_level(0) {
+            init(c);
+        }
+
+        //! Constructor for an int_vector_file_buffer of unsigned integers.
+        template<uint8_t int_width, class size_type_class>
+        dac_vector(int_vector_file_buffer<int_width, size_type_class>& v_buf):m_size(0), m_max_level(0) {
+            init(v_buf);
+        }
+
+        template<class Container>
+        void init(const Container& c);
+
+        template<uint8_t int_width, class size_type_class>
+        void init(int_vector_file_buffer<int_width, size_type_class>& v_buf);
+
+        //! The number of elements in the dac_vector.
+        size_type size()const {
+            return m_size;
+        }
+
+        //! Return the largest size that this container can ever have.
+        static size_type max_size() {
+            return int_vector<>::max_size();
+        }
+
+        //! Returns if the dac_vector is empty.
+        bool empty()const {
+            return 0 == m_size;
+        }
+
+        //! Number of levels.
+        uint8_t levels()const {
+            return m_max_level;
+        }
+
+        //! Width of the chunks in a level.
+        /*! \param level Level \f$ \in [0..levels()-1] \f$.
+         */
+        uint8_t level_width(uint8_t level)const {
+            return m_level_info[4*level+3];
+        }
+
+        //! []-operator
+        /*! \param i Index of the value. \f$ i \in [0..size()-1]\f$.
+         *  \par Time complexity
+         *       One rank query for each level of the value except the first.
+         */
+        value_type operator[](size_type i)const {
+            const uint64_t* p = m_level_info.data();
+            value_type result = m_data.get_int(i*p[3], p[3]);
+            uint8_t shift = p[3];
+            for (uint8_t level=1; level < m_max_level and m_overflow[p[0]+i]; ++level) {
+                i = m_overflow_rank(p[0]+i) - p[1]; // index of the chunk in the next level
+                p += 4;
+                result |= m_data.get_int(p[2]+i*p[3], p[3]) << shift;
+                shift += p[3];
+            }
+            return result;
+        }
+
+        //! Decodes the elements with indices in [begin, end) into the array out.
+        /*! The levels are processed one after another; for each level
+         *  the chunks of the range are read sequentially. So only one rank
+         *  query per level is needed for the whole range.
+         *  \param begin Index of the first element.
+         *  \param end   Index behind the last element.
+         *  \param out   Array of at least end-begin elements.
+         */
+        void decode(size_type begin, size_type end, uint64_t* out)const;
+
+        //! Decodes the sample_dens elements of block k into out.
+        /*! Required by random_access_block_const_iterator.
+         *  \return The number of decoded values.
+         */
+        size_type decode_block(const size_type k, uint64_t* out)const {
+            size_type begin = k*sample_dens, end = std::min(begin+sample_dens, m_size);
+            decode(begin, end, out);
+            return end-begin;
+        }
+
+        //! Iterator that points to the first element of the dac_vector.
+        const_iterator begin()const {
+            return const_iterator(this, 0);
+        }
+
+        //! Iterator that points to the position after the last element of the dac_vector.
+        const_iterator end()const {
+            return const_iterator(this, size());
+        }
+
+        //! Swap method for dac_vector
+        void swap(dac_vector& v) {
+            if (this != &v) {
+                std::swap(m_size, v.m_size);
+                m_data.swap(v.m_data);
+                m_overflow.swap(v.m_overflow);
+                util::swap_support(m_overflow_rank, v.m_overflow_rank, &m_overflow, &(v.m_overflow));
+                m_level_info.swap(v.m_level_info);
+                std::swap(m_max_level, v.m_max_level);
+            }
+        }
+
+        //! Assignment Operator.
+        dac_vector& operator=(const dac_vector& v) {
+            if (this != &v) {
+                copy(v);
+            }
+            return *this;
+        }
+
+        //! Equality Operator
+        /*! Two dac_vectors are equal if they have the same levels and chunks.
+         *  The rank supports are not compared, as they are determined by the overflow bits.
+         */
+        bool operator==(const dac_vector& v)const {
+            return m_size == v.m_size and m_max_level == v.m_max_level
+                   and m_level_info == v.m_level_info
+                   and m_data == v.m_data and m_overflow == v.m_overflow;
+        }
+
+        //! Unequality Operator
+        bool operator!=(const dac_vector& v)const {
+            return !(*this == v);
+        }
+
+        //! Serializes the dac_vector to a stream.
+        size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += util::write_member(m_size, out, child, "size");
+            written_bytes += m_data.serialize(out, child, "data");
+            written_bytes += m_overflow.serialize(out, child, "overflow");
+            written_bytes += m_overflow_rank.serialize(out, child, "overflow_rank");
+            written_bytes += m_level_info.serialize(out, child, "level_info");
+            written_bytes += util::write_member(m_max_level, out, child, "max_level");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Load the dac_vector from a stream.
+        void load(std::istream& in) {
+            util::read_member(m_size, in);
+            m_data.load(in);
+            m_overflow.load(in);
+            m_overflow_rank.load(in, &m_overflow);
+            m_level_info.load(in);
+            util::read_member(m_max_level, in);
+        }
+};
+
+template<uint8_t b, class rank_support_type>
+void dac_vector<b, rank_support_type>::init_levels(const std::vector<size_type>& cnt)
+{
+    // above[k] = number of integers with more than k bits
+    uint8_t max_len = 1;
+    std::vector<size_type> above(65, 0);
+    for (uint8_t k=64; k > 0; --k) {
+        above[k-1] = above[k] + cnt[k];
+        if (cnt[k] > 0 and k > max_len)
+            max_len = k;
+    }
+    // next[k] = end of the level which starts at bit k
+    std::vector<uint8_t> next(max_len+1, max_len);
+    if (b == 0) {
+        // cost[k] = minimal number of bits for the chunks from bit k on;
+        // a level from bit k to bit e stores above[k] chunks of e-k bits and,
+        // if it is not the last level, above[k] overflow bits.
+        std::vector<uint64_t> cost(max_len+1, 0);
+        for (int k=max_len-1; k >= 0; --k) {
+            cost[k] = above[k]*(max_len-k);
+            for (uint8_t e=k+1; e < max_len; ++e) {
+                uint64_t c = above[k]*(e-k+1) + cost[e];
+                if (c < cost[k]) {
+                    cost[k] = c;
+                    next[k] = e;
+                }
+            }
+        }
+    } else {
+        for (uint8_t k=0; k < max_len; ++k)
+            next[k] = std::min(k+b, (int)max_len);
+    }
+    m_max_level = 0;
+    for (uint8_t k=0; k < max_len; k = next[k])
+        ++m_max_level;
+    m_level_info = int_vector<64>(4*m_max_level, 0);
+    size_type overflow_size = 0, data_size = 0;
+    uint8_t level = 0;
+    for (uint8_t k=0; k < max_len; k = next[k], ++level) {
+        m_level_info[4*level]   = overflow_size;
+        m_level_info[4*level+2] = data_size;
+        m_level_info[4*level+3] = next[k]-k;
+        if (level+1 < m_max_level)
+            overflow_size += above[k];
+        data_size += above[k]*(next[k]-k);
+    }
+    m_overflow = bit_vector(overflow_size, 0);
+    m_data     = bit_vector(data_size, 0);
+}
+
+template<uint8_t b, class rank_support_type>
+template<class Container>
+void dac_vector<b, rank_support_type>::init(const Container& c)
+{
+    m_size = c.size();
+    std::vector<size_type> cnt(65, 0);
+    for (typename Container::const_iterator it = c.begin(), end = c.end(); it != end; ++it)
+        ++cnt[bit_length(*it)];
+    init_levels(cnt);
+    std::vector<size_type> next(m_max_level, 0);
+    for (typename Container::const_iterator it = c.begin(), end = c.end(); it != end; ++it)
+        append(*it, next);
+    finish();
+}
+
+template<uint8_t b, class rank_support_type>
+template<uint8_t int_width, class size_type_class>
+void dac_vector<b, rank_support_type>::init(int_vector_file_buffer<int_width, size_type_class>& v_buf)
+{
+    m_size = v_buf.int_vector_size;
+    std::vector<size_type> cnt(65, 0);
+    v_buf.reset();
+    for (size_type i=0, r_sum=0, r = v_buf.load_next_block(); r_sum < m_size;) {
+        for (; i < r_sum+r; ++i)
+            ++cnt[bit_length(v_buf[i-r_sum])];
+        r_sum += r; r = v_buf.load_next_block();
+    }
+    init_levels(cnt);
+    std::vector<size_type> next(m_max_level, 0);
+    v_buf.reset();
+    for (size_type i=0, r_sum=0, r = v_buf.load_next_block(); r_sum < m_size;) {
+        for (; i < r_sum+r; ++i)
+            append(v_buf[i-r_sum], next);
+        r_sum += r; r = v_buf.load_next_block();
+    }
+    finish();
+}
+
+template<uint8_t b, class rank_support_type>
+void dac_vector<b, rank_support_type>::decode(size_type begin, size_type end, uint64_t* out)const
+{
+    if (begin >= end)
+        return;
+    const uint64_t* p = m_level_info.data();
+    const uint64_t* data = m_data.data();
+    const uint64_t* overflow = m_overflow.data();
+    // pos[l] = position of the next chunk of the range in the overflow bits of level l
+    size_type pos[64];
+    pos[0] = begin;
+    for (uint8_t level=1; level < m_max_level; ++level)
+        pos[level] = p[4*level] + m_overflow_rank(pos[level-1]) - p[4*level-3];
+    const size_type window = 256;
+    uint32_t pending[window]; // elements of the window which continue on the current level
+    for (; begin < end; begin += window, out += window) {
+        size_type n = std::min(window, end-begin), m = 0;
+        uint8_t w = p[3];
+        for (size_type k=0, j=pos[0]; k < n; ++k, ++j) {
+            out[k] = bit_magic::read_int(data+((j*w)>>6), (j*w)&0x3F, w);
+            pending[m] = k;
+            m += (m_max_level > 1) and ((overflow[j>>6] >> (j&0x3F)) & 1ULL);
+        }
+        pos[0] += n;
+        uint8_t shift = w;
+        for (uint8_t level=1; level < m_max_level and m > 0; ++level) {
+            const uint64_t* q = p + 4*level;
+            bool last = (level+1 == m_max_level);
+            size_type mm = 0;
+            w = q[3];
+            for (size_type t=0, j=pos[level]; t < m; ++t, ++j) {
+                size_type idx = (j - q[0])*w + q[2];
+                out[pending[t]] |= bit_magic::read_int(data+(idx>>6), idx&0x3F, w) << shift;
+                pending[mm] = pending[t];
+                mm += !last and ((overflow[j>>6] >> (j&0x3F)) & 1ULL);
+            }
+            pos[level] += m;
+            m = mm;
+            shift += w;
+        }
+    }
+}
+
+} // end namespace sdsl
+
+#endif
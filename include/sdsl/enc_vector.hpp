@@ -20,6 +20,8 @@
 */
 #include "int_vector.hpp"
 #include "elias_delta_coder.hpp"
+#include "block_decoder.hpp"
+#include "block_encoder.hpp"
 #include "iterators.hpp"
 
 #ifndef SDSL_ENC_VECTOR
@@ -53,7 +55,7 @@ class enc_vector
 {
     public:
         typedef uint64_t 							value_type;  	// STL Container requirement
-        typedef random_access_const_iterator<enc_vector> iterator;// STL Container requirement
+        typedef random_access_block_const_iterator<enc_vector> iterator;// STL Container requirement
         typedef iterator							const_iterator; // STL Container requirement
         typedef const value_type		 			reference;
         typedef const value_type 					const_reference;
@@ -236,16 +238,27 @@ class enc_vector
          * \param i The index of the sample for which all values till the next sample should be decoded. 0 <= i < size()/get_sample_dens()
          * \param it A pointer to a uint64_t vector, whereto the values should be written
          */
-//		template<class Iterator>
         void get_inter_sampled_values(const size_type i, uint64_t* it)const {
+            assert(i*SampleDens < size());
             *(it++) = 0;
-            if (i*SampleDens + SampleDens - 1 < size()) {
-                Coder::template decode<true, true>(m_z.data(), m_sample_vals_and_pointer[(i<<1)+1], SampleDens - 1, it);
-            } else {
-                assert(i*SampleDens < size());
-                Coder::template decode<true, true>(m_z.data(), m_sample_vals_and_pointer[(i<<1)+1], size()-i*SampleDens - 1, it);
-            }
+            size_type n = std::min((size_type)SampleDens, size()-i*SampleDens) - 1;
+            sdsl::coder::block_decoder<Coder>::template decode<true>(m_z.data(), m_z.bit_size(), m_sample_vals_and_pointer[(i<<1)+1], n, it);
         };
+
+        //! Decodes the values of the i-th sample interval.
+        /*! \param i   The index of the sample interval. 0 <= i < (size()+SampleDens-1)/SampleDens
+         *  \param out A buffer for SampleDens values.
+         *  \return The number of decoded values, i.e. min(SampleDens, size()-i*SampleDens).
+         *  \par Time complexity
+         *       \f$ \Order{SampleDens} \f$; short codes are decoded several at a time.
+         */
+        size_type decode_block(const size_type i, uint64_t* out)const {
+            assert(i*SampleDens < size());
+            size_type n = std::min((size_type)SampleDens, size()-i*SampleDens);
+            out[0] = m_sample_vals_and_pointer[i<<1];
+            sdsl::coder::block_decoder<Coder>::template decode<true>(m_z.data(), m_z.bit_size(), m_sample_vals_and_pointer[(i<<1)+1], n-1, out+1, out[0]);
+            return n;
+        }
 };
 
 
@@ -361,67 +374,41 @@ void enc_vector<Coder, SampleDens,fixedIntWidth>::init(const Container& c)
     if (c.empty())  // if c is empty there is nothing to do...
         return;
     typename Container::const_iterator	it		 	= c.begin(), end = c.end();
-    typename Container::value_type 		v1			= *it, v2, max_sample_value=0, x;
+    typename Container::value_type 		max_sample_value=0;
     size_type samples=0;
-    size_type z_size = 0;
-//  (1) Calculate maximal value of samples and of deltas
-    for (size_type i=0, no_sample=0; it != end; ++it,++i, --no_sample) {
-        v2 = *it;
+    sdsl::coder::block_encoder<Coder, true> enc(get_sample_dens(), c.size());
+//  (1) Calculate maximal value of samples and the length of the codes of each block
+    for (size_type no_sample=0; it != end; ++it, --no_sample) {
         if (!no_sample) { // add a sample
             no_sample = get_sample_dens();
-            if (max_sample_value < v2) max_sample_value = v2;
+            if (max_sample_value < *it) max_sample_value = *it;
             ++samples;
-        } else {
-            z_size += Coder::encoding_length(v2-v1);
         }
-        v1=v2;
+        enc.count(*it);
     }
-//	(2) Write sample values and deltas
-    {
-        if (max_sample_value > z_size+1)
-            m_sample_vals_and_pointer.set_int_width(bit_magic::l1BP(max_sample_value) + 1);
-        else
-            m_sample_vals_and_pointer.set_int_width(bit_magic::l1BP(z_size+1) + 1);
-        m_sample_vals_and_pointer.resize(2*samples+2); // add 2 for last entry
-        util::set_zero_bits(m_sample_vals_and_pointer);
-        typename int_vector_type::iterator sv_it = m_sample_vals_and_pointer.begin();
-        z_size = 0;
-        size_type no_sample=0;
-        for (it = c.begin(); it != end; ++it, --no_sample) {
-            v2 = *it;
-            if (!no_sample) { // add a sample
-                no_sample = get_sample_dens();
-                *sv_it = v2; ++sv_it;
-                *sv_it = z_size; ++sv_it;
-            } else {
-                x = v2-v1;
-//                if (v2 == v1) {
-//                    throw std::logic_error("enc_vector cannot decode adjacent equal values!");
-//                }
-                z_size += Coder::encoding_length(x);
-            }
-            v1=v2;
-        }
-        *sv_it = 0; ++sv_it;        // initialize
-        *sv_it = z_size+1; ++sv_it; // last entry
-
-        util::assign(m_z, int_vector<>(z_size, 0, 1));
-        uint64_t* z_data = Coder::raw_data(m_z);
-        uint8_t offset = 0;
-        no_sample = 0;
-        for (it = c.begin(); it != end; ++it, --no_sample) {
-            v2 = *it;
-            if (!no_sample) { // add a sample
-                no_sample = get_sample_dens();
-            } else {
-                Coder::encode(v2-v1, z_data, offset);
-            }
-            v1=v2;
+    size_type z_size = enc.count_end();
+//	(2) Write sample values and pointers and encode the deltas of the blocks in parallel
+    if (max_sample_value > z_size+1)
+        m_sample_vals_and_pointer.set_int_width(bit_magic::l1BP(max_sample_value) + 1);
+    else
+        m_sample_vals_and_pointer.set_int_width(bit_magic::l1BP(z_size+1) + 1);
+    m_sample_vals_and_pointer.resize(2*samples+2); // add 2 for last entry
+    util::set_zero_bits(m_sample_vals_and_pointer);
+    util::assign(m_z, int_vector<>(z_size, 0, 1));
+    enc.encode_begin(Coder::raw_data(m_z));
+    typename int_vector_type::iterator sv_it = m_sample_vals_and_pointer.begin();
+    it = c.begin();
+    for (size_type no_sample=0, k=0; it != end; ++it, --no_sample) {
+        if (!no_sample) { // add a sample
+            no_sample = get_sample_dens();
+            *sv_it = *it; ++sv_it;
+            *sv_it = enc.block_pos(k++); ++sv_it;
         }
-//		Coder::encode(delta_c, m_z); // encode delta_c to m_z
+        enc.encode(*it);
     }
-//	delta_c.resize(0);
-//std::cerr<<"Finished "<<std::endl;,
+    enc.encode_end();
+    *sv_it = 0; ++sv_it;        // initialize
+    *sv_it = z_size+1; ++sv_it; // last entry
     m_elements = c.size();
 }
 
@@ -436,27 +423,24 @@ void enc_vector<Coder, SampleDens,fixedIntWidth>::init(int_vector_file_buffer<in
     if (n == 0)  // if c is empty there is nothing to do...
         return;
     v_buf.reset();
-    value_type 	v1=0, v2=0, max_sample_value=0;
-    size_type samples=0, z_size=0;
+    value_type 	v=0, max_sample_value=0;
+    size_type samples=0;
     const size_type sd = get_sample_dens();
-//  (1) Calculate maximal value of samples and of deltas
+    sdsl::coder::block_encoder<Coder, true> enc(sd, n);
+//  (1) Calculate maximal value of samples and the length of the codes of each block
     for (size_type i=0, r_sum=0, r = v_buf.load_next_block(), no_sample = 0; r_sum < n;) {
         for (; i < r_sum+r; ++i, --no_sample) {
-            v2 = v_buf[i-r_sum];
+            v = v_buf[i-r_sum];
             if (!no_sample) { // is sample
                 no_sample = sd;
-                if (max_sample_value < v2) max_sample_value = v2;
+                if (max_sample_value < v) max_sample_value = v;
                 ++samples;
-            } else {
-//                if (v2 == v1) {
-//                    throw std::logic_error("enc_vector cannot decode adjacent equal values!");
-//                }
-                z_size += Coder::encoding_length(v2-v1);
             }
-            v1 = v2;
+            enc.count(v);
         }
         r_sum += r; r = v_buf.load_next_block();
     }
+    size_type z_size = enc.count_end();
 
 //	(2) Write sample values and deltas
 //     (a) Initialize array for sample values and pointers
@@ -469,27 +453,25 @@ void enc_vector<Coder, SampleDens,fixedIntWidth>::init(int_vector_file_buffer<in
 
 //     (b) Initilize bit_vector for encoded data
     util::assign(m_z, int_vector<>(z_size, 0, 1));
-    uint64_t* z_data = Coder::raw_data(m_z);
-    uint8_t offset = 0;
+    enc.encode_begin(Coder::raw_data(m_z));
 
-//     (c) Write sample values and deltas
+//     (c) Write sample values and pointers and encode the deltas of the blocks in parallel
     v_buf.reset();
-    z_size = 0;
-    for (size_type i=0, j=0, r_sum=0, r = v_buf.load_next_block(), no_sample = 0; r_sum < n;) {
+    for (size_type i=0, j=0, k=0, r_sum=0, r = v_buf.load_next_block(), no_sample = 0; r_sum < n;) {
         for (; i < r_sum+r; ++i, --no_sample) {
-            v2 = v_buf[i-r_sum];
+            v = v_buf[i-r_sum];
             if (!no_sample) { // is sample
                 no_sample = sd;
-                m_sample_vals_and_pointer[j++] = v2;	// write samples
-                m_sample_vals_and_pointer[j++] = z_size;// write pointers
-            } else {
-                z_size += Coder::encoding_length(v2-v1);
-                Coder::encode(v2-v1, z_data, offset);   // write encoded values
+                m_sample_vals_and_pointer[j++] = v;	// write samples
+                m_sample_vals_and_pointer[j++] = enc.block_pos(k++);// write pointers
             }
-            v1 = v2;
+            enc.encode(v);
         }
         r_sum += r; r = v_buf.load_next_block();
     }
+    enc.encode_end();
+    m_sample_vals_and_pointer[2*samples]   = 0;        // initialize
+    m_sample_vals_and_pointer[2*samples+1] = z_size+1; // last entry
     m_elements = n;
 }
 
@@ -109,9 +109,24 @@ class enc_vector_dna
             init(c);
         }
 
+        //! Constructor for an int_vector_file_buffer of positive integers.
+        /*! The values are read three times from the file and are not
+         *  held in memory.
+         */
+        template<uint8_t int_width, class size_type_class>
+        enc_vector_dna(int_vector_file_buffer<int_width, size_type_class>& v_buf) {
+            construct();
+            init(v_buf);
+        }
+
         template<class Container>
         void init(const Container& c);
 
+        template<uint8_t int_width, class size_type_class>
+        void init(int_vector_file_buffer<int_width, size_type_class>& v_buf) {
+            init(int_vector_file_buffer_view<int_width, size_type_class>(v_buf));
+        }
+
         //! Default Destructor
         ~enc_vector_dna() {
         };
@@ -612,6 +627,7 @@ void enc_vector_dna<SampleDens,fixedIntWidth>::init(const Container& c)
         blocknr = (z_size/64)%9;
         assert(blocknr==0 and (z_size%64)==0);
     }
+    const size_type z_bits = z_size; // length including the last sumblock
 
 //std::cerr<<"Calculate delta"<<std::endl;
     {
@@ -647,7 +663,8 @@ void enc_vector_dna<SampleDens,fixedIntWidth>::init(const Container& c)
         *sv_it = 0; ++sv_it;        // initialize
         *sv_it = z_size+1; ++sv_it; // last entry
 
-        m_z.bit_resize(z_size);
+        m_z.bit_resize(z_bits);
+        util::set_zero_bits(m_z);
         z_size = 0;
         uint64_t* z_data = coder::raw_data(m_z);
         uint8_t offset = 0;
@@ -710,7 +727,10 @@ void enc_vector_dna<SampleDens,fixedIntWidth>::init(const Container& c)
 
                 // sumblock[blocknr] contains the sum of fibonacci encoded words that ends in this block
                 // or 0 if this sum is greater than 255.
-                write_sumblock(x, writeblock, sbp, ovp);
+                // writeblock is 8 if the code ended right before the sumblock, which was
+                // already added to block 7 above.
+                if (writeblock != 8)
+                    write_sumblock(x, writeblock, sbp, ovp);
 //				if(!overflow[blocknr]){
 //					if( x > 255 ){
 //						overflow[blocknr] = true; sumblock[blocknr] = 0;
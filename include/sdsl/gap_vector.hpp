@@ -24,6 +24,7 @@
 
 #include "int_vector.hpp"
 #include "util.hpp"
+#include <iterator> // for std::distance
 
 //! Namespace for the succinct data structure library
 namespace sdsl
@@ -36,6 +37,14 @@ template<bool b=true>// forward declaration needed for friend declaration
 class gap_select_support;  // in gap_vector
 
 //! A bit vector which compresses very sparse populated bit vectors by representing the 1 or 0 by gap encoding
+/*! The positions of the ones are stored explicitly, so select takes constant
+ *  time. For rank and access the bit vector is divided into buckets of
+ *  \f$2^k\f$ bits, where k is chosen such that a bucket contains 8 to 16
+ *  ones on average, and the number of ones before each bucket is sampled.
+ *  A query binary searches the positions of one bucket, i.e. it takes
+ *  \f$\Order{\log d}\f$ time, where d is the number of ones in the bucket.
+ *  The samples take at most \f$\frac{1}{8}\f$ of the space of the positions.
+ */
 template<bool b=true>
 class gap_vector
 {
@@ -51,14 +60,51 @@ class gap_vector
     private:
         size_type m_size;
         int_vector<> m_position;
+        int_vector<> m_rank_samples; // m_rank_samples[j] = number of ones before position j*2^m_bucket_log
+        uint8_t      m_bucket_log;
+
+        void build_rank_samples() {
+            size_type ones = m_position.size();
+            size_type max_width = ones ? (16*m_size)/ones : m_size;
+            m_bucket_log = 6;
+            while (m_bucket_log < 62 and ((size_type)1 << (m_bucket_log+1)) <= max_width)
+                ++m_bucket_log;
+            m_rank_samples = int_vector<>((m_size >> m_bucket_log) + 2, 0, bit_magic::l1BP(ones)+1);
+            for (size_type j=0, k=0; j < m_rank_samples.size(); ++j) {
+                while (k < ones and m_position[k] < (j << m_bucket_log))
+                    ++k;
+                m_rank_samples[j] = k;
+            }
+        }
+
+        // Returns the number of ones before position i and sets pos to the
+        // position of the next one (or m_size if there is none).
+        size_type bucket_search(size_type i, size_type& pos)const {
+            size_type j  = i >> m_bucket_log;
+            size_type lb = m_rank_samples[j], rb = m_rank_samples[j+1];
+            // the ones in [lb, rb) lie in the bucket of i
+            while (rb > lb) {
+                size_type mid = (lb+rb)/2;
+                if (m_position[mid] < i)
+                    lb = mid+1;
+                else
+                    rb = mid;
+            }
+            pos = lb < m_position.size() ? m_position[lb] : m_size;
+            return lb;
+        }
 
     public:
-        gap_vector():m_size(0) {}
+        gap_vector():m_size(0) {
+            build_rank_samples();
+        }
 
         gap_vector(const bit_vector& bv) {
             m_size = bv.size();
-            if (m_size == 0)
+            if (m_size == 0) {
+                build_rank_samples();
                 return;
+            }
             size_type ones = util::get_one_bits(bv);
             m_position = int_vector<>(ones, 0, bit_magic::l1BP(m_size)+1);
             const uint64_t* bvp = bv.data();
@@ -70,6 +116,28 @@ class gap_vector
                         }
                 }
             }
+            build_rank_samples();
+        }
+
+        //! Constructs a gap_vector from the sorted positions of the ones.
+        /*! \param begin Iterator to the first position.
+         *  \param end   Iterator past the last position.
+         *  \param size  Length of the bit vector.
+         */
+        template<class Iterator>
+        gap_vector(Iterator begin, Iterator end, size_type size):m_size(size) {
+            if (m_size > 0) {
+                m_position = int_vector<>(std::distance(begin, end), 0, bit_magic::l1BP(m_size)+1);
+                for (size_type i=0; begin != end; ++begin, ++i) {
+                    m_position[i] = *begin;
+                }
+            }
+            build_rank_samples();
+        }
+
+        //! Returns the number of ones.
+        size_type ones()const {
+            return m_position.size();
         }
 
         //! Swap method
@@ -77,6 +145,8 @@ class gap_vector
             if (this != &v) {
                 std::swap(m_size, v.m_size);
                 m_position.swap(v.m_position);
+                m_rank_samples.swap(v.m_rank_samples);
+                std::swap(m_bucket_log, v.m_bucket_log);
             }
         }
 
@@ -84,23 +154,12 @@ class gap_vector
         /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
            \return The i-th bit of the original bit_vector
            \par Time complexity
-           		\f$ \Order{\log m} \f$, where m equals the number of zeros
+           		\f$ \Order{\log d} \f$, where d equals the number of ones in the bucket of i
         */
         value_type operator[](size_type i)const {
-            // binary search the entries in m_position
-            size_type lb=0, rb=m_position.size(), mid, pos;  // start interval [lb,rb)
-            while (rb > lb) {
-                mid = (lb+rb)/2; // then mid>=lb mid<rb
-                pos = m_position[mid];
-                if (i > pos) {
-                    lb = mid+1;
-                } else if (i < pos) {
-                    rb = mid;
-                } else { // i == pos
-                    return 1;
-                }
-            }
-            return 0;
+            size_type pos;
+            bucket_search(i, pos);
+            return pos == i;
         }
 
         //! Returns the size of the original bit vector.
@@ -114,6 +173,8 @@ class gap_vector
             structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
             written_bytes += util::write_member(m_size, out, child, "size");
             written_bytes += m_position.serialize(out, child, "positions");
+            written_bytes += m_rank_samples.serialize(out, child, "rank_samples");
+            written_bytes += util::write_member(m_bucket_log, out, child, "bucket_log");
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
         }
@@ -122,6 +183,8 @@ class gap_vector
         void load(std::istream& in) {
             util::read_member(m_size, in);
             m_position.load(in);
+            m_rank_samples.load(in);
+            util::read_member(m_bucket_log, in);
         }
 };
 
@@ -144,19 +207,13 @@ class gap_rank_support
             set_vector(v);
         }
 
+        //! Returns the number of ones in the prefix [0..i-1].
+        /*! \par Time complexity
+         *       \f$ \Order{\log d} \f$, where d equals the number of ones in the bucket of i
+         */
         size_type rank(size_type i)const {
-            // binary search the entries in m_position
-            size_type lb=0, rb=m_v->m_position.size(), mid, pos=0;  // start interval [lb,rb)
-            while (rb > lb) {
-                mid = (lb+rb)/2; // then mid>=lb mid<rb
-                pos = m_v->m_position[mid];
-                if (i <= pos) {
-                    rb = mid;
-                } else {
-                    lb = mid+1;
-                }
-            } // m_position[rb] >= i
-            return rb;
+            size_type pos;
+            return m_v->bucket_search(i, pos);
         }
 
         const size_type operator()(size_type i)const {
@@ -27,6 +27,10 @@
 #include "testutils.hpp"
 #include "uintx_t.hpp"
 #include "structure_tree.hpp"
+#include "memory_management.hpp"
+#include "async_io.hpp"
+#include "block_codec.hpp"
+#include "parallel.hpp"
 #include <iosfwd>    // forward declaration of ostream
 #include <stdexcept> // for exceptions
 #include <iostream>  // for cerr
@@ -40,6 +44,7 @@
 #include <ostream>
 #include <istream>
 #include <string>
+#include <algorithm> // for std::min, std::max
 
 
 
@@ -96,14 +101,21 @@ namespace coder
 class fibonacci;
 class elias_delta;
 class ternary;
+class vbyte;
+template<uint8_t BitWidth> class pfor;
 }
 
 template<uint8_t=0, class size_type_class = std_size_type_for_int_vector>
 class int_vector_file_buffer;
 
+template<uint8_t=0, class size_type_class = std_size_type_for_int_vector>
+class int_vector_file_writer;
+
 template<class size_type_class = std_size_type_for_int_vector>
 class char_array_serialize_wrapper;
 
+class bit_operations;
+
 
 template<uint8_t fixedIntWidth, class size_type_class>
 struct int_vector_trait {
@@ -327,7 +339,10 @@ class int_vector
         friend class  coder::elias_delta;
         friend class  coder::fibonacci;
         friend class  coder::ternary;
+        friend class  coder::vbyte;
+        template<uint8_t BitWidth> friend class coder::pfor;
         friend class  int_vector_file_buffer<fixedIntWidth, size_type_class>;
+        friend class  bit_operations;
         //! Operator to create an int_vector<1> (aka bit_vector) from an input stream.
         friend std::istream& operator>>(std::istream&, int_vector<1>&);
         friend void util::set_random_bits<int_vector>(int_vector& v, int);
@@ -340,6 +355,14 @@ class int_vector
         size_type	m_size; //!< Number of bits needed to store int_vector.
         uint64_t*   m_data; //!< Pointer to the memory for the bits.
         int_width_type m_int_width;//!< Width of the integers that are accessed via the [] operator .
+        alloc_policy m_alloc_policy;//!< Policy for the allocation of m_data.
+        mm_file*    m_mapping; //!< File mapping which contains m_data or NULL if m_data was allocated on the heap.
+
+        //! Copies the content of a memory mapped int_vector to the heap and releases the mapping.
+        void copy_mapping_to_heap();
+
+        //! Loads the int_vector from a stream which was written by serialize_compressed.
+        void load_compressed(std::istream& in);
     public:
 
         //! Constructor for int_vector.
@@ -440,6 +463,22 @@ class int_vector
         */
         void set_int(size_type idx, value_type x, const uint8_t len=64);
 
+        //! Decodes the elements with indices in [begin, end) into the array out.
+        /*! Much faster than sequential access via operator[] or iterators,
+            since blocks of 64 elements are decoded by kernels which are
+            specialized for the width of the elements.
+            \param begin Index of the first element.
+            \param end   Index behind the last element.
+            \param out   Array of at least end-begin elements.
+            \sa encode
+        */
+        void decode(size_type begin, size_type end, uint64_t* out) const;
+
+        //! Stores the values in[0..end-begin-1] in the elements with indices in [begin, end).
+        /*! \sa decode
+        */
+        void encode(size_type begin, size_type end, const uint64_t* in);
+
         //! Returns the width of the integers which are accessed via the [] operator.
         /*! \returns The width of the integers which are accessed via the [] operator.
             \sa set_int_width
@@ -453,16 +492,65 @@ class int_vector
         */
         void set_int_width(uint8_t intWidth);
 
+        //! Changes the width of the elements to new_width and keeps their values, if fixedIntWidth equals 0.
+        /*! In contrast to set_int_width the elements are repacked. This is done in place,
+            i.e. no second buffer of the size of the vector is allocated, and large vectors
+            are repacked by up to util::thread_count() threads.
+            \param new_width The new width of the elements.
+            \pre All elements are smaller than \f$2^{new\_width}\f$.
+            \note This method has no effect if fixedIntWidth is in the range [1..64].
+            \sa set_int_width, util::bit_compress
+        */
+        void repack(uint8_t new_width);
+
         //! Serializes the int_vector to a stream.
-        /*!
+        /*! The int_vector is written in the aligned format if it is enabled
+         *  for out by util::set_aligned_serialization.
          * \return The number of bytes written to out.
          * \sa load
          */
         size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name = "", bool write_fixed_as_variable=false) const;
 
+        //! Serializes the int_vector to a stream in compressed form.
+        /*! The elements are compressed block-wise with the block_codec. The
+         *  result is understood by load and int_vector_file_buffer, but cannot
+         *  be memory mapped. Used for the temporary files of the construction
+         *  algorithms, see util::store_to_temp_file.
+         * \return The number of bytes written to out.
+         */
+        size_type serialize_compressed(std::ostream& out) const;
+
         //! Load the int_vector for a stream.
+        /*! If the stream reads from a memory mapped file (see mm_streambuf and
+         *  util::load_from_file_mapped) the int_vector becomes a view of the
+         *  mapped data and no data is copied. The view is copy-on-write, i.e.
+         *  modifications are private to the process and the first call of a
+         *  resize method copies the data to the heap. The data is only used in
+         *  place if it is 8-byte aligned in the mapping and, in case the bit
+         *  size is a multiple of 64, is followed by a zero word; otherwise it
+         *  is copied to the heap. The aligned format (see
+         *  util::set_aligned_serialization) guarantees both.
+         */
         void load(std::istream& in);
 
+        //! Returns the allocation policy of the int_vector.
+        const alloc_policy& get_alloc_policy()const {
+            return m_alloc_policy;
+        }
+
+        //! Sets the allocation policy of the int_vector.
+        /*! Vectors are created with memory_manager::default_policy(). If the
+            int_vector is not empty, its content is moved to memory which is
+            allocated according to the new policy.
+            \sa alloc_policy, memory_manager
+        */
+        void set_alloc_policy(const alloc_policy& policy);
+
+        //! Returns true if the data of the int_vector is a view of a memory mapped file.
+        bool mapped()const {
+            return m_mapping != NULL;
+        }
+
         //! non const version of [] operator
         /*! \param i Index the i-th integer of length get_int_width().
          * 	\return A reference to the i-th integer of length get_int_width().
@@ -1079,7 +1167,7 @@ inline std::istream& operator>>(std::istream &in, int_vector<1> &v){
 // ==== int_vector implemenation  ====
 
 template<uint8_t fixedIntWidth, class size_type_class>
-inline int_vector<fixedIntWidth,size_type_class>::int_vector(size_type elements, value_type default_value, uint8_t intWidth):m_size(0), m_data(NULL), m_int_width(intWidth)
+inline int_vector<fixedIntWidth,size_type_class>::int_vector(size_type elements, value_type default_value, uint8_t intWidth):m_size(0), m_data(NULL), m_int_width(intWidth), m_alloc_policy(memory_manager::default_policy()), m_mapping(NULL)
 {
     int_vector_trait<fixedIntWidth,size_type_class>::set_int_width(m_int_width, intWidth);
     resize(elements);
@@ -1093,7 +1181,7 @@ inline int_vector<fixedIntWidth,size_type_class>::int_vector(size_type elements,
 }
 
 template<uint8_t fixedIntWidth, class size_type_class>
-inline int_vector<fixedIntWidth,size_type_class>::int_vector(const int_vector& v):m_size(0), m_data(NULL), m_int_width(v.m_int_width)
+inline int_vector<fixedIntWidth,size_type_class>::int_vector(const int_vector& v):m_size(0), m_data(NULL), m_int_width(v.m_int_width), m_alloc_policy(v.m_alloc_policy), m_mapping(NULL)
 {
     bit_resize(v.bit_size());
     if (v.capacity() > 0) {
@@ -1124,8 +1212,10 @@ int_vector<fixedIntWidth,size_type_class>& int_vector<fixedIntWidth,size_type_cl
 template<uint8_t fixedIntWidth, class size_type_class>
 int_vector<fixedIntWidth,size_type_class>::~int_vector()
 {
-    if (m_data != NULL) {
-        free(m_data); //fixed delete
+    if (m_mapping != NULL) {
+        m_mapping->release();
+    } else if (m_data != NULL) {
+        memory_manager::free_mem(m_data);
     }
 }
 
@@ -1136,11 +1226,17 @@ void int_vector<fixedIntWidth,size_type_class>::swap(int_vector& v)
         size_type	size 		= m_size;
         uint64_t*	 data		= m_data;
         uint8_t		intWidth 	= m_int_width;
+        mm_file*	mapping		= m_mapping;
+        alloc_policy policy		= m_alloc_policy;
         m_size 		= v.m_size;
         m_data 		= v.m_data;
+        m_mapping	= v.m_mapping;
+        m_alloc_policy = v.m_alloc_policy;
         int_vector_trait<fixedIntWidth,size_type_class>::set_int_width(m_int_width, v.m_int_width);
         v.m_size	= size;
         v.m_data	= data;
+        v.m_mapping	= mapping;
+        v.m_alloc_policy = policy;
         int_vector_trait<fixedIntWidth,size_type_class>::set_int_width(v.m_int_width, intWidth);
     }
 }
@@ -1155,6 +1251,9 @@ void int_vector<fixedIntWidth,size_type_class>::resize(const size_type size)
 template<uint8_t fixedIntWidth, class size_type_class>
 void int_vector<fixedIntWidth,size_type_class>::bit_resize(const size_type size)
 {
+    if (m_mapping != NULL) {
+        copy_mapping_to_heap();
+    }
     bool do_realloc = ((size+63)>>6) != ((m_size+63)>>6);
     const size_type old_size = m_size;
     m_size = size;                       // set new size
@@ -1165,10 +1264,11 @@ void int_vector<fixedIntWidth,size_type_class>::bit_resize(const size_type size)
         // We need this padding since rank data structures do a memory
         // access to this padding to answer rank(size()) if size()%64 ==0.
         // Note that this padding is not counted in the serialize method!
-        data = (uint64_t*)realloc(m_data, (((m_size+64)>>6)<<3)); // if m_data == NULL realloc
-        // Method realloc is equivalent to malloc if m_data == NULL.
-        // If size is zero and ptr is not NULL, a new, minimum sized object is allocated and the original object is freed.
-        // The allocated memory is aligned such that it can be used for any data type, including AltiVec- and SSE-related types.
+        data = memory_manager::realloc_mem(m_data, (((m_size+64)>>6)<<3),
+                                           m_data==NULL ? 0 : (((old_size+64)>>6)<<3), m_alloc_policy);
+        // Method realloc_mem is equivalent to alloc_mem if m_data == NULL.
+        // Small blocks come from realloc, large blocks with a non-default policy from mmap.
+        // In both cases the memory is aligned such that it can be used for any data type, including AltiVec- and SSE-related types.
         m_data = data;
         // initialize unreachable bits to 0
         if (m_size > old_size and bit_size() < capacity()) {//m_size>0
@@ -1180,6 +1280,40 @@ void int_vector<fixedIntWidth,size_type_class>::bit_resize(const size_type size)
     }
 }
 
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::copy_mapping_to_heap()
+{
+    size_type words = (m_size+63)>>6;
+    // allocate the padding word, see bit_resize
+    uint64_t* data = memory_manager::alloc_mem(((m_size+64)>>6)<<3, m_alloc_policy);
+    if (data == NULL) {
+        throw std::bad_alloc();
+    }
+    memcpy(data, m_data, words<<3);
+    if ((m_size % 64) == 0) {
+        data[m_size/64] = 0;
+    }
+    m_mapping->release();
+    m_mapping = NULL;
+    m_data = data;
+}
+
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::set_alloc_policy(const alloc_policy& policy)
+{
+    m_alloc_policy = policy;
+    if (m_mapping == NULL and m_data != NULL) {
+        const size_type bytes = ((m_size+64)>>6)<<3;
+        uint64_t* data = memory_manager::alloc_mem(bytes, m_alloc_policy);
+        if (data == NULL) {
+            throw std::bad_alloc();
+        }
+        memcpy(data, m_data, bytes);
+        memory_manager::free_mem(m_data);
+        m_data = data;
+    }
+}
+
 template<uint8_t fixedIntWidth, class size_type_class>
 inline void int_vector<fixedIntWidth,size_type_class>::setBit(size_type idx,const bool value)
 {
@@ -1260,6 +1394,28 @@ bool int_vector<fixedIntWidth,size_type_class>::empty() const
     return m_size==0;
 }
 
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::decode(size_type begin, size_type end, uint64_t* out)const
+{
+#ifdef SDSL_DEBUG
+    if (begin > end or end > size()) {
+        throw std::out_of_range("OUT_OF_RANGE_ERROR: int_vector::decode(size_type, size_type, uint64_t*); end > size()!");
+    }
+#endif
+    bit_magic::read_ints(m_data, begin*m_int_width, m_int_width, end-begin, out);
+}
+
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::encode(size_type begin, size_type end, const uint64_t* in)
+{
+#ifdef SDSL_DEBUG
+    if (begin > end or end > size()) {
+        throw std::out_of_range("OUT_OF_RANGE_ERROR: int_vector::encode(size_type, size_type, const uint64_t*); end > size()!");
+    }
+#endif
+    bit_magic::write_ints(m_data, begin*m_int_width, m_int_width, end-begin, in);
+}
+
 template<uint8_t fixedIntWidth, class size_type_class>
 inline typename int_vector<fixedIntWidth,size_type_class>::size_type int_vector<fixedIntWidth,size_type_class>::capacity() const
 {
@@ -1278,6 +1434,86 @@ void int_vector<fixedIntWidth,size_type_class>::set_int_width(uint8_t width)
     int_vector_trait<fixedIntWidth,size_type_class>::set_int_width(m_int_width, width); // delegate to trait function
 }
 
+//! Moves the elements of a range of an int_vector from width old_width to width new_width.
+/*! Blocks are processed in ascending order if the width shrinks and in
+ *  descending order otherwise, so a range can be moved in place.
+ */
+struct int_vector_repack_range {
+    uint64_t* data;
+    uint8_t   old_width;
+    uint8_t   new_width;
+    uint64_t  offset; // index of the first element of the range [0..]
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t) {
+        const uint64_t block_size = 1024;
+        uint64_t buf[block_size];
+        begin += offset; end += offset;
+        if (new_width < old_width) {
+            for (uint64_t i=begin; i < end; i += block_size) {
+                uint64_t n = std::min(block_size, end-i);
+                bit_magic::read_ints(data, i*old_width, old_width, n, buf);
+                bit_magic::write_ints(data, i*new_width, new_width, n, buf);
+            }
+        } else {
+            for (uint64_t i=end; i > begin;) {
+                uint64_t n = std::min(block_size, i-begin);
+                i -= n;
+                bit_magic::read_ints(data, i*old_width, old_width, n, buf);
+                bit_magic::write_ints(data, i*new_width, new_width, n, buf);
+            }
+        }
+    }
+};
+
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::repack(uint8_t new_width)
+{
+    if (fixedIntWidth != 0) {
+        return;
+    }
+    if (new_width == 0 or new_width > 64) {
+        new_width = 64;
+    }
+    uint8_t old_width = m_int_width;
+    if (new_width == old_width) {
+        return;
+    }
+    const uint64_t n = size();
+    if (new_width > old_width) {
+        bit_resize(n*new_width);
+    }
+    int_vector_repack_range f;
+    f.data      = m_data;
+    f.old_width = old_width;
+    f.new_width = new_width;
+    // Elements are moved in rounds. In each round the target bits of the moved range
+    // do not overlap its source bits, so the range can be split among threads. All
+    // range boundaries are multiples of 64 elements and therefore of 64 bits.
+    const uint64_t serial = std::min(n, (uint64_t)1<<16);
+    if (new_width < old_width) {
+        f.offset = 0;
+        f(0, serial, 0);
+        for (uint64_t a = serial; a < n;) {
+            uint64_t b = std::min(n, ((a*old_width/new_width)/64)*64);
+            f.offset = a;
+            parallel_for(b-a, f);
+            a = b;
+        }
+        bit_resize(n*new_width);
+    } else {
+        uint64_t b = n;
+        while (b > serial) {
+            uint64_t a = std::max(serial, ((b*old_width+new_width-1)/new_width+63)/64*64);
+            f.offset = a;
+            parallel_for(b-a, f);
+            b = a;
+        }
+        f.offset = 0;
+        f(0, b, 0);
+    }
+    int_vector_trait<fixedIntWidth,size_type_class>::set_int_width(m_int_width, new_width);
+}
+
 template<uint8_t fixedIntWidth, class size_type_class>
 inline typename int_vector<fixedIntWidth,size_type_class>::reference int_vector<fixedIntWidth,size_type_class>::operator[](const size_type& idx)
 {
@@ -1450,6 +1686,48 @@ bool int_vector<fixedIntWidth,size_type_class>::operator!=(const int_vector& v)c
     return !(*this==v);
 }
 
+//! Value which is stored instead of the size to mark an int_vector as compressed (see int_vector::serialize_compressed).
+/*! The compressed format consists of the marker, the width of the elements
+ *  (1 byte), the size in bits and the elements in blocks of
+ *  block_codec::int_vector_block_size elements, encoded by block_codec::write_ints.
+ */
+template<class size_type_class>
+inline size_type_class int_vector_compressed_marker()
+{
+    return (size_type_class)-1;
+}
+
+//! Value which is stored instead of the size to mark an int_vector in the aligned format (see util::set_aligned_serialization).
+/*! The aligned format consists of the marker, the width of the elements
+ *  (1 byte), the size in bits, the number p of padding bytes (1 byte), p
+ *  zero bytes, the data words and a zero word if the size is a multiple
+ *  of 64. The padding places the data at an offset of the file which is
+ *  a multiple of 8, so that a memory mapped int_vector can use it in place.
+ */
+template<class size_type_class>
+inline size_type_class int_vector_aligned_marker()
+{
+    return (size_type_class)-2;
+}
+
+template<class size_type_class>
+size_type_class _sdsl_serialize_aligned_header(std::ostream& out, uint8_t int_width, size_type_class size)
+{
+    size_type_class marker = int_vector_aligned_marker<size_type_class>();
+    uint8_t pad = 0;
+    std::streamoff pos = out.tellp();
+    if (pos >= 0) {
+        pad = (8 - (pos + sizeof(marker) + sizeof(int_width) + sizeof(size) + sizeof(pad))%8)%8;
+    }
+    const char zeros[8] = {0};
+    out.write((char*) &marker, sizeof(marker));
+    out.write((char*) &int_width, sizeof(int_width));
+    out.write((char*) &size, sizeof(size));
+    out.write((char*) &pad, sizeof(pad));
+    out.write(zeros, pad);
+    return sizeof(marker) + sizeof(int_width) + sizeof(size) + sizeof(pad) + pad;
+}
+
 template<class size_type_class>
 size_type_class _sdsl_serialize_size_and_int_width(std::ostream& out, uint8_t fixed_int_width, uint8_t int_width, size_type_class size)
 {
@@ -1471,7 +1749,10 @@ typename int_vector<fixedIntWidth,size_type_class>::size_type int_vector<fixedIn
 {
     structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
     size_type written_bytes = 0;
-    if (fixedIntWidth > 0 and write_fixed_as_variable) {
+    bool aligned = util::aligned_serialization(out);
+    if (aligned) {
+        written_bytes += _sdsl_serialize_aligned_header(out, get_int_width(), m_size);
+    } else if (fixedIntWidth > 0 and write_fixed_as_variable) {
         written_bytes += _sdsl_serialize_size_and_int_width(out, 0, fixedIntWidth, m_size);
     } else {
         written_bytes += _sdsl_serialize_size_and_int_width(out, fixedIntWidth, m_int_width, m_size);
@@ -1487,15 +1768,104 @@ typename int_vector<fixedIntWidth,size_type_class>::size_type int_vector<fixedIn
     }
     out.write((char*) p, ((capacity()>>6)-idx)*sizeof(uint64_t));
     written_bytes += ((capacity()>>6)-idx)*sizeof(uint64_t);
+    if (aligned and (m_size&0x3F) == 0) { // the zero word behind the data of a heap int_vector
+        uint64_t zero = 0;
+        out.write((char*) &zero, sizeof(zero));
+        written_bytes += sizeof(zero);
+    }
     structure_tree::add_size(child, written_bytes);
+    if (child != NULL) {
+        child->add_key_value("alloc_policy", m_alloc_policy.to_string());
+        child->add_key_value("memory", mapped() ? "mapped_file" : memory_manager::memory_type(m_data));
+    }
     return written_bytes;
 }
 
+template<uint8_t fixedIntWidth, class size_type_class>
+typename int_vector<fixedIntWidth,size_type_class>::size_type int_vector<fixedIntWidth,size_type_class>::serialize_compressed(std::ostream& out) const
+{
+    size_type written_bytes = 0;
+    size_type marker = int_vector_compressed_marker<size_type>();
+    out.write((char*) &marker, sizeof(marker));
+    uint8_t width = get_int_width();
+    out.write((char*) &width, sizeof(width));
+    out.write((char*) &m_size, sizeof(m_size));
+    written_bytes += sizeof(marker) + sizeof(width) + sizeof(m_size);
+    std::vector<uint64_t> buf(std::min((size_type)block_codec::int_vector_block_size, size()));
+    for (size_type idx = 0; idx < size(); idx += buf.size()) {
+        size_type n = std::min((size_type)buf.size(), size()-idx);
+        decode(idx, idx+n, &buf[0]);
+        written_bytes += block_codec::write_ints(out, &buf[0], n, width);
+    }
+    return written_bytes;
+}
+
+template<uint8_t fixedIntWidth, class size_type_class>
+void int_vector<fixedIntWidth,size_type_class>::load_compressed(std::istream& in)
+{
+    if (0 != fixedIntWidth) { // read_header reads the width only for vectors of variable width
+        uint8_t width;
+        util::read_member(width, in);
+    }
+    size_type size;
+    util::read_member(size, in);
+    bit_resize(size);
+    std::vector<uint64_t> buf(std::min((size_type)block_codec::int_vector_block_size, this->size()));
+    for (size_type idx = 0; idx < this->size(); idx += buf.size()) {
+        size_type n = std::min((size_type)buf.size(), this->size()-idx);
+        if (!block_codec::read_ints(in, n, &buf[0])) {
+            in.setstate(std::ios::failbit);
+            return;
+        }
+        encode(idx, idx+n, &buf[0]);
+    }
+}
+
 template<uint8_t fixedIntWidth, class size_type_class>
 void int_vector<fixedIntWidth,size_type_class>::load(std::istream& in)
 {
     size_type size;
     int_vector_trait<fixedIntWidth, size_type_class>::read_header(size, m_int_width, in);
+    if (size == int_vector_compressed_marker<size_type>()) {
+        load_compressed(in);
+        return;
+    }
+    bool aligned = (size == int_vector_aligned_marker<size_type>());
+    if (aligned) {
+        uint8_t width, pad;
+        if (0 != fixedIntWidth) { // read_header reads the width only for vectors of variable width
+            util::read_member(width, in);
+        }
+        util::read_member(size, in);
+        util::read_member(pad, in);
+        in.ignore(pad);
+    }
+    // Number of bytes behind the data in the aligned format
+    size_type trailer = (aligned and (size&0x3F) == 0) ? sizeof(uint64_t) : 0;
+
+    mm_streambuf* mm_buf = dynamic_cast<mm_streambuf*>(in.rdbuf());
+    if (mm_buf != NULL) {
+        size_type bytes = ((size+63)>>6)<<3;
+        const char* p = mm_buf->current();
+        // A heap int_vector has a zero word behind the last word if the size is a
+        // multiple of 64. The word is not serialized; in the mapping it is the
+        // next word of the file or the zero padding behind the file.
+        if (in.good() and (((uintptr_t)p)&0x7) == 0 and mm_buf->remaining() >= bytes and
+            ((size&0x3F) != 0 or mm_buf->remaining() == bytes or
+             (mm_buf->remaining() >= bytes+8 and *((const uint64_t*)(p+bytes)) == 0))) {
+            if (m_mapping != NULL) {
+                m_mapping->release();
+            } else if (m_data != NULL) {
+                memory_manager::free_mem(m_data);
+            }
+            m_mapping = mm_buf->file();
+            m_mapping->add_ref();
+            m_data = (uint64_t*)p;
+            m_size = size;
+            mm_buf->skip(std::min(bytes+trailer, mm_buf->remaining()));
+            return;
+        }
+    }
 
 //	util::read_member(size, in);
 //	if( fixedIntWidth == 0 ){
@@ -1515,6 +1885,7 @@ void int_vector<fixedIntWidth,size_type_class>::load(std::istream& in)
         idx += SDSL_BLOCK_SIZE;
     }
     in.read((char*) p, ((capacity()>>6)-idx)*sizeof(uint64_t));
+    in.ignore(trailer);
 }
 
 //! A wrapper class which allows us to serialize an char array as an int_vector.
@@ -1559,6 +1930,10 @@ class char_array_serialize_wrapper
 };
 
 //! A class for reading an int_vector buffered from a file.
+/*! The file is read sequentially block by block. If enabled, the next
+ *  block is prefetched by a background thread while the current block is
+ *  processed (see buffered_file_reader and util::set_file_buffer_prefetch).
+ */
 template<uint8_t fixedIntWidth, class size_type_class>
 class int_vector_file_buffer
 {
@@ -1571,7 +1946,7 @@ class int_vector_file_buffer
 
     private:
 
-        std::fstream m_in;
+        buffered_file_reader m_in;
         uint64_t* m_buf;
         size_type m_off; // offset in the first 64bit word of the buffer
         size_type m_read_values; // number of values read in the last buffer operation
@@ -1581,12 +1956,56 @@ class int_vector_file_buffer
         int_width_type   m_int_width;
         std::string m_file_name;
         bool	m_load_from_plain;
+        bool	m_prefetch;
+        bool	m_compressed; // true if the file was written by int_vector::serialize_compressed
+        std::vector<uint64_t> m_dec; // current decoded block of a compressed file
+        size_type m_dec_idx;      // index of the next value in m_dec
+        size_type m_dec_sum;      // number of values decoded so far
+        std::vector<uint8_t> m_enc; // current encoded block of a compressed file
 
         void load_size_and_width() {
-            int_vector_trait<fixedIntWidth, size_type_class>::read_header(m_int_vector_size, m_int_width, m_in);
+            m_in.read((char*)&m_int_vector_size, sizeof(m_int_vector_size));
+            m_compressed = (m_int_vector_size == int_vector_compressed_marker<size_type>());
+            bool aligned = (m_int_vector_size == int_vector_aligned_marker<size_type>());
+            if (0 == fixedIntWidth or m_compressed or aligned) {
+                uint8_t width = 0;
+                m_in.read((char*)&width, sizeof(width));
+                int_vector_trait<fixedIntWidth, size_type_class>::set_int_width(m_int_width, width);
+            }
+            if (m_compressed or aligned) {
+                m_in.read((char*)&m_int_vector_size, sizeof(m_int_vector_size));
+            }
+            if (aligned) {
+                char pad[256];
+                uint8_t p = 0;
+                m_in.read((char*)&p, sizeof(p));
+                m_in.read(pad, p);
+            }
             m_int_vector_size/=m_int_width;
         }
 
+        // Decodes the next block of a compressed file into m_dec
+        void decode_next_block() {
+            size_type n = std::min((size_type)block_codec::int_vector_block_size, m_int_vector_size-m_dec_sum);
+            uint64_t len = 0;
+            m_in.read((char*)&len, sizeof(len));
+            if (len > block_codec::max_encoded_ints_size(n)) {
+                throw std::ios_base::failure("int_vector_file_buffer: corrupted block in compressed file");
+            }
+            m_enc.resize(len+1);
+            m_in.read((char*)&m_enc[0], len);
+            m_dec.resize(n);
+            block_codec::decode_ints(&m_enc[0], n, n ? &m_dec[0] : NULL);
+            m_dec_sum += n;
+            m_dec_idx = 0;
+        }
+
+        // Number of bytes which are read from disk at once
+        uint64_t chunk_size()const {
+            uint64_t block_bytes = ((m_len*m_int_width+63)/64)*sizeof(uint64_t);
+            return block_bytes < (1ULL<<20) ? (1ULL<<20) : block_bytes;
+        }
+
         size_type words_to_read(size_type len) {
             if (len == 0)
                 return 0;
@@ -1600,6 +2019,10 @@ class int_vector_file_buffer
             m_off				= 0;
             m_read_values		= 0;
             m_read_values_sum 	= 0;
+            m_compressed		= false;
+            m_dec.clear();
+            m_dec_idx			= 0;
+            m_dec_sum			= 0;
         }
 
     public:
@@ -1612,8 +2035,11 @@ class int_vector_file_buffer
         /*
          * \param f_file_name 	File which contains the int_vector.
          * \param len 			Length of the buffer in elements.
+         * \param int_width		Width of the elements, if it is not stored in the file.
+         * \param prefetch		If true, the next block is read from disk in a background
+         *						thread while the current block is processed.
          */
-        int_vector_file_buffer(const char* f_file_name=NULL, size_type len=1000000, uint8_t int_width=0):m_in(), m_buf(NULL), m_off(0), m_read_values(0), m_len(0), m_int_vector_size(0), m_read_values_sum(0), m_int_width(fixedIntWidth), m_file_name(), m_load_from_plain(false), int_vector_size(m_int_vector_size), int_width(m_int_width), file_name(m_file_name) {
+        int_vector_file_buffer(const char* f_file_name=NULL, size_type len=1000000, uint8_t int_width=0, bool prefetch=util::file_buffer_prefetch()):m_in(), m_buf(NULL), m_off(0), m_read_values(0), m_len(0), m_int_vector_size(0), m_read_values_sum(0), m_int_width(fixedIntWidth), m_file_name(), m_load_from_plain(false), m_prefetch(prefetch), m_compressed(false), m_dec_idx(0), m_dec_sum(0), int_vector_size(m_int_vector_size), int_width(m_int_width), file_name(m_file_name) {
             m_load_from_plain = false;
             int_vector_trait<fixedIntWidth, size_type_class>::set_int_width(m_int_width, int_width);
             m_len		 		= len;
@@ -1622,7 +2048,7 @@ class int_vector_file_buffer
                 return;
             }
             m_file_name = f_file_name;
-            m_in.open(m_file_name.c_str(), std::ifstream::in);
+            m_in.open(m_file_name.c_str(), chunk_size(), m_prefetch);
             if (m_in.is_open()) {
                 load_size_and_width();
                 m_buf = new uint64_t[(m_len*m_int_width+63)/64 + 2];
@@ -1647,7 +2073,7 @@ class int_vector_file_buffer
             m_len = len;
             m_file_name = f_file_name;
             m_int_vector_size = get_file_size(m_file_name.c_str());
-            m_in.open(m_file_name.c_str(), std::ifstream::in);
+            m_in.open(m_file_name.c_str(), chunk_size(), m_prefetch);
             if (m_in.is_open()) {
                 m_buf = new uint64_t[(m_len*m_int_width+63)/64 + 2];
             } else {
@@ -1658,8 +2084,7 @@ class int_vector_file_buffer
         }
 
         bool reset(size_type new_buf_len=0) {
-            m_in.clear();
-            if (!m_in.seekg(0, std::ios::beg)) {
+            if (!m_in.seek(0)) {
                 throw std::ios_base::failure("int_vector_file_buffer: reset()");
                 return false;
             };
@@ -1691,7 +2116,19 @@ class int_vector_file_buffer
             if (values_to_read + m_read_values_sum > m_int_vector_size) {
                 values_to_read = m_int_vector_size - m_read_values_sum;
             }
-            if (((m_read_values_sum*m_int_width)%64) == 0) { //if the new offset == 0
+            if (m_compressed) {
+                for (size_type filled = 0; filled < values_to_read;) {
+                    if (m_dec_idx == m_dec.size()) {
+                        decode_next_block();
+                    }
+                    size_type n = std::min(values_to_read-filled, (size_type)(m_dec.size()-m_dec_idx));
+                    size_type idx = filled*m_int_width;
+                    bit_magic::write_ints(m_buf+(idx>>6), idx&0x3F, m_int_width, n, &m_dec[m_dec_idx]);
+                    filled += n;
+                    m_dec_idx += n;
+                }
+                m_off = 0;
+            } else if (((m_read_values_sum*m_int_width)%64) == 0) { //if the new offset == 0
                 m_in.read((char*) m_buf, words_to_read(values_to_read) * sizeof(uint64_t));
                 m_off = 0;
             } else { // the new offset != 0
@@ -1740,12 +2177,288 @@ class int_vector_file_buffer
 
         ~int_vector_file_buffer() {
             if (m_in.is_open()) {
-                m_in.close(); // close ifstream
+                m_in.close(); // close file
                 delete [] m_buf;
             }
         }
 };
 
+//! A sequential view of an int_vector_file_buffer as a container.
+/*! Algorithms which pass a Container several times from begin() to end()
+ *  can read the values from a file with this view. begin() rewinds the
+ *  buffer, so only one iterator can be used at a time.
+ *
+ *  \par Example
+ *  \code
+ *  int_vector_file_buffer<> psi_buf("psi.sdsl");
+ *  int_vector_file_buffer_view<> psi_view(psi_buf);
+ *  enc_vector_dna<> psi;
+ *  psi.init(psi_view);
+ *  \endcode
+ */
+template<uint8_t fixedIntWidth=0, class size_type_class=std_size_type_for_int_vector>
+class int_vector_file_buffer_view
+{
+    public:
+        typedef int_vector_file_buffer<fixedIntWidth, size_type_class> buffer_type;
+        typedef typename buffer_type::value_type value_type;
+        typedef typename buffer_type::size_type  size_type;
+
+        //! Input iterator which reads the buffer block by block.
+        /*! The iterator is single-pass: all iterators share the buffer, and
+         *  incrementing one of them loads the next block for all of them.
+         */
+        class const_iterator
+        {
+            private:
+                buffer_type* m_buf;
+                size_type    m_idx;
+                size_type    m_r_sum; // number of values in the previous blocks
+                size_type    m_r;     // number of values in the current block
+            public:
+                const_iterator(buffer_type* buf, size_type idx):m_buf(buf), m_idx(idx), m_r_sum(0), m_r(0) {}
+
+                value_type operator*()const {
+                    return (*m_buf)[m_idx-m_r_sum];
+                }
+
+                const_iterator& operator++() {
+                    if (++m_idx == m_r_sum+m_r) {
+                        m_r_sum += m_r;
+                        m_r = m_buf->load_next_block();
+                    }
+                    return *this;
+                }
+
+                bool operator==(const const_iterator& it)const {
+                    return m_idx == it.m_idx;
+                }
+
+                bool operator!=(const const_iterator& it)const {
+                    return m_idx != it.m_idx;
+                }
+
+                friend class int_vector_file_buffer_view;
+        };
+
+    private:
+        buffer_type* m_buf;
+
+    public:
+        int_vector_file_buffer_view(buffer_type& buf):m_buf(&buf) {}
+
+        size_type size()const {
+            return m_buf->int_vector_size;
+        }
+
+        bool empty()const {
+            return 0 == size();
+        }
+
+        //! Rewinds the buffer and returns an iterator to the first value.
+        const_iterator begin()const {
+            const_iterator it(m_buf, 0);
+            m_buf->reset();
+            it.m_r = m_buf->load_next_block();
+            return it;
+        }
+
+        const_iterator end()const {
+            return const_iterator(m_buf, size());
+        }
+};
+
+//! A class for writing an int_vector buffered to a file.
+/*! The counterpart of int_vector_file_buffer: values are appended one by one
+ *  (or in bulk) and the file is a serialized int_vector, which can be read
+ *  by int_vector::load, util::load_from_file and int_vector_file_buffer.
+ *  Only one block of values is held in memory, so arrays which do not fit
+ *  into main memory can be produced. The header is written on close(),
+ *  when the size is known. If enabled, full blocks are written to disk by a
+ *  background thread while the next block is filled (see buffered_file_writer
+ *  and util::set_file_buffer_prefetch).
+ *
+ *  \par Example
+ *  \code
+ *  int_vector_file_writer<> lcp_out("lcp.sdsl", 32);
+ *  for (size_type i=0; i < n; ++i)
+ *      lcp_out.push_back(lcp(i));
+ *  if (!lcp_out.close())
+ *      throw std::ios_base::failure("Cannot write lcp.sdsl");
+ *  \endcode
+ */
+template<uint8_t fixedIntWidth, class size_type_class>
+class int_vector_file_writer
+{
+    public:
+        typedef typename int_vector<fixedIntWidth, size_type_class>::size_type 			size_type;
+        typedef typename int_vector<fixedIntWidth, size_type_class>::value_type 		value_type;
+        typedef typename int_vector<fixedIntWidth, size_type_class>::int_width_type		int_width_type;
+
+    private:
+        buffered_file_writer m_out;
+        std::vector<uint64_t> m_buf;  // bit-packed words of the current block or, if compressed, the values
+        size_type m_buf_len;          // number of words (or values) of a block
+        size_type m_bit_pos;          // bit position of the next value in m_buf
+        size_type m_size;             // number of values written
+        int_width_type m_int_width;
+        bool      m_compress;
+        std::vector<uint8_t> m_enc;   // encoded block of a compressed file
+        std::string m_file_name;
+
+        // Size of the header before the bit size of the vector
+        uint64_t size_offset()const {
+            return m_compress ? sizeof(size_type)+sizeof(uint8_t) : 0;
+        }
+
+        void write_header() {
+            size_type bit_size = 0;
+            uint8_t width = m_int_width;
+            if (m_compress) {
+                size_type marker = int_vector_compressed_marker<size_type>();
+                m_out.write((char*)&marker, sizeof(marker));
+                m_out.write((char*)&width, sizeof(width));
+                m_out.write((char*)&bit_size, sizeof(bit_size));
+            } else {
+                m_out.write((char*)&bit_size, sizeof(bit_size));
+                if (0 == fixedIntWidth) {
+                    m_out.write((char*)&width, sizeof(width));
+                }
+            }
+        }
+
+        // Writes the full words (or the values, if compressed) of the buffer
+        void flush_block() {
+            if (m_compress) {
+                if (m_bit_pos > 0) {
+                    uint64_t len = block_codec::write_ints(&m_enc[0], &m_buf[0], m_bit_pos, m_int_width);
+                    m_out.write((char*)&m_enc[0], len);
+                    m_bit_pos = 0;
+                }
+            } else {
+                size_type words = m_bit_pos>>6;
+                m_out.write((char*)&m_buf[0], words*sizeof(uint64_t));
+                m_buf[0] = m_buf[words];
+                m_bit_pos &= 0x3F;
+            }
+        }
+
+        int_vector_file_writer(const int_vector_file_writer&);
+        int_vector_file_writer& operator=(const int_vector_file_writer&);
+
+    public:
+        const uint8_t& int_width;
+
+        //! Constructor
+        /*!
+         * \param file_name File to which the int_vector is written. An existing file is overwritten.
+         * \param int_width Width of the elements; ignored for fixed width vectors.
+         * \param len       Length of the buffer in elements.
+         * \param async     If true, full blocks are written by a background thread.
+         * \param compress  If true, the vector is written in the format of int_vector::serialize_compressed.
+         */
+        int_vector_file_writer(const char* file_name, uint8_t int_width=64, size_type len=1000000,
+                               bool async=util::file_buffer_prefetch(), bool compress=false):
+            m_buf_len(0), m_bit_pos(0), m_size(0), m_int_width(fixedIntWidth), m_compress(compress),
+            m_file_name(file_name), int_width(m_int_width) {
+            int_vector_trait<fixedIntWidth, size_type_class>::set_int_width(m_int_width, int_width);
+            if (m_compress) {
+                m_buf_len = block_codec::int_vector_block_size;
+                m_enc.resize(sizeof(uint64_t)+block_codec::max_encoded_ints_size(m_buf_len));
+            } else {
+                m_buf_len = (len*m_int_width+63)/64;
+                if (m_buf_len < 64) {
+                    m_buf_len = 64;
+                }
+            }
+            m_buf.resize(m_buf_len+1, 0);
+            if (m_out.open(file_name, m_buf_len*sizeof(uint64_t), async)) {
+                write_header();
+            }
+        }
+
+        //! Returns true if the file could be opened and no write failed so far.
+        bool is_open()const {
+            return m_out.is_open();
+        }
+
+        //! Appends the value x to the vector.
+        void push_back(value_type x) {
+            if (m_compress) {
+                m_buf[m_bit_pos++] = x & bit_magic::Li1Mask[m_int_width];
+                if (m_bit_pos == m_buf_len) {
+                    flush_block();
+                }
+            } else {
+                bit_magic::write_int(&m_buf[m_bit_pos>>6], x, m_bit_pos&0x3F, m_int_width);
+                m_bit_pos += m_int_width;
+                if (m_bit_pos >= m_buf_len*64) {
+                    flush_block();
+                }
+            }
+            ++m_size;
+        }
+
+        //! Appends the n values of the array values to the vector.
+        void append(const uint64_t* values, size_type n) {
+            while (n > 0) {
+                if (m_compress) {
+                    size_type cnt = std::min(n, m_buf_len-m_bit_pos);
+                    for (size_type i=0; i < cnt; ++i) {
+                        m_buf[m_bit_pos+i] = values[i] & bit_magic::Li1Mask[m_int_width];
+                    }
+                    m_bit_pos += cnt;
+                    n -= cnt; values += cnt; m_size += cnt;
+                    if (m_bit_pos == m_buf_len) {
+                        flush_block();
+                    }
+                } else {
+                    size_type cnt = std::min(n, (m_buf_len*64-m_bit_pos+m_int_width-1)/m_int_width);
+                    bit_magic::write_ints(&m_buf[m_bit_pos>>6], m_bit_pos&0x3F, m_int_width, cnt, values);
+                    m_bit_pos += cnt*m_int_width;
+                    n -= cnt; values += cnt; m_size += cnt;
+                    if (m_bit_pos >= m_buf_len*64) {
+                        flush_block();
+                    }
+                }
+            }
+        }
+
+        //! Returns the number of values written so far.
+        size_type size()const {
+            return m_size;
+        }
+
+        //! Returns the name of the file.
+        const std::string& file_name()const {
+            return m_file_name;
+        }
+
+        //! Writes the remaining values and the header and closes the file.
+        /*! \return If the int_vector was written successfully.
+         *  Calling close on a closed writer returns false.
+         */
+        bool close() {
+            if (!m_out.is_open()) {
+                return false;
+            }
+            flush_block();
+            if (!m_compress and m_bit_pos > 0) { // write the last word with the unused bits set to zero
+                m_buf[0] &= bit_magic::Li1Mask[m_bit_pos];
+                m_out.write((char*)&m_buf[0], sizeof(uint64_t));
+                m_bit_pos = 0;
+            }
+            size_type bit_size = m_size*m_int_width;
+            m_out.write_at(size_offset(), (char*)&bit_size, sizeof(bit_size));
+            return m_out.close();
+        }
+
+        //! Destructor. Closes the file if close() was not called.
+        ~int_vector_file_writer() {
+            close();
+        }
+};
+
 /*
 // specialized [] operator for 8 bit access.
 template<>
@@ -149,6 +149,177 @@ inline random_access_const_iterator<RandomAccessContainer> operator+(typename ra
     return it+n;
 }
 
+//! A random access iterator which decodes the container block by block.
+/*! The container provides the block size as static member sample_dens and a
+ *  method decode_block(k, out), which writes the values of block k to out.
+ *  The iterator keeps the values of the last decoded block, so a sequential
+ *  scan decodes each block once. An access outside of this block, e.g. by
+ *  operator[] or after operator+=, decodes the whole block of the accessed
+ *  element.
+ *
+ *  The buffer for the block is allocated on the first dereference. Copies of
+ *  an iterator do not share or copy it, so copying is cheap (e.g. postfix
+ *  increment or passing by value), but the first dereference of a copy
+ *  decodes its block again.
+ *  \sa enc_vector, vlc_vector
+ */
+template<class BlockContainer>
+class random_access_block_const_iterator: public std::iterator<std::random_access_iterator_tag, typename BlockContainer::value_type, typename BlockContainer::difference_type>
+{
+    public:
+        typedef const typename BlockContainer::value_type  const_reference;
+        typedef typename BlockContainer::value_type value_type;
+        typedef typename BlockContainer::size_type size_type;
+        typedef random_access_block_const_iterator<BlockContainer> iterator;
+        typedef typename BlockContainer::difference_type difference_type;
+
+    private:
+        const BlockContainer* m_rac;// pointer to the random access container
+        size_type m_idx;
+        mutable size_type   m_block; // index of the block in m_buf or m_rac->size() if m_buf is empty
+        mutable value_type* m_buf;   // values of block m_block; allocated on the first access
+
+        // Returns the element at index idx
+        const_reference get(size_type idx)const {
+            size_type k = idx / BlockContainer::sample_dens;
+            if (k != m_block) {
+                if (m_buf == NULL) {
+                    m_buf = new value_type[BlockContainer::sample_dens];
+                }
+                m_rac->decode_block(k, m_buf);
+                m_block = k;
+            }
+            return m_buf[idx - k*BlockContainer::sample_dens];
+        }
+
+        template<class BC>
+        friend typename random_access_block_const_iterator<BC>::difference_type operator-(const random_access_block_const_iterator<BC>& x,
+                const random_access_block_const_iterator<BC>& y);
+
+    public:
+        //! Constructor
+        random_access_block_const_iterator(const BlockContainer* rac, size_type idx = 0) {
+            m_rac = rac;
+            m_idx = idx;
+            m_block = rac->size();
+            m_buf = NULL;
+        }
+
+        //! Copy constructor; the decoded block is not copied.
+        random_access_block_const_iterator(const random_access_block_const_iterator& it) {
+            m_rac = it.m_rac;
+            m_idx = it.m_idx;
+            m_block = m_rac->size();
+            m_buf = NULL;
+        }
+
+        //! Assignment operator; the decoded block is not copied.
+        iterator& operator=(const random_access_block_const_iterator& it) {
+            if (this != &it) {
+                m_rac = it.m_rac;
+                m_idx = it.m_idx;
+                m_block = m_rac->size();
+            }
+            return *this;
+        }
+
+        ~random_access_block_const_iterator() {
+            delete [] m_buf;
+        }
+
+        //! Dereference operator for the Iterator.
+        const_reference operator*()const {
+            return get(m_idx);
+        }
+
+        //! Prefix increment of the Iterator.
+        iterator& operator++() {
+            ++m_idx;
+            return *this;
+        }
+
+        //! Postfix increment of the Iterator.
+        iterator operator++(int) {
+            iterator it = *this;
+            ++(*this);
+            return it;
+        }
+
+        //! Prefix decrement of the Iterator.
+        iterator& operator--() {
+            --m_idx;
+            return *this;
+        }
+
+        //! Postfix decrement of the Iterator.
+        iterator operator--(int) {
+            iterator it = *this;
+            --(*this);
+            return it;
+        }
+
+        iterator& operator+=(difference_type i) {
+            m_idx += i;
+            return *this;
+        }
+
+        iterator& operator-=(difference_type i) {
+            m_idx -= i;
+            return *this;
+        }
+
+        iterator operator+(difference_type i) const {
+            iterator it = *this;
+            return it += i;
+        }
+
+        iterator operator-(difference_type i) const {
+            iterator it = *this;
+            return it -= i;
+        }
+
+        const_reference operator[](difference_type i) const {
+            return get(m_idx + i);
+        }
+
+        bool operator==(const iterator& it)const {
+            return it.m_rac == m_rac && it.m_idx == m_idx;
+        }
+
+        bool operator!=(const iterator& it)const {
+            return !(*this==it);
+        }
+
+        bool operator<(const iterator& it)const {
+            return m_idx < it.m_idx;
+        }
+
+        bool operator>(const iterator& it)const {
+            return m_idx > it.m_idx;
+        }
+
+        bool operator>=(const iterator& it)const {
+            return !(*this < it);
+        }
+
+        bool operator<=(const iterator& it)const {
+            return !(*this > it);
+        }
+};
+
+template<class BlockContainer>
+inline typename random_access_block_const_iterator<BlockContainer>::difference_type operator-(const random_access_block_const_iterator<BlockContainer>& x, const random_access_block_const_iterator<BlockContainer>& y)
+{
+    return (typename random_access_block_const_iterator<BlockContainer>::difference_type)x.m_idx
+           - (typename random_access_block_const_iterator<BlockContainer>::difference_type)y.m_idx;
+}
+
+template<class BlockContainer>
+inline random_access_block_const_iterator<BlockContainer> operator+(typename random_access_block_const_iterator<BlockContainer>::difference_type n, const random_access_block_const_iterator<BlockContainer>& it)
+{
+    return it+n;
+}
+
 } // end namespace sdsl
 
 #endif // end of include guard
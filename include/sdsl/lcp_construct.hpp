@@ -79,8 +79,9 @@ class buffered_char_queue
         bool		m_sync; // are read and write buffer the same?
         size_type 	m_disk_buffered_blocks; // number of blocks written to disk and not read again yet
         char 		m_c;
-        size_type	m_rb; // read blocks
-        size_type	m_wb; // written blocks
+        size_type	m_rpos; // file offset of the next block to read
+        size_type	m_wpos; // file offset of the next block to write
+        bool		m_compress; // are the blocks on disk compressed?
 
         std::string m_file_name;
 
@@ -89,7 +90,7 @@ class buffered_char_queue
     public:
 
         buffered_char_queue();
-        void init(const std::string& dir, char c);
+        void init(const std::string& dir, char c, bool compress=util::temp_file_compression());
         ~buffered_char_queue();
         void push_back(uint8_t x);
         uint8_t pop_front();
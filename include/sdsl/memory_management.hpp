@@ -0,0 +1,244 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file memory_management.hpp
+    \brief memory_management.hpp contains helper classes for memory mapped files and the allocation policies of int_vectors.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_MEMORY_MANAGEMENT
+#define INCLUDED_SDSL_MEMORY_MANAGEMENT
+
+#include <stdint.h> // for uint64_t
+#include <streambuf>
+#include <ios>
+#include <string>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! A reference counted, copy-on-write memory mapping of a whole file.
+/*! The file is mapped with MAP_PRIVATE, i.e. all processes which map the same
+ *  file share the pages of the page cache. Writes to the mapping are private
+ *  to the process and never reach the file.
+ *  The mapping is followed by at least one zero-filled padding word, since rank
+ *  data structures access the word behind the last word of a bit_vector.
+ *
+ *  The mapping is released when the last reference is dropped.
+ */
+class mm_file
+{
+    private:
+        char*    m_data;     // start of the mapping
+        uint64_t m_size;     // size of the file in bytes
+        uint64_t m_reserved; // size of the mapped region including the padding
+        uint64_t m_refs;     // number of references to the mapping
+
+        mm_file();
+        mm_file(const mm_file&);             // not copyable
+        mm_file& operator=(const mm_file&);  // not assignable
+        ~mm_file();
+    public:
+        //! Maps the file file_name into memory.
+        /*! \param file_name Name of the file to map.
+         *  \return A pointer to the mapping with reference count 1 or NULL if the
+         *          file could not be mapped.
+         */
+        static mm_file* open(const char* file_name);
+
+        //! Pointer to the first byte of the mapped file.
+        const char* data()const {
+            return m_data;
+        }
+
+        //! Size of the mapped file in bytes.
+        uint64_t size()const {
+            return m_size;
+        }
+
+        //! Increments the reference count.
+        void add_ref();
+        //! Decrements the reference count and unmaps the file if it drops to zero.
+        void release();
+};
+
+//! A std::streambuf which reads from a memory mapped file.
+/*! An std::istream constructed on top of a mm_streambuf behaves like an
+ *  std::ifstream. Data structures can detect the mm_streambuf
+ *  (see int_vector::load) and use the mapped memory directly instead of
+ *  copying it to the heap.
+ */
+class mm_streambuf : public std::streambuf
+{
+    private:
+        mm_file* m_file;
+
+        mm_streambuf(const mm_streambuf&);
+        mm_streambuf& operator=(const mm_streambuf&);
+    protected:
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+    public:
+        //! Constructor
+        /*! \param file The mapping to read from. The streambuf holds a reference to it.
+         */
+        explicit mm_streambuf(mm_file* file);
+        ~mm_streambuf();
+
+        //! The mapping the streambuf reads from.
+        mm_file* file()const {
+            return m_file;
+        }
+
+        //! Pointer to the current read position in the mapping.
+        const char* current()const {
+            return gptr();
+        }
+
+        //! Number of bytes between the current read position and the end of the file.
+        uint64_t remaining()const {
+            return egptr()-gptr();
+        }
+
+        //! Moves the read position n bytes forward.
+        /*! \pre n <= remaining()
+         */
+        void skip(uint64_t n) {
+            setg(eback(), gptr()+n, egptr());
+        }
+};
+
+//! Page size which backs the memory of an allocation.
+enum page_size_type {
+    SMALL_PAGES    = 0, //!< Pages of the default size of the system (usually 4kB).
+    HUGE_PAGES_2MB = 1, //!< 2MB huge pages.
+    HUGE_PAGES_1GB = 2  //!< 1GB huge pages.
+};
+
+//! Placement of the memory of an allocation on the nodes of a NUMA system.
+enum numa_placement_type {
+    NUMA_DEFAULT    = 0, //!< Placement of the operating system (usually first touch).
+    NUMA_INTERLEAVE = 1, //!< Pages are interleaved round-robin over all nodes.
+    NUMA_LOCAL      = 2  //!< Pages are placed on the node of the allocating thread.
+};
+
+//! Describes how the memory of an int_vector is allocated.
+/*! Allocations smaller than memory_manager::min_bytes() always come from the heap.
+ *  Larger allocations with a policy other than the default one are anonymous
+ *  memory mappings:
+ *   - HUGE_PAGES_2MB and HUGE_PAGES_1GB first try to map explicit huge pages
+ *     (MAP_HUGETLB). If the system has no reserved huge pages of that size,
+ *     1GB falls back to 2MB and 2MB falls back to transparent huge pages
+ *     (madvise(MADV_HUGEPAGE)).
+ *   - NUMA_INTERLEAVE and NUMA_LOCAL bind the mapping with mbind before
+ *     the first page is touched.
+ *  All requests are best effort: if the system does not support a feature
+ *  the memory is allocated without it.
+ *  \sa memory_manager, int_vector::set_alloc_policy
+ */
+class alloc_policy
+{
+    private:
+        uint8_t m_pages;
+        uint8_t m_numa;
+    public:
+        alloc_policy(page_size_type pages=SMALL_PAGES, numa_placement_type numa=NUMA_DEFAULT):
+            m_pages(pages), m_numa(numa) {}
+
+        page_size_type pages()const {
+            return (page_size_type)m_pages;
+        }
+
+        numa_placement_type numa()const {
+            return (numa_placement_type)m_numa;
+        }
+
+        //! Returns true if the policy does neither request huge pages nor a NUMA placement.
+        bool is_default()const {
+            return m_pages == SMALL_PAGES and m_numa == NUMA_DEFAULT;
+        }
+
+        bool operator==(const alloc_policy& p)const {
+            return m_pages == p.m_pages and m_numa == p.m_numa;
+        }
+
+        bool operator!=(const alloc_policy& p)const {
+            return !(*this == p);
+        }
+
+        //! String representation of the policy, e.g. "huge_2MB/interleave".
+        std::string to_string()const;
+};
+
+//! Allocates memory according to an alloc_policy.
+/*! Memory which is allocated by memory_manager has to be freed by memory_manager::free_mem.
+ *  Memory mappings are registered, so free_mem and realloc_mem know how
+ *  a block was allocated.
+ */
+class memory_manager
+{
+    private:
+        memory_manager(); // only static methods
+    public:
+        //! Allocates bytes bytes according to policy.
+        /*! \return Pointer to the memory or NULL if no memory is available.
+         */
+        static uint64_t* alloc_mem(uint64_t bytes, const alloc_policy& policy);
+
+        //! Resizes the memory block data to bytes bytes, like realloc.
+        /*! \param data      Block allocated by memory_manager or NULL.
+         *  \param bytes     New size of the block.
+         *  \param old_bytes Current size of the block.
+         *  \param policy    Policy of the new block. If the policy changes the content is moved.
+         *  \return Pointer to the block or NULL if no memory is available. In the latter case data remains valid.
+         */
+        static uint64_t* realloc_mem(uint64_t* data, uint64_t bytes, uint64_t old_bytes, const alloc_policy& policy);
+
+        //! Frees a block allocated by memory_manager.
+        static void free_mem(uint64_t* data);
+
+        //! Returns how a block allocated by memory_manager is backed and placed.
+        /*! \return One of "heap", "small_pages", "thp" (transparent huge pages),
+         *          "huge_2MB" and "huge_1GB", followed by "/interleave" or "/local"
+         *          if the kernel accepted the NUMA placement of the block.
+         */
+        static std::string memory_type(const uint64_t* data);
+
+        //! Sets the policy which new int_vectors are created with.
+        static void set_default_policy(const alloc_policy& policy);
+        //! Returns the policy which new int_vectors are created with.
+        static alloc_policy default_policy();
+
+        //! Sets the size in bytes from which on allocations follow their policy. Default is 1MB.
+        static void set_min_bytes(uint64_t bytes);
+        //! Returns the size in bytes from which on allocations follow their policy.
+        static uint64_t min_bytes();
+
+        //! Returns the number of bytes which are currently allocated by memory_manager.
+        /*! Includes the rounding of mapped blocks to the page size.
+         */
+        static uint64_t allocated_bytes();
+
+        //! Returns the maximum of allocated_bytes() since the last call of reset_peak_bytes().
+        static uint64_t peak_bytes();
+
+        //! Sets peak_bytes() to allocated_bytes().
+        static void reset_peak_bytes();
+};
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,112 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file parallel.hpp
+    \brief parallel.hpp contains a simple parallel for loop based on pthreads.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_PARALLEL
+#define INCLUDED_SDSL_PARALLEL
+
+#include <stdint.h> // for uint64_t
+#include <pthread.h>
+#include <vector>
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+namespace util
+{
+//! Sets the maximal number of threads of the parallel algorithms.
+/*! The default is 1, i.e. the algorithms run in the calling thread and no
+ *  threads are created. set_thread_count(0) selects the number of online
+ *  processors.
+ */
+void set_thread_count(uint32_t threads);
+
+//! Returns the maximal number of threads of the parallel algorithms.
+uint32_t thread_count();
+}
+
+template<class Functor>
+struct parallel_for_task {
+    Functor* f;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t thread;
+};
+
+template<class Functor>
+void* run_parallel_for_task(void* arg)
+{
+    parallel_for_task<Functor>* t = (parallel_for_task<Functor>*)arg;
+    (*(t->f))(t->begin, t->end, t->thread);
+    return NULL;
+}
+
+//! Calls f(begin, end, thread) for a partition of [0..n-1] into at most util::thread_count() ranges.
+/*! The ranges are processed concurrently, the first one by the calling thread.
+ *  \param n           Size of the interval.
+ *  \param f           Functor with an operator()(uint64_t begin, uint64_t end, uint32_t thread).
+ *  \param granularity All range boundaries except n are multiples of granularity.
+ *                     E.g. 64 guarantees that ranges of an int_vector do not share words.
+ *  \param min_range   Minimal size of a range. Small intervals are processed by one call.
+ *  \return The number of ranges.
+ */
+template<class Functor>
+uint32_t parallel_for(uint64_t n, Functor& f, uint64_t granularity=64, uint64_t min_range=(1ULL<<16))
+{
+    uint64_t threads = util::thread_count();
+    if (min_range < granularity) {
+        min_range = granularity;
+    }
+    if (threads > n/min_range) {
+        threads = n/min_range;
+    }
+    if (threads <= 1) {
+        f((uint64_t)0, n, (uint32_t)0);
+        return 1;
+    }
+    uint64_t range = (((n+threads-1)/threads + granularity-1)/granularity)*granularity;
+    std::vector<parallel_for_task<Functor> > tasks;
+    for (uint64_t begin=0; begin < n; begin += range) {
+        parallel_for_task<Functor> t;
+        t.f      = &f;
+        t.begin  = begin;
+        t.end    = (begin+range < n) ? begin+range : n;
+        t.thread = tasks.size();
+        tasks.push_back(t);
+    }
+    std::vector<pthread_t> handles(tasks.size());
+    std::vector<bool> started(tasks.size(), false);
+    for (size_t i=1; i < tasks.size(); ++i) {
+        started[i] = (pthread_create(&handles[i], NULL, run_parallel_for_task<Functor>, &tasks[i]) == 0);
+    }
+    run_parallel_for_task<Functor>(&tasks[0]);
+    for (size_t i=1; i < tasks.size(); ++i) {
+        if (started[i]) {
+            pthread_join(handles[i], NULL);
+        } else { // no more threads available; process the range here
+            run_parallel_for_task<Functor>(&tasks[i]);
+        }
+    }
+    return tasks.size();
+}
+
+}// end namespace sdsl
+
+#endif // end file
@@ -0,0 +1,531 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file pef_vector.hpp
+   \brief pef_vector.hpp contains the sdsl::pef_vector class, a partitioned
+          Elias-Fano representation of non-decreasing sequences.
+   \author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_PEF_VECTOR
+#define INCLUDED_SDSL_PEF_VECTOR
+
+#include "int_vector.hpp"
+#include "iterators.hpp"
+#include "util.hpp"
+#include "bitmagic.hpp"
+#include "sd_vector.hpp"
+#include <vector>
+#include <algorithm> // for std::reverse
+#include <stdexcept> // for std::logic_error
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+//! An immutable vector for non-decreasing sequences of integers, which is partitioned into chunks.
+/*! The sequence is split into chunks (partitions) of variable length, which
+ *  are chosen by the approximate dynamic program of Ottaviano and Venturini:
+ *  the partition minimizes the total size up to a factor of about
+ *  \f$ 1+\epsilon \f$, in time linear in the number of elements. The first
+ *  value of each chunk and the position of its encoding are stored side by side,
+ *  and the first indexes of the chunks are stored in an sd_vector. The values of
+ *  a chunk, relative to its first value, are encoded with the smallest of three
+ *  encodings:
+ *   - run:    the values are consecutive; nothing is stored,
+ *   - bitmap: a bit vector with a one for each value (strictly increasing chunks),
+ *   - EF:     the Elias-Fano representation with the optimal number of low bits.
+ *  So dense regions, e.g. runs in \f$\Psi\f$ or document boundaries, cost
+ *  about one bit per element or less, while sparse regions are coded as in sd_vector.
+ *
+ *  Access, next_geq and the decoding of a block touch only the chunks of the
+ *  block, their top-level entries and the chunk starts in the sd_vector.
+ *  A chunk has at most ChunkSize elements, so its encoding is at most about
+ *  \f$ 3\cdot ChunkSize \f$ bits long and the in-chunk selects are done by
+ *  scanning a few words. next_geq finds the chunk with a bucket index over
+ *  the high bits of the first values of the chunks.
+ *
+ * \par References
+ *  - G. Ottaviano, R. Venturini: ,,Partitioned Elias-Fano Indexes'',
+ *             Proceedings of SIGIR 2014.
+ *
+ *  \tparam ChunkSize Maximal number of elements in a chunk and number of
+ *                    values which are decoded by decode_block.
+ *  @ingroup int_vector
+ */
+template<uint32_t ChunkSize=128>
+class pef_vector
+{
+    public:
+        typedef uint64_t 							value_type;
+        typedef random_access_block_const_iterator<pef_vector> iterator;
+        typedef iterator							const_iterator;
+        typedef const value_type		 			reference;
+        typedef const value_type 					const_reference;
+        typedef const value_type*					const_pointer;
+        typedef ptrdiff_t 							difference_type;
+        typedef int_vector<>::size_type				size_type;
+        static  const uint32_t 						sample_dens	= ChunkSize; // Required by random_access_block_const_iterator
+
+        static const uint8_t run_chunk    = 0;
+        static const uint8_t bitmap_chunk = 1;
+        static const uint8_t ef_chunk     = 2;
+    private:
+        size_type	 m_elements;     // number of elements
+        int_vector<> m_chunk_vals_and_pointer; // first value of chunk c at 2c, start of chunk c in m_data at 2c+1
+        bit_vector	 m_data;         // chunk encodings followed by one word of padding
+        sd_vector<>  m_chunk_starts; // a one at the index of the first element of each chunk
+        sd_select_support<> m_chunk_starts_select;
+        int_vector<> m_bucket_chunk; // number of chunks whose first value is smaller than b*2^m_bucket_log, for each b
+        uint8_t		 m_bucket_log;
+
+        // A chunk starts with an 8 bit header: the type in the lowest 2 bits and the number of low bits of EF.
+        // EF chunks store the high parts in unary before the low parts, which end at the start of the next chunk.
+
+        // The chunk [start, end) of the sequence which is considered by the dynamic
+        // program. The window grows until its cost reaches bound.
+        struct partition_window {
+            size_type start, end;
+            size_type dups;  // number of t in (start, end) with v[t] == v[t-1]
+            uint64_t  bound; // upper bound for the cost of the window
+
+            partition_window(uint64_t b):start(0), end(0), dups(0), bound(b) {}
+
+            void grow(const std::vector<uint64_t>& v) {
+                if (end > start and v[end] == v[end-1])
+                    ++dups;
+                ++end;
+            }
+
+            void shrink(const std::vector<uint64_t>& v) {
+                if (start+1 < end and v[start+1] == v[start])
+                    --dups;
+                ++start;
+            }
+        };
+
+        // Index of the first element after chunk c.
+        size_type chunk_end(size_type c)const {
+            return c+1 < chunks() ? m_chunk_starts_select(c+2) : m_elements;
+        }
+
+        // Reads 64 bits starting at position pos of m_data.
+        uint64_t read_word(size_type pos)const {
+            return m_data.get_int(pos, 64);
+        }
+
+        // Position of the k-th one (k>=1) after position pos, relative to pos.
+        size_type select_1(size_type pos, size_type k)const {
+            size_type off = 0;
+            uint64_t w;
+            uint32_t cnt;
+            while ((cnt = bit_magic::b1Cnt(w = read_word(pos+off))) < k) {
+                k   -= cnt;
+                off += 64;
+            }
+            return off + bit_magic::i1BP(w, k);
+        }
+
+        // Position of the k-th zero (k>=1) after position pos, relative to pos.
+        size_type select_0(size_type pos, size_type k)const {
+            size_type off = 0;
+            uint64_t w;
+            uint32_t cnt;
+            while ((cnt = bit_magic::b1Cnt(w = ~read_word(pos+off))) < k) {
+                k   -= cnt;
+                off += 64;
+            }
+            return off + bit_magic::i1BP(w, k);
+        }
+
+        // Chooses the encoding of m non-decreasing values, whose largest relative value
+        // is u, and returns its length in bits. strict is true if the values are distinct.
+        static size_type chunk_encoding(uint64_t u, size_type m, bool strict, uint8_t& type, uint8_t& wl) {
+            wl = 0;
+            if (strict and u == m-1) {
+                type = run_chunk;
+                return 8;
+            }
+            if (u/m > 0)
+                wl = bit_magic::l1BP(u/m);
+            size_type bits = m*wl + (u>>wl) + m;
+            type = ef_chunk;
+            if (strict and u < bits) {
+                type = bitmap_chunk;
+                bits = u+1;
+            }
+            return 8 + bits;
+        }
+
+        // Chooses the encoding of the non-decreasing values v[0..m-1] and returns its length in bits.
+        static size_type chunk_encoding(const uint64_t* v, size_type m, uint8_t& type, uint8_t& wl) {
+            bool strict = true;
+            for (size_type j=1; j < m and strict; ++j)
+                strict = (v[j] != v[j-1]);
+            return chunk_encoding(v[m-1]-v[0], m, strict, type, wl);
+        }
+
+        // Returns the first indexes of the chunks of v, which minimize the size of the
+        // encodings plus fix_cost bits per chunk up to a factor of about 1+eps1.
+        // The dynamic program considers only the windows, which end first after each of
+        // the cost bounds fix_cost*(1+eps2)^h for h>=0, up to fix_cost/eps1.
+        static std::vector<size_type> optimal_partition(const std::vector<uint64_t>& v, uint64_t fix_cost) {
+            const double eps1 = 0.03, eps2 = 0.3;
+            size_type n = v.size();
+            std::vector<partition_window> windows;
+            for (uint64_t bound = fix_cost; ; bound = std::max(bound+1, (uint64_t)(bound*(1+eps2)))) {
+                windows.push_back(partition_window(bound));
+                if (bound >= fix_cost/eps1)
+                    break;
+            }
+            windows.back().bound = ~0ULL; // the largest window is only limited by ChunkSize
+            std::vector<uint64_t>  min_cost(n+1, ~0ULL);
+            std::vector<size_type> prev(n+1, 0);
+            min_cost[0] = 0;
+            uint8_t type, wl;
+            for (size_type i=0; i < n; ++i) { // all windows start at i
+                size_type last_end = i+1;
+                for (size_type h=0; h < windows.size(); ++h) {
+                    partition_window& w = windows[h];
+                    while (w.end < last_end)
+                        w.grow(v);
+                    while (true) {
+                        uint64_t cost = fix_cost + chunk_encoding(v[w.end-1]-v[w.start], w.end-w.start, w.dups == 0, type, wl);
+                        if (min_cost[i] + cost < min_cost[w.end]) {
+                            min_cost[w.end] = min_cost[i] + cost;
+                            prev[w.end]     = i;
+                        }
+                        last_end = w.end;
+                        if (w.end == n or w.end - w.start == ChunkSize or cost >= w.bound)
+                            break;
+                        w.grow(v);
+                    }
+                    w.shrink(v);
+                }
+            }
+            std::vector<size_type> starts;
+            for (size_type end = n; end > 0; end = prev[end])
+                starts.push_back(prev[end]);
+            std::reverse(starts.begin(), starts.end());
+            return starts;
+        }
+
+        // Decodes the m values of chunk c.
+        void decode_chunk(size_type c, size_type m, uint64_t* out)const {
+            uint64_t  base = m_chunk_vals_and_pointer[c<<1];
+            size_type pos  = m_chunk_vals_and_pointer[(c<<1)+1];
+            uint8_t header = m_data.get_int(pos, 8);
+            pos += 8;
+            if ((header & 3) == run_chunk) {
+                for (size_type j=0; j < m; ++j)
+                    out[j] = base + j;
+            } else if ((header & 3) == bitmap_chunk) {
+                for (size_type off=0, k=0; k < m; off += 64) {
+                    for (uint64_t w = read_word(pos+off); w and k < m; w &= w-1)
+                        out[k++] = base + off + bit_magic::r1BP(w);
+                }
+            } else {
+                uint8_t wl = header >> 2;
+                size_type low = m_chunk_vals_and_pointer[(c<<1)+3] - m*wl;
+                for (size_type off=0, k=0; k < m; off += 64) {
+                    for (uint64_t w = read_word(pos+off); w and k < m; w &= w-1, ++k) {
+                        uint64_t high = off + bit_magic::r1BP(w) - k;
+                        out[k] = base + ((high << wl) | m_data.get_int(low + k*wl, wl));
+                    }
+                }
+            }
+        }
+
+        // Writes the encoding of v[0..m-1] at position pos of m_data.
+        void write_chunk(const uint64_t* v, size_type m, uint8_t type, uint8_t wl, size_type pos) {
+            m_data.set_int(pos, type | (wl << 2), 8);
+            pos += 8;
+            if (type == bitmap_chunk) {
+                for (size_type j=0; j < m; ++j)
+                    m_data[pos + v[j]-v[0]] = 1;
+            } else if (type == ef_chunk) {
+                size_type low = pos + ((v[m-1]-v[0]) >> wl) + m;
+                for (size_type j=0; j < m; ++j) {
+                    uint64_t x = v[j]-v[0];
+                    m_data[pos + (x>>wl) + j] = 1;
+                    if (wl)
+                        m_data.set_int(low + j*wl, x, wl);
+                }
+            }
+        }
+
+        void copy(const pef_vector& v) {
+            m_elements               = v.m_elements;
+            m_chunk_vals_and_pointer = v.m_chunk_vals_and_pointer;
+            m_data                   = v.m_data;
+            m_chunk_starts           = v.m_chunk_starts;
+            m_chunk_starts_select.set_vector(&m_chunk_starts);
+            m_bucket_chunk           = v.m_bucket_chunk;
+            m_bucket_log             = v.m_bucket_log;
+        }
+
+    public:
+        //! Default Constructor
+        pef_vector():m_elements(0), m_bucket_log(0) {}
+
+        //! Copy constructor
+        pef_vector(const pef_vector& v) {
+            copy(v);
+        }
+
+        //! Constructor for a Container of non-decreasing integers.
+        /*! \param c A container of non-decreasing integers.
+         *  \throws std::logic_error if c is not non-decreasing.
+         */
+        template<class Container>
+        pef_vector(const Container& c):m_elements(0), m_bucket_log(0) {
+            init(c);
+        }
+
+        template<class Container>
+        void init(const Container& c) {
+            // (1) Partition the values; the dynamic program needs random access to them
+            std::vector<uint64_t> v(c.begin(), c.end());
+            for (size_type i=1; i < v.size(); ++i) {
+                if (v[i] < v[i-1])
+                    throw std::logic_error("pef_vector: the values have to be non-decreasing!");
+            }
+            m_elements = v.size();
+            uint64_t last = v.empty() ? 0 : v.back();
+            // cost of a chunk besides its encoding: the header, the top-level
+            // entries and about 2+log(ChunkSize) bits for its start in m_chunk_starts
+            uint64_t fix_cost = 8 + 2*(bit_magic::l1BP(std::max(last, 8*(uint64_t)m_elements) | 1)+1)
+                                + 2 + bit_magic::l1BP(ChunkSize);
+            std::vector<size_type> starts = optimal_partition(v, fix_cost);
+            size_type chunks = starts.size();
+            starts.push_back(m_elements);
+            // (2) Write the chunks
+            std::vector<uint8_t> types(chunks), wls(chunks);
+            uint64_t max_base = 0;
+            size_type data_size = 0;
+            for (size_type k=0; k < chunks; ++k) {
+                max_base   = v[starts[k]];
+                data_size += chunk_encoding(&v[starts[k]], starts[k+1]-starts[k], types[k], wls[k]);
+            }
+            m_chunk_vals_and_pointer = int_vector<>(2*chunks+2, 0, bit_magic::l1BP(std::max(max_base, (uint64_t)data_size) | 1)+1);
+            m_data = bit_vector(data_size+64, 0);
+            for (size_type k=0, pos=0; k < chunks; ++k) {
+                size_type m = starts[k+1]-starts[k];
+                m_chunk_vals_and_pointer[2*k]   = v[starts[k]];
+                m_chunk_vals_and_pointer[2*k+1] = pos;
+                write_chunk(&v[starts[k]], m, types[k], wls[k], pos);
+                pos += chunk_encoding(&v[starts[k]], m, types[k], wls[k]);
+            }
+            m_chunk_vals_and_pointer[2*chunks+1] = data_size; // last entry
+            starts.pop_back();
+            m_chunk_starts = chunks > 0 ? sd_vector<>(starts.begin(), starts.end(), m_elements) : sd_vector<>();
+            m_chunk_starts_select.set_vector(&m_chunk_starts);
+            // (3) Index the chunks by the high bits of their first values; about one chunk per bucket
+            m_bucket_log = 0;
+            if (chunks > 0 and last/chunks > 0)
+                m_bucket_log = bit_magic::l1BP(last/chunks);
+            size_type buckets = chunks > 0 ? (last >> m_bucket_log) + 2 : 0;
+            m_bucket_chunk = int_vector<>(buckets, 0, bit_magic::l1BP(chunks+1)+1);
+            for (size_type b=0, k=0; b < buckets; ++b) {
+                while (k < chunks and (m_chunk_vals_and_pointer[2*k] >> m_bucket_log) < b)
+                    ++k;
+                m_bucket_chunk[b] = k;
+            }
+        }
+
+        //! The number of elements in the pef_vector.
+        size_type size()const {
+            return m_elements;
+        }
+
+        //! Returns if the pef_vector is empty.
+        bool empty()const {
+            return 0 == m_elements;
+        }
+
+        //! The number of chunks which the elements are partitioned into.
+        size_type chunks()const {
+            return m_elements > 0 ? m_chunk_vals_and_pointer.size()/2 - 1 : 0;
+        }
+
+        //! []-operator
+        /*! \param i Index of the value. \f$ i \in [0..size()-1]\f$.
+         *  \par Time complexity
+         *       \f$ \Order{ChunkSize/64} \f$ word operations, plus a predecessor
+         *       query and, for EF chunks, a select on the sd_vector of the chunk starts.
+         */
+        value_type operator[](size_type i)const {
+            size_type c = 0, j = i - m_chunk_starts.prev_leq(i, c);
+            uint64_t  base = m_chunk_vals_and_pointer[c<<1];
+            size_type pos  = m_chunk_vals_and_pointer[(c<<1)+1];
+            uint8_t header = m_data.get_int(pos, 8);
+            pos += 8;
+            if ((header & 3) == run_chunk)
+                return base + j;
+            if ((header & 3) == bitmap_chunk)
+                return base + select_1(pos, j+1);
+            uint8_t wl = header >> 2;
+            size_type m = chunk_end(c) - (i-j);
+            size_type low = m_chunk_vals_and_pointer[(c<<1)+3] - m*wl;
+            uint64_t high = select_1(pos, j+1) - j;
+            return base + ((high << wl) | m_data.get_int(low + j*wl, wl));
+        }
+
+        //! Returns the index of the first element which is greater or equal to x.
+        /*! \param x A value.
+         *  \return The smallest index i with (*this)[i] >= x, or size() if there is no such element.
+         *  \par Time complexity
+         *       \f$ \Order{ChunkSize/64} \f$ expected, if the first values of the chunks are about uniformly distributed.
+         */
+        size_type next_geq(value_type x)const {
+            // number of chunks whose first value is smaller than x
+            size_type b = x >> m_bucket_log, lb, rb;
+            if (m_bucket_chunk.size() > 0 and b < m_bucket_chunk.size()-1) { // b+1 overflows for x=2^64-1
+                lb = m_bucket_chunk[b];
+                rb = m_bucket_chunk[b+1];
+            } else {
+                lb = rb = chunks();
+            }
+            while (lb < rb) {
+                size_type mid = (lb+rb)/2;
+                if (m_chunk_vals_and_pointer[mid<<1] < x)
+                    lb = mid+1;
+                else
+                    rb = mid;
+            }
+            if (lb == 0)
+                return 0;
+            size_type c = lb-1, first = m_chunk_starts_select(lb), m = chunk_end(c) - first;
+            uint64_t  rel = x - m_chunk_vals_and_pointer[c<<1]; // > 0
+            size_type pos = m_chunk_vals_and_pointer[(c<<1)+1];
+            size_type end = m_chunk_vals_and_pointer[(c<<1)+3];
+            uint8_t header = m_data.get_int(pos, 8);
+            pos += 8;
+            size_type k; // number of elements of the chunk which are smaller than x
+            if ((header & 3) == run_chunk) {
+                k = std::min((size_type)rel, m);
+            } else if ((header & 3) == bitmap_chunk) {
+                if (rel >= end - pos) {
+                    k = m;
+                } else {
+                    k = 0;
+                    size_type off = 0;
+                    for (; off+64 <= rel; off += 64)
+                        k += bit_magic::b1Cnt(read_word(pos+off));
+                    if (rel > off)
+                        k += bit_magic::b1Cnt(read_word(pos+off) & bit_magic::Li1Mask[rel-off]);
+                }
+            } else {
+                uint8_t wl = header >> 2;
+                size_type low = end - m*wl;
+                uint64_t h = rel >> wl, rel_low = rel & bit_magic::Li1Mask[wl];
+                if (h > low - pos - m) { // h is larger than the high part of the last element
+                    k = m;
+                } else {
+                    size_type u = h ? select_0(pos, h)+1 : 0; // first element with high part >= h
+                    k = u - h;
+                    while (k < m and m_data[pos+u] and m_data.get_int(low + k*wl, wl) < rel_low) {
+                        ++k; ++u;
+                    }
+                }
+            }
+            return first + k;
+        }
+
+        //! Decodes the values of the b-th block, i.e. of the elements b*ChunkSize to (b+1)*ChunkSize-1.
+        /*! \param b   The index of the block. 0 <= b < (size()+ChunkSize-1)/ChunkSize
+         *  \param out A buffer for ChunkSize values.
+         *  \return The number of decoded values, i.e. min(ChunkSize, size()-b*ChunkSize).
+         */
+        size_type decode_block(const size_type b, uint64_t* out)const {
+            size_type begin = b*ChunkSize, end = std::min(begin+ChunkSize, m_elements);
+            if (begin >= end)
+                return 0;
+            uint64_t buf[ChunkSize];
+            size_type c = 0;
+            for (size_type first = m_chunk_starts.prev_leq(begin, c); first < end; ++c) {
+                size_type last = chunk_end(c);
+                if (first >= begin and last <= end) {
+                    decode_chunk(c, last-first, out + (first-begin));
+                } else { // the chunk overlaps the start or the end of the block
+                    decode_chunk(c, last-first, buf);
+                    for (size_type i=std::max(first, begin); i < std::min(last, end); ++i)
+                        out[i-begin] = buf[i-first];
+                }
+                first = last;
+            }
+            return end-begin;
+        }
+
+        //! Iterator that points to the first element of the pef_vector.
+        const const_iterator begin()const {
+            return const_iterator(this, 0);
+        }
+
+        //! Iterator that points to the position after the last element of the pef_vector.
+        const const_iterator end()const {
+            return const_iterator(this, m_elements);
+        }
+
+        //! Assignment operator
+        pef_vector& operator=(const pef_vector& v) {
+            if (this != &v) {
+                copy(v);
+            }
+            return *this;
+        }
+
+        //! Swap method
+        void swap(pef_vector& v) {
+            if (this != &v) {
+                std::swap(m_elements, v.m_elements);
+                m_chunk_vals_and_pointer.swap(v.m_chunk_vals_and_pointer);
+                m_data.swap(v.m_data);
+                m_chunk_starts.swap(v.m_chunk_starts);
+                util::swap_support(m_chunk_starts_select, v.m_chunk_starts_select, &m_chunk_starts, &v.m_chunk_starts);
+                m_bucket_chunk.swap(v.m_bucket_chunk);
+                std::swap(m_bucket_log, v.m_bucket_log);
+            }
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += util::write_member(m_elements, out, child, "elements");
+            written_bytes += m_chunk_vals_and_pointer.serialize(out, child, "chunk_vals_and_pointer");
+            written_bytes += m_data.serialize(out, child, "data");
+            written_bytes += m_chunk_starts.serialize(out, child, "chunk_starts");
+            written_bytes += m_bucket_chunk.serialize(out, child, "bucket_chunk");
+            written_bytes += util::write_member(m_bucket_log, out, child, "bucket_log");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in) {
+            util::read_member(m_elements, in);
+            m_chunk_vals_and_pointer.load(in);
+            m_data.load(in);
+            m_chunk_starts.load(in);
+            m_chunk_starts_select.set_vector(&m_chunk_starts);
+            m_bucket_chunk.load(in);
+            util::read_member(m_bucket_log, in);
+        }
+};
+
+} // end namespace sdsl
+
+#endif
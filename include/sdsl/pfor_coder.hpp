@@ -0,0 +1,177 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file pfor_coder.hpp
+    \brief pfor_coder.hpp contains the class sdsl::coder::pfor
+	\author Simon Gog
+ */
+#ifndef SDSL_PFOR_CODER
+#define SDSL_PFOR_CODER
+
+#include "int_vector.hpp"
+#include "elias_delta_coder.hpp"
+
+namespace sdsl
+{
+
+namespace coder
+{
+
+//! A class to encode and decode integers in slots of fixed width with exceptions.
+/*! Each integer x is written into a slot of BitWidth bits. If x does not fit
+ *  into the slot, i.e. \f$ x \geq 2^{BitWidth}-1 \f$, the slot contains the
+ *  escape value \f$ 2^{BitWidth}-1 \f$ and is followed by the Elias-\f$\delta\f$
+ *  code of \f$ x-2^{BitWidth}+2 \f$ (the exception). This is the patching
+ *  scheme of PFor with a width which is fixed per instantiation instead of
+ *  per frame: the coders of the sdsl encode one value at a time.
+ *
+ *  BitWidth should be chosen such that most of the values fit into the slot;
+ *  these are decoded with one read and without bit-wise parsing.
+ *  Zero can be encoded.
+ *
+ *  \tparam BitWidth Width of a slot; 1 <= BitWidth <= 63.
+ */
+template<uint8_t BitWidth=8>
+class pfor
+{
+    public:
+        typedef uint64_t size_type;
+
+        static const uint64_t escape = (1ULL<<BitWidth)-1; //!< Slot value which marks an exception.
+        static const uint8_t min_codeword_length = BitWidth;
+
+        static uint8_t encoding_length(uint64_t);
+
+        //! Decode n encoded integers beginning at start_idx in the bitstring "data"
+        /* \param data Bitstring
+           \param start_idx Starting index of the decoding.
+           \param n Number of values to decode from the bitstring.
+           \param it Iterator to decode the values.
+         */
+        template<bool sumup, bool increment,class Iterator>
+        static uint64_t decode(const uint64_t* data, const size_type start_idx, size_type n, Iterator it=(Iterator)NULL);
+
+        //! Decode n encoded integers beginning at start_idx in the bitstring "data" and return the sum of these values.
+        static uint64_t decode_prefix_sum(const uint64_t* data, const size_type start_idx, size_type n) {
+            return decode<true, false, int*>(data, start_idx, n);
+        }
+        static uint64_t decode_prefix_sum(const uint64_t* data, const size_type start_idx, const size_type, size_type n) {
+            return decode<true, false, int*>(data, start_idx, n);
+        }
+
+        template<class int_vector>
+        static bool encode(const int_vector& v, int_vector& z);
+        template<class int_vector>
+        static bool decode(const int_vector& z, int_vector& v);
+
+        //! Encode one integer x to an int_vector at bit position start_idx.
+        /* \param x Integer to encode.
+           \param z Raw data of vector to write the encoded form of x.
+           \param offset Bit offset in *z, where the encoded form of x starts.
+        */
+        static void encode(uint64_t x, uint64_t*& z, uint8_t& offset);
+
+        template<class int_vector>
+        static uint64_t* raw_data(int_vector& v) {
+            return v.m_data;
+        }
+};
+
+template<uint8_t BitWidth>
+inline uint8_t pfor<BitWidth>::encoding_length(uint64_t w)
+{
+    if (w < escape)
+        return BitWidth;
+    return BitWidth + elias_delta::encoding_length(w-escape+1);
+}
+
+template<uint8_t BitWidth>
+inline void pfor<BitWidth>::encode(uint64_t x, uint64_t*& z, uint8_t& offset)
+{
+    if (x < escape) {
+        bit_magic::write_int_and_move(z, x, offset, BitWidth);
+    } else {
+        bit_magic::write_int_and_move(z, escape, offset, BitWidth);
+        elias_delta::encode(x-escape+1, z, offset);
+    }
+}
+
+template<uint8_t BitWidth>
+template<class int_vector>
+bool pfor<BitWidth>::encode(const int_vector& v, int_vector& z)
+{
+    typedef typename int_vector::size_type size_type;
+    z.set_int_width(v.get_int_width());
+    size_type z_bit_size = 0;
+    for (typename int_vector::const_iterator it = v.begin(), end = v.end(); it != end; ++it) {
+        z_bit_size += encoding_length(*it);
+    }
+    z.bit_resize(z_bit_size);   // Initial size of z
+    if (z_bit_size & 0x3F) { // if z_bit_size % 64 != 0
+        *(z.m_data + (z_bit_size>>6)) = 0; // initialize last word
+    }
+    uint64_t* z_data = z.m_data;
+    uint8_t offset = 0;
+    for (typename int_vector::const_iterator it = v.begin(), end=v.end(); it != end; ++it) {
+        encode(*it, z_data, offset);
+    }
+    return true;
+}
+
+template<uint8_t BitWidth>
+template<class int_vector>
+bool pfor<BitWidth>::decode(const int_vector& z, int_vector& v)
+{
+    typename int_vector::size_type n = 0, pos = 0;
+    while (pos < z.bit_size()) {
+        uint64_t x = bit_magic::read_int(z.data()+(pos>>6), pos&0x3F, BitWidth);
+        pos += BitWidth;
+        if (x == escape)
+            pos += elias_delta::encoding_length(elias_delta::decode<false, false, int*>(z.data(), pos, 1));
+        ++n;
+    }
+    v.set_int_width(z.get_int_width());
+    v.resize(n);
+    return decode<false, true>(z.data(), 0, n, v.begin());
+}
+
+template<uint8_t BitWidth>
+template<bool sumup, bool increment, class Iterator>
+inline uint64_t pfor<BitWidth>::decode(const uint64_t* data, const size_type start_idx, size_type n, Iterator it)
+{
+    uint64_t value = 0;
+    size_type pos = start_idx;
+    for (size_type i=0; i < n; ++i) {
+        uint64_t x = bit_magic::read_int(data+(pos>>6), pos&0x3F, BitWidth);
+        pos += BitWidth;
+        if (x == escape) { // exception
+            uint64_t y = elias_delta::decode<false, false, int*>(data, pos, 1);
+            pos += elias_delta::encoding_length(y);
+            x = y + escape - 1;
+        }
+        if (sumup)
+            value += x;
+        else
+            value = x;
+        if (increment) *(it++) = value;
+    }
+    return value;
+}
+
+} // end namespace coder
+} // end namespace sdsl
+
+#endif
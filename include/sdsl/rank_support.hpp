@@ -64,6 +64,14 @@ class rank_support
         	\sa init
          */
         virtual const size_type rank(size_type i) const = 0;
+        //! Answers n independent rank queries.
+        /*! \param idx Array of n arguments.
+            \param n   Number of queries.
+            \param out Array of size n, which contains rank(idx[k]) at position k afterwards.
+            \note Subclasses overlap the cache misses of the queries by prefetching,
+                  which pays off for large bit_vectors and random arguments.
+         */
+        virtual void rank(const size_type* idx, size_type n, size_type* out) const;
         //! Alias for rank(i)
         virtual const size_type operator()(size_type idx) const = 0;
         //! Serializes rank_support.
@@ -93,6 +101,23 @@ inline rank_support::rank_support(const rank_support& rs)
     m_v = rs.m_v;
 }
 
+inline void rank_support::rank(const size_type* idx, size_type n, size_type* out) const
+{
+    for (size_type k=0; k < n; ++k) {
+        out[k] = rank(idx[k]);
+    }
+}
+
+//! Number of queries which are prefetched ahead by the batch versions of rank and select.
+const int_vector<1>::size_type batch_prefetch_distance = 16;
+
+//! Loads the data which is needed by rs.rank(idx) into the cache.
+/*! Used by the batch queries of the wavelet trees. This version does
+ *  nothing; there are overloads for rank supports which can prefetch.
+ */
+template<class RankSupport>
+inline void prefetch_rank(const RankSupport&, typename RankSupport::size_type) {}
+
 }// end namespace sdsl
 
 #include "rank_support_v.hpp"
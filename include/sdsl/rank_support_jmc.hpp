@@ -46,6 +46,7 @@ class rank_support_jmc : public rank_support
         rank_support_jmc(const rank_support_jmc& rs);
         ~rank_support_jmc();
         void init(const int_vector<1>* v=NULL);
+        using rank_support::rank; // batch version
         inline const size_type rank(size_type idx) const;
         inline const size_type operator()(size_type idx)const;
         size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
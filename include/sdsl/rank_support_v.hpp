@@ -22,6 +22,8 @@
 #define INCLUDED_SDSL_RANK_SUPPORT_V
 
 #include "rank_support.hpp"
+#include "parallel.hpp"
+#include <vector>
 
 //! Namespace for the succinct data structure library.
 namespace sdsl
@@ -140,6 +142,54 @@ struct rank_support_v_trait<01,2> {
     }
 };
 
+//! Initializes the superblocks [begin..end-1] of rank_support_v in parallel_for.
+/*! In the first pass each superblock entry gets the number of arguments in
+ *  the superblock and the block counts, in the second pass (prefix=true)
+ *  the superblock entries are replaced by prefix sums.
+ */
+template<uint8_t b, uint8_t pattern_len>
+struct rank_support_v_init_task {
+    typedef rank_support::size_type size_type;
+    const bit_vector*     v;
+    int_vector<64>&       basic_block;
+    bool                  prefix;
+    std::vector<uint64_t> range_sum; // arguments in the ranges 0..thread after the first pass
+
+    rank_support_v_init_task(const bit_vector* f_v, int_vector<64>& f_basic_block):
+        v(f_v), basic_block(f_basic_block), prefix(false), range_sum(util::thread_count()+1, 0) {}
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+        if (prefix) {
+            uint64_t sum = thread ? range_sum[thread-1] : 0;
+            for (uint64_t i=begin; i < end; ++i) {
+                uint64_t cnt = basic_block[i<<1];
+                basic_block[i<<1] = sum;
+                sum += cnt;
+            }
+            return;
+        }
+        const uint64_t* data = v->data();
+        size_type words = v->capacity()>>6;
+        uint64_t range_cnt = 0;
+        for (uint64_t i=begin; i < end; ++i) {
+            size_type first = i<<3, m = std::min((size_type)8, words - std::min(words, first)); // words in superblock i
+            uint64_t carry = first ? (data[first-1]>>63) : rank_support_v_trait<b, pattern_len>::init_carry();
+            uint64_t sum = 0, second_level_cnt = 0;
+            for (size_type k=0; k < m; ++k) {
+                if (k > 0)
+                    second_level_cnt |= sum<<(63-9*k);//  54, 45, 36, 27, 18, 9, 0
+                sum += rank_support_v_trait<b, pattern_len>::args_in_the_word(data[first+k], carry);
+            }
+            if (m > 0 and m < 8)
+                second_level_cnt |= sum<<(63-9*m);
+            basic_block[i<<1]     = sum;
+            basic_block[(i<<1)+1] = second_level_cnt;
+            range_cnt += sum;
+        }
+        range_sum[thread] = range_cnt;
+    }
+};
+
 //! A class supporting rank queries in constant time. The implementation is a version of the data structure proposed by Vigna (WEA 2008).
 /*! \par Space complexity
  *  \f$ 0.25n\f$ for a bit vector of length n bits.
@@ -167,12 +217,33 @@ class rank_support_v : public rank_support
         ~rank_support_v();
         void init(const bit_vector* v=NULL);
         const size_type rank(size_type idx) const;
+        void rank(const size_type* idx, size_type n, size_type* out) const;
+        //! Loads the data which is needed by rank(idx) into the cache.
+        void prefetch(size_type idx) const;
         const size_type operator()(size_type idx)const;
         const size_type size()const;
         size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
         void load(std::istream& in, const int_vector<1>* v=NULL);
         void set_vector(const bit_vector* v=NULL);
 
+        //! Number of bits which are covered by one superblock counter.
+        static const size_type superblock_size = 512;
+        //! Number of arguments in the prefix [0..i*superblock_size-1] of the supported bit_vector.
+        /*! \param i Superblock index in \f$[0..size()/superblock\_size]\f$.
+         */
+        const size_type superblock_rank(size_type i)const {
+            return m_basic_block[i<<1];
+        }
+        //! Position of the j-th argument in superblock i.
+        /*! \param i          Superblock index.
+         *  \param j          Argument in \f$[1..\f$ number of arguments in superblock i\f$]\f$.
+         *  \param complement If true, the position of the j-th bit which is not an argument
+         *                    is returned (e.g. the j-th 0-bit for rank_support_v<1>).
+         *  \pre pattern_len == 1
+         *  \sa select_support_rank
+         */
+        const size_type superblock_select(size_type i, size_type j, bool complement=false)const;
+
         //! Assign Operator
         /*! Required for the Assignable Concept of the STL.
          */
@@ -239,32 +310,14 @@ inline void rank_support_v<b, pattern_len>::init(const bit_vector* v)
     m_basic_block.resize(basic_block_size);   // resize structure for basic_blocks
     if (m_basic_block.empty())
         return;
-    const uint64_t* data = m_v->data();
-    size_type i, j=0;
-    m_basic_block[0] = m_basic_block[1] = 0;
-
-    uint64_t carry = rank_support_v_trait<b, pattern_len>::init_carry();
-    uint64_t sum = rank_support_v_trait<b, pattern_len>::args_in_the_word(*data, carry), second_level_cnt = 0;
-    for (i = 1; i < (m_v->capacity()>>6) ; ++i) {
-        if (!(i&0x7)) {// if i%8==0
-            j += 2;
-            m_basic_block[j-1] = second_level_cnt;
-            m_basic_block[j] 	= m_basic_block[j-2] + sum;
-            second_level_cnt = sum = 0;
-        } else {
-            second_level_cnt |= sum<<(63-9*(i&0x7));//  54, 45, 36, 27, 18, 9, 0
-        }
-        sum += rank_support_v_trait<b, pattern_len>::args_in_the_word(*(++data), carry);
-    }
-    if (i&0x7) { // if i%8 != 0
-        second_level_cnt |= sum << (63-9*(i&0x7));
-        m_basic_block[j+1] = second_level_cnt;
-    } else { // if i%8 == 0
-        j += 2;
-        m_basic_block[j-1] = second_level_cnt;
-        m_basic_block[j]   = m_basic_block[j-2] + sum;
-        m_basic_block[j+1] = 0;
+    // the superblocks are counted in parallel, then the counts are turned into prefix sums
+    rank_support_v_init_task<b, pattern_len> task(m_v, m_basic_block);
+    parallel_for(basic_block_size>>1, task, 1, 1ULL<<12);
+    for (size_type t=1; t < task.range_sum.size(); ++t) {
+        task.range_sum[t] += task.range_sum[t-1];
     }
+    task.prefix = true;
+    parallel_for(basic_block_size>>1, task, 1, 1ULL<<12);
 }
 
 template<uint8_t b, uint8_t pattern_len>
@@ -279,6 +332,54 @@ inline const typename rank_support_v<b, pattern_len>::size_type rank_support_v<b
 }
 
 
+template<uint8_t b, uint8_t pattern_len>
+inline void rank_support_v<b, pattern_len>::prefetch(size_type idx)const
+{
+    __builtin_prefetch(m_basic_block.data() + ((idx>>8)&0xFFFFFFFFFFFFFFFEULL));
+    __builtin_prefetch(m_v->data() + (idx>>6));
+}
+
+template<uint8_t b, uint8_t pattern_len>
+inline void prefetch_rank(const rank_support_v<b, pattern_len>& rs, typename rank_support_v<b, pattern_len>::size_type idx)
+{
+    rs.prefetch(idx);
+}
+
+template<uint8_t b, uint8_t pattern_len>
+void rank_support_v<b, pattern_len>::rank(const size_type* idx, size_type n, size_type* out)const
+{
+    for (size_type k=0; k < n and k < batch_prefetch_distance; ++k) {
+        prefetch(idx[k]);
+    }
+    for (size_type k=0; k < n; ++k) {
+        if (k+batch_prefetch_distance < n) {
+            prefetch(idx[k+batch_prefetch_distance]);
+        }
+        out[k] = rank(idx[k]);
+    }
+}
+
+template<uint8_t b, uint8_t pattern_len>
+inline const typename rank_support_v<b, pattern_len>::size_type rank_support_v<b, pattern_len>::superblock_select(size_type i, size_type j, bool complement)const
+{
+    uint64_t block_cnts = m_basic_block[(i<<1)+1];
+    size_type blocks = std::min((size_type)8, (m_v->capacity()>>6) - (i<<3)); // words in superblock i
+    size_type k = 0, cnt = 0; // cnt = arguments in the blocks before block k
+    while (k+1 < blocks) {
+        size_type next = (block_cnts>>(63-9*(k+1)))&0x1FF;
+        if (complement)
+            next = ((k+1)<<6) - next;
+        if (next >= j)
+            break;
+        cnt = next;
+        ++k;
+    }
+    uint64_t w = m_v->data()[(i<<3)+k];
+    if ((b==1) == complement)
+        w = ~w;
+    return (i<<9) + (k<<6) + bit_magic::i1BP(w, j-cnt);
+}
+
 template<uint8_t b, uint8_t pattern_len>
 inline const typename rank_support_v<b, pattern_len>::size_type rank_support_v<b, pattern_len>::operator()(size_type idx)const
 {
@@ -23,6 +23,8 @@
 
 #include "rank_support.hpp"
 #include "rank_support_v.hpp"
+#include "parallel.hpp"
+#include <vector>
 
 //! Namespace for the succinct data structure library.
 namespace sdsl
@@ -31,6 +33,53 @@ namespace sdsl
 template<uint8_t, uint8_t>
 struct rank_support_v_trait;
 
+//! Initializes the superblocks [begin..end-1] of rank_support_v5 in parallel_for.
+/*! \sa rank_support_v_init_task
+ */
+template<uint8_t b, uint8_t pattern_len>
+struct rank_support_v5_init_task {
+    typedef rank_support::size_type size_type;
+    const bit_vector*     v;
+    int_vector<64>&       basic_block;
+    bool                  prefix;
+    std::vector<uint64_t> range_sum; // arguments in the ranges 0..thread after the first pass
+
+    rank_support_v5_init_task(const bit_vector* f_v, int_vector<64>& f_basic_block):
+        v(f_v), basic_block(f_basic_block), prefix(false), range_sum(util::thread_count()+1, 0) {}
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+        if (prefix) {
+            uint64_t sum = thread ? range_sum[thread-1] : 0;
+            for (uint64_t i=begin; i < end; ++i) {
+                uint64_t cnt = basic_block[i<<1];
+                basic_block[i<<1] = sum;
+                sum += cnt;
+            }
+            return;
+        }
+        const uint64_t* data = v->data();
+        size_type words = v->capacity()>>6;
+        uint64_t range_cnt = 0;
+        for (uint64_t i=begin; i < end; ++i) {
+            size_type first = i<<5, m = std::min((size_type)32, words - std::min(words, first)); // words in superblock i
+            uint64_t carry = first ? (data[first-1]>>63) : rank_support_v_trait<b, pattern_len>::init_carry();
+            uint64_t sum = 0, second_level_cnt = 0;
+            for (size_type k=0; k < m; ++k) {
+                if (k > 0 and (k%6) == 0)
+                    // pack the prefix sum for each 6x64bit block into the second_level_cnt
+                    second_level_cnt |= sum<<(60-12*(k/6));//  48, 36, 24, 12, 0
+                sum += rank_support_v_trait<b, pattern_len>::args_in_the_word(data[first+k], carry);
+            }
+            if (m > 0 and (m%6) == 0)
+                second_level_cnt |= sum<<(60-12*(m/6));
+            basic_block[i<<1]     = sum;
+            basic_block[(i<<1)+1] = second_level_cnt;
+            range_cnt += sum;
+        }
+        range_sum[thread] = range_cnt;
+    }
+};
+
 //! A class supporting rank queries in constant time. The implementation is a space saving version of the data structure proposed by Vigna (WEA 2008).
 /*! \par Space complexity
  *  \f$ 0.0625n\f$ bits for a bit vector of length n bits.
@@ -58,12 +107,33 @@ class rank_support_v5 : public rank_support
         ~rank_support_v5();
         void init(const bit_vector* v=NULL);
         const size_type rank(size_type idx) const;
+        void rank(const size_type* idx, size_type n, size_type* out) const;
+        //! Loads the data which is needed by rank(idx) into the cache.
+        void prefetch(size_type idx) const;
         const size_type operator()(size_type idx)const;
         const size_type size()const;
         size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
         void load(std::istream& in, const bit_vector* v=NULL);
         void set_vector(const bit_vector* v=NULL);
 
+        //! Number of bits which are covered by one superblock counter.
+        static const size_type superblock_size = 2048;
+        //! Number of arguments in the prefix [0..i*superblock_size-1] of the supported bit_vector.
+        /*! \param i Superblock index in \f$[0..size()/superblock\_size]\f$.
+         */
+        const size_type superblock_rank(size_type i)const {
+            return m_basic_block[i<<1];
+        }
+        //! Position of the j-th argument in superblock i.
+        /*! \param i          Superblock index.
+         *  \param j          Argument in \f$[1..\f$ number of arguments in superblock i\f$]\f$.
+         *  \param complement If true, the position of the j-th bit which is not an argument
+         *                    is returned (e.g. the j-th 0-bit for rank_support_v5<1>).
+         *  \pre pattern_len == 1
+         *  \sa select_support_rank
+         */
+        const size_type superblock_select(size_type i, size_type j, bool complement=false)const;
+
         //! Assign Operator
         /*! Required for the Assignable Concept of the STL.
          */
@@ -116,39 +186,14 @@ inline void rank_support_v5<b, pattern_len>::init(const bit_vector* v)
     m_basic_block.resize(basic_block_size);   // resize structure for basic_blocks
     if (m_basic_block.empty())
         return;
-    const uint64_t* data = m_v->data();
-    size_type i, j=0;
-    m_basic_block[0] = m_basic_block[1] = 0;
-//	uint64_t carry = 0;
-
-    uint64_t carry = rank_support_v_trait<b, pattern_len>::init_carry();
-    uint64_t sum = rank_support_v_trait<b, pattern_len>::args_in_the_word(*data, carry), second_level_cnt = 0;
-    uint64_t cnt_words=1;
-    for (i = 1; i < (m_v->capacity()>>6) ; ++i, ++cnt_words) {
-        if (cnt_words == 32) {
-            j += 2;
-            m_basic_block[j-1] = second_level_cnt;
-            m_basic_block[j] 	= m_basic_block[j-2] + sum;
-            second_level_cnt = sum = cnt_words = 0;
-        } else if ((cnt_words%6)==0) {
-            // pack the prefix sum for each 6x64bit block into the second_level_cnt
-            second_level_cnt |= sum<<(60-12*(cnt_words/6));//  48, 36, 24, 12, 0
-        }
-        sum += rank_support_v_trait<b, pattern_len>::args_in_the_word(*(++data), carry);
-    }
-
-    if ((cnt_words%6)==0) {
-        second_level_cnt |= sum<<(60-12*(cnt_words/6));
-    }
-    if (cnt_words == 32) {
-        j += 2;
-        m_basic_block[j-1] = second_level_cnt;
-        m_basic_block[j]   = m_basic_block[j-2] + sum;
-        m_basic_block[j+1] = 0;
-    } else {
-        m_basic_block[j+1] = second_level_cnt;
+    // the superblocks are counted in parallel, then the counts are turned into prefix sums
+    rank_support_v5_init_task<b, pattern_len> task(m_v, m_basic_block);
+    parallel_for(basic_block_size>>1, task, 1, 1ULL<<10);
+    for (size_type t=1; t < task.range_sum.size(); ++t) {
+        task.range_sum[t] += task.range_sum[t-1];
     }
-
+    task.prefix = true;
+    parallel_for(basic_block_size>>1, task, 1, 1ULL<<10);
 }
 
 template<uint8_t b, uint8_t pattern_len>
@@ -173,6 +218,60 @@ inline const typename rank_support_v5<b, pattern_len>::size_type rank_support_v5
 }
 
 
+template<uint8_t b, uint8_t pattern_len>
+inline void rank_support_v5<b, pattern_len>::prefetch(size_type idx)const
+{
+    __builtin_prefetch(m_basic_block.data() + ((idx>>10)&0xFFFFFFFFFFFFFFFEULL));
+    __builtin_prefetch(m_v->data() + (idx>>6));
+}
+
+template<uint8_t b, uint8_t pattern_len>
+inline void prefetch_rank(const rank_support_v5<b, pattern_len>& rs, typename rank_support_v5<b, pattern_len>::size_type idx)
+{
+    rs.prefetch(idx);
+}
+
+template<uint8_t b, uint8_t pattern_len>
+void rank_support_v5<b, pattern_len>::rank(const size_type* idx, size_type n, size_type* out)const
+{
+    for (size_type k=0; k < n and k < batch_prefetch_distance; ++k) {
+        prefetch(idx[k]);
+    }
+    for (size_type k=0; k < n; ++k) {
+        if (k+batch_prefetch_distance < n) {
+            prefetch(idx[k+batch_prefetch_distance]);
+        }
+        out[k] = rank(idx[k]);
+    }
+}
+
+template<uint8_t b, uint8_t pattern_len>
+inline const typename rank_support_v5<b, pattern_len>::size_type rank_support_v5<b, pattern_len>::superblock_select(size_type i, size_type j, bool complement)const
+{
+    uint64_t block_cnts = m_basic_block[(i<<1)+1];
+    size_type words = std::min((size_type)32, (m_v->capacity()>>6) - (i<<5)); // words in superblock i
+    size_type k = 0, cnt = 0; // cnt = arguments in the blocks of 6 words before block k
+    while (6*(k+1) < words) {
+        size_type next = (block_cnts>>(60-12*(k+1)))&0x7FF;
+        if (complement)
+            next = 384*(k+1) - next;
+        if (next >= j)
+            break;
+        cnt = next;
+        ++k;
+    }
+    const uint64_t* data = m_v->data() + (i<<5) + 6*k;
+    for (size_type l=0; ; ++l, ++data) {
+        uint64_t w = *data;
+        if ((b==1) == complement)
+            w = ~w;
+        size_type word_cnt = bit_magic::b1Cnt(w);
+        if (cnt + word_cnt >= j or 6*k+l+1 == words)
+            return (i<<11) + ((6*k+l)<<6) + bit_magic::i1BP(w, j-cnt);
+        cnt += word_cnt;
+    }
+}
+
 template<uint8_t b, uint8_t pattern_len>
 inline const typename rank_support_v5<b, pattern_len>::size_type rank_support_v5<b, pattern_len>::operator()(size_type idx)const
 {
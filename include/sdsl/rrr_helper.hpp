@@ -384,6 +384,50 @@ class rrr_helper
             return result + ((n-nr-1) < off);
         }
 
+        //! Decode the block encoded by the pair (k, nr).
+        /*! \return The block; bit i of the result is the bit at position i of the block.
+         */
+        static inline number_type decode_int(uint16_t k, number_type nr) {
+            if (k == n) {  // if n==k, then the encoded block consists only of ones
+                return binomial::data.L1Mask[n];
+            } else if (k == 0) { // if k==0 then the encoded block consists only of zeros
+                return 0;
+            }
+            number_type bin = 0;
+            uint16_t nn = n;
+            // if k < n \log n, it is better to do a binary search for each of the on bits
+            if (k < binomial::data.BINARY_SEARCH_THRESHOLD) {
+                while (k > 1) {
+                    uint16_t nn_lb = k, nn_rb = nn+1; // invariant nr >= binomial::data.table[nn_lb-1][k]
+                    while (nn_lb < nn_rb) {
+                        uint16_t nn_mid = (nn_lb + nn_rb) / 2;
+                        if (nr >= binomial::data.table[nn_mid-1][k]) {
+                            nn_lb = nn_mid+1;
+                        } else {
+                            nn_rb = nn_mid;
+                        }
+                    }
+                    nn = nn_lb-1;
+                    bin |= binomial::data.O1Mask[n-nn];
+                    nr -= binomial::data.table[nn-1][k];
+                    --k;
+                    --nn;
+                }
+            } else { // else do a linear decoding
+                int i = 0;
+                while (k > 1) {
+                    if (nr >= binomial::data.table[nn-1][k]) {
+                        nr -= binomial::data.table[nn-1][k];
+                        --k;
+                        bin |= binomial::data.O1Mask[i];
+                    }
+                    --nn;
+                    ++i;
+                }
+            }
+            return bin | binomial::data.O1Mask[n-nr-1]; // the last one bit
+        }
+
         /*! \pre k >= sel, sel>0
          */
         static inline uint16_t decode_select(uint16_t k, number_type& nr, uint16_t sel) {
@@ -102,6 +102,8 @@ class rrr_vector
         }
 
     public:
+        class block_reader;
+
         const wt_type& bt;
         const bit_vector& btnr;
 
@@ -197,6 +199,11 @@ class rrr_vector
                 }
                 btnr_pos += space_for_bt;
             }
+            if (i < bt_array.size() and (i % m_sample_rate) == (size_type)0) { // the empty block after the last full block starts a new sample
+                m_btnrp[ i/m_sample_rate ] = btnr_pos;
+                m_rank[ i/m_sample_rate ] = sum_rank;
+                m_invert[ i/m_sample_rate ] = 0;
+            }
             // for technical reasons add an additional element to m_rank
             m_rank[ m_rank.size()-1 ] = sum_rank; // sum_rank contains the total number of set bits in bv
             util::assign(m_bt, bt_array);
@@ -292,6 +299,89 @@ class rrr_vector
         }
 };
 
+//! Creates the select hints of the select supports of rrr_vector.
+/*! hint[k] is the index of the last rank sample before the (k*hint_rate+1)-th
+ *  argument, i.e. the binary search for the i-th argument can be restricted
+ *  to the rank samples hint[(i-1)/hint_rate]..hint[(i-1)/hint_rate+1]+1.
+ *  The hint rate is chosen such that a hint covers about 8 rank samples.
+ *  \param rank            The rank samples of the rrr_vector.
+ *  \param bits_per_sample Number of bits between two rank samples.
+ *  \param size            Size of the rrr_vector.
+ *  \tparam b              1 for the hints of select1, 0 for select0.
+ */
+template<uint8_t b>
+void rrr_select_hints(const int_vector<>& rank, bit_vector::size_type bits_per_sample, bit_vector::size_type size,
+                      int_vector<>& hint, bit_vector::size_type& hint_rate)
+{
+    typedef bit_vector::size_type size_type;
+    size_type samples = rank.size()-1;
+    size_type args = b ? rank[samples] : size - rank[samples];
+    hint_rate = samples ? (args*8 + samples-1)/samples : 1;
+    if (hint_rate == 0)
+        hint_rate = 1;
+    size_type hints = (args + hint_rate-1)/hint_rate;
+    hint = int_vector<>(hints, 0, bit_magic::l1BP(samples)+1);
+    for (size_type s=0, k=0; s < samples and k < hints; ++s) {
+        size_type end_args = b ? rank[s+1] : std::min((s+1)*bits_per_sample, size) - rank[s+1];
+        while (k < hints and k*hint_rate+1 <= end_args) {
+            hint[k++] = s;
+        }
+    }
+}
+
+//! Reads the blocks of a rrr_vector one after another.
+/*! Only blocks which are neither empty nor full are decoded, see bits().
+ *  After the last block, empty blocks are returned.
+ */
+template<uint16_t block_size, class wt_type>
+class rrr_vector<block_size, wt_type>::block_reader
+{
+    public:
+        typedef typename rrr_vector::number_type value_type;
+        typedef typename rrr_vector::size_type   size_type;
+    private:
+        const rrr_vector* m_v;
+        size_type m_idx;   // index of the current block
+        size_type m_btnrp; // pointer to the block type number of the current block
+        uint16_t  m_ones;  // number of ones in the current block
+
+        void read_block_type() {
+            if (m_idx < m_v->m_bt.size()) {
+                m_ones = m_v->m_bt[m_idx];
+                if (m_v->m_invert[m_idx/m_v->m_sample_rate])
+                    m_ones = block_size - m_ones;
+            } else {
+                m_ones = 0;
+            }
+        }
+    public:
+        explicit block_reader(const rrr_vector* v):m_v(v), m_idx(0), m_btnrp(0) {
+            read_block_type();
+        }
+
+        //! Number of ones in the current block.
+        uint16_t ones()const {
+            return m_ones;
+        }
+
+        //! The current block; bit j of the result is bit j of the block.
+        value_type bits()const {
+            if (m_ones == 0 or m_ones == block_size)
+                return rrr_helper_type::decode_int(m_ones, 0);
+            uint16_t len = rrr_helper_type::space_for_bt(m_ones);
+            return rrr_helper_type::decode_int(m_ones, rrr_helper_type::decode_btnr(m_v->m_btnr, m_btnrp, len));
+        }
+
+        //! Moves to the next block.
+        void next() {
+            if (m_idx < m_v->m_bt.size()) {
+                m_btnrp += rrr_helper_type::space_for_bt(m_ones);
+                ++m_idx;
+                read_block_type();
+            }
+        }
+};
+
 template<uint8_t bit_pattern>
 struct rrr_rank_support_trait {
     typedef bit_vector::size_type size_type;
@@ -445,6 +535,10 @@ class rrr_rank_support
 
 
 //! Select support for the rrr_vector class.
+/*! The binary search in the rank samples of the rrr_vector is restricted by
+ *  select hints (see rrr_select_hints), which take about 1/8 of the space
+ *  of the rank samples. Blocks of at most 64 bits are decoded at once.
+ */
 template< uint8_t b, uint16_t block_size, class wt_type>
 class rrr_select_support
 {
@@ -457,12 +551,22 @@ class rrr_select_support
     private:
         const bit_vector_type* m_v; //!< Pointer to the rank supported rrr_vector
         uint16_t m_sample_rate;  //!<    "     "   "      "
+        int_vector<> m_hint;     // select hints, see rrr_select_hints
+        size_type    m_hint_rate;
+
+        // Returns the rank samples begin and end, between which the binary search for the i-th argument is done.
+        void hint_range(size_type i, size_type& begin, size_type& end)const {
+            size_type k = (i-1)/m_hint_rate;
+            begin = m_hint[k];
+            end   = (k+1 < m_hint.size()) ? m_hint[k+1]+1 : m_v->m_rank.size()-1;
+        }
 
         size_type select1(size_type i)const {
             if (m_v->m_rank[m_v->m_rank.size()-1] < i)
                 return size();
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            size_type begin, end; // min included, max excluded
+            hint_range(i, begin, end);
             size_type idx, rank;
             // invariant:  m_rank[end] >= i
             //             m_rank[begin] < i
@@ -492,16 +596,19 @@ class rrr_select_support
             }
             rank -= bt;
             number_type	btnr = rrr_helper_type::decode_btnr(m_v->m_btnr, btnrp-btnrlen, btnrlen);
+            if (block_size <= 64) { // decode the block at once
+                return (idx-1) * block_size + bit_magic::i1BP((uint64_t)rrr_helper_type::decode_int(bt, btnr), i-rank);
+            }
             return (idx-1) * block_size + rrr_helper_type::decode_select(bt, btnr, i-rank);
         }
 
         size_type  select0(size_type i)const {
             if ((size() - m_v->m_rank[m_v->m_rank.size()-1]) < i) {
-//				std::cout<<"i="<<i<<" size()-m_v->m_rank[m_v->m_rank.size()-1] = " << m_v->m_rank[m_v->m_rank.size()-1]<< std::endl;
                 return size();
             }
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            size_type begin, end; // min included, max excluded
+            hint_range(i, begin, end);
             size_type idx, rank;
             // invariant:  m_rank[end] >= i
             //             m_rank[begin] < i
@@ -530,6 +637,10 @@ class rrr_select_support
             }
             rank -= (block_size-bt);
             number_type	btnr = rrr_helper_type::decode_btnr(m_v->m_btnr, btnrp-btnrlen, btnrlen);
+            if (block_size <= 64) { // decode the block at once
+                uint64_t zeros = ~(uint64_t)rrr_helper_type::decode_int(bt, btnr) & bit_magic::Li1Mask[block_size];
+                return (idx-1) * block_size + bit_magic::i1BP(zeros, i-rank);
+            }
             return (idx-1) * block_size + rrr_helper_type::template decode_select_bitpattern<0, 1>(bt, btnr, i-rank);
         }
 
@@ -540,8 +651,15 @@ class rrr_select_support
             init(v);
         }
 
+        //! Initialize the data structure with a rrr_vector, which should be supported, and create the select hints.
         void init(const bit_vector_type* v=NULL) {
             set_vector(v);
+            if (m_v != NULL) {
+                rrr_select_hints<b>(m_v->m_rank, (size_type)block_size*m_sample_rate, m_v->size(), m_hint, m_hint_rate);
+            } else {
+                m_hint = int_vector<>();
+                m_hint_rate = 1;
+            }
         }
 
         //! Answers select queries
@@ -571,6 +689,8 @@ class rrr_select_support
             if (this != &rs) {
                 set_vector(rs.m_v);
                 m_sample_rate = rs.m_sample_rate;
+                m_hint        = rs.m_hint;
+                m_hint_rate   = rs.m_hint_rate;
             }
             return *this;
         }
@@ -578,13 +698,15 @@ class rrr_select_support
         void swap(rrr_select_support& rs) {
             if (this != &rs) {
                 std::swap(m_sample_rate, rs.m_sample_rate);
+                m_hint.swap(rs.m_hint);
+                std::swap(m_hint_rate, rs.m_hint_rate);
             }
         }
 
         bool operator==(const rrr_select_support& rs)const {
             if (this == &rs)
                 return true;
-            return m_sample_rate == rs.m_sample_rate;
+            return m_sample_rate == rs.m_sample_rate and m_hint_rate == rs.m_hint_rate and m_hint == rs.m_hint;
         }
 
         bool operator!=(const rrr_select_support& rs)const {
@@ -594,6 +716,8 @@ class rrr_select_support
 
         void load(std::istream& in, const bit_vector_type* v=NULL) {
             util::read_member(m_sample_rate, in);
+            util::read_member(m_hint_rate, in);
+            m_hint.load(in);
             set_vector(v);
         }
 
@@ -601,6 +725,8 @@ class rrr_select_support
             structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
             size_type written_bytes = 0;
             written_bytes += util::write_member(m_sample_rate, out, child, "sample_rate");
+            written_bytes += util::write_member(m_hint_rate, out, child, "hint_rate");
+            written_bytes += m_hint.serialize(out, child, "hint");
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
         }
@@ -188,6 +188,8 @@ class rrr_vector<15, wt_type>
             m_rank = rrr.m_rank;
         }
     public:
+        class block_reader;
+
         const wt_type& bt;
         const bit_vector& btnr;
 
@@ -258,6 +260,10 @@ class rrr_vector<15, wt_type>
                 }
                 btnr_pos += space_for_bt;
             }
+            if (i < bt_array.size() and (i % m_sample_rate) == 0) { // the empty block after the last full block starts a new sample
+                m_btnrp[ i/m_sample_rate ] = btnr_pos;
+                m_rank[ i/m_sample_rate ] = sum_rank;
+            }
             // for technical reasons add an additional element to m_rank
             m_rank[ m_rank.size()-1 ] = sum_rank; // sum_rank contains the total number of set bits in bv
             util::assign(m_bt, bt_array);
@@ -365,6 +371,49 @@ class rrr_vector<15, wt_type>
 };
 
 
+//! Reads the blocks of the specialized rrr_vector class of block size 15 one after another.
+template<class wt_type>
+class rrr_vector<15, wt_type>::block_reader
+{
+    public:
+        typedef uint32_t value_type;
+        typedef typename rrr_vector::size_type size_type;
+    private:
+        const rrr_vector* m_v;
+        size_type m_idx;   // index of the current block
+        size_type m_btnrp; // pointer to the block type number of the current block
+        uint16_t  m_ones;  // number of ones in the current block
+
+        void read_block_type() {
+            m_ones = (m_idx < m_v->m_bt.size()) ? m_v->m_bt[m_idx] : 0;
+        }
+    public:
+        explicit block_reader(const rrr_vector* v):m_v(v), m_idx(0), m_btnrp(0) {
+            read_block_type();
+        }
+
+        //! Number of ones in the current block.
+        uint16_t ones()const {
+            return m_ones;
+        }
+
+        //! The current block; bit j of the result is bit j of the block.
+        value_type bits()const {
+            if (m_ones == 0 or m_ones == block_size)
+                return bi_type::nr_to_bin(m_ones, 0);
+            return bi_type::nr_to_bin(m_ones, m_v->m_btnr.get_int(m_btnrp, bi_type::space_for_bt(m_ones)));
+        }
+
+        //! Moves to the next block.
+        void next() {
+            if (m_idx < m_v->m_bt.size()) {
+                m_btnrp += bi_type::space_for_bt(m_ones);
+                ++m_idx;
+                read_block_type();
+            }
+        }
+};
+
 //! rank_support for the specialized rrr_vector class of block size 15.
 /*! The first template parameter is the bit pattern of size one.
  */
@@ -552,6 +601,10 @@ class rrr_rank_support<b, 15, wt_type>
 
 
 //! Select support for the specialized rrr_vector class of block size 15.
+/*! The binary search in the rank samples is restricted by select hints
+ *  (see rrr_select_hints) and the block types between the rank sample and
+ *  the answer are scanned two at a time.
+ */
 template<uint8_t b,class wt_type>
 class rrr_select_support<b, 15, wt_type>
 {
@@ -563,13 +616,57 @@ class rrr_select_support<b, 15, wt_type>
     private:
         const bit_vector_type* m_v; //!< Pointer to the rank supported rrr_vector
         uint16_t m_sample_rate;  //!<    "     "   "      "
+        int_vector<> m_hint;     // select hints, see rrr_select_hints
+        size_type    m_hint_rate;
+
+        // Returns the rank samples begin and end, between which the binary search for the i-th argument is done.
+        void hint_range(size_type i, size_type& begin, size_type& end)const {
+            size_type k = (i-1)/m_hint_rate;
+            begin = m_hint[k];
+            end   = (k+1 < m_hint.size()) ? m_hint[k+1]+1 : m_v->m_rank.size()-1;
+        }
+
+        // Scans the block types from block idx on until the block which contains the i-th
+        // argument (1 for arg_bit=1, 0 otherwise) is reached. rank is the number of arguments
+        // before block idx and btnrp the pointer to the block type number of block idx.
+        // Afterwards idx is the block which contains the i-th argument, bt its block type.
+        template<bool arg_bit>
+        void scan_blocks(size_type i, size_type& idx, size_type& rank, size_type& btnrp, uint8_t& bt)const {
+            const uint8_t* bt8 = (const uint8_t*)(m_v->m_bt.data());
+            if (idx%2 == 1) {
+                bt = bt8[idx/2]>>4;
+                size_type args = arg_bit ? bt : 15-bt;
+                if (rank + args >= i)
+                    return;
+                rank  += args;
+                btnrp += bi_type::space_for_bt(bt);
+                ++idx;
+            }
+            while (true) { // two blocks at once
+                uint8_t r = bt8[idx/2];
+                size_type args = arg_bit ? (r>>4)+(r&0x0F) : 30-(r>>4)-(r&0x0F);
+                if (rank + args >= i)
+                    break;
+                rank  += args;
+                btnrp += bi_type::space_for_bt_pair(r);
+                idx += 2;
+            }
+            bt = bt8[idx/2]&0x0F;
+            size_type args = arg_bit ? bt : 15-bt;
+            if (rank + args < i) {
+                rank  += args;
+                btnrp += bi_type::space_for_bt(bt);
+                bt = bt8[idx/2]>>4;
+                ++idx;
+            }
+        }
 
-        // TODO: hinted binary search
         size_type  select1(size_type i)const {
             if (m_v->m_rank[m_v->m_rank.size()-1] < i)
                 return size();
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            size_type begin, end; // min included, max excluded
+            hint_range(i, begin, end);
             size_type idx, rank;
             // invariant:  m_rank[end] >= i
             //             m_rank[begin] < i
@@ -590,23 +687,18 @@ class rrr_select_support<b, 15, wt_type>
                 return idx*bit_vector_type::block_size + i-rank -1;
             }
             size_type btnrp = m_v->m_btnrp[ begin ];
-            uint8_t bt = 0, s = 0; // temp variables for block_type and space for block type
-            while (i > rank) {
-                bt = m_v->m_bt[idx++];
-                rank += bt;
-                btnrp += (s=bi_type::space_for_bt(bt));
-            }
-            rank -= bt;
-            uint32_t btnr = m_v->m_btnr.get_int(btnrp-s, s);
-            return (idx-1) * bit_vector_type::block_size + bit_magic::i1BP(bi_type::nr_to_bin(bt, btnr), i-rank);
+            uint8_t bt = 0;
+            scan_blocks<true>(i, idx, rank, btnrp, bt);
+            uint32_t btnr = m_v->m_btnr.get_int(btnrp, bi_type::space_for_bt(bt));
+            return idx * bit_vector_type::block_size + bit_magic::i1BP(bi_type::nr_to_bin(bt, btnr), i-rank);
         }
 
-        // TODO: hinted binary search
         size_type  select0(size_type i)const {
             if ((size()-m_v->m_rank[m_v->m_rank.size()-1]) < i)
                 return size();
             //  (1) binary search for the answer in the rank_samples
-            size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
+            size_type begin, end; // min included, max excluded
+            hint_range(i, begin, end);
             size_type idx, rank;
             // invariant:  m_rank[end] >= i
             //             m_rank[begin] < i
@@ -626,15 +718,10 @@ class rrr_select_support<b, 15, wt_type>
                 return idx*bit_vector_type::block_size +  i-rank -1;
             }
             size_type btnrp = m_v->m_btnrp[ begin ];
-            uint8_t bt = 0, s = 0; // temp variables for block_type and space for block type
-            while (i > rank) {
-                bt = m_v->m_bt[idx++];
-                rank += (bit_vector_type::block_size-bt);
-                btnrp += (s=bi_type::space_for_bt(bt));
-            }
-            rank -= (bit_vector_type::block_size-bt);
-            uint32_t btnr = m_v->m_btnr.get_int(btnrp-s, s);
-            return (idx-1) * bit_vector_type::block_size + bit_magic::i1BP(~((uint64_t)bi_type::nr_to_bin(bt, btnr)), i-rank);
+            uint8_t bt = 0;
+            scan_blocks<false>(i, idx, rank, btnrp, bt);
+            uint32_t btnr = m_v->m_btnr.get_int(btnrp, bi_type::space_for_bt(bt));
+            return idx * bit_vector_type::block_size + bit_magic::i1BP(~((uint64_t)bi_type::nr_to_bin(bt, btnr)), i-rank);
         }
 
 
@@ -644,8 +731,15 @@ class rrr_select_support<b, 15, wt_type>
             init(v);
         }
 
+        //! Initialize the data structure with a rrr_vector, which should be supported, and create the select hints.
         void init(const bit_vector_type* v=NULL) {
             set_vector(v);
+            if (m_v != NULL) {
+                rrr_select_hints<b>(m_v->m_rank, (size_type)bit_vector_type::block_size*m_sample_rate, m_v->size(), m_hint, m_hint_rate);
+            } else {
+                m_hint = int_vector<>();
+                m_hint_rate = 1;
+            }
         }
 
         //! Answers select queries
@@ -675,6 +769,8 @@ class rrr_select_support<b, 15, wt_type>
             if (this != &rs) {
                 set_vector(rs.m_v);
                 m_sample_rate = rs.m_sample_rate;
+                m_hint        = rs.m_hint;
+                m_hint_rate   = rs.m_hint_rate;
             }
             return *this;
         }
@@ -682,13 +778,15 @@ class rrr_select_support<b, 15, wt_type>
         void swap(rrr_select_support& rs) {
             if (this != &rs) {
                 std::swap(m_sample_rate, rs.m_sample_rate);
+                m_hint.swap(rs.m_hint);
+                std::swap(m_hint_rate, rs.m_hint_rate);
             }
         }
 
         bool operator==(const rrr_select_support& rs)const {
             if (this == &rs)
                 return true;
-            return m_sample_rate == rs.m_sample_rate;
+            return m_sample_rate == rs.m_sample_rate and m_hint_rate == rs.m_hint_rate and m_hint == rs.m_hint;
         }
 
         bool operator!=(const rrr_select_support& rs)const {
@@ -698,6 +796,8 @@ class rrr_select_support<b, 15, wt_type>
 
         void load(std::istream& in, const bit_vector_type* v=NULL) {
             util::read_member(m_sample_rate, in);
+            util::read_member(m_hint_rate, in);
+            m_hint.load(in);
             set_vector(v);
         }
 
@@ -705,6 +805,8 @@ class rrr_select_support<b, 15, wt_type>
             structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
             size_type written_bytes = 0;
             written_bytes += util::write_member(m_sample_rate, out, child, "sample_rate");
+            written_bytes += util::write_member(m_hint_rate, out, child, "hint_rate");
+            written_bytes += m_hint.serialize(out, child, "hint");
             structure_tree::add_size(child, written_bytes);
             return written_bytes;
         }
@@ -26,6 +26,7 @@
 #include "select_support_mcl.hpp"
 #include "util.hpp"
 #include "bitmagic.hpp"
+#include <iterator> // for std::distance
 
 //! Namespace for the succinct data structure library
 namespace sdsl
@@ -101,7 +102,14 @@ class sd_vector
             m_high_0_select.set_vector(&m_high);
         }
 
+        // Position of the one with index rank (0-based), whose 1 in m_high is at high_pos
+        size_type value(size_type high_pos, size_type rank)const {
+            return ((high_pos - rank) << m_wl) | m_low[rank];
+        }
+
     public:
+        class cursor;
+
         const hi_bit_vector_type& high;
         const int_vector<>& low;
         const select_1_support_type&	 high_1_select;
@@ -150,6 +158,33 @@ class sd_vector
             util::init_support(m_high_0_select, &m_high);
         }
 
+        //! Constructs a sd_vector from the sorted positions of the ones.
+        /*! \param begin Iterator to the first position.
+         *  \param end   Iterator past the last position.
+         *  \param size  Length of the bit vector.
+         */
+        template<class Iterator>
+        sd_vector(Iterator begin, Iterator end, size_type size):high(m_high),low(m_low),
+            high_1_select(m_high_1_select), high_0_select(m_high_0_select) {
+            m_size = size;
+            size_type m = std::distance(begin, end);
+            uint8_t logm = bit_magic::l1BP(m)+1;
+            uint8_t logn = bit_magic::l1BP(m_size)+1;
+            if (logm == logn) {
+                --logm;    // to ensure logn-logm > 0
+            }
+            m_wl    = logn - logm;
+            m_low = int_vector<>(m, 0, m_wl);
+            bit_vector high = bit_vector(m + (1ULL<<logm), 0);
+            for (size_type i=0; begin != end; ++begin, ++i) {
+                m_low[i] = *begin; // int_vector truncates the most significant logm bits
+                high[(*begin >> m_wl) + i] = 1;
+            }
+            util::assign(m_high, high);
+            util::init_support(m_high_1_select, &m_high);
+            util::init_support(m_high_0_select, &m_high);
+        }
+
         //! Accessing the i-th element of the original bit_vector
         /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
         *   \return The i-th bit of the original bit_vector
@@ -177,6 +212,78 @@ class sd_vector
             return m_high[sel_high] and m_low[rank_low] == val_low;
         }
 
+        //! Returns the number of ones in the original bit_vector.
+        size_type ones()const {
+            return m_low.size();
+        }
+
+        //! Returns the smallest position p >= x with a one in the original bit_vector.
+        /*! \param x A position.
+         *  \return The position, or size() if there is no one at or after position x.
+         *  \par Time complexity
+         *        \f$ \Order{t_{select0} + t_{select1} + n/m} \f$
+         */
+        size_type next_geq(size_type x)const {
+            if (x >= m_size or m_low.size() == 0)
+                return m_size;
+            size_type high_val = (x >> m_wl);
+            // position of the first one in m_high whose high part is at least high_val
+            size_type sel_high = high_val ? m_high_0_select.select(high_val) + 1 : 0;
+            size_type rank_low = sel_high - high_val;
+            size_type val_low  = x & bit_magic::Li1Mask[ m_wl ];
+            while (rank_low < m_low.size() and m_high[sel_high]) {
+                if (m_low[rank_low] >= val_low)
+                    return value(sel_high, rank_low);
+                ++sel_high; ++rank_low;
+            }
+            if (rank_low == m_low.size())
+                return m_size;
+            // the next one lies in a following bucket
+            return value(m_high_1_select.select(rank_low+1), rank_low);
+        }
+
+        //! Returns the largest position p <= x with a one in the original bit_vector.
+        /*! \param x A position. Positions >= size() are treated as size()-1.
+         *  \return The position, or size() if there is no one at or before position x.
+         *  \par Time complexity
+         *        \f$ \Order{t_{select0} + t_{select1} + n/m} \f$
+         */
+        size_type prev_leq(size_type x)const {
+            size_type idx;
+            return prev_leq(x, idx);
+        }
+
+        //! Returns the largest position p <= x with a one and the number of ones before p.
+        /*! \param x   A position. Positions >= size() are treated as size()-1.
+         *  \param idx Is set to the number of ones before the returned position, i.e. rank(p).
+         *  \return The position, or size() if there is no one at or before position x.
+         *  \par Time complexity
+         *        \f$ \Order{t_{select0} + t_{select1} + n/m} \f$
+         */
+        size_type prev_leq(size_type x, size_type& idx)const {
+            if (m_low.size() == 0)
+                return m_size;
+            if (x >= m_size)
+                x = m_size-1;
+            size_type high_val = (x >> m_wl);
+            // position of the 0 which terminates the bucket of high_val
+            size_type sel_high = m_high_0_select.select(high_val + 1);
+            size_type rank_low = sel_high - high_val;
+            size_type val_low  = x & bit_magic::Li1Mask[ m_wl ];
+            while (rank_low > 0 and m_high[sel_high-1]) {
+                if (m_low[rank_low-1] <= val_low) {
+                    idx = rank_low-1;
+                    return value(sel_high-1, idx);
+                }
+                --sel_high; --rank_low;
+            }
+            if (rank_low == 0)
+                return m_size;
+            // the previous one lies in a preceding bucket
+            idx = rank_low-1;
+            return value(m_high_1_select.select(rank_low), idx);
+        }
+
         //! Swap method
         void swap(sd_vector& v) {
             if (this != &v) {
@@ -226,6 +333,104 @@ class sd_vector
         }
 };
 
+//! A forward cursor over the positions of the ones in an sd_vector.
+/*! The cursor decodes the ones one after another by scanning the high part
+ *  and can skip to the first one at or after a position. Short skips scan the
+ *  high part, long skips jump with select0 on the high part. This makes the
+ *  cursor suitable for the intersection of posting lists.
+ *
+ *  \par Example
+ *  \code
+ *  sd_vector<>::cursor a(&v1), b(&v2);
+ *  while (!a.end() and !b.end()) {
+ *      if (a.value() < b.value()) a.skip_to(b.value());
+ *      else if (b.value() < a.value()) b.skip_to(a.value());
+ *      else { result.push_back(a.value()); a.next(); b.next(); }
+ *  }
+ *  \endcode
+ *  The sd_vector must not be changed while a cursor on it is used.
+ */
+template<class hi_bit_vector_type, class hi_select_1, class hi_select_0>
+class sd_vector<hi_bit_vector_type, hi_select_1, hi_select_0>::cursor
+{
+    public:
+        typedef typename sd_vector::size_type size_type;
+        //! Skips over more buckets of the high part are done by select0.
+        static const size_type skip_threshold = 2;
+    private:
+        const sd_vector* m_v;
+        size_type m_rank;     // index of the current one
+        size_type m_high_pos; // position of the current one in m_v->m_high
+        size_type m_value;    // position of the current one in the original bit_vector
+
+        // Moves to the first one at or after high position pos, which has rank ones before it.
+        void scan(size_type pos, size_type rank) {
+            while (rank < m_v->ones() and !m_v->m_high[pos])
+                ++pos;
+            set(pos, rank);
+        }
+
+        void set(size_type pos, size_type rank) {
+            m_high_pos = pos;
+            m_rank     = rank;
+            m_value    = (rank < m_v->ones()) ? m_v->value(pos, rank) : m_v->size();
+        }
+
+    public:
+        //! Constructs a cursor at the first one of v.
+        explicit cursor(const sd_vector* v):m_v(v) {
+            scan(0, 0);
+        }
+
+        //! Returns true if the cursor has passed the last one.
+        bool end()const {
+            return m_rank >= m_v->ones();
+        }
+
+        //! Position of the current one in the original bit_vector, or size() at the end.
+        size_type value()const {
+            return m_value;
+        }
+
+        //! Number of ones before the current one, i.e. rank(value()).
+        size_type index()const {
+            return m_rank;
+        }
+
+        //! Moves to the next one.
+        void next() {
+            if (!end())
+                scan(m_high_pos+1, m_rank+1);
+        }
+
+        //! Moves to the first one at or after position x. The cursor does not move backwards.
+        void skip_to(size_type x) {
+            if (end() or x <= m_value)
+                return;
+            if (x >= m_v->size()) {
+                set(m_high_pos, m_v->ones());
+                return;
+            }
+            size_type high_val = (x >> m_v->m_wl);
+            size_type pos = m_high_pos, rank = m_rank;
+            if (high_val > (pos - rank) + skip_threshold) {
+                pos  = m_v->m_high_0_select.select(high_val) + 1;
+                rank = pos - high_val;
+            }
+            size_type val_low = x & bit_magic::Li1Mask[ m_v->m_wl ];
+            while (rank < m_v->ones()) {
+                if (m_v->m_high[pos]) {
+                    size_type h = pos - rank;
+                    if (h > high_val or (h == high_val and m_v->m_low[rank] >= val_low))
+                        break;
+                    ++rank;
+                }
+                ++pos;
+            }
+            set(pos, rank);
+        }
+};
+
 //! Rank data structure for sd_vector
 /*
  *	\tparam hi_bit_vector_type	Type of the bitvector HI used for representing the high part of the positions of the 1s in sd_vector.
@@ -71,6 +71,15 @@ class select_support
          */
         virtual const size_type select(size_type i) const = 0;
 
+        //! Answers n independent select queries.
+        /*! \param idx Array of n arguments.
+            \param n   Number of queries.
+            \param out Array of size n, which contains select(idx[k]) at position k afterwards.
+            \note Subclasses overlap the cache misses of the queries by prefetching,
+                  which pays off for large bit_vectors and random arguments.
+         */
+        virtual void select(const size_type* idx, size_type n, size_type* out) const;
+
         //! Alias for select
         virtual const size_type operator()(size_type i) const = 0;
         //! Serialize the select_support to an out file stream.
@@ -92,11 +101,18 @@ class select_support
         virtual void set_vector(const int_vector<1>* v=NULL) = 0;
 };
 
+inline void select_support::select(const size_type* idx, size_type n, size_type* out) const
+{
+    for (size_type k=0; k < n; ++k) {
+        out[k] = select(idx[k]);
+    }
+}
 
 } // end namespace sdsl
 
 #include "select_support_bs.hpp"
 #include "select_support_mcl.hpp"
 #include "select_support_dummy.hpp"
+#include "select_support_rank.hpp"
 
 #endif
@@ -47,6 +47,7 @@ class select_support_bs : public select_support
         ~select_support_bs() {}
         void init(const int_vector<1>* v=NULL);
 
+        using select_support::select; // batch version
         inline const size_type select(size_type) const;
         //! Alias for select(i).
         inline const size_type operator()(size_type)const;
@@ -51,6 +51,7 @@ class select_support_dummy : public select_support
         //! Select function
         /*! \sa select_support.select
          */
+        using select_support::select; // batch version
         inline const size_type select(size_type i) const;
         //! Alias for select(i).
         inline const size_type operator()(size_type i)const;
@@ -23,6 +23,8 @@
 
 #include "int_vector.hpp"
 #include "select_support.hpp"
+#include "parallel.hpp"
+#include <vector>
 
 //#define SDSL_DEBUG_SELECT_SUPPORT_JMC
 
@@ -220,6 +222,50 @@ struct select_support_mcl_trait<01,2> {
 };
 
 
+template<uint8_t b, uint8_t pattern_len>
+class select_support_mcl;
+
+//! Initializes select_support_mcl in parallel_for.
+/*! Phase 0 counts the arguments in ranges of words, phase 1 stores the
+ *  position of the first argument of each superblock in sb_pos and phase 2
+ *  creates the mini- and longsuperblocks of ranges of superblocks.
+ */
+template<uint8_t b, uint8_t pattern_len>
+struct select_support_mcl_init_task {
+    typedef select_support::size_type size_type;
+    select_support_mcl<b, pattern_len>* ss;
+    uint32_t              phase;
+    std::vector<uint64_t> range_args; // arguments in the word ranges 0..thread after phase 0
+    std::vector<uint64_t> sb_pos;
+
+    select_support_mcl_init_task(select_support_mcl<b, pattern_len>* f_ss):
+        ss(f_ss), phase(0), range_args(util::thread_count()+1, 0) {}
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+        if (phase == 0) {
+            uint64_t cnt = 0;
+            for (uint64_t i=begin; i < end; ++i) {
+                cnt += bit_magic::b1Cnt(ss->arg_word(i));
+            }
+            range_args[thread] = cnt;
+        } else if (phase == 1) {
+            uint64_t k = thread ? range_args[thread-1] : 0; // arguments before word i
+            for (uint64_t i=begin; i < end; ++i) {
+                uint64_t x = ss->arg_word(i);
+                uint64_t cnt = bit_magic::b1Cnt(x);
+                for (uint64_t j=(k+4095)&~0xFFFULL; j < k+cnt; j+=4096) {
+                    sb_pos[j>>12] = (i<<6) + bit_magic::i1BP(x, j-k+1);
+                }
+                k += cnt;
+            }
+        } else {
+            for (uint64_t i=begin; i < end; ++i) {
+                ss->init_superblock(i, sb_pos[i]);
+            }
+        }
+    }
+};
+
 //! A class supporting constant time select queries (proposed by Munro/Clark, 1996) enhanced by broadword computing tricks.
 /*!
  * \par Space usage
@@ -259,6 +305,11 @@ class select_support_mcl : public select_support
         void construct();
         void initData();
         void init_fast(const int_vector<1>* v=NULL);
+        // Word i of the supported bit_vector, in which the arguments are set (only for pattern_len == 1).
+        uint64_t arg_word(size_type i)const;
+        // Creates the mini- or longsuperblock of superblock i, whose first argument is at position first.
+        void init_superblock(size_type i, size_type first);
+        friend struct select_support_mcl_init_task<b, pattern_len>;
     public:
         explicit select_support_mcl(const int_vector<1>* v=NULL);
         select_support_mcl(const select_support_mcl<b,pattern_len>& ss);
@@ -269,6 +320,14 @@ class select_support_mcl : public select_support
         /*! \sa select_support.select
          */
         inline const size_type select(size_type i) const;
+        //! Batch version of select
+        /*! The queries are processed in groups. For all queries of a group
+         *  first the superblock entries, then the miniblock (or long superblock)
+         *  entries and finally the first words of the bit_vector which are
+         *  scanned are prefetched. So the cache misses of the queries overlap.
+         *  \sa select_support.select
+         */
+        void select(const size_type* idx, size_type n, size_type* out) const;
         //! Alias for select(i).
         inline const size_type operator()(size_type i)const;
         size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
@@ -445,7 +504,6 @@ void select_support_mcl<b,pattern_len>::init_slow(const int_vector<1>* v)
 #endif
 }
 
-// TODO: find bug, detected by valgrind
 template<uint8_t b, uint8_t pattern_len>
 void select_support_mcl<b,pattern_len>::init_fast(const int_vector<1>* v)
 {
@@ -453,96 +511,87 @@ void select_support_mcl<b,pattern_len>::init_fast(const int_vector<1>* v)
     initData();
     if (m_v==NULL)
         return;
-//#define SDSL_DEBUG_SELECT_SUPPORT_JMC
-#ifdef SDSL_DEBUG_SELECT_SUPPORT_JMC
-    stop_watch sw;
-    sw.start();
-#endif
     // Count the number of arguments in the bit vector
     m_arg_cnt = select_support_mcl_trait<b,pattern_len>::arg_cnt(*v);
-#ifdef SDSL_DEBUG_SELECT_SUPPORT_JMC
-    sw.stop();
-    std::cerr<<"Count arguments takes "<<sw.get_real_time()<<" ms"<<std::endl;
-    std::cerr<<"m_arg_cnt="<<m_arg_cnt<<std::endl;
-    sw.start();
-#endif
 
     const size_type SUPER_BLOCK_SIZE = 64*64;
 
     if (m_arg_cnt==0) // if there are no arguments in the vector we are done...
         return;
 
-//	size_type sb = (m_arg_cnt+63+SUPER_BLOCK_SIZE-1)/SUPER_BLOCK_SIZE; // number of superblocks, add 63 as the last block could contain 63 uninitialized bits
     size_type sb = (m_arg_cnt+SUPER_BLOCK_SIZE-1)/SUPER_BLOCK_SIZE; // number of superblocks
-    if (m_miniblock != NULL) delete [] m_miniblock;
-    m_miniblock = new int_vector<0>[sb];
-
-    m_superblock = int_vector<0>(sb, 0, m_logn);// TODO: hier koennte man logn noch optimieren...s
-
-#ifdef SDSL_DEBUG_SELECT_SUPPORT_JMC
-    std::cerr<<"H1"<<std::endl;
-#endif
+    m_miniblock      = new int_vector<0>[sb];
+    m_longsuperblock = new int_vector<0>[sb];
+    m_superblock     = int_vector<0>(sb, 0, m_logn);
+
+    // (1) count the arguments in ranges of words, (2) find the first argument of
+    // each superblock and (3) create the mini- or longsuperblocks in parallel
+    select_support_mcl_init_task<b, pattern_len> task(this);
+    task.sb_pos.resize(sb);
+    size_type words = (v->size()+63)>>6;
+    parallel_for(words, task, 64, 1ULL<<14);
+    for (size_type t=1; t < task.range_args.size(); ++t) {
+        task.range_args[t] += task.range_args[t-1];
+    }
+    task.phase = 1;
+    parallel_for(words, task, 64, 1ULL<<14);
+    for (size_type i=0; i < sb; ++i) {
+        m_superblock[i] = task.sb_pos[i];
+    }
+    task.phase = 2;
+    parallel_for(sb, task, 1, 16);
+
+    bool long_blocks = false;
+    for (size_type i=0; i < sb and !long_blocks; ++i) {
+        long_blocks = m_miniblock[i].empty();
+    }
+    if (!long_blocks) {
+        delete[] m_longsuperblock;
+        m_longsuperblock = NULL;
+    }
+}
 
-    bit_vector::size_type arg_position[SUPER_BLOCK_SIZE];
-    const uint64_t* data = v->data();
-    uint64_t carry_new=0;
-    size_type last_k64 = 1, sb_cnt=0;
-    for (size_type i=0, cnt_old=0, cnt_new=0, last_k64_sum=1; i < v->capacity(); i+=64, ++data) {
-        cnt_new += select_support_mcl_trait<b, pattern_len>::args_in_the_word(*data, carry_new);
-        if (cnt_new >= last_k64_sum) {
-            arg_position[last_k64-1] = i + select_support_mcl_trait<b, pattern_len>::ith_arg_pos_in_the_word(*data, last_k64_sum  - cnt_old, carry_new);
-            last_k64 += 64;
-            last_k64_sum += 64;
-
-            if (last_k64 == SUPER_BLOCK_SIZE+1) {
-                m_superblock[sb_cnt] = arg_position[0];
-                size_type pos_of_last_arg_in_the_block = arg_position[last_k64-65];
+template<uint8_t b, uint8_t pattern_len>
+inline uint64_t select_support_mcl<b,pattern_len>::arg_word(size_type i)const
+{
+    uint64_t w = b ? m_v->data()[i] : ~m_v->data()[i];
+    if (((i+1)<<6) > m_v->size())
+        w &= bit_magic::Li1Mask[m_v->size()&0x3F]; // remove the bits after the end of the vector
+    return w;
+}
 
-                for (size_type i=arg_position[last_k64-65]+1, j=last_k64-65; i < v->size() and j < SUPER_BLOCK_SIZE; ++i)
-                    if (select_support_mcl_trait<b,pattern_len>::found_arg(i, *v)) {
-                        pos_of_last_arg_in_the_block = i;
-                        ++j;
-                    }
-                size_type pos_diff = pos_of_last_arg_in_the_block - arg_position[0];
-                if (pos_diff > m_logn4) { // long block
-                    if (m_longsuperblock == NULL) m_longsuperblock = new int_vector<0>[sb+1]; // create longsuperblock
-                    // GEANDERT am 2010-07-17 +1 nach pos_of_last_arg..
-                    m_longsuperblock[sb_cnt] = int_vector<0>(SUPER_BLOCK_SIZE, 0, bit_magic::l1BP(pos_of_last_arg_in_the_block) + 1);
-                    for (size_type j=arg_position[0], k=0; j < pos_of_last_arg_in_the_block; ++j)
-                        if (select_support_mcl_trait<b, pattern_len>::found_arg(j, *v)) {
-//							if(k>=SUPER_BLOCK_SIZE){
-//								std::cout<<"k="<<k<<" SUPER_BLOCK_SIZE="<<SUPER_BLOCK_SIZE<<std::endl;
-//							}
-                            m_longsuperblock[sb_cnt][k++] = j;
-                        }
-                } else {
-                    m_miniblock[sb_cnt] = int_vector<0>(64, 0, bit_magic::l1BP(pos_diff)+1);
-                    for (size_type j=0; j < SUPER_BLOCK_SIZE; j+=64) {
-                        m_miniblock[sb_cnt][j/64] = arg_position[j]-arg_position[0];
-                    }
-                }
-                ++sb_cnt;
-                last_k64 = 1;
-            }
+template<uint8_t b, uint8_t pattern_len>
+void select_support_mcl<b,pattern_len>::init_superblock(size_type i, size_type first)
+{
+    size_type args = std::min((size_type)4096, m_arg_cnt-(i<<12)); // arguments in superblock i
+    size_type arg_position[64]; // position of every 64th argument
+    size_type last = first, k = 0, w = first>>6;
+    for (uint64_t x = arg_word(w) & ~bit_magic::Li1Mask[first&0x3F]; ; x = arg_word(++w)) {
+        size_type cnt = bit_magic::b1Cnt(x);
+        for (size_type j=(k+63)&~(size_type)0x3F; j < k+cnt and j < args; j+=64) {
+            arg_position[j>>6] = (w<<6) + bit_magic::i1BP(x, j-k+1);
         }
-        cnt_old = cnt_new;
-    }
-    // TODO: handle last block!!! einfach ein longsuperblock anhaengen?
-    if (last_k64 > 1) {
-        // GEANDERT am 2010-09-27 +1 nach sb, da wir den superblock extra zu den existierenden anhaengen koennen
-        if (m_longsuperblock == NULL) m_longsuperblock = new int_vector<0>[sb+1]; // create longsuperblock
-        m_longsuperblock[sb_cnt] = int_vector<0>(SUPER_BLOCK_SIZE, 0, bit_magic::l1BP(v->size()-1) + 1);
-        for (size_type i=arg_position[0],k=0; i < v->size(); ++i) {
-            if (select_support_mcl_trait<b, pattern_len>::found_arg(i, *v)) {
-                m_longsuperblock[sb_cnt][k++] = i;
+        if (k+cnt >= args) {
+            last = (w<<6) + bit_magic::i1BP(x, args-k);
+            break;
+        }
+        k += cnt;
+    }
+    size_type pos_diff = last - first;
+    if (pos_diff > m_logn4) { // long block: store all positions
+        m_longsuperblock[i] = int_vector<0>(4096, 0, bit_magic::l1BP(last) + 1);
+        k = 0, w = first>>6;
+        for (uint64_t x = arg_word(w) & ~bit_magic::Li1Mask[first&0x3F]; k < args; x = arg_word(++w)) {
+            for (; x and k < args; x &= x-1) {
+                m_longsuperblock[i][k++] = (w<<6) + bit_magic::r1BP(x);
             }
         }
-        ++sb_cnt;
+    } else {
+        m_miniblock[i] = int_vector<0>(64, 0, bit_magic::l1BP(pos_diff)+1);
+        for (size_type j=0; j < args; j+=64) {
+            m_miniblock[i][j>>6] = arg_position[j>>6]-first;
+        }
     }
-#ifdef SDSL_DEBUG_SELECT_SUPPORT_JMC
-    sw.stop();
-    std::cerr<<"Init tables  takes "<<sw.get_real_time()<<" ms"<<std::endl;
-#endif
 }
 
 template<uint8_t b, uint8_t pattern_len>
@@ -615,6 +664,49 @@ inline const typename select_support_mcl<b,pattern_len>::size_type select_suppor
     }
 }
 
+// Address of the word which contains the k-th entry of v
+inline const uint64_t* select_support_mcl_entry(const int_vector<0>& v, int_vector<0>::size_type k)
+{
+    return v.data() + ((k*v.get_int_width())>>6);
+}
+
+template<uint8_t b, uint8_t pattern_len>
+void select_support_mcl<b,pattern_len>::select(const size_type* idx, size_type n, size_type* out)const
+{
+    const size_type group = 2*batch_prefetch_distance;
+    size_type sb_idx[group];
+    for (size_type g=0; g < n; g += group) {
+        const size_type* q = idx+g;
+        size_type m = std::min(group, n-g);
+        for (size_type k=0; k < m; ++k) { // superblock entry and vector headers
+            sb_idx[k] = (q[k]-1)>>12;
+            __builtin_prefetch(select_support_mcl_entry(m_superblock, sb_idx[k]));
+            __builtin_prefetch(m_miniblock + sb_idx[k]);
+            if (m_longsuperblock != NULL) {
+                __builtin_prefetch(m_longsuperblock + sb_idx[k]);
+            }
+        }
+        for (size_type k=0; k < m; ++k) { // entry in the long superblock or miniblock
+            size_type offset = (q[k]-1)&0xFFF;
+            if (m_longsuperblock != NULL and !m_longsuperblock[sb_idx[k]].empty()) {
+                __builtin_prefetch(select_support_mcl_entry(m_longsuperblock[sb_idx[k]], offset));
+            } else {
+                __builtin_prefetch(select_support_mcl_entry(m_miniblock[sb_idx[k]], offset>>6));
+            }
+        }
+        for (size_type k=0; k < m; ++k) { // first word of the scan
+            size_type offset = (q[k]-1)&0xFFF;
+            if ((offset&0x3F) != 0 and (m_longsuperblock == NULL or m_longsuperblock[sb_idx[k]].empty())) {
+                size_type pos = m_superblock[sb_idx[k]] + m_miniblock[sb_idx[k]][offset>>6] + 1;
+                __builtin_prefetch(m_v->data() + (pos>>6));
+            }
+        }
+        for (size_type k=0; k < m; ++k) {
+            out[g+k] = select(q[k]);
+        }
+    }
+}
+
 template<uint8_t b, uint8_t pattern_len>
 inline const typename select_support_mcl<b,pattern_len>::size_type select_support_mcl<b,pattern_len>::operator()(size_type i)const
 {
@@ -0,0 +1,245 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file select_support_rank.hpp
+    \brief select_support_rank.hpp contains the select_support_rank class which supports select queries with the counters of a rank support and a few position samples.
+	\author Simon Gog
+*/
+#ifndef INCLUDED_SDSL_SELECT_SUPPORT_RANK
+#define INCLUDED_SDSL_SELECT_SUPPORT_RANK
+
+#include "int_vector.hpp"
+#include "rank_support.hpp"
+#include "select_support.hpp"
+#include "util.hpp"
+
+//! Namespace for the succinct data structure library.
+namespace sdsl
+{
+
+//! A class supporting select queries by the superblock counters of a rank support and sparse position samples.
+/*! The class stores for every sample_rate-th argument the index of the
+ *  superblock of the rank support which contains it. A query i is answered
+ *  by searching the superblock counters between the samples of the arguments
+ *  around i and selecting inside the superblock with the block counters of
+ *  the rank support (similar to Vigna's simple-select and Zhou et al.'s
+ *  CS-Poppy). Select1 and select0 can be answered with the same rank support.
+ *
+ * \par Space complexity
+ *  \f$ \frac{\log(n/s)}{8192}\f$ bits per argument, where s is the superblock size
+ *  of the rank support, i.e. less than 0.3% of the size of the bit_vector.
+ *  The rank support is not owned by the select support.
+ *
+ * \par Time complexity
+ *  Constant if the arguments are evenly distributed, \f$\Order{\log n}\f$ in the worst case.
+ *
+ *  \tparam b           Bit which is selected, i.e. 1 for select1 and 0 for select0.
+ *  \tparam RankSupport rank_support_v<1> or rank_support_v5<1>.
+ *
+ * @ingroup select_support_group
+ */
+template<uint8_t b=1, class RankSupport=rank_support_v5<> >
+class select_support_rank : public select_support
+{
+    public:
+        typedef typename RankSupport::bit_vector_type bit_vector_type;
+        typedef RankSupport rank_support_type;
+        //! Every sample_rate-th argument is sampled.
+        static const size_type sample_rate = 8192;
+    private:
+        const RankSupport* m_rs;
+        int_vector<0>      m_samples; // m_samples[k] = superblock which contains the (k*sample_rate+1)-th argument
+        size_type          m_args;    // number of arguments in the supported bit_vector
+
+        // Number of arguments in the superblocks before superblock i
+        size_type superblock_args(size_type i)const {
+            size_type ones = m_rs->superblock_rank(i);
+            return b ? ones : i*RankSupport::superblock_size - ones;
+        }
+        void copy(const select_support_rank& ss);
+    public:
+        //! Constructor
+        /*! \param v  The supported bit_vector.
+         *  \param rs Rank support for v whose counters are used.
+         */
+        explicit select_support_rank(const int_vector<1>* v=NULL, const RankSupport* rs=NULL);
+        select_support_rank(const select_support_rank& ss);
+        ~select_support_rank() {}
+        //! Creates the samples. The rank support has to be set before.
+        void init(const int_vector<1>* v=NULL);
+
+        using select_support::select; // batch version
+        inline const size_type select(size_type i) const;
+        //! Alias for select(i).
+        inline const size_type operator()(size_type i)const;
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=NULL, std::string name="")const;
+        void load(std::istream& in, const int_vector<1>* v=NULL);
+        void set_vector(const int_vector<1>* v=NULL);
+        //! Sets the rank support whose counters are used. Call it after load.
+        void set_rank_support(const RankSupport* rs);
+        select_support_rank& operator=(const select_support_rank& ss);
+        void swap(select_support_rank& ss);
+        //! Equality Operator
+        /*! Two select_support_ranks are equal if all member variables are equal.
+         * Required for the Equality Comparable Concept of the STL.
+         * \sa operator!=
+         */
+        bool operator==(const select_support_rank& ss)const;
+        //! Unequality Operator
+        /*! Two select_support_ranks are not equal if any member variable are not equal.
+         * Required for the Equality Comparable Concept of the STL.
+         * \sa operator==
+         */
+        bool operator!=(const select_support_rank& ss)const;
+};
+
+template<uint8_t b, class RankSupport>
+select_support_rank<b, RankSupport>::select_support_rank(const int_vector<1>* v, const RankSupport* rs):select_support(v), m_rs(rs), m_args(0)
+{
+    if (v != NULL and rs != NULL)
+        init(v);
+}
+
+template<uint8_t b, class RankSupport>
+select_support_rank<b, RankSupport>::select_support_rank(const select_support_rank& ss):select_support(ss.m_v)
+{
+    copy(ss);
+}
+
+template<uint8_t b, class RankSupport>
+select_support_rank<b, RankSupport>& select_support_rank<b, RankSupport>::operator=(const select_support_rank& ss)
+{
+    if (this != &ss) {
+        copy(ss);
+    }
+    return *this;
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::swap(select_support_rank& ss)
+{
+    std::swap(m_rs, ss.m_rs);
+    m_samples.swap(ss.m_samples);
+    std::swap(m_args, ss.m_args);
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::copy(const select_support_rank& ss)
+{
+    m_v       = ss.m_v;
+    m_rs      = ss.m_rs;
+    m_samples = ss.m_samples;
+    m_args    = ss.m_args;
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::init(const int_vector<1>* v)
+{
+    if (v != NULL)
+        set_vector(v);
+    if (m_v == NULL or m_rs == NULL)
+        return;
+    size_type n = m_v->size();
+    m_args = m_rs->rank(n);
+    if (!b)
+        m_args = n - m_args;
+    size_type sample_cnt = (m_args+sample_rate-1)/sample_rate;
+    size_type last = n ? (n-1)/RankSupport::superblock_size : 0; // last superblock
+    m_samples = int_vector<0>(sample_cnt, 0, bit_magic::l1BP(last)+1);
+    size_type k = 0;
+    for (size_type i=0; i <= last and k < sample_cnt; ++i) {
+        size_type end_args = (i == last) ? m_args : superblock_args(i+1);
+        while (k < sample_cnt and k*sample_rate+1 <= end_args) {
+            m_samples[k++] = i;
+        }
+    }
+}
+
+template<uint8_t b, class RankSupport>
+inline const typename select_support_rank<b, RankSupport>::size_type select_support_rank<b, RankSupport>::select(size_type i)const
+{
+    assert(i > 0 and i <= m_args);
+    size_type k  = (i-1)/sample_rate;
+    size_type lo = m_samples[k]; // the i-th argument is in superblock lo..hi
+    size_type hi = (k+1 < m_samples.size()) ? m_samples[k+1] : (m_v->size()-1)/RankSupport::superblock_size;
+    while (hi - lo > 8) { // binary search for the last superblock with less than i arguments before it
+        size_type mid = (lo+hi+1)>>1;
+        if (superblock_args(mid) < i)
+            lo = mid;
+        else
+            hi = mid-1;
+    }
+    while (lo < hi and superblock_args(lo+1) < i) {
+        ++lo;
+    }
+    return m_rs->superblock_select(lo, i-superblock_args(lo), !b);
+}
+
+template<uint8_t b, class RankSupport>
+typename select_support_rank<b, RankSupport>::size_type select_support_rank<b, RankSupport>::serialize(std::ostream& out, structure_tree_node* v, std::string name)const
+{
+    structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+    size_type written_bytes = 0;
+    written_bytes += util::write_member(m_args, out, child, "args");
+    written_bytes += m_samples.serialize(out, child, "samples");
+    structure_tree::add_size(child, written_bytes);
+    return written_bytes;
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::load(std::istream& in, const int_vector<1>* v)
+{
+    set_vector(v);
+    util::read_member(m_args, in);
+    m_samples.load(in);
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::set_vector(const int_vector<1>* v)
+{
+    m_v = v;
+}
+
+template<uint8_t b, class RankSupport>
+void select_support_rank<b, RankSupport>::set_rank_support(const RankSupport* rs)
+{
+    m_rs = rs;
+}
+
+template<uint8_t b, class RankSupport>
+bool select_support_rank<b, RankSupport>::operator==(const select_support_rank& ss)const
+{
+    if (this == &ss)
+        return true;
+    return m_args == ss.m_args and m_samples == ss.m_samples;
+}
+
+template<uint8_t b, class RankSupport>
+bool select_support_rank<b, RankSupport>::operator!=(const select_support_rank& ss)const
+{
+    return !(*this == ss);
+}
+
+template<uint8_t b, class RankSupport>
+inline const typename select_support_rank<b, RankSupport>::size_type select_support_rank<b, RankSupport>::operator()(size_type i)const
+{
+    return select(i);
+}
+
+}
+
+#endif
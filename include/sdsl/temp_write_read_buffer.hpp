@@ -5,8 +5,10 @@
 #ifndef INCLUDED_SDSL_TEMP_WRITE_READ_BUFFER
 #define INCLUDED_SDSL_TEMP_WRITE_READ_BUFFER
 #include "int_vector.hpp"
+#include "block_codec.hpp"
 #include <string>
 #include <fstream>
+#include <vector>
 
 namespace sdsl
 {
@@ -38,17 +40,44 @@ class temp_write_read_buffer
         bool				m_output_exists; // if there exists output to the file
         size_type			m_r;// remaining entries in the buffer
         size_type			m_last_block_size; // size of the last block written to disk
+        bool				m_compress; // if the blocks on disk are compressed
+        std::vector<uint64_t> m_tmp; // uncompressed block for the block_codec
         static size_t		m_buffer_id;
 
+        // writes the first n entries of the buffer to disk
+        void write_block(size_type n) {
+            if (m_compress) {
+                m_tmp.resize(m_buf_size);
+                m_buf.decode(0, n, m_tmp.empty() ? NULL : &m_tmp[0]);
+                block_codec::write_ints(m_out, m_tmp.empty() ? NULL : &m_tmp[0], n, m_buf.get_int_width());
+            } else {
+                m_buf.serialize(m_out);
+            }
+        }
+
+        // reads the next block of n entries from disk
+        void read_block(size_type n) {
+            if (m_compress) {
+                m_tmp.resize(m_buf_size);
+                block_codec::read_ints(m_in, n, m_tmp.empty() ? NULL : &m_tmp[0]);
+                m_buf.encode(0, n, m_tmp.empty() ? NULL : &m_tmp[0]);
+            } else {
+                m_buf.load(m_in);
+            }
+        }
+
     public:
 
         //! Constructior
         /*! \param buf_size The size of the buffer.
          *	\param width	The width of the integers if template paramter int_width=0.
          *	\param dir		Directory in which the temporary file is stored.
+         *	\param compress If true, the blocks on disk are compressed with the block_codec.
          * */
-        temp_write_read_buffer(size_type buf_size, uint8_t width, std::string dir="./") {
+        temp_write_read_buffer(size_type buf_size, uint8_t width, std::string dir="./",
+                               bool compress=util::temp_file_compression()) {
             m_buf_size = buf_size;
+            m_compress = compress;
             m_buf = buffer_type(buf_size, 0, width);    // initialize buffer
             m_in_buf_idx = 0;
             m_buf_cnt = 0;
@@ -78,7 +107,7 @@ class temp_write_read_buffer
                 if (m_buf_cnt == 1) {
                     m_out.open(m_file_name.c_str(), std::ios::trunc | std::ios::out | std::ios::binary);   // open file buffer
                 }
-                m_buf.serialize(m_out);   // write buffer to disk
+                write_block(m_buf_size);   // write buffer to disk
                 m_output_exists = true;
             }
             m_buf[m_in_buf_idx++] = x;
@@ -87,7 +116,7 @@ class temp_write_read_buffer
 
         void write_close() {
             if (m_buf_cnt > 0) {
-                m_buf.serialize(m_out);    // write last buffer to disk
+                write_block(m_in_buf_idx);    // write last buffer to disk
                 m_out.close(); // close stream
                 m_last_block_size = m_in_buf_idx;
                 ++m_buf_cnt;
@@ -119,11 +148,11 @@ class temp_write_read_buffer
                 if (m_buf_idx < m_buf_cnt) {
                     ++m_buf_idx; // increase buffer index
                     m_in_buf_idx = 0; // reset in buffer index
-                    m_buf.load(m_in);   // load next block
                     if (m_buf_idx == m_buf_cnt)
                         m_r = m_last_block_size;
                     else
                         m_r = m_buf_size;
+                    read_block(m_r);   // load next block
                 } else {
                     x = 0;
                     return false;
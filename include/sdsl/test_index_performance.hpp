@@ -25,6 +25,7 @@
 #include "testutils.hpp"	// for write_R_output 
 #include "util.hpp"			// for 
 #include "algorithms.hpp"	// for backward_search
+#include "parallel.hpp"		// for util::thread_count
 #include "testutils.hpp"    // for file
 #include <cstdlib>			// for rand 
 #include <algorithm>		// for swap
@@ -39,6 +40,13 @@ namespace sdsl
  */
 int_vector<64> get_rnd_positions(uint8_t log_s, uint64_t& mask, uint64_t m=0, uint64_t x=17);
 
+//! Test the speed of the word primitives b1Cnt, i1BP, l1BP and r1BP of bit_magic
+/*! Each primitive is measured in all implementations which are supported by
+ *  the CPU (e.g. "b1Cnt broadword" and "b1Cnt popcnt") and in the version
+ *  which is selected at runtime (e.g. "b1Cnt").
+ */
+void test_bit_magic_performance(uint64_t times=100000000);
+
 template<class Vector>
 void test_int_vector_random_access(const Vector& v, bit_vector::size_type times=100000000)
 {
@@ -81,6 +89,122 @@ void test_int_vector_sequential_write(Vector& v, bit_vector::size_type times=100
     write_R_output("int_vector","seq write","end",times,cnt);
 }
 
+template<class Vector>
+void test_int_vector_sequential_access(const Vector& v, bit_vector::size_type times=100000000)
+{
+    typedef bit_vector::size_type size_type;
+    size_type cnt=0;
+    write_R_output("int_vector","seq access","begin",times,cnt);
+    for (size_type i=0; i<times;) {
+        for (typename Vector::const_iterator it=v.begin(), end=v.end(); it!=end and i<times; ++it, ++i) {
+            cnt += *it;
+        }
+    }
+    write_R_output("int_vector","seq access","end",times,cnt);
+}
+
+//! Test random next_geq(x) queries for values x < max_value, e.g. on sd_vector or pef_vector
+template<class Vector>
+void test_next_geq_random_access(const Vector& v, uint64_t max_value, bit_vector::size_type times=20000000)
+{
+    typedef bit_vector::size_type size_type;
+    uint64_t mask;
+    int_vector<64> rands = get_rnd_positions(20, mask, max_value);
+    size_type cnt=0;
+    write_R_output("vector","next_geq","begin",times,cnt);
+    for (size_type i=0; i<times; ++i) {
+        cnt += v.next_geq(rands[ i&mask ]);
+    }
+    write_R_output("vector","next_geq","end",times,cnt);
+}
+
+//! Test sequential decoding of blocks of block_size elements with int_vector::decode
+template<class Vector>
+void test_int_vector_bulk_decode(const Vector& v, bit_vector::size_type times=100000000, bit_vector::size_type block_size=1024,
+                                 const std::string& action="bulk decode")
+{
+    typedef bit_vector::size_type size_type;
+    std::vector<uint64_t> buf(block_size);
+    size_type cnt=0;
+    write_R_output("int_vector",action,"begin",times,cnt);
+    for (size_type i=0, j=0; i<times; i+=block_size, j+=block_size) {
+        if (j+block_size > v.size()) {
+            j = 0;
+        }
+        v.decode(j, j+block_size, &buf[0]);
+        for (size_type k=0; k<block_size; ++k) {
+            cnt += buf[k];
+        }
+    }
+    write_R_output("int_vector",action,"end",times,cnt);
+}
+
+//! Test decoding of blocks of block_size elements with int_vector::decode with the kernels selected at runtime and with the scalar kernels
+/*! The widths 8, 16 and 32 are decoded by AVX2 kernels if bit_magic::cpu.avx2
+ *  is set. For these widths the scalar kernels are measured as "bulk decode scalar".
+ */
+template<class Vector>
+void test_int_vector_bulk_decode_kernels(const Vector& v, bit_vector::size_type times=100000000, bit_vector::size_type block_size=1024)
+{
+    uint8_t width = v.get_int_width();
+    if (bit_magic::cpu.avx2 and (width == 8 or width == 16 or width == 32)) {
+        bit_magic::cpu.avx2 = false;
+        test_int_vector_bulk_decode(v, times, block_size, "bulk decode scalar");
+        bit_magic::cpu.avx2 = true;
+    }
+    test_int_vector_bulk_decode(v, times, block_size);
+}
+
+//! Test sequential encoding of blocks of block_size elements with int_vector::encode
+template<class Vector>
+void test_int_vector_bulk_encode(Vector& v, bit_vector::size_type times=100000000, bit_vector::size_type block_size=1024)
+{
+    typedef bit_vector::size_type size_type;
+    std::vector<uint64_t> buf(block_size);
+    size_type cnt=0;
+    write_R_output("int_vector","bulk encode","begin",times,cnt);
+    for (size_type i=0, j=0; i<times; i+=block_size, j+=block_size) {
+        if (j+block_size > v.size()) {
+            j = 0;
+        }
+        for (size_type k=0; k<block_size; ++k) {
+            buf[k] = i+k;
+        }
+        v.encode(j, j+block_size, &buf[0]);
+        cnt += v[j];
+    }
+    write_R_output("int_vector","bulk encode","end",times,cnt);
+}
+
+//! Test storing and scanning an intermediate int_vector of a construction with and without temp file compression
+/*! The check value of the store actions is the size of the file in bytes.
+ */
+template<uint8_t fixedIntWidth>
+void test_temp_file_compression(const int_vector<fixedIntWidth>& v, const std::string& file_name)
+{
+    typedef bit_vector::size_type size_type;
+    bool compression = util::temp_file_compression();
+    for (size_type compress=0; compress < 2; ++compress) {
+        util::set_temp_file_compression(compress);
+        std::string suffix = compress ? " compressed" : " raw";
+        write_R_output("temp_file","store"+suffix,"begin",v.size(),0);
+        util::store_to_temp_file(v, file_name.c_str());
+        write_R_output("temp_file","store"+suffix,"end",v.size(),get_file_size(file_name.c_str()));
+        size_type cnt=0;
+        write_R_output("temp_file","scan"+suffix,"begin",v.size(),cnt);
+        int_vector_file_buffer<fixedIntWidth> buf(file_name.c_str());
+        for (size_type i=0, r_sum=0, r=buf.load_next_block(); r_sum < v.size();) {
+            for (; i < r_sum+r; ++i) {
+                cnt += buf[i-r_sum];
+            }
+            r_sum += r; r = buf.load_next_block();
+        }
+        write_R_output("temp_file","scan"+suffix,"end",v.size(),cnt);
+    }
+    util::set_temp_file_compression(compression);
+    std::remove(file_name.c_str());
+}
+
 //! Test random queries on rank data structure
 /*
  */
@@ -98,9 +222,35 @@ void test_rank_random_access(const Rank& rank, bit_vector::size_type times=20000
     write_R_output("rank","random access","end",times,cnt);
 }
 
+//! Test random queries on rank data structure with the batch version of rank
+/*! Uses the same queries as test_rank_random_access; the check sums are equal
+ *  if times is a multiple of batch.
+ *  \param batch Number of queries per call. A power of two smaller than 2^20.
+ */
+template<class Rank>
+void test_rank_batch_random_access(const Rank& rank, bit_vector::size_type times=20000000, bit_vector::size_type batch=1024)
+{
+    typedef bit_vector::size_type size_type;
+    uint64_t mask;
+    int_vector<64> rands = get_rnd_positions(20, mask, rank.size()+1);
+    std::vector<size_type> out(batch);
+    size_type cnt=0;
+    write_R_output("rank","batch random access","begin",times,cnt);
+    for (size_type i=0; i<times; i+=batch) {
+        size_type n = std::min(batch, times-i);
+        rank.rank(rands.data() + (i&mask), n, &out[0]);
+        for (size_type k=0; k<n; ++k)
+            cnt += out[k];
+    }
+    write_R_output("rank","batch random access","end",times,cnt);
+}
+
 //! Test creation time for a rank data structure
 /*
  * param size The size of the bit vector in bits for which to rank_support should be created
+ *
+ * The construction is timed with one thread ("construct 1 thread") and
+ * with util::thread_count() threads ("construct").
  */
 template<class Rank>
 void test_rank_construction(bit_vector::size_type size=838860800)
@@ -109,6 +259,15 @@ void test_rank_construction(bit_vector::size_type size=838860800)
     bit_vector b(size);
     util::set_random_bits(b, 17);
     std::cout<<"# bit vector size of rank construct : "<<size<<std::endl;
+    uint32_t threads = util::thread_count();
+    std::cout<<"# threads of rank construct : "<<threads<<std::endl;
+    if (threads > 1) {
+        util::set_thread_count(1);
+        write_R_output("rank","construct 1 thread","begin",1,0);
+        Rank rs(&b);
+        write_R_output("rank","construct 1 thread","end",1,rs(size));
+        util::set_thread_count(threads);
+    }
     write_R_output("rank","construct","begin",1,0);
     Rank rs(&b); // construct rank_support data structure
     write_R_output("rank","construct","end",1,rs(size));
@@ -161,9 +320,41 @@ void test_select_random_access(const Select& select, bit_vector::size_type args,
     write_R_output("select","random access","end",times,cnt);
 }
 
-//! Test creation time for a rank data structure
+//! Test random queries on select data structure with the batch version of select
+/*! Uses the same queries as test_select_random_access; the check sums are equal
+ *  if times is a multiple of batch.
+ *  \param batch Number of queries per call. A power of two smaller than 2^20.
+ */
+template<class Select>
+void test_select_batch_random_access(const Select& select, bit_vector::size_type times=20000000, bit_vector::size_type batch=1024)
+{
+    typedef bit_vector::size_type size_type;
+    const int s = 20;
+    const uint64_t mask = (1<<s)-1;
+    int_vector<64> rands(1<<s ,0);
+    util::set_random_bits(rands, 17);
+    size_type args = util::get_one_bits(*(select.v));
+    util::all_elements_mod(rands, args);
+    for (size_type i=0; i<rands.size(); ++i)
+        rands[i] = rands[i]+1;
+    std::vector<size_type> out(batch);
+    size_type cnt=0;
+    write_R_output("select","batch random access","begin",times,cnt);
+    for (size_type i=0; i<times; i+=batch) {
+        size_type n = std::min(batch, times-i);
+        select.select(rands.data() + (i&mask), n, &out[0]);
+        for (size_type k=0; k<n; ++k)
+            cnt += out[k];
+    }
+    write_R_output("select","batch random access","end",times,cnt);
+}
+
+//! Test creation time for a select data structure
 /*
- * param size The size of the bit vector in bits for which to rank_support should be created
+ * param size The size of the bit vector in bits for which to select_support should be created
+ *
+ * The construction is timed with one thread ("construct 1 thread") and
+ * with util::thread_count() threads ("construct").
  */
 template<class Select>
 void test_select_construction(bit_vector::size_type size=838860800)
@@ -172,12 +363,41 @@ void test_select_construction(bit_vector::size_type size=838860800)
     bit_vector b(size);
     util::set_random_bits(b, 17);
     std::cout<<"# bit vector size of select construct : "<<size<<std::endl;
+    uint32_t threads = util::thread_count();
+    std::cout<<"# threads of select construct : "<<threads<<std::endl;
+    if (threads > 1) {
+        util::set_thread_count(1);
+        write_R_output("select","construct 1 thread","begin",1,0);
+        Select sls(&b);
+        write_R_output("select","construct 1 thread","end",1, sls(1));
+        util::set_thread_count(threads);
+    }
     write_R_output("select","construct","begin",1,0);
     Select sls(&b); // construct rank_support data structure
     write_R_output("select","construct","end",1, sls(1));
     std::cout<<"# size of the select_support_mcl :  "<< ((double)util::get_size_in_bytes(sls))/util::get_size_in_bytes(b) <<std::endl;
 }
 
+//! Test random rank and select queries on a bit vector which provides rank_1_type and select_1_type
+/*! \param b The bit vector from which the bit vector of type Bv is constructed.
+ *
+ *  E.g. test_bit_vector_rank_select<gap_vector<> >(b) compares gap_vector to the other bit vectors.
+ */
+template<class Bv>
+void test_bit_vector_rank_select(const bit_vector& b, bit_vector::size_type times=20000000)
+{
+    typedef bit_vector::size_type size_type;
+    Bv bv(b);
+    typename Bv::rank_1_type rank(&bv);
+    typename Bv::select_1_type select(&bv);
+    std::cout<<"# bit vector type : "<<util::class_name(bv)<<std::endl;
+    std::cout<<"# size relative to the bit_vector : "<<((double)util::get_size_in_bytes(bv))/util::get_size_in_bytes(b)<<std::endl;
+    test_rank_random_access(rank, times);
+    size_type args = rank(bv.size());
+    if (args > 0)
+        test_select_random_access(select, args, times);
+}
+
 template<class Csa>
 void test_csa_access(const Csa& csa, typename Csa::size_type times=1000000)
 {
@@ -314,6 +534,32 @@ void test_rank_bwt_access(const Csa& csa, typename Csa::size_type times=1000000)
     delete [] c_rands;
 }
 
+//! Test random rank_bwt queries with the batch version of rank_bwt
+/*! Uses the same queries as test_rank_bwt_access; the check sums are equal
+ *  if times is a multiple of batch.
+ */
+template<class Csa>
+void test_rank_bwt_batch_access(const Csa& csa, typename Csa::size_type times=1000000, typename Csa::size_type batch=1024)
+{
+    typedef typename Csa::size_type size_type;
+    size_type cnt=0;
+    uint64_t mask, s=20;
+    int_vector<64> rands = get_rnd_positions(s, mask, csa.size()+1);
+    std::vector<typename Csa::char_type> c_rands(1<<s);
+    for (size_type i=0; i<rands.size(); ++i)
+        c_rands[i] = csa.bwt[ rands[i] ];
+    std::vector<size_type> out(batch);
+
+    write_R_output("csa","batch rank_bwt","begin",times,cnt);
+    for (size_type i=0; i<times; i+=batch) {
+        size_type n = std::min(batch, times-i);
+        csa.rank_bwt(rands.data() + (i&mask), &c_rands[i&mask], n, &out[0]);
+        for (size_type k=0; k<n; ++k)
+            cnt += out[k];
+    }
+    write_R_output("csa","batch rank_bwt","end",times,cnt);
+}
+
 template<class Csa>
 void test_select_bwt_access(const Csa& csa, typename Csa::size_type times=500000)
 {
@@ -23,6 +23,7 @@
 
 #include "util.hpp"
 #include "uintx_t.hpp"
+#include "construction_log.hpp"
 #include <sys/time.h> // for struct timeval
 #include <sys/resource.h> // for struct rusage
 #include <iomanip>
@@ -106,6 +107,7 @@ class stop_watch
 inline void write_R_output(std::string data_structure, std::string action,
                            std::string state="begin", uint64_t times=1, uint64_t check=0)
 {
+    construction_log::record(data_structure, action, state);
     if (util::verbose) {
         stop_watch _sw;
         _sw.stop();
@@ -131,6 +131,14 @@ class uint256_t
         uint256_t operator&(const uint256_t& x) {
             return uint256_t(m_lo&x.m_lo, m_mid&x.m_mid, m_high&x.m_high);
         }
+
+        uint256_t operator^(const uint256_t& x) {
+            return uint256_t(m_lo^x.m_lo, m_mid^x.m_mid, m_high^x.m_high);
+        }
+
+        uint256_t operator~() {
+            return uint256_t(~m_lo, ~m_mid, ~m_high);
+        }
         /* // is not needed since we can convert uint256_t to uint64_t
         		uint64_t operator&(uint64_t x){
         			return m_lo & x;
@@ -24,6 +24,9 @@
 #include "bitmagic.hpp"
 #include "typedefs.hpp"
 #include "structure_tree.hpp"
+#include "memory_management.hpp"
+#include "block_codec.hpp"
+#include "parallel.hpp"
 #include <iosfwd>      // forward declaration of ostream
 #include <stdint.h>    // for uint64_t uint32_t declaration
 #include <cassert>
@@ -37,6 +40,8 @@
 #include <sstream>     // for to_string method
 #include <stdexcept>   // for std::logic_error
 #include <typeinfo>    // for typeid
+#include <vector>
+#include <algorithm>   // for std::min
 
 
 // macros to transform a defined name to a string
@@ -88,7 +93,8 @@ void set_one_bits(int_vector_type& v);
 //! Bit compress the int_vector
 /*! Determine the biggest value X and then set the
  *  int_width to the smallest possible so that we
- *  still can represent X
+ *  still can represent X. Both steps are parallelized
+ *  for large vectors, see int_vector::repack.
  */
 template<class int_vector_type>
 void bit_compress(int_vector_type& v);
@@ -104,16 +110,20 @@ void all_elements_mod(int_vector_type& v, size_type_class m);
  *  \par Details
  *   This method precalculates the content of at most 64
  *   words and then repeatedly inserts these words into v.
+ *   Large vectors are filled by up to util::thread_count() threads.
  */
 template<class int_vector_type>
 void set_all_values_to_k(int_vector_type& v, uint64_t k);
 
 //! Sets each entry of the numerical vector v at position \$fi\f$ to value \$fi\$f
+/*! Large vectors are filled by up to util::thread_count() threads.
+ */
 template<class int_vector_type>
 void set_to_id(int_vector_type& v);
 
 //! Counts and returns the 1-bits an int_vector contains.
-/*! \param v The int_vector to count the 1-bits.
+/*! Large vectors are processed by up to util::thread_count() threads.
+    \param v The int_vector to count the 1-bits.
   	\return The number of 1-bits in v.
  */
 template<class int_vector_type>
@@ -142,6 +152,23 @@ bool load_from_file(T& v, const char* file_name);
 template<>
 bool load_from_file(void*&, const char* file_name);
 
+//! Load a data structure from a memory mapped file.
+/*! All int_vectors of the data structure become read-only views
+ *  (copy-on-write) of the mapped file instead of heap copies. The mapping
+ *  is shared between all processes which map the same file and is
+ *  released when the last int_vector which uses it is destroyed.
+ *  Store the structure with store_to_file_aligned to map all of its
+ *  int_vectors. In a file written by store_to_file only int_vectors whose
+ *  data happens to be 8-byte aligned are mapped (not an int_vector<0>,
+ *  which has a 9 byte header, nor anything stored behind it); the others
+ *  are copied to the heap.
+ * \param v Data structure to load.
+   \param file_name Name of the serialized file.
+   \return If the file could be mapped and v was loaded.
+ */
+template<class T>
+bool load_from_file_mapped(T& v, const char* file_name);
+
 template<class size_type_class>
 bool load_from_int_vector_buffer(unsigned char*& text, int_vector_file_buffer<8, size_type_class>& text_buf);
 
@@ -163,10 +190,40 @@ bool store_to_file(const T& v, const char* file_name);
 //! Specialization of store_to_file for a char array
 bool store_to_file(const char* v, const char* file_name);
 
+//! Store a data structure to a file, such that load_from_file_mapped maps all of its int_vectors.
+/*! The int_vectors are written in the aligned format (see
+ *  set_aligned_serialization). The file can be read by load_from_file,
+ *  load_from_file_mapped and int_vector_file_buffer.
+	\param v Data structure to store.
+	\param file_name Name of the file where to store the data structure.
+	eturn If the data structure was stored successfully
+ */
+template<class T>
+bool store_to_file_aligned(const T& v, const char* file_name);
+
+//! Enables or disables the aligned serialization of int_vectors to a stream.
+/*! In the aligned format the header of an int_vector is padded, such that
+ *  its data starts at an offset of the stream which is a multiple of 8,
+ *  and the data is followed by a zero word if its bit size is a multiple
+ *  of 64. The format requires a stream which reports its position with
+ *  tellp(); otherwise the data is not padded.
+ */
+void set_aligned_serialization(std::ios_base& out, bool aligned=true);
+
+//! Returns true if int_vectors are serialized to the stream in the aligned format.
+bool aligned_serialization(std::ios_base& out);
+
 //! Specialization of store_to_file for int_vector
 template<uint8_t fixed_int_width, class size_type_class>
 bool store_to_file(const int_vector<fixed_int_width, size_type_class>& v, const char* file_name, bool write_fixed_as_variable=false);
 
+//! Store an intermediate int_vector of a construction algorithm to a file.
+/*! The int_vector is stored compressed if util::temp_file_compression() is enabled.
+ *  Both formats can be read by load_from_file and int_vector_file_buffer.
+ */
+template<uint8_t fixed_int_width, class size_type_class>
+bool store_to_temp_file(const int_vector<fixed_int_width, size_type_class>& v, const char* file_name);
+
 //! Demangle the class name of typeid(...).name()
 /*!
  *	\param name A pointer to the the result of typeid(...).name()
@@ -376,6 +433,19 @@ bool util::store_to_file(const T& t, const char* file_name)
     return true;
 }
 
+template<class T>
+bool util::store_to_file_aligned(const T& t, const char* file_name)
+{
+    std::ofstream out;
+    out.open(file_name, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!out)
+        return false;
+    set_aligned_serialization(out);
+    t.serialize(out);
+    out.close();
+    return out.good();
+}
+
 inline bool util::store_to_file(const char* v, const char* file_name)
 {
     std::ofstream out;
@@ -400,6 +470,21 @@ bool util::store_to_file(const int_vector<fixed_int_width, size_type_class>& v,
     return true;
 }
 
+template<uint8_t fixed_int_width, class size_type_class>
+bool util::store_to_temp_file(const int_vector<fixed_int_width, size_type_class>& v, const char* file_name)
+{
+    if (!temp_file_compression()) {
+        return store_to_file(v, file_name);
+    }
+    std::ofstream out;
+    out.open(file_name, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!out)
+        return false;
+    v.serialize_compressed(out);
+    out.close();
+    return out.good();
+}
+
 template<class T>
 bool util::load_from_file(T& v, const char* file_name)
 {
@@ -412,6 +497,20 @@ bool util::load_from_file(T& v, const char* file_name)
     return true;
 }
 
+template<class T>
+bool util::load_from_file_mapped(T& v, const char* file_name)
+{
+    mm_file* file = mm_file::open(file_name);
+    if (file == NULL)
+        return false;
+    {
+        mm_streambuf buf(file);
+        std::istream in(&buf);
+        v.load(in);
+    }
+    file->release();
+    return true;
+}
 
 template<class size_type_class>
 bool util::load_from_int_vector_buffer(unsigned char*& text, int_vector_file_buffer<8, size_type_class>& text_buf)
@@ -492,28 +591,90 @@ void util::set_one_bits(int_vector_type& v)
     }
 }
 
+// Calculates the bitwise or of all elements of ranges of an int_vector; one result per thread.
+template<class int_vector_type>
+struct int_vector_or_of_range {
+    const int_vector_type* v;
+    std::vector<uint64_t>  result;
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+        const uint64_t block_size = 1024;
+        uint64_t buf[block_size];
+        uint64_t x = 0;
+        for (uint64_t i=begin; i < end; i += block_size) {
+            uint64_t n = std::min(block_size, end-i);
+            v->decode(i, i+n, buf);
+            for (uint64_t j=0; j < n; ++j) {
+                x |= buf[j];
+            }
+        }
+        result[thread] = x;
+    }
+};
+
+// Sets the elements of ranges of an int_vector to their index.
+template<class int_vector_type>
+struct int_vector_id_of_range {
+    int_vector_type* v;
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t) {
+        const uint64_t block_size = 1024;
+        uint64_t buf[block_size];
+        for (uint64_t i=begin; i < end; i += block_size) {
+            uint64_t n = std::min(block_size, end-i);
+            for (uint64_t j=0; j < n; ++j) {
+                buf[j] = i+j;
+            }
+            v->encode(i, i+n, buf);
+        }
+    }
+};
+
+// Fills ranges of words with a periodic pattern of n words.
+struct fill_words_of_range {
+    uint64_t*       data;
+    const uint64_t* pattern;
+    uint64_t        n;
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t) {
+        for (uint64_t i=begin, ii=begin%n; i < end; ++i) {
+            data[i] = pattern[ii];
+            if (++ii == n) {
+                ii = 0;
+            }
+        }
+    }
+};
+
+// Counts the 1-bits in ranges of words; one result per thread.
+struct one_bits_of_range {
+    const uint64_t*       data;
+    std::vector<uint64_t> result;
+
+    void operator()(uint64_t begin, uint64_t end, uint32_t thread) {
+        uint64_t cnt = 0;
+        for (uint64_t i=begin; i < end; ++i) {
+            cnt += bit_magic::b1Cnt(data[i]);
+        }
+        result[thread] = cnt;
+    }
+};
+
 template<class int_vector_type>
 void util::bit_compress(int_vector_type& v)
 {
+    int_vector_or_of_range<int_vector_type> f;
+    f.v = &v;
+    f.result.resize(thread_count(), 0);
+    parallel_for(v.size(), f);
     typename int_vector_type::value_type max=0;
-    for (typename int_vector_type::size_type i=0; i < v.size(); ++i) {
-        if (v[i] > max) {
-            max = v[i];
-        }
+    for (size_t i=0; i < f.result.size(); ++i) {
+        max |= f.result[i]; // max and the bitwise or of all values have the same length
     }
     uint8_t min_width = bit_magic::l1BP(max)+1;
     uint8_t old_width = v.get_int_width();
     if (old_width > min_width) {
-        const uint64_t* read_data = v.m_data;
-        uint64_t* write_data = v.m_data;
-        uint8_t read_offset = 0;
-        uint8_t write_offset = 0;
-        for (typename int_vector_type::size_type i=0; i < v.size(); ++i) {
-            uint64_t x = bit_magic::read_int_and_move(read_data, read_offset, old_width);
-            bit_magic::write_int_and_move(write_data,  x, write_offset, min_width);
-        }
-        v.bit_resize(v.size()*min_width);
-        v.set_int_width(min_width);
+        v.repack(min_width);
     }
 }
 
@@ -544,21 +705,20 @@ void util::set_all_values_to_k(int_vector_type& v, uint64_t k)
         }
     } while (offset != 0);
 
-    typename int_vector_type::size_type n64 = v.capacity()/64;
-    for (typename int_vector_type::size_type i=0; i < n64;) {
-        for (uint64_t ii=0; ii < n and i < n64; ++ii,++i) {
-            *(data++) = vec[ii];
-        }
-    }
+    fill_words_of_range f;
+    f.data    = data;
+    f.pattern = vec;
+    f.n       = n;
+    parallel_for(v.capacity()/64, f, 1);
 }
 
 
 template<class int_vector_type>
 void util::set_to_id(int_vector_type& v)
 {
-    for (typename int_vector_type::size_type i=0; i < v.size(); ++i) {
-        v[i] = i;
-    }
+    int_vector_id_of_range<int_vector_type> f;
+    f.v = &v;
+    parallel_for(v.size(), f);
 }
 
 template<class int_vector_type>
@@ -567,10 +727,15 @@ typename int_vector_type::size_type util::get_one_bits(const int_vector_type& v)
     const uint64_t* data = v.data();
     if (v.empty())
         return 0;
-    typename int_vector_type::size_type result = bit_magic::b1Cnt(*data);
-    for (typename int_vector_type::size_type i=1; i < (v.capacity()>>6); ++i) {
-        result += bit_magic::b1Cnt(*(++data));
+    one_bits_of_range f;
+    f.data = data;
+    f.result.resize(thread_count(), 0);
+    parallel_for(v.capacity()>>6, f, 1);
+    typename int_vector_type::size_type result = 0;
+    for (size_t i=0; i < f.result.size(); ++i) {
+        result += f.result[i];
     }
+    data += (v.capacity()>>6)-1; // last word
     if (v.bit_size()&0x3F) {
         result -= bit_magic::b1Cnt((*data) & (~bit_magic::Li1Mask[v.bit_size()&0x3F]));
     }
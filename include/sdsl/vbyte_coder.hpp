@@ -0,0 +1,167 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+/*! \file vbyte_coder.hpp
+    \brief vbyte_coder.hpp contains the class sdsl::coder::vbyte
+	\author Simon Gog
+ */
+#ifndef SDSL_VBYTE_CODER
+#define SDSL_VBYTE_CODER
+
+#include "int_vector.hpp"
+
+namespace sdsl
+{
+
+namespace coder
+{
+
+//! A class to encode and decode between variable byte code and binary code.
+/*! An integer is split into groups of 7 bits, starting with the least
+ *  significant group. Each group is written into one byte whose most
+ *  significant bit is set if more bytes follow. The code is larger than
+ *  Elias-\f$\delta\f$ for small integers, but each code is a multiple of
+ *  8 bits long. So in enc_vector and vlc_vector all codes start at
+ *  byte boundaries and are decoded byte-wise instead of bit-wise.
+ *  Zero can be encoded.
+ */
+class vbyte
+{
+    public:
+        typedef uint64_t size_type;
+
+        static const uint8_t min_codeword_length = 8; // one byte represents 0..127
+
+        static uint8_t encoding_length(uint64_t);
+
+        //! Decode n variable byte encoded integers beginning at start_idx in the bitstring "data"
+        /* \param data Bitstring
+           \param start_idx Starting index of the decoding.
+           \param n Number of values to decode from the bitstring.
+           \param it Iterator to decode the values.
+         */
+        template<bool sumup, bool increment,class Iterator>
+        static uint64_t decode(const uint64_t* data, const size_type start_idx, size_type n, Iterator it=(Iterator)NULL);
+
+        //! Decode n variable byte encoded integers beginning at start_idx in the bitstring "data" and return the sum of these values.
+        static uint64_t decode_prefix_sum(const uint64_t* data, const size_type start_idx, size_type n);
+        static uint64_t decode_prefix_sum(const uint64_t* data, const size_type start_idx, const size_type end_idx, size_type n);
+
+        template<class int_vector>
+        static bool encode(const int_vector& v, int_vector& z);
+        template<class int_vector>
+        static bool decode(const int_vector& z, int_vector& v);
+
+        //! Encode one integer x to an int_vector at bit position start_idx.
+        /* \param x Integer to encode.
+           \param z Raw data of vector to write the encoded form of x.
+           \param offset Bit offset in *z, where the encoded form of x starts.
+        */
+        static void encode(uint64_t x, uint64_t*& z, uint8_t& offset);
+
+        template<class int_vector>
+        static uint64_t* raw_data(int_vector& v) {
+            return v.m_data;
+        }
+};
+
+inline uint8_t vbyte::encoding_length(uint64_t w)
+{
+    return w ? ((bit_magic::l1BP(w)+7)/7)<<3 : 8;
+}
+
+inline void vbyte::encode(uint64_t x, uint64_t*& z, uint8_t& offset)
+{
+    while (x >= 0x80) {
+        bit_magic::write_int_and_move(z, (x & 0x7F) | 0x80, offset, 8);
+        x >>= 7;
+    }
+    bit_magic::write_int_and_move(z, x, offset, 8);
+}
+
+template<class int_vector>
+bool vbyte::encode(const int_vector& v, int_vector& z)
+{
+    typedef typename int_vector::size_type size_type;
+    z.set_int_width(v.get_int_width());
+    size_type z_bit_size = 0;
+    for (typename int_vector::const_iterator it = v.begin(), end = v.end(); it != end; ++it) {
+        z_bit_size += encoding_length(*it);
+    }
+    z.bit_resize(z_bit_size);   // Initial size of z
+    if (z_bit_size & 0x3F) { // if z_bit_size % 64 != 0
+        *(z.m_data + (z_bit_size>>6)) = 0; // initialize last word
+    }
+    uint64_t* z_data = z.m_data;
+    uint8_t offset = 0;
+    for (typename int_vector::const_iterator it = v.begin(), end=v.end(); it != end; ++it) {
+        encode(*it, z_data, offset);
+    }
+    return true;
+}
+
+template<class int_vector>
+bool vbyte::decode(const int_vector& z, int_vector& v)
+{
+    typename int_vector::size_type n = 0;
+    const uint64_t* z_data = z.data();
+    uint8_t offset = 0;
+    for (typename int_vector::size_type i=0; i < (z.bit_size()>>3); ++i) {
+        if (!(bit_magic::read_int_and_move(z_data, offset, 8) & 0x80)) // last byte of a code
+            ++n;
+    }
+    v.set_int_width(z.get_int_width());
+    v.resize(n);
+    return decode<false, true>(z.data(), 0, n, v.begin());
+}
+
+template<bool sumup, bool increment, class Iterator>
+inline uint64_t vbyte::decode(const uint64_t* data, const size_type start_idx, size_type n, Iterator it)
+{
+    data += (start_idx >> 6);
+    uint64_t value = 0;
+    uint8_t offset = start_idx & 0x3F;
+    for (size_type i=0; i < n; ++i) {
+        uint64_t x = 0, b;
+        uint8_t shift = 0;
+        do {
+            b = bit_magic::read_int_and_move(data, offset, 8);
+            x |= (b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        if (sumup)
+            value += x;
+        else
+            value = x;
+        if (increment) *(it++) = value;
+    }
+    return value;
+}
+
+inline uint64_t vbyte::decode_prefix_sum(const uint64_t* data, const size_type start_idx, size_type n)
+{
+    return decode<true, false, int*>(data, start_idx, n);
+}
+
+inline uint64_t vbyte::decode_prefix_sum(const uint64_t* data, const size_type start_idx, const size_type, size_type n)
+{
+    return decode<true, false, int*>(data, start_idx, n);
+}
+
+} // end namespace coder
+} // end namespace sdsl
+
+#endif
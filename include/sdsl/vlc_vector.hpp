@@ -20,6 +20,8 @@
 */
 #include "int_vector.hpp"
 #include "elias_delta_coder.hpp"
+#include "block_decoder.hpp"
+#include "block_encoder.hpp"
 #include "iterators.hpp"
 
 #ifndef SDSL_VLC_VECTOR
@@ -50,7 +52,7 @@ class vlc_vector
 {
     public:
         typedef uint64_t 							value_type;  	// STL Container requirement
-        typedef random_access_const_iterator<vlc_vector> iterator;// STL Container requirement
+        typedef random_access_block_const_iterator<vlc_vector> iterator;// STL Container requirement
         typedef iterator							const_iterator; // STL Container requirement
         typedef const value_type		 			reference;
         typedef const value_type 					const_reference;
@@ -188,6 +190,23 @@ class vlc_vector
          */
         value_type operator[](size_type i)const;
 
+        //! Decodes the values of the i-th sample interval.
+        /*! \param i   The index of the sample interval. 0 <= i < (size()+SampleDens-1)/SampleDens
+         *  \param out A buffer for SampleDens values.
+         *  \return The number of decoded values, i.e. min(SampleDens, size()-i*SampleDens).
+         *  \par Time complexity
+         *       \f$ \Order{SampleDens} \f$; short codes are decoded several at a time.
+         */
+        size_type decode_block(const size_type i, uint64_t* out)const {
+            assert(i*SampleDens < size());
+            size_type n = std::min((size_type)SampleDens, size()-i*SampleDens);
+            sdsl::coder::block_decoder<Coder>::template decode<false>(m_z.data(), m_z.bit_size(), m_sample_pointer[i], n, out);
+            for (size_type k=0; k < n; ++k) {
+                --out[k]; // the values are stored incremented by one
+            }
+            return n;
+        }
+
         //! Assignment Operator
         /*!
          *	Required for the Assignable Concept of the STL.
@@ -343,37 +362,27 @@ void vlc_vector<Coder, SampleDens,fixedIntWidth>::init(const Container& c)
 
     if (c.empty())  // if c is empty there is nothing to do...
         return;
-    size_type samples = 0, z_size = 0;
-//  (1) Calculate size of z
-    for (size_type i=0; i < c.size(); ++i) {
-        if (c[i]+1<1) {
+    size_type samples = (c.size()+get_sample_dens()-1)/get_sample_dens();
+    sdsl::coder::block_encoder<Coder, false> enc(get_sample_dens(), c.size());
+//  (1) Calculate the length of the codes of each block
+    for (typename Container::const_iterator it = c.begin(), end = c.end(); it != end; ++it) {
+        if (*it+1<1) {
             throw std::logic_error("vlc_vector cannot decode values smaller than 1!");
         }
-        z_size += Coder::encoding_length(c[i]+1);
+        enc.count(*it);
     }
-    samples = (c.size()+get_sample_dens()-1)/get_sample_dens();
-//	(2) Write z
-
+    size_type z_size = enc.count_end();
+//	(2) Write sample pointers and encode the blocks in parallel
     m_sample_pointer.set_int_width(bit_magic::l1BP(z_size+1) + 1);
     m_sample_pointer.resize(samples+1); // add 1 for last entry
-
-    std::cout<<"z_size="<<z_size<<std::endl;
-    std::cout<<"int_width = "<<bit_magic::l1BP(z_size+1)+1<<std::endl;
-    std::cout<<samples<<std::endl;
-
-    m_z.bit_resize(z_size);
-    z_size = 0;
-    uint64_t* z_data = Coder::raw_data(m_z);
-    uint8_t offset = 0;
-    size_type no_sample = 0;
-    for (size_type i=0, sample_cnt=0; i < c.size(); ++i, --no_sample) {
-        if (!no_sample) { // add a sample pointer
-            no_sample = get_sample_dens();
-            m_sample_pointer[sample_cnt++] = z_size;
-        }
-        Coder::encode(c[i]+1, z_data, offset);
-        z_size += Coder::encoding_length(c[i]+1);
-    }
+    for (size_type k=0; k <= samples; ++k)
+        m_sample_pointer[k] = enc.block_pos(k);
+
+    util::assign(m_z, int_vector<>(z_size, 0, 1));
+    enc.encode_begin(Coder::raw_data(m_z));
+    for (typename Container::const_iterator it = c.begin(), end = c.end(); it != end; ++it)
+        enc.encode(*it);
+    enc.encode_end();
     m_elements = c.size();
 }
 
@@ -387,45 +396,39 @@ void vlc_vector<Coder, SampleDens,fixedIntWidth>::init(int_vector_file_buffer<in
     if (n == 0)  // if c is empty there is nothing to do...
         return;
     v_buf.reset();
-    size_type samples=0, z_size=0;
-//  (1) Calculate size of z
+    size_type samples = (n+get_sample_dens()-1)/get_sample_dens();
+    sdsl::coder::block_encoder<Coder, false> enc(get_sample_dens(), n);
+//  (1) Calculate the length of the codes of each block
     for (size_type i=0, r_sum=0, r = v_buf.load_next_block(); r_sum < n;) {
         for (; i < r_sum+r; ++i) {
-            size_type x = v_buf[i-r_sum]+1;
-            if (x < 1) {
+            size_type x = v_buf[i-r_sum];
+            if (x+1 < 1) {
                 throw std::logic_error("vlc_vector cannot decode values smaller than 1!");
             }
-            z_size += Coder::encoding_length(x);
+            enc.count(x);
         }
         r_sum += r; r = v_buf.load_next_block();
     }
-    samples = (n+get_sample_dens()-1)/get_sample_dens();
-//	(2) Write z
+    size_type z_size = enc.count_end();
+//	(2) Write sample pointers
 
     m_sample_pointer.set_int_width(bit_magic::l1BP(z_size+1) + 1);
     m_sample_pointer.resize(samples+1); // add 1 for last entry
+    for (size_type k=0; k <= samples; ++k)
+        m_sample_pointer[k] = enc.block_pos(k);
 
 //     (b) Initilize bit_vector for encoded data
-    m_z.bit_resize(z_size);
-    z_size = 0;
-    uint64_t* z_data = Coder::raw_data(m_z);
-    uint8_t offset = 0;
+    util::assign(m_z, int_vector<>(z_size, 0, 1));
+    enc.encode_begin(Coder::raw_data(m_z));
 
-//     (c) Write sample values and deltas
+//     (c) Encode the blocks in parallel
     v_buf.reset();
-    size_type no_sample = 0;
-    for (size_type i=0, sample_cnt = 0, r_sum=0, r = v_buf.load_next_block(); r_sum < n;) {
-        for (; i < r_sum+r; ++i, --no_sample) {
-            if (!no_sample) { // add a sample pointer
-                no_sample = get_sample_dens();
-                m_sample_pointer[sample_cnt++] = z_size;
-            }
-            size_type x = v_buf[i-r_sum]+1;
-            Coder::encode(x, z_data, offset);   // write encoded values
-            z_size += Coder::encoding_length(x);
-        }
+    for (size_type i=0, r_sum=0, r = v_buf.load_next_block(); r_sum < n;) {
+        for (; i < r_sum+r; ++i)
+            enc.encode(v_buf[i-r_sum]);
         r_sum += r; r = v_buf.load_next_block();
     }
+    enc.encode_end();
     m_elements = n;
 }
 
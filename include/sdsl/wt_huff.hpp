@@ -581,6 +581,59 @@ class wt_huff
             return result;
         };
 
+        //! Batch version of rank.
+        /*! \param idx Array of n prefix lengths.
+         *  \param c   Array of n symbols.
+         *  \param n   Number of queries.
+         *  \param out Array of size n, which contains rank(idx[k], c[k]) at position k afterwards.
+         *  The queries are processed level by level in groups. The rank queries of
+         *  a group on one level are prefetched before they are answered, so their
+         *  cache misses overlap.
+         */
+        void rank(const size_type* idx, const value_type* c, size_type n, size_type* out)const {
+            if (1 == m_sigma) {
+                for (size_type k=0; k < n; ++k) {
+                    out[k] = rank(idx[k], c[k]);
+                }
+                return;
+            }
+            const size_type group = 2*batch_prefetch_distance;
+            size_type result[group];
+            uint64_t  p[group];
+            uint32_t  node[group];
+            for (size_type g=0; g < n; g += group) {
+                size_type m = std::min(group, n-g);
+                uint32_t max_path_len = 0;
+                for (size_type k=0; k < m; ++k) {
+                    p[k]      = m_path[c[g+k]];
+                    result[k] = idx[g+k] & ZoO[(p[k]>>56)>0];
+                    node[k]   = 0;
+                    max_path_len = std::max(max_path_len, (uint32_t)(p[k]>>56));
+                }
+                for (uint32_t l=0; l < max_path_len; ++l) {
+                    for (size_type k=0; k < m; ++k) {
+                        if (l < (p[k]>>56) and result[k]) {
+                            prefetch_rank(m_tree_rank, m_nodes[node[k]].tree_pos+result[k]);
+                        }
+                    }
+                    for (size_type k=0; k < m; ++k) {
+                        if (l < (p[k]>>56) and result[k]) {
+                            uint64_t bit = (p[k]>>l)&1;
+                            if (bit) {
+                                result[k] = (m_tree_rank(m_nodes[node[k]].tree_pos+result[k]) -  m_nodes[node[k]].tree_pos_rank);
+                            } else {
+                                result[k] -= (m_tree_rank(m_nodes[node[k]].tree_pos+result[k]) -  m_nodes[node[k]].tree_pos_rank);
+                            }
+                            node[k] = m_nodes[node[k]].child[bit]; // goto child
+                        }
+                    }
+                }
+                for (size_type k=0; k < m; ++k) {
+                    out[g+k] = result[k];
+                }
+            }
+        }
+
         //! Calculates how many occurrences of symbol wt[i] are in the prefix [0..i-1] of the original sequence.
         /*!
          *	\param i The index of the symbol.
@@ -225,13 +225,7 @@ class wt_int
                 m_logn = logn;
             }
             std::string tree_out_buf_file_name = (dir+"m_tree"+util::to_string(util::get_pid())+"_"+util::to_string(util::get_id()));
-            std::ofstream tree_out_buf(tree_out_buf_file_name.c_str(),
-                                       std::ios::binary | std::ios::trunc | std::ios::out);   // open buffer for tree
-            size_type bit_size = n*m_logn;
-            tree_out_buf.write((char*) &bit_size, sizeof(bit_size));    // write size of bit_vector
-
-            size_type tree_pos = 0;
-            uint64_t tree_word = 0;
+            int_vector_file_writer<1> tree_out_buf(tree_out_buf_file_name.c_str()); // buffer for the tree
 
             uint64_t		mask_old = 1ULL<<(m_logn);
             for (uint32_t k=0; k<m_logn; ++k) {
@@ -245,16 +239,12 @@ class wt_int
                     uint64_t	x;
                     while (i < n and((x=rac[i])&mask_old)==start_value) {
                         if (x&mask_new) {
-                            tree_word |= (1ULL << (tree_pos&0x3FULL));
+                            tree_out_buf.push_back(1);
                             buf1 << x;
                         } else {
+                            tree_out_buf.push_back(0);
                             rac[start + cnt0++ ] = x;
                         }
-                        ++tree_pos;
-                        if ((tree_pos & 0x3FULL) == 0) { // if tree_pos % 64 == 0 write old word
-                            tree_out_buf.write((char*) &tree_word, sizeof(tree_word));
-                            tree_word = 0;
-                        }
                         ++i;
                     }
                     buf1.write_close();
@@ -272,10 +262,9 @@ class wt_int
                 } while (start < n);
                 mask_old += mask_new;
             }
-            if ((tree_pos & 0x3FULL) != 0) { // if tree_pos % 64 > 0 => there are remaining entries we have to write
-                tree_out_buf.write((char*) &tree_word, sizeof(tree_word));
+            if (!tree_out_buf.close()) {
+                throw std::ios_base::failure("wt_int: Cannot write tree to "+tree_out_buf_file_name);
             }
-            tree_out_buf.close();
             rac.resize(0);
             bit_vector tree;
             util::load_from_file(tree, tree_out_buf_file_name.c_str());
@@ -393,6 +382,57 @@ class wt_int
             return i;
         };
 
+        //! Batch version of rank.
+        /*! \param idx Array of n prefix lengths.
+         *  \param c   Array of n symbols.
+         *  \param n   Number of queries.
+         *  \param out Array of size n, which contains rank(idx[k], c[k]) at position k afterwards.
+         *  The queries are processed level by level in groups. The rank queries of
+         *  a group on one level are prefetched before they are answered, so their
+         *  cache misses overlap.
+         */
+        void rank(const size_type* idx, const value_type* c, size_type n, size_type* out)const {
+            const size_type group = 2*batch_prefetch_distance;
+            size_type offset[group], node_size[group], i[group];
+            for (size_type g=0; g < n; g += group) {
+                size_type m = std::min(group, n-g);
+                for (size_type k=0; k < m; ++k) {
+                    offset[k]    = 0;
+                    node_size[k] = m_size;
+                    i[k]         = idx[g+k];
+                }
+                uint64_t mask = (1ULL) << (m_logn-1);
+                for (uint32_t l=0; l < m_logn; ++l, mask >>= 1) {
+                    for (size_type k=0; k < m; ++k) {
+                        if (i[k]) {
+                            prefetch_rank(m_tree_rank, offset[k]);
+                            prefetch_rank(m_tree_rank, offset[k] + i[k]);
+                            prefetch_rank(m_tree_rank, offset[k] + node_size[k]);
+                        }
+                    }
+                    for (size_type k=0; k < m; ++k) {
+                        if (i[k]) {
+                            size_type ones_before_o	  = m_tree_rank(offset[k]);
+                            size_type ones_before_i   = m_tree_rank(offset[k] + i[k]) - ones_before_o;
+                            size_type ones_before_end = m_tree_rank(offset[k] + node_size[k]) - ones_before_o;
+                            if (c[g+k] & mask) { // search for a one at this level
+                                offset[k] += (node_size[k] - ones_before_end);
+                                node_size[k] = ones_before_end;
+                                i[k] = ones_before_i;
+                            } else { // search for a zero at this level
+                                node_size[k] = (node_size[k] - ones_before_end);
+                                i[k] = (i[k]-ones_before_i);
+                            }
+                            offset[k] += m_size;
+                        }
+                    }
+                }
+                for (size_type k=0; k < m; ++k) {
+                    out[g+k] = i[k];
+                }
+            }
+        }
+
         //! Calculates the ith occurence of the symbol c in the supported vector.
         /*!
          *  \param i The ith occurence. \f$i\in [1..rank(size(),c)]\f$.
@@ -82,7 +82,7 @@ echo "Test cases in the test-directory"
 echo "A program 'example.cpp' can be compiled with the command: "
 echo "g++ -DNDEBUG -O3 [-msse4.2] \\"
 echo "   -I${SDSL_INSTALL_PREFIX}/include -L${SDSL_INSTALL_PREFIX}/lib \\"
-echo "   example.cpp -lsdsl -ldivsufsort -ldivsufsort64"
+echo "   example.cpp -lsdsl -ldivsufsort -ldivsufsort64 -lpthread"
 echo " "
 echo "Tests can be found in the test-directory."
 echo "Have fun!"
@@ -0,0 +1,329 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/async_io.hpp"
+#include <cstring>    // for memcpy
+#include <cerrno>
+#include <fcntl.h>    // for open, posix_fadvise
+#include <unistd.h>   // for pread, pwrite, close
+
+namespace sdsl
+{
+
+buffered_file_reader::buffered_file_reader():m_fd(-1), m_chunk_size(0), m_cur(0), m_pos(0),
+    m_file_pos(0), m_prefetch(false), m_pending(false), m_thread(), m_request()
+{
+    m_buf[0] = m_buf[1] = NULL;
+    m_buf_len[0] = m_buf_len[1] = 0;
+}
+
+buffered_file_reader::~buffered_file_reader()
+{
+    close();
+}
+
+bool buffered_file_reader::open(const char* file_name, uint64_t chunk_size, bool prefetch)
+{
+    close();
+    m_fd = ::open(file_name, O_RDONLY);
+    if (m_fd == -1) {
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    m_chunk_size = chunk_size < 4096 ? 4096 : chunk_size;
+    m_prefetch   = prefetch;
+    m_buf[0] = new char[m_chunk_size];
+    m_buf[1] = new char[m_chunk_size];
+    return seek(0);
+}
+
+uint64_t buffered_file_reader::read_fully(int fd, char* buf, uint64_t len, uint64_t offset)
+{
+    uint64_t read_bytes = 0;
+    while (read_bytes < len) {
+        ssize_t r = pread(fd, buf+read_bytes, len-read_bytes, offset+read_bytes);
+        if (r < 0 and errno == EINTR)
+            continue;
+        if (r <= 0)
+            break;
+        read_bytes += r;
+    }
+    return read_bytes;
+}
+
+void* buffered_file_reader::read_chunk(void* request)
+{
+    read_request* r = (read_request*)request;
+    *(r->read_bytes) = read_fully(r->fd, r->buf, r->len, r->offset);
+    return NULL;
+}
+
+void buffered_file_reader::request_next_chunk()
+{
+    uint8_t back = 1-m_cur;
+    m_request.fd         = m_fd;
+    m_request.buf        = m_buf[back];
+    m_request.len        = m_chunk_size;
+    m_request.offset     = m_file_pos;
+    m_request.read_bytes = &m_buf_len[back];
+    m_file_pos += m_chunk_size;
+    if (m_prefetch and pthread_create(&m_thread, NULL, read_chunk, &m_request) == 0) {
+        m_pending = true;
+    } else { // synchronous fallback
+        read_chunk(&m_request);
+        m_pending = false;
+    }
+}
+
+void buffered_file_reader::wait_for_chunk()
+{
+    if (m_pending) {
+        pthread_join(m_thread, NULL);
+        m_pending = false;
+    }
+}
+
+bool buffered_file_reader::next_chunk()
+{
+    if (m_buf_len[m_cur] < m_chunk_size) { // the front buffer contained the end of the file
+        return false;
+    }
+    if (!m_prefetch) {
+        request_next_chunk();
+    }
+    wait_for_chunk();
+    m_cur = 1-m_cur;
+    m_pos = 0;
+    if (m_prefetch and m_buf_len[m_cur] == m_chunk_size) {
+        request_next_chunk(); // overlap reading the next chunk with the consumption of this one
+    }
+    return m_buf_len[m_cur] > 0;
+}
+
+uint64_t buffered_file_reader::read(char* dest, uint64_t len)
+{
+    uint64_t read_bytes = 0;
+    while (read_bytes < len) {
+        if (m_pos == m_buf_len[m_cur] and !next_chunk()) {
+            break;
+        }
+        uint64_t n = m_buf_len[m_cur]-m_pos;
+        if (n > len-read_bytes) {
+            n = len-read_bytes;
+        }
+        memcpy(dest+read_bytes, m_buf[m_cur]+m_pos, n);
+        m_pos += n;
+        read_bytes += n;
+    }
+    return read_bytes;
+}
+
+bool buffered_file_reader::seek(uint64_t offset)
+{
+    if (m_fd == -1) {
+        return false;
+    }
+    wait_for_chunk();
+    // load the chunk which contains offset into the front buffer
+    uint64_t chunk_begin = offset - (offset % m_chunk_size);
+    m_buf_len[m_cur] = read_fully(m_fd, m_buf[m_cur], m_chunk_size, chunk_begin);
+    m_file_pos = chunk_begin + m_chunk_size;
+    m_pos = offset - chunk_begin;
+    if (m_pos > m_buf_len[m_cur]) {
+        m_pos = m_buf_len[m_cur];
+    }
+    if (m_prefetch and m_buf_len[m_cur] == m_chunk_size) {
+        request_next_chunk();
+    }
+    return true;
+}
+
+void buffered_file_reader::close()
+{
+    wait_for_chunk();
+    if (m_fd != -1) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    for (uint8_t i=0; i<2; ++i) {
+        delete [] m_buf[i];
+        m_buf[i] = NULL;
+        m_buf_len[i] = 0;
+    }
+    m_pos = m_file_pos = 0;
+    m_cur = 0;
+}
+
+buffered_file_writer::buffered_file_writer():m_fd(-1), m_chunk_size(0), m_buf_len(0), m_cur(0),
+    m_file_pos(0), m_async(false), m_pending(false), m_ok(true), m_thread(), m_request()
+{
+    m_buf[0] = m_buf[1] = NULL;
+}
+
+buffered_file_writer::~buffered_file_writer()
+{
+    close();
+}
+
+bool buffered_file_writer::open(const char* file_name, uint64_t chunk_size, bool async)
+{
+    close();
+    m_fd = ::open(file_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (m_fd == -1) {
+        return false;
+    }
+    m_chunk_size = chunk_size < 4096 ? 4096 : chunk_size;
+    m_async  = async;
+    m_ok     = true;
+    m_buf[0] = new char[m_chunk_size];
+    m_buf[1] = new char[m_chunk_size];
+    return true;
+}
+
+bool buffered_file_writer::write_fully(int fd, const char* buf, uint64_t len, uint64_t offset)
+{
+    uint64_t written_bytes = 0;
+    while (written_bytes < len) {
+        ssize_t r = pwrite(fd, buf+written_bytes, len-written_bytes, offset+written_bytes);
+        if (r < 0 and errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        written_bytes += r;
+    }
+    return true;
+}
+
+void* buffered_file_writer::write_chunk(void* request)
+{
+    write_request* r = (write_request*)request;
+    if (!write_fully(r->fd, r->buf, r->len, r->offset)) {
+        *(r->ok) = false;
+    }
+    return NULL;
+}
+
+void buffered_file_writer::wait_for_chunk()
+{
+    if (m_pending) {
+        pthread_join(m_thread, NULL);
+        m_pending = false;
+    }
+}
+
+// Hands the front buffer over to the writing thread and continues with the other buffer
+void buffered_file_writer::flush_chunk()
+{
+    if (m_buf_len == 0) {
+        return;
+    }
+    wait_for_chunk(); // the back buffer is free afterwards
+    m_request.fd     = m_fd;
+    m_request.buf    = m_buf[m_cur];
+    m_request.len    = m_buf_len;
+    m_request.offset = m_file_pos;
+    m_request.ok     = &m_ok;
+    if (m_async and pthread_create(&m_thread, NULL, write_chunk, &m_request) == 0) {
+        m_pending = true;
+    } else { // synchronous fallback
+        write_chunk(&m_request);
+    }
+    m_file_pos += m_buf_len;
+    m_buf_len = 0;
+    m_cur = 1-m_cur;
+}
+
+bool buffered_file_writer::write(const char* src, uint64_t len)
+{
+    if (m_fd == -1) {
+        return false;
+    }
+    while (len > 0) {
+        uint64_t n = m_chunk_size-m_buf_len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(m_buf[m_cur]+m_buf_len, src, n);
+        m_buf_len += n;
+        src += n;
+        len -= n;
+        if (m_buf_len == m_chunk_size) {
+            flush_chunk();
+        }
+    }
+    return m_ok;
+}
+
+bool buffered_file_writer::write_at(uint64_t offset, const char* src, uint64_t len)
+{
+    if (m_fd == -1 or offset+len > size()) {
+        return false;
+    }
+    wait_for_chunk();
+    if (offset < m_file_pos) { // part which is already handed over to the file
+        uint64_t n = m_file_pos-offset < len ? m_file_pos-offset : len;
+        if (!write_fully(m_fd, src, n, offset)) {
+            m_ok = false;
+        }
+        offset += n;
+        src += n;
+        len -= n;
+    }
+    if (len > 0) { // part which is still in the front buffer
+        memcpy(m_buf[m_cur]+(offset-m_file_pos), src, len);
+    }
+    return m_ok;
+}
+
+bool buffered_file_writer::close()
+{
+    if (m_fd != -1) {
+        flush_chunk();
+        wait_for_chunk();
+        if (::close(m_fd) != 0) {
+            m_ok = false;
+        }
+        m_fd = -1;
+    }
+    for (uint8_t i=0; i<2; ++i) {
+        delete [] m_buf[i];
+        m_buf[i] = NULL;
+    }
+    m_buf_len = m_file_pos = 0;
+    m_cur = 0;
+    return m_ok;
+}
+
+namespace util
+{
+
+static bool prefetch_file_buffers = false;
+
+void set_file_buffer_prefetch(bool prefetch)
+{
+    prefetch_file_buffers = prefetch;
+}
+
+bool file_buffer_prefetch()
+{
+    return prefetch_file_buffers;
+}
+
+} // end namespace util
+
+} // end namespace sdsl
@@ -0,0 +1,77 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/bit_operations.hpp"
+
+namespace sdsl
+{
+
+namespace
+{
+
+// Word i of the bit vector with n bits starting at data; bits after n are zero.
+inline uint64_t word(const uint64_t* data, uint64_t n, uint64_t i)
+{
+    if (64*i >= n)
+        return 0;
+    if (64*(i+1) > n)
+        return data[i] & bit_magic::Li1Mask[n&63];
+    return data[i];
+}
+
+} // end anonymous namespace
+
+void bit_operations::apply(const bit_vector& a, const bit_vector& b, operation op, bit_vector& res)
+{
+    size_type n = std::max(a.size(), b.size());
+    bit_vector r(n, 0);
+    const uint64_t* pa = a.data();
+    const uint64_t* pb = b.data();
+    uint64_t* pr = r.m_data;
+    size_type full  = std::min(a.size(), b.size())/64; // words which are complete in a and b
+    size_type words = (n+63)/64;
+    // The simple loops over the complete words are vectorized by the compiler.
+    switch (op) {
+        case AND:
+            for (size_type i=0; i < full; ++i)
+                pr[i] = pa[i] & pb[i];
+            break;
+        case OR:
+            for (size_type i=0; i < full; ++i)
+                pr[i] = pa[i] | pb[i];
+            break;
+        case XOR:
+            for (size_type i=0; i < full; ++i)
+                pr[i] = pa[i] ^ pb[i];
+            break;
+        case ANDNOT:
+            for (size_type i=0; i < full; ++i)
+                pr[i] = pa[i] & ~pb[i];
+            break;
+    }
+    for (size_type i=full; i < words; ++i) { // the last word of the shorter operand and the tail of the longer one
+        uint64_t x = word(pa, a.size(), i), y = word(pb, b.size(), i);
+        switch (op) {
+            case AND:    pr[i] = x & y; break;
+            case OR:     pr[i] = x | y; break;
+            case XOR:    pr[i] = x ^ y; break;
+            case ANDNOT: pr[i] = x & ~y; break;
+        }
+    }
+    res.swap(r);
+}
+
+} // end namespace sdsl
@@ -0,0 +1,536 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/bit_vector_dynamic.hpp"
+#include "sdsl/bitmagic.hpp"
+#include <algorithm> // for std::min
+#include <cstring>   // for memcpy, memset
+
+namespace sdsl
+{
+
+namespace
+{
+
+typedef bit_vector_dynamic::size_type size_type;
+
+// Leaves with less bits and nodes with less children are merged with or refilled from a sibling.
+const uint32_t min_leaf_bits = bit_vector_dynamic::leaf_bits/4;
+const uint32_t min_node_cnt  = bit_vector_dynamic::fanout/4;
+
+// Returns len <= 64 bits of a starting at position pos.
+inline uint64_t read_bits(const uint64_t* a, uint64_t pos, uint8_t len)
+{
+    uint64_t off = pos & 63;
+    uint64_t x = a[pos>>6] >> off;
+    if (off + len > 64)
+        x |= a[(pos>>6)+1] << (64-off);
+    return len == 64 ? x : x & bit_magic::Li1Mask[len];
+}
+
+// Writes len <= 64 bits x at position pos of a, where the bits are zero.
+inline void write_bits(uint64_t* a, uint64_t pos, uint64_t x, uint8_t len)
+{
+    uint64_t off = pos & 63;
+    a[pos>>6] |= x << off;
+    if (off + len > 64)
+        a[(pos>>6)+1] |= x >> (64-off);
+}
+
+// Copies len bits of src from position src_pos to the zero bits of dst at position dst_pos.
+void copy_bit_range(uint64_t* dst, uint64_t dst_pos, const uint64_t* src, uint64_t src_pos, uint64_t len)
+{
+    for (uint64_t p=0; p < len; p += 64) {
+        uint8_t l = (uint8_t)std::min((uint64_t)64, len-p);
+        write_bits(dst, dst_pos+p, read_bits(src, src_pos+p, l), l);
+    }
+}
+
+inline uint32_t count_ones(const uint64_t* a, uint32_t words)
+{
+    uint32_t ones = 0;
+    for (uint32_t k=0; k < words; ++k)
+        ones += bit_magic::b1Cnt(a[k]);
+    return ones;
+}
+
+} // end anonymous namespace
+
+const uint32_t bit_vector_dynamic::leaf_words;
+const uint32_t bit_vector_dynamic::leaf_bits;
+const uint32_t bit_vector_dynamic::fanout;
+
+bit_vector_dynamic::bit_vector_dynamic():m_size(0), m_ones(0), m_height(0)
+{
+    m_root = new_leaf();
+}
+
+bit_vector_dynamic::bit_vector_dynamic(const bit_vector& bv)
+{
+    build(bv);
+}
+
+uint32_t bit_vector_dynamic::new_leaf()
+{
+    uint32_t l;
+    if (!m_free_leaves.empty()) {
+        l = m_free_leaves.back();
+        m_free_leaves.pop_back();
+    } else {
+        l = m_leaves.size();
+        m_leaves.push_back(leaf());
+    }
+    memset(&m_leaves[l], 0, sizeof(leaf));
+    return l;
+}
+
+uint32_t bit_vector_dynamic::new_node()
+{
+    uint32_t n;
+    if (!m_free_nodes.empty()) {
+        n = m_free_nodes.back();
+        m_free_nodes.pop_back();
+    } else {
+        n = m_nodes.size();
+        m_nodes.push_back(node());
+    }
+    m_nodes[n].cnt = 0;
+    return n;
+}
+
+void bit_vector_dynamic::delete_leaf(uint32_t l)
+{
+    m_free_leaves.push_back(l);
+}
+
+void bit_vector_dynamic::delete_node(uint32_t n)
+{
+    m_free_nodes.push_back(n);
+}
+
+void bit_vector_dynamic::subtree_counts(uint32_t idx, uint32_t height, uint64_t& size, uint64_t& ones)const
+{
+    if (height == 0) {
+        size = m_leaves[idx].size;
+        ones = m_leaves[idx].ones;
+    } else {
+        const node& n = m_nodes[idx];
+        size = ones = 0;
+        for (uint32_t c=0; c < n.cnt; ++c) {
+            size += n.size[c];
+            ones += n.ones[c];
+        }
+    }
+}
+
+void bit_vector_dynamic::build(const bit_vector& bv)
+{
+    m_leaves.clear(); m_nodes.clear();
+    m_free_leaves.clear(); m_free_nodes.clear();
+    m_size = bv.size();
+    m_ones = 0;
+    std::vector<uint32_t> level;
+    for (size_type pos=0; pos < m_size; pos += leaf_bits) {
+        uint32_t l = new_leaf();
+        leaf& lf = m_leaves[l];
+        lf.size = (uint32_t)std::min((size_type)leaf_bits, m_size-pos);
+        copy_bit_range(lf.bits, 0, bv.data(), pos, lf.size);
+        lf.ones = count_ones(lf.bits, leaf_words);
+        m_ones += lf.ones;
+        level.push_back(l);
+    }
+    if (level.empty())
+        level.push_back(new_leaf());
+    m_height = 0;
+    while (level.size() > 1) { // distribute the children evenly over the nodes of the next level
+        size_type groups = (level.size()+fanout-1)/fanout;
+        std::vector<uint32_t> next_level(groups);
+        for (size_type g=0; g < groups; ++g) {
+            uint32_t r = new_node();
+            node& n = m_nodes[r];
+            for (size_type k=g*level.size()/groups; k < (g+1)*level.size()/groups; ++k) {
+                n.child[n.cnt] = level[k];
+                subtree_counts(level[k], m_height, n.size[n.cnt], n.ones[n.cnt]);
+                ++n.cnt;
+            }
+            next_level[g] = r;
+        }
+        level.swap(next_level);
+        ++m_height;
+    }
+    m_root = level[0];
+}
+
+bit_vector_dynamic::value_type bit_vector_dynamic::operator[](size_type i)const
+{
+    uint32_t idx = m_root;
+    for (uint32_t h=m_height; h > 0; --h) {
+        const node& n = m_nodes[idx];
+        uint32_t c = 0;
+        while (i >= n.size[c]) {
+            i -= n.size[c++];
+        }
+        idx = n.child[c];
+    }
+    return (m_leaves[idx].bits[i>>6] >> (i&63)) & 1ULL;
+}
+
+bit_vector_dynamic::size_type bit_vector_dynamic::rank(size_type i)const
+{
+    size_type r = 0;
+    uint32_t idx = m_root;
+    for (uint32_t h=m_height; h > 0; --h) {
+        const node& n = m_nodes[idx];
+        uint32_t c = 0;
+        while (c+1 < n.cnt and i > n.size[c]) {
+            i -= n.size[c];
+            r += n.ones[c++];
+        }
+        idx = n.child[c];
+    }
+    const leaf& l = m_leaves[idx];
+    r += count_ones(l.bits, i>>6);
+    if (i & 63)
+        r += bit_magic::b1Cnt(l.bits[i>>6] & bit_magic::Li1Mask[i&63]);
+    return r;
+}
+
+bit_vector_dynamic::size_type bit_vector_dynamic::select(size_type i, bool b)const
+{
+    size_type pos = 0;
+    uint32_t idx = m_root;
+    for (uint32_t h=m_height; h > 0; --h) {
+        const node& n = m_nodes[idx];
+        uint32_t c = 0;
+        while (true) {
+            size_type args = b ? n.ones[c] : n.size[c]-n.ones[c];
+            if (i <= args)
+                break;
+            i   -= args;
+            pos += n.size[c++];
+        }
+        idx = n.child[c];
+    }
+    const leaf& l = m_leaves[idx];
+    for (uint32_t k=0; ; ++k) {
+        uint64_t w = b ? l.bits[k] : ~l.bits[k];
+        uint32_t args = bit_magic::b1Cnt(w);
+        if (i <= args)
+            return pos + 64*k + bit_magic::i1BP(w, i);
+        i -= args;
+    }
+}
+
+bool bit_vector_dynamic::insert(uint32_t idx, uint32_t height, size_type i, bool bit, uint32_t& sibling)
+{
+    if (height == 0) {
+        bool split = false;
+        if (m_leaves[idx].size == leaf_bits) { // move the upper half to a new leaf
+            sibling = new_leaf();
+            leaf& l = m_leaves[idx];
+            leaf& s = m_leaves[sibling];
+            memcpy(s.bits, l.bits + leaf_words/2, sizeof(l.bits)/2);
+            memset(l.bits + leaf_words/2, 0, sizeof(l.bits)/2);
+            s.size = l.size = leaf_bits/2;
+            s.ones = count_ones(s.bits, leaf_words/2);
+            l.ones -= s.ones;
+            split = true;
+            if (i > l.size) {
+                i  -= l.size;
+                idx = sibling;
+            }
+        }
+        leaf& l = m_leaves[idx];
+        uint32_t w = i>>6, off = i&63;
+        for (uint32_t k=l.size>>6; k > w; --k) {
+            l.bits[k] = (l.bits[k] << 1) | (l.bits[k-1] >> 63);
+        }
+        uint64_t low = bit_magic::Li1Mask[off];
+        l.bits[w] = (l.bits[w] & low) | ((l.bits[w] & ~low) << 1) | ((uint64_t)bit << off);
+        ++l.size;
+        l.ones += bit;
+        return split;
+    }
+    uint32_t c = 0;
+    {
+        const node& n = m_nodes[idx];
+        while (c+1 < n.cnt and i > n.size[c]) {
+            i -= n.size[c++];
+        }
+    }
+    uint32_t child = m_nodes[idx].child[c], s;
+    bool child_split = insert(child, height-1, i, bit, s);
+    node* n = &m_nodes[idx]; // the recursion might have moved the nodes
+    if (!child_split) {
+        ++n->size[c];
+        n->ones[c] += bit;
+        return false;
+    }
+    for (uint32_t k=n->cnt; k > c+1; --k) {
+        n->size[k]  = n->size[k-1];
+        n->ones[k]  = n->ones[k-1];
+        n->child[k] = n->child[k-1];
+    }
+    n->child[c+1] = s;
+    subtree_counts(child, height-1, n->size[c], n->ones[c]);
+    subtree_counts(s, height-1, n->size[c+1], n->ones[c+1]);
+    if (++n->cnt <= fanout)
+        return false;
+    // move the upper half of the children to a new node
+    sibling = new_node();
+    n = &m_nodes[idx];
+    node& sn = m_nodes[sibling];
+    uint32_t h = n->cnt/2;
+    sn.cnt = n->cnt - h;
+    memcpy(sn.size, n->size+h, sn.cnt*sizeof(n->size[0]));
+    memcpy(sn.ones, n->ones+h, sn.cnt*sizeof(n->ones[0]));
+    memcpy(sn.child, n->child+h, sn.cnt*sizeof(n->child[0]));
+    n->cnt = h;
+    return true;
+}
+
+void bit_vector_dynamic::insert(size_type i, bool bit)
+{
+    assert(i <= m_size);
+    uint32_t sibling;
+    if (insert(m_root, m_height, i, bit, sibling)) { // the root was split
+        uint32_t r = new_node();
+        node& n = m_nodes[r];
+        n.cnt = 2;
+        n.child[0] = m_root;
+        n.child[1] = sibling;
+        subtree_counts(m_root, m_height, n.size[0], n.ones[0]);
+        subtree_counts(sibling, m_height, n.size[1], n.ones[1]);
+        m_root = r;
+        ++m_height;
+    }
+    ++m_size;
+    m_ones += bit;
+}
+
+// Merges child c of node p with a neighbour or moves elements from the neighbour to c.
+void bit_vector_dynamic::rebalance(uint32_t p, uint32_t c, uint32_t height)
+{
+    node& n = m_nodes[p];
+    uint32_t a = (c+1 < n.cnt) ? c : c-1; // children a and a+1 are balanced
+    uint32_t ia = n.child[a], ib = n.child[a+1];
+    bool merge;
+    if (height == 0) {
+        leaf& la = m_leaves[ia];
+        leaf& lb = m_leaves[ib];
+        merge = (la.size + lb.size <= leaf_bits);
+        if (merge) {
+            copy_bit_range(la.bits, la.size, lb.bits, 0, lb.size);
+            la.size += lb.size;
+            la.ones += lb.ones;
+            delete_leaf(ib);
+        } else {
+            uint64_t tmp[2*leaf_words];
+            memset(tmp, 0, sizeof(tmp));
+            memcpy(tmp, la.bits, sizeof(la.bits));
+            copy_bit_range(tmp, la.size, lb.bits, 0, lb.size);
+            uint32_t total = la.size + lb.size, ones = la.ones + lb.ones;
+            memset(la.bits, 0, sizeof(la.bits));
+            memset(lb.bits, 0, sizeof(lb.bits));
+            la.size = total/2;
+            lb.size = total - la.size;
+            copy_bit_range(la.bits, 0, tmp, 0, la.size);
+            copy_bit_range(lb.bits, 0, tmp, la.size, lb.size);
+            la.ones = count_ones(la.bits, leaf_words);
+            lb.ones = ones - la.ones;
+        }
+    } else {
+        node& na = m_nodes[ia];
+        node& nb = m_nodes[ib];
+        merge = (na.cnt + nb.cnt <= fanout);
+        if (merge) {
+            memcpy(na.size+na.cnt, nb.size, nb.cnt*sizeof(nb.size[0]));
+            memcpy(na.ones+na.cnt, nb.ones, nb.cnt*sizeof(nb.ones[0]));
+            memcpy(na.child+na.cnt, nb.child, nb.cnt*sizeof(nb.child[0]));
+            na.cnt += nb.cnt;
+            delete_node(ib);
+        } else {
+            uint32_t total = na.cnt + nb.cnt, left = total/2;
+            if (na.cnt > left) { // move the last children of a to the front of b
+                uint32_t m = na.cnt - left;
+                memmove(nb.size+m, nb.size, nb.cnt*sizeof(nb.size[0]));
+                memmove(nb.ones+m, nb.ones, nb.cnt*sizeof(nb.ones[0]));
+                memmove(nb.child+m, nb.child, nb.cnt*sizeof(nb.child[0]));
+                memcpy(nb.size, na.size+left, m*sizeof(na.size[0]));
+                memcpy(nb.ones, na.ones+left, m*sizeof(na.ones[0]));
+                memcpy(nb.child, na.child+left, m*sizeof(na.child[0]));
+            } else { // move the first children of b to the end of a
+                uint32_t m = left - na.cnt;
+                memcpy(na.size+na.cnt, nb.size, m*sizeof(nb.size[0]));
+                memcpy(na.ones+na.cnt, nb.ones, m*sizeof(nb.ones[0]));
+                memcpy(na.child+na.cnt, nb.child, m*sizeof(nb.child[0]));
+                memmove(nb.size, nb.size+m, (nb.cnt-m)*sizeof(nb.size[0]));
+                memmove(nb.ones, nb.ones+m, (nb.cnt-m)*sizeof(nb.ones[0]));
+                memmove(nb.child, nb.child+m, (nb.cnt-m)*sizeof(nb.child[0]));
+            }
+            na.cnt = left;
+            nb.cnt = total - left;
+        }
+    }
+    if (merge) { // remove child a+1 from p
+        n.size[a] += n.size[a+1];
+        n.ones[a] += n.ones[a+1];
+        for (uint32_t k=a+1; k+1 < n.cnt; ++k) {
+            n.size[k]  = n.size[k+1];
+            n.ones[k]  = n.ones[k+1];
+            n.child[k] = n.child[k+1];
+        }
+        --n.cnt;
+    } else {
+        subtree_counts(ia, height, n.size[a], n.ones[a]);
+        subtree_counts(ib, height, n.size[a+1], n.ones[a+1]);
+    }
+}
+
+bool bit_vector_dynamic::erase(uint32_t idx, uint32_t height, size_type i)
+{
+    if (height == 0) {
+        leaf& l = m_leaves[idx];
+        uint32_t w = i>>6, off = i&63;
+        bool bit = (l.bits[w] >> off) & 1ULL;
+        uint64_t low = bit_magic::Li1Mask[off];
+        l.bits[w] = (l.bits[w] & low) | ((l.bits[w] >> 1) & ~low);
+        for (uint32_t k=w+1; k <= (l.size-1)>>6; ++k) {
+            l.bits[k-1] |= l.bits[k] << 63;
+            l.bits[k] >>= 1;
+        }
+        --l.size;
+        l.ones -= bit;
+        return bit;
+    }
+    node& n = m_nodes[idx]; // erase does not allocate nodes
+    uint32_t c = 0;
+    while (i >= n.size[c]) {
+        i -= n.size[c++];
+    }
+    uint32_t child = n.child[c];
+    bool bit = erase(child, height-1, i);
+    --n.size[c];
+    n.ones[c] -= bit;
+    bool underflow = (height == 1) ? (m_leaves[child].size < min_leaf_bits)
+                     : (m_nodes[child].cnt < min_node_cnt);
+    if (underflow and n.cnt > 1)
+        rebalance(idx, c, height-1);
+    return bit;
+}
+
+void bit_vector_dynamic::erase(size_type i)
+{
+    assert(i < m_size);
+    bool bit = erase(m_root, m_height, i);
+    --m_size;
+    m_ones -= bit;
+    while (m_height > 0 and m_nodes[m_root].cnt == 1) { // shrink the tree
+        uint32_t r = m_root;
+        m_root = m_nodes[r].child[0];
+        delete_node(r);
+        --m_height;
+    }
+}
+
+void bit_vector_dynamic::set(size_type i, bool bit)
+{
+    assert(i < m_size);
+    if ((bool)(*this)[i] == bit)
+        return;
+    uint32_t idx = m_root;
+    for (uint32_t h=m_height; h > 0; --h) {
+        node& n = m_nodes[idx];
+        uint32_t c = 0;
+        while (i >= n.size[c]) {
+            i -= n.size[c++];
+        }
+        n.ones[c] += bit ? 1 : -1;
+        idx = n.child[c];
+    }
+    leaf& l = m_leaves[idx];
+    l.bits[i>>6] ^= 1ULL << (i&63);
+    l.ones += bit ? 1 : -1;
+    m_ones += bit ? 1 : -1;
+}
+
+void bit_vector_dynamic::clear()
+{
+    build(bit_vector());
+}
+
+void bit_vector_dynamic::swap(bit_vector_dynamic& v)
+{
+    if (this != &v) {
+        std::swap(m_size, v.m_size);
+        std::swap(m_ones, v.m_ones);
+        std::swap(m_height, v.m_height);
+        std::swap(m_root, v.m_root);
+        m_leaves.swap(v.m_leaves);
+        m_nodes.swap(v.m_nodes);
+        m_free_leaves.swap(v.m_free_leaves);
+        m_free_nodes.swap(v.m_free_nodes);
+    }
+}
+
+void bit_vector_dynamic::copy_bits(bit_vector& bv, uint32_t idx, uint32_t height, size_type& pos)const
+{
+    if (height == 0) {
+        const leaf& l = m_leaves[idx];
+        for (uint32_t p=0; p < l.size; p += 64) {
+            uint8_t len = (uint8_t)std::min((uint32_t)64, l.size-p);
+            bv.set_int(pos+p, read_bits(l.bits, p, len), len);
+        }
+        pos += l.size;
+    } else {
+        const node& n = m_nodes[idx];
+        for (uint32_t c=0; c < n.cnt; ++c) {
+            copy_bits(bv, n.child[c], height-1, pos);
+        }
+    }
+}
+
+bit_vector bit_vector_dynamic::to_bit_vector()const
+{
+    bit_vector bv(m_size, 0);
+    size_type pos = 0;
+    copy_bits(bv, m_root, m_height, pos);
+    return bv;
+}
+
+bool bit_vector_dynamic::operator==(const bit_vector_dynamic& v)const
+{
+    if (this == &v)
+        return true;
+    return m_size == v.m_size and m_ones == v.m_ones and to_bit_vector() == v.to_bit_vector();
+}
+
+bit_vector_dynamic::size_type bit_vector_dynamic::serialize(std::ostream& out, structure_tree_node* v, std::string name)const
+{
+    structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+    size_type written_bytes = to_bit_vector().serialize(out, child, "bits");
+    structure_tree::add_size(child, written_bytes);
+    return written_bytes;
+}
+
+void bit_vector_dynamic::load(std::istream& in)
+{
+    bit_vector bv;
+    bv.load(in);
+    build(bv);
+}
+
+} // end namespace sdsl
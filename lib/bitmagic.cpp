@@ -15,10 +15,50 @@
     along with this program.  If not, see http://www.gnu.org/licenses/ .
 */
 #include "sdsl/bitmagic.hpp"
+#ifdef SDSL_BITMAGIC_X86
+#include <cpuid.h>
+#include <immintrin.h> // for the AVX2 kernels of read_ints
+#endif
 
 namespace sdsl
 {
 
+bit_magic::cpu_features bit_magic::detect_cpu_features()
+{
+    cpu_features f;
+    f.popcnt = f.bmi2 = f.fast_pdep = f.avx2 = false;
+#ifdef SDSL_BITMAGIC_X86
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int max_leaf = __get_cpuid_max(0, 0);
+    if (max_leaf >= 1 and __get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        f.popcnt = (ecx >> 23) & 1;
+        // AVX needs the OS to save the ymm registers (OSXSAVE and XCR0 bits 1 and 2)
+        bool avx = false;
+        if (((ecx >> 27) & 1) and ((ecx >> 28) & 1)) {
+            uint32_t xcr0_lo, xcr0_hi;
+            __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            avx = (xcr0_lo & 6) == 6;
+        }
+        uint32_t family = (eax >> 8) & 0xF;
+        if (family == 0xF) {
+            family += (eax >> 20) & 0xFF;
+        }
+        if (max_leaf >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            f.bmi2 = (ebx >> 8) & 1;
+            f.avx2 = avx and ((ebx >> 5) & 1);
+        }
+        unsigned int vendor[3];
+        __cpuid(0, eax, vendor[0], vendor[2], vendor[1]);
+        bool amd = (vendor[0] == 0x68747541); // "Auth"enticAMD
+        f.fast_pdep = f.bmi2 and !(amd and family < 0x19); // Zen 1 and 2 need hundreds of cycles for PDEP
+    }
+#endif
+    return f;
+}
+
+bit_magic::cpu_features bit_magic::cpu = bit_magic::detect_cpu_features();
+
 const uint8_t bit_magic::B1CntBytes[] = {
     0, 1, 1, 2, 1, 2, 2, 3,
     1, 2, 2, 3, 2, 3, 3, 4,
@@ -1165,5 +1205,208 @@ const uint8_t* bit_magic::covers[] = { cover0, cover1, cover2, cover3, cover4, c
 
 const uint32_t cover_sizes[] = {1,2,3,4,5,7,9,13,20};
 
+// Kernels for bit_magic::read_ints and bit_magic::write_ints.
+// A block of 64 integers of length len occupies exactly len words. The
+// position of each integer inside the block is a compile time constant,
+// so the template recursion below yields a fully unrolled, branch free
+// sequence of shifts and masks for each length.
+// There are no PEXT/PDEP variants: these instructions gather or scatter
+// several fields inside one word, but each integer here is read from or
+// written to a word of its own, which already takes one shift and one mask
+// (two shifts if it spans a word boundary). For the byte aligned lengths
+// 8, 16 and 32 read_ints selects AVX2 kernels if bit_magic::cpu.avx2 is set,
+// which zero extend four integers with one instruction.
+namespace
+{
+
+template<uint8_t len, uint32_t k>
+struct unpack_step {
+    static inline void apply(const uint64_t* in, uint64_t* out) {
+        const uint64_t mask = len==64 ? 0xFFFFFFFFFFFFFFFFULL : ((1ULL<<(len&0x3F))-1);
+        const uint32_t i = (k*len)>>6;
+        const uint32_t o = (k*len)&0x3F;
+        if (o+len > 64) {
+            out[k] = ((in[i] >> o) | (in[i+1] << ((64-o)&0x3F))) & mask;
+        } else {
+            out[k] = (in[i] >> o) & mask;
+        }
+        unpack_step<len, k+1>::apply(in, out);
+    }
+};
+
+template<uint8_t len>
+struct unpack_step<len, 64> {
+    static inline void apply(const uint64_t*, uint64_t*) {}
+};
+
+template<uint8_t len, uint32_t k>
+struct pack_step {
+    static inline void apply(const uint64_t* in, uint64_t* out) {
+        const uint64_t mask = len==64 ? 0xFFFFFFFFFFFFFFFFULL : ((1ULL<<(len&0x3F))-1);
+        const uint32_t i = (k*len)>>6;
+        const uint32_t o = (k*len)&0x3F;
+        const uint64_t x = in[k] & mask;
+        if (o == 0) {
+            out[i] = x;
+        } else {
+            out[i] |= x << o;
+        }
+        if (o+len > 64) {
+            out[i+1] = x >> ((64-o)&0x3F);
+        }
+        pack_step<len, k+1>::apply(in, out);
+    }
+};
+
+template<uint8_t len>
+struct pack_step<len, 64> {
+    static inline void apply(const uint64_t*, uint64_t*) {}
+};
+
+template<uint8_t len>
+void unpack64(const uint64_t* in, uint64_t* out)
+{
+    unpack_step<len, 0>::apply(in, out);
+}
+
+template<uint8_t len>
+void pack64(const uint64_t* in, uint64_t* out)
+{
+    pack_step<len, 0>::apply(in, out);
+}
+
+typedef void (*bulk_kernel)(const uint64_t*, uint64_t*);
+
+#if defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+// The AVX2 kernels are compiled for AVX2 regardless of the flags of the
+// translation unit and are only called if bit_magic::cpu.avx2 is set.
+__attribute__((target("avx2")))
+void unpack64_avx2_8(const uint64_t* in, uint64_t* out)
+{
+    const __m128i* src = (const __m128i*)in;
+    for (uint32_t k=0; k < 4; ++k) { // 16 integers per 128 bits
+        __m128i x = _mm_loadu_si128(src+k);
+        for (uint32_t j=0; j < 4; ++j, x = _mm_srli_si128(x, 4)) {
+            _mm256_storeu_si256((__m256i*)(out + 16*k + 4*j), _mm256_cvtepu8_epi64(x));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void unpack64_avx2_16(const uint64_t* in, uint64_t* out)
+{
+    const __m128i* src = (const __m128i*)in;
+    for (uint32_t k=0; k < 8; ++k) { // 8 integers per 128 bits
+        __m128i x = _mm_loadu_si128(src+k);
+        _mm256_storeu_si256((__m256i*)(out + 8*k), _mm256_cvtepu16_epi64(x));
+        _mm256_storeu_si256((__m256i*)(out + 8*k + 4), _mm256_cvtepu16_epi64(_mm_srli_si128(x, 8)));
+    }
+}
+
+__attribute__((target("avx2")))
+void unpack64_avx2_32(const uint64_t* in, uint64_t* out)
+{
+    const __m128i* src = (const __m128i*)in;
+    for (uint32_t k=0; k < 16; ++k) { // 4 integers per 128 bits
+        _mm256_storeu_si256((__m256i*)(out + 4*k), _mm256_cvtepu32_epi64(_mm_loadu_si128(src+k)));
+    }
+}
+#endif
+
+const bulk_kernel unpack_kernels[65] = {
+    NULL,
+    &unpack64<1>, &unpack64<2>, &unpack64<3>, &unpack64<4>, &unpack64<5>, &unpack64<6>, &unpack64<7>, &unpack64<8>,
+    &unpack64<9>, &unpack64<10>, &unpack64<11>, &unpack64<12>, &unpack64<13>, &unpack64<14>, &unpack64<15>, &unpack64<16>,
+    &unpack64<17>, &unpack64<18>, &unpack64<19>, &unpack64<20>, &unpack64<21>, &unpack64<22>, &unpack64<23>, &unpack64<24>,
+    &unpack64<25>, &unpack64<26>, &unpack64<27>, &unpack64<28>, &unpack64<29>, &unpack64<30>, &unpack64<31>, &unpack64<32>,
+    &unpack64<33>, &unpack64<34>, &unpack64<35>, &unpack64<36>, &unpack64<37>, &unpack64<38>, &unpack64<39>, &unpack64<40>,
+    &unpack64<41>, &unpack64<42>, &unpack64<43>, &unpack64<44>, &unpack64<45>, &unpack64<46>, &unpack64<47>, &unpack64<48>,
+    &unpack64<49>, &unpack64<50>, &unpack64<51>, &unpack64<52>, &unpack64<53>, &unpack64<54>, &unpack64<55>, &unpack64<56>,
+    &unpack64<57>, &unpack64<58>, &unpack64<59>, &unpack64<60>, &unpack64<61>, &unpack64<62>, &unpack64<63>, &unpack64<64>
+};
+
+const bulk_kernel pack_kernels[65] = {
+    NULL,
+    &pack64<1>, &pack64<2>, &pack64<3>, &pack64<4>, &pack64<5>, &pack64<6>, &pack64<7>, &pack64<8>,
+    &pack64<9>, &pack64<10>, &pack64<11>, &pack64<12>, &pack64<13>, &pack64<14>, &pack64<15>, &pack64<16>,
+    &pack64<17>, &pack64<18>, &pack64<19>, &pack64<20>, &pack64<21>, &pack64<22>, &pack64<23>, &pack64<24>,
+    &pack64<25>, &pack64<26>, &pack64<27>, &pack64<28>, &pack64<29>, &pack64<30>, &pack64<31>, &pack64<32>,
+    &pack64<33>, &pack64<34>, &pack64<35>, &pack64<36>, &pack64<37>, &pack64<38>, &pack64<39>, &pack64<40>,
+    &pack64<41>, &pack64<42>, &pack64<43>, &pack64<44>, &pack64<45>, &pack64<46>, &pack64<47>, &pack64<48>,
+    &pack64<49>, &pack64<50>, &pack64<51>, &pack64<52>, &pack64<53>, &pack64<54>, &pack64<55>, &pack64<56>,
+    &pack64<57>, &pack64<58>, &pack64<59>, &pack64<60>, &pack64<61>, &pack64<62>, &pack64<63>, &pack64<64>
+};
+
+// Returns the kernel which decodes a block of 64 integers of length len.
+bulk_kernel unpack_kernel(uint8_t len)
+{
+#if defined(SDSL_BITMAGIC_X86) && defined(__x86_64__)
+    if (bit_magic::cpu.avx2) {
+        switch (len) {
+            case 8: return &unpack64_avx2_8;
+            case 16: return &unpack64_avx2_16;
+            case 32: return &unpack64_avx2_32;
+        }
+    }
+#endif
+    return unpack_kernels[len];
+}
+
+} // end anonymous namespace
+
+void bit_magic::read_ints(const uint64_t* word, uint64_t offset, const uint8_t len, uint64_t n, uint64_t* out)
+{
+    word += (offset>>6);
+    uint8_t o = offset&0x3F;
+    if (n >= 64) {
+        bulk_kernel unpack = unpack_kernel(len);
+        uint64_t aligned[64];
+        while (n >= 64) {
+            const uint64_t* block = word;
+            if (o) { // shift the block to a word boundary
+                for (uint8_t i=0; i < len; ++i) {
+                    aligned[i] = (word[i] >> o) | (word[i+1] << (64-o));
+                }
+                block = aligned;
+            }
+            unpack(block, out);
+            word += len;
+            out  += 64;
+            n    -= 64;
+        }
+    }
+    for (; n > 0; --n) {
+        *(out++) = read_int_and_move(word, o, len);
+    }
+}
+
+void bit_magic::write_ints(uint64_t* word, uint64_t offset, const uint8_t len, uint64_t n, const uint64_t* in)
+{
+    word += (offset>>6);
+    uint8_t o = offset&0x3F;
+    if (n >= 64) {
+        bulk_kernel pack = pack_kernels[len];
+        uint64_t aligned[64];
+        while (n >= 64) {
+            if (o) { // pack to a word boundary and merge the shifted block
+                pack(in, aligned);
+                word[0] = (word[0] & Li1Mask[o]) | (aligned[0] << o);
+                for (uint8_t i=1; i < len; ++i) {
+                    word[i] = (aligned[i-1] >> (64-o)) | (aligned[i] << o);
+                }
+                word[len] = (word[len] & ~Li1Mask[o]) | (aligned[len-1] >> (64-o));
+            } else {
+                pack(in, word);
+            }
+            word += len;
+            in   += 64;
+            n    -= 64;
+        }
+    }
+    for (; n > 0; --n) {
+        write_int_and_move(word, *(in++), o, len);
+    }
+}
+
 } // end namespace sdsl
 
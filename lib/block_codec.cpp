@@ -0,0 +1,332 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/block_codec.hpp"
+#include <algorithm> // for std::min
+#include <cstring>   // for memcpy, memset
+#include <vector>
+
+namespace sdsl
+{
+
+namespace
+{
+
+uint64_t raw_bytes_cnt     = 0;
+uint64_t encoded_bytes_cnt = 0;
+
+inline uint8_t bit_width(uint64_t x)
+{
+    return x == 0 ? 1 : 64 - __builtin_clzll(x);
+}
+
+inline uint64_t vbyte_size(uint64_t x)
+{
+    return (bit_width(x)+6)/7;
+}
+
+inline uint64_t zigzag(uint64_t cur, uint64_t prev)
+{
+    int64_t d = (int64_t)(cur - prev);
+    return ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+}
+
+inline uint64_t unzigzag(uint64_t z, uint64_t prev)
+{
+    return prev + ((z >> 1) ^ (0 - (z & 1)));
+}
+
+inline uint8_t* write_vbyte(uint64_t x, uint8_t* out)
+{
+    while (x >= 128) {
+        *(out++) = (uint8_t)(x | 128);
+        x >>= 7;
+    }
+    *(out++) = (uint8_t)x;
+    return out;
+}
+
+inline const uint8_t* read_vbyte(const uint8_t* in, uint64_t& x)
+{
+    x = 0;
+    uint8_t shift = 0;
+    while (*in & 128) {
+        x |= ((uint64_t)(*(in++) & 127)) << shift;
+        shift += 7;
+    }
+    x |= ((uint64_t)*(in++)) << shift;
+    return in;
+}
+
+void count(uint64_t raw, uint64_t encoded)
+{
+    __sync_fetch_and_add(&raw_bytes_cnt, raw);
+    __sync_fetch_and_add(&encoded_bytes_cnt, encoded);
+}
+
+} // end anonymous namespace
+
+uint64_t block_codec::encode_ints(const uint64_t* in, uint64_t n, uint8_t* out)
+{
+    uint64_t max = 0, vbyte = 0, delta = 0, prev = 0;
+    for (uint64_t i=0; i < n; ++i) {
+        max   |= in[i];
+        vbyte += vbyte_size(in[i]);
+        delta += vbyte_size(zigzag(in[i], prev));
+        prev   = in[i];
+    }
+    uint8_t width = bit_width(max);
+    uint64_t raw = 2 + (n*width+7)/8;
+    uint8_t* begin = out;
+    if (raw <= vbyte and raw <= delta) {
+        *(out++) = RAW;
+        *(out++) = width;
+        uint64_t buf = 0;
+        uint8_t  buf_len = 0;
+        for (uint64_t i=0; i < n; ++i) {
+            uint64_t x = in[i];
+            uint8_t  len = width;
+            // at most 7 bits are pending, so split values of more than 56 bits
+            if (len > 56) {
+                buf |= (x & 0xFFFFFFFFULL) << buf_len;
+                buf_len += 32;
+                for (; buf_len >= 8; buf_len -= 8, buf >>= 8) {
+                    *(out++) = (uint8_t)buf;
+                }
+                x >>= 32;
+                len -= 32;
+            }
+            buf |= x << buf_len;
+            buf_len += len;
+            for (; buf_len >= 8; buf_len -= 8, buf >>= 8) {
+                *(out++) = (uint8_t)buf;
+            }
+        }
+        if (buf_len > 0) {
+            *(out++) = (uint8_t)buf;
+        }
+    } else if (vbyte <= delta) {
+        *(out++) = VBYTE;
+        for (uint64_t i=0; i < n; ++i) {
+            out = write_vbyte(in[i], out);
+        }
+    } else {
+        *(out++) = DELTA;
+        prev = 0;
+        for (uint64_t i=0; i < n; ++i) {
+            out = write_vbyte(zigzag(in[i], prev), out);
+            prev = in[i];
+        }
+    }
+    return out - begin;
+}
+
+uint64_t block_codec::decode_ints(const uint8_t* in, uint64_t n, uint64_t* out)
+{
+    const uint8_t* begin = in;
+    uint8_t type = *(in++);
+    if (type == RAW) {
+        uint8_t width = *(in++);
+        uint64_t mask = width == 64 ? 0xFFFFFFFFFFFFFFFFULL : (1ULL << width)-1;
+        uint64_t buf = 0;
+        uint8_t  buf_len = 0;
+        for (uint64_t i=0; i < n; ++i) {
+            if (width > 56) {
+                while (buf_len < 32) {
+                    buf |= ((uint64_t)*(in++)) << buf_len;
+                    buf_len += 8;
+                }
+                uint64_t x = buf & 0xFFFFFFFFULL;
+                buf = buf >> 32;
+                buf_len -= 32;
+                while (buf_len < width-32) {
+                    buf |= ((uint64_t)*(in++)) << buf_len;
+                    buf_len += 8;
+                }
+                out[i] = x | ((buf & (mask>>32)) << 32);
+                buf = (width-32 == 32) ? 0 : buf >> (width-32);
+                buf_len -= width-32;
+            } else {
+                while (buf_len < width) {
+                    buf |= ((uint64_t)*(in++)) << buf_len;
+                    buf_len += 8;
+                }
+                out[i] = buf & mask;
+                buf >>= width;
+                buf_len -= width;
+            }
+        }
+    } else if (type == VBYTE) {
+        for (uint64_t i=0; i < n; ++i) {
+            in = read_vbyte(in, out[i]);
+        }
+    } else {
+        uint64_t prev = 0, z;
+        for (uint64_t i=0; i < n; ++i) {
+            in = read_vbyte(in, z);
+            prev = out[i] = unzigzag(z, prev);
+        }
+    }
+    return in - begin;
+}
+
+// A control byte c < 128 is followed by c+1 literals, a control byte
+// c >= 128 is followed by one byte which is repeated c-128+3 times.
+uint64_t block_codec::encode_bytes(const uint8_t* in, uint64_t n, uint8_t* out)
+{
+    uint8_t* begin = out;
+    uint64_t i = 0, lit = 0; // in[lit..i-1] are pending literals
+    while (i < n) {
+        uint64_t run = 1;
+        while (i+run < n and run < 130 and in[i+run] == in[i]) {
+            ++run;
+        }
+        if (run >= 3) {
+            while (lit < i) {
+                uint64_t len = std::min((uint64_t)128, i-lit);
+                *(out++) = (uint8_t)(len-1);
+                memcpy(out, in+lit, len);
+                out += len; lit += len;
+            }
+            *(out++) = (uint8_t)(128+run-3);
+            *(out++) = in[i];
+            i  += run;
+            lit = i;
+        } else {
+            i += run;
+        }
+    }
+    while (lit < n) {
+        uint64_t len = std::min((uint64_t)128, n-lit);
+        *(out++) = (uint8_t)(len-1);
+        memcpy(out, in+lit, len);
+        out += len; lit += len;
+    }
+    return out - begin;
+}
+
+uint64_t block_codec::decode_bytes(const uint8_t* in, uint64_t len, uint64_t n, uint8_t* out)
+{
+    const uint8_t* begin = in;
+    const uint8_t* end   = in + len;
+    for (uint64_t i=0; i < n;) {
+        if (in == end) {
+            return 0;
+        }
+        uint8_t c = *(in++);
+        if (c < 128) {
+            uint64_t run = c+1;
+            if (run > n-i or run > (uint64_t)(end-in)) {
+                return 0;
+            }
+            memcpy(out+i, in, run);
+            in += run; i += run;
+        } else {
+            uint64_t run = c-128+3;
+            if (run > n-i or in == end) {
+                return 0;
+            }
+            memset(out+i, *(in++), run);
+            i += run;
+        }
+    }
+    return in - begin;
+}
+
+uint64_t block_codec::write_ints(std::ostream& out, const uint64_t* in, uint64_t n, uint8_t width)
+{
+    std::vector<uint8_t> buf(sizeof(uint64_t)+max_encoded_ints_size(n));
+    uint64_t len = write_ints(&buf[0], in, n, width);
+    out.write((char*)&buf[0], len);
+    return len;
+}
+
+uint64_t block_codec::write_ints(uint8_t* out, const uint64_t* in, uint64_t n, uint8_t width)
+{
+    uint64_t len = encode_ints(in, n, out+sizeof(len));
+    memcpy(out, &len, sizeof(len));
+    count((n*width+7)/8, len+sizeof(len));
+    return len+sizeof(len);
+}
+
+bool block_codec::read_ints(std::istream& in, uint64_t n, uint64_t* out)
+{
+    uint64_t len = 0;
+    if (!in.read((char*)&len, sizeof(len)) or len > max_encoded_ints_size(n)) {
+        return false;
+    }
+    std::vector<uint8_t> buf(len+1);
+    if (!in.read((char*)&buf[0], len)) {
+        return false;
+    }
+    return decode_ints(&buf[0], n, out) == len;
+}
+
+uint64_t block_codec::write_bytes(std::ostream& out, const uint8_t* in, uint64_t n)
+{
+    std::vector<uint8_t> buf(max_encoded_bytes_size(n));
+    uint64_t len = encode_bytes(in, n, &buf[0]);
+    out.write((char*)&len, sizeof(len));
+    out.write((char*)&buf[0], len);
+    count(n, len+sizeof(len));
+    return len+sizeof(len);
+}
+
+bool block_codec::read_bytes(std::istream& in, uint64_t n, uint8_t* out)
+{
+    uint64_t len = 0;
+    if (!in.read((char*)&len, sizeof(len)) or len > max_encoded_bytes_size(n)) {
+        return false;
+    }
+    std::vector<uint8_t> buf(len+1);
+    if (!in.read((char*)&buf[0], len)) {
+        return false;
+    }
+    return decode_bytes(&buf[0], len, n, out) == len;
+}
+
+block_codec::statistics block_codec::stats()
+{
+    statistics s;
+    s.raw_bytes     = raw_bytes_cnt;
+    s.encoded_bytes = encoded_bytes_cnt;
+    return s;
+}
+
+void block_codec::reset_stats()
+{
+    raw_bytes_cnt     = 0;
+    encoded_bytes_cnt = 0;
+}
+
+namespace util
+{
+
+static bool compress_temp_files = false;
+
+void set_temp_file_compression(bool compress)
+{
+    compress_temp_files = compress;
+}
+
+bool temp_file_compression()
+{
+    return compress_temp_files;
+}
+
+} // end namespace util
+
+} // end namespace sdsl
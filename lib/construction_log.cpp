@@ -0,0 +1,292 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/construction_log.hpp"
+#include "sdsl/memory_management.hpp"
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sys/time.h>     // for gettimeofday
+#include <sys/resource.h> // for getrusage
+#include <unistd.h>       // for sysconf
+
+namespace sdsl
+{
+
+namespace
+{
+
+// Snapshot of the resource counters of the process.
+struct sample {
+    double   real, user, sys; // in milliseconds
+    uint64_t rss, hwm;
+    uint64_t heap, peak_heap;
+    uint64_t rchar, wchar, read_bytes, write_bytes;
+};
+
+bool                            log_enabled = false;
+bool                            log_reset_rss = false;
+timeval                         log_start;
+std::vector<construction_phase> log_phases;
+std::vector<size_t>             open_phases;  // indices of the open phases in log_phases
+std::vector<sample>             open_samples; // samples at the begin of the open phases
+
+double to_ms(const timeval& t)
+{
+    return t.tv_sec*1000.0 + t.tv_usec/1000.0;
+}
+
+// Reads the value of key (e.g. "VmHWM:" or "rchar:") from a /proc file of the form "key value".
+uint64_t read_proc_value(const char* file_name, const char* key)
+{
+    std::ifstream in(file_name);
+    std::string k;
+    uint64_t value;
+    while (in >> k) {
+        if (k == key) {
+            return (in >> value) ? value : 0;
+        }
+        in.ignore(1024, '\n');
+    }
+    return 0;
+}
+
+// Reads the I/O counters of the process in one pass
+void read_io_counters(sample& s)
+{
+    s.rchar = s.wchar = s.read_bytes = s.write_bytes = 0;
+    std::ifstream in("/proc/self/io");
+    std::string k;
+    uint64_t value;
+    while (in >> k >> value) {
+        if (k == "rchar:") {
+            s.rchar = value;
+        } else if (k == "wchar:") {
+            s.wchar = value;
+        } else if (k == "read_bytes:") {
+            s.read_bytes = value;
+        } else if (k == "write_bytes:") {
+            s.write_bytes = value;
+        }
+    }
+}
+
+sample take_sample()
+{
+    sample s;
+    read_io_counters(s); // first, so that the reads of the other /proc files are not attributed to the phase
+    timeval t;
+    gettimeofday(&t, 0);
+    s.real = to_ms(t) - to_ms(log_start);
+    rusage r;
+    getrusage(RUSAGE_SELF, &r);
+    s.user = to_ms(r.ru_utime);
+    s.sys  = to_ms(r.ru_stime);
+    uint64_t pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> resident;
+    s.rss = resident * sysconf(_SC_PAGESIZE);
+    s.hwm = read_proc_value("/proc/self/status", "VmHWM:") * 1024;
+    if (s.hwm < s.rss) {
+        s.hwm = s.rss;
+    }
+    s.heap      = memory_manager::allocated_bytes();
+    s.peak_heap = memory_manager::peak_bytes();
+    return s;
+}
+
+// Resets the peak counters, so that the next sample reports the peaks from now on.
+void reset_peaks()
+{
+    if (log_reset_rss) {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5"; // reset the high water mark of the RSS
+    }
+    memory_manager::reset_peak_bytes();
+}
+
+// Updates the peaks of all open phases
+void fold_peaks(const sample& s)
+{
+    for (size_t i=0; i < open_phases.size(); ++i) {
+        construction_phase& p = log_phases[open_phases[i]];
+        uint64_t peak_rss = s.hwm;
+        if (!log_reset_rss and s.hwm <= open_samples[i].hwm) {
+            peak_rss = s.rss; // the high water mark was reached before the phase
+        }
+        if (peak_rss > p.peak_rss) {
+            p.peak_rss = peak_rss;
+        }
+        if (s.peak_heap > p.peak_heap) {
+            p.peak_heap = s.peak_heap;
+        }
+    }
+}
+
+void close_phase(const sample& s, bool complete)
+{
+    construction_phase& p = log_phases[open_phases.back()];
+    const sample& b = open_samples.back();
+    p.complete      = complete;
+    p.end           = s.real;
+    p.user_time     = s.user - b.user;
+    p.sys_time      = s.sys - b.sys;
+    p.rss_end       = s.rss;
+    p.heap_end      = s.heap;
+    p.bytes_read    = s.rchar - b.rchar;
+    p.bytes_written = s.wchar - b.wchar;
+    p.disk_read     = s.read_bytes - b.read_bytes;
+    p.disk_written  = s.write_bytes - b.write_bytes;
+    open_phases.pop_back();
+    open_samples.pop_back();
+}
+
+// Writes s as JSON string
+void write_json_string(std::ostream& out, const std::string& s)
+{
+    out << "\"";
+    for (size_t i=0; i < s.size(); ++i) {
+        if (s[i] == '"' or s[i] == '\\') {
+            out << "\\" << s[i];
+        } else if ((unsigned char)s[i] < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)s[i] << std::dec << std::setfill(' ');
+        } else {
+            out << s[i];
+        }
+    }
+    out << "\"";
+}
+
+} // end anonymous namespace
+
+void construction_log::enable(bool enable)
+{
+    if (enable) {
+        clear();
+    }
+    log_enabled = enable;
+}
+
+bool construction_log::enabled()
+{
+    return log_enabled;
+}
+
+void construction_log::reset_peak_rss(bool reset)
+{
+    log_reset_rss = reset;
+}
+
+void construction_log::clear()
+{
+    log_phases.clear();
+    open_phases.clear();
+    open_samples.clear();
+    gettimeofday(&log_start, 0);
+}
+
+void construction_log::record(const std::string& data_structure, const std::string& action, const std::string& state)
+{
+    if (!log_enabled) {
+        return;
+    }
+    sample s = take_sample();
+    fold_peaks(s);
+    if (state == "begin") {
+        construction_phase p;
+        p.data_structure = data_structure;
+        p.action         = action;
+        p.depth          = open_phases.size();
+        p.complete       = false;
+        p.begin          = s.real;
+        p.end            = s.real;
+        p.user_time      = p.sys_time = 0;
+        p.rss_begin      = p.rss_end = p.peak_rss = s.rss;
+        p.heap_begin     = p.heap_end = p.peak_heap = s.heap;
+        p.bytes_read     = p.bytes_written = p.disk_read = p.disk_written = 0;
+        open_phases.push_back(log_phases.size());
+        open_samples.push_back(s);
+        log_phases.push_back(p);
+    } else if (state == "end") {
+        size_t i = open_phases.size();
+        while (i > 0 and (log_phases[open_phases[i-1]].data_structure != data_structure or
+                          log_phases[open_phases[i-1]].action != action)) {
+            --i;
+        }
+        if (i == 0) {
+            return; // end without begin
+        }
+        while (open_phases.size() > i) {
+            close_phase(s, false);
+        }
+        close_phase(s, true);
+    }
+    reset_peaks();
+}
+
+const std::vector<construction_phase>& construction_log::phases()
+{
+    return log_phases;
+}
+
+void construction_log::write_json(std::ostream& out)
+{
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << "{\n  \"phases\": [";
+    for (size_t i=0; i < log_phases.size(); ++i) {
+        const construction_phase& p = log_phases[i];
+        out << (i ? ",\n" : "\n") << "    {";
+        out << "\"data_structure\": ";
+        write_json_string(out, p.data_structure);
+        out << ", \"action\": ";
+        write_json_string(out, p.action);
+        out << std::fixed << std::setprecision(3)
+            << ", \"depth\": " << p.depth
+            << ", \"complete\": " << (p.complete ? "true" : "false")
+            << ", \"begin_ms\": " << p.begin
+            << ", \"end_ms\": " << p.end
+            << ", \"wall_ms\": " << p.end - p.begin
+            << ", \"user_ms\": " << p.user_time
+            << ", \"sys_ms\": " << p.sys_time
+            << ", \"rss_begin\": " << p.rss_begin
+            << ", \"rss_end\": " << p.rss_end
+            << ", \"peak_rss\": " << p.peak_rss
+            << ", \"heap_begin\": " << p.heap_begin
+            << ", \"heap_end\": " << p.heap_end
+            << ", \"peak_heap\": " << p.peak_heap
+            << ", \"bytes_read\": " << p.bytes_read
+            << ", \"bytes_written\": " << p.bytes_written
+            << ", \"disk_read\": " << p.disk_read
+            << ", \"disk_written\": " << p.disk_written
+            << "}";
+    }
+    out << "\n  ]\n}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool construction_log::store_json(const char* file_name)
+{
+    std::ofstream out(file_name, std::ios::trunc | std::ios::out);
+    if (!out) {
+        return false;
+    }
+    write_json(out);
+    return out.good();
+}
+
+} // end namespace sdsl
@@ -0,0 +1,352 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/construction_workspace.hpp"
+#include "sdsl/container.hpp"     // for checksum64
+#include "sdsl/int_vector.hpp"    // for char_array_serialize_wrapper
+#include "sdsl/util.hpp"
+#include "sdsl/testutils.hpp"     // for file::read_text
+#include "sdsl/algorithms_for_suffix_array_construction.hpp" // for shift_text
+#include <algorithm>
+#include <cerrno>      // for errno
+#include <cstdio>      // for remove
+#include <cstring>     // for strlen
+#include <fstream>
+#include <sstream>
+#include <dirent.h>    // for opendir, readdir
+#include <fcntl.h>     // for open
+#include <unistd.h>    // for close
+#include <sys/file.h>  // for flock
+#include <sys/stat.h>  // for stat
+#include <utime.h>     // for utime
+
+namespace sdsl
+{
+
+const char* construction_workspace::reusable_artifacts[] = {"text", "sa", "isa", "lcp", "bwt", NULL};
+
+namespace
+{
+
+const std::string manifest_prefix = "workspace_";
+const std::string lock_prefix     = "workspace_lock_"; // not a manifest, see is_manifest
+
+bool is_manifest(const std::string& entry)
+{
+    return entry.compare(0, manifest_prefix.size(), manifest_prefix) == 0
+           and entry.compare(0, lock_prefix.size(), lock_prefix) != 0;
+}
+
+typedef std::vector<std::pair<std::string, uint64_t> > tArtifactList;
+
+bool is_reusable(const std::string& key)
+{
+    for (const char** k = construction_workspace::reusable_artifacts; *k != NULL; ++k) {
+        if (key == *k) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool file_size(const std::string& file_name, uint64_t& size)
+{
+    struct stat s;
+    if (stat(file_name.c_str(), &s) != 0) {
+        return false;
+    }
+    size = s.st_size;
+    return true;
+}
+
+// Reads the list of (key, size) pairs of a manifest file.
+tArtifactList read_artifact_list(const std::string& manifest)
+{
+    tArtifactList res;
+    std::ifstream in(manifest.c_str());
+    std::string key;
+    uint64_t size;
+    while (in >> key >> size) {
+        res.push_back(std::make_pair(key, size));
+    }
+    return res;
+}
+
+// Hashes the content of a file.
+bool hash_file(const std::string& file_name, checksum64& c)
+{
+    std::ifstream in(file_name.c_str(), std::ios::binary | std::ios::in);
+    if (!in) {
+        return false;
+    }
+    std::vector<char> buf(1<<20);
+    while (in) {
+        in.read(&buf[0], buf.size());
+        c.update(&buf[0], in.gcount());
+    }
+    return true;
+}
+
+struct cached_input {
+    std::string id;
+    uint64_t    size;  // size of all artifacts
+    time_t      mtime; // last use
+    bool operator<(const cached_input& c)const {
+        return mtime < c.mtime;
+    }
+};
+
+} // end anonymous namespace
+
+construction_workspace::construction_workspace(const std::string& dir, bool persistent, uint64_t disk_budget):
+    m_dir(dir), m_persistent(persistent), m_disk_budget(disk_budget), m_finished(false), m_lock_fd(-1) {}
+
+construction_workspace::~construction_workspace()
+{
+    if (!m_finished) {
+        // remove everything which is not recorded in the manifest, since it might be incomplete
+        for (tMSS::const_iterator it=m_file_map.begin(); it!=m_file_map.end(); ++it) {
+            if (m_kept.find(it->first) == m_kept.end()) {
+                std::remove(it->second.c_str());
+            }
+        }
+    }
+    unlock();
+}
+
+std::string construction_workspace::manifest_file_name()const
+{
+    return m_dir + manifest_prefix + m_id;
+}
+
+bool construction_workspace::lock()
+{
+    unlock();
+    m_lock_fd = open((m_dir + lock_prefix + m_id).c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_lock_fd < 0) {
+        return false;
+    }
+    while (flock(m_lock_fd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            unlock();
+            return false;
+        }
+    }
+    return true;
+}
+
+void construction_workspace::unlock()
+{
+    if (m_lock_fd >= 0) {
+        close(m_lock_fd); // releases the lock
+        m_lock_fd = -1;
+    }
+}
+
+void construction_workspace::read_manifest()
+{
+    m_kept.clear();
+    tArtifactList artifacts = read_artifact_list(manifest_file_name());
+    for (size_t i=0; i < artifacts.size(); ++i) {
+        std::string name = file_name(m_dir, artifacts[i].first, m_id);
+        uint64_t size;
+        if (file_size(name, size) and size == artifacts[i].second) {
+            m_kept[artifacts[i].first] = name;
+            m_file_map[artifacts[i].first] = name;
+        }
+    }
+    // Files of reusable artifacts which are not in the manifest are remains of an
+    // aborted construction. Remove them, as some construction steps test only for
+    // the existence of a file. The lock guarantees that no other construction
+    // writes them.
+    for (const char** k = reusable_artifacts; *k != NULL; ++k) {
+        if (m_kept.find(*k) == m_kept.end()) {
+            std::remove(file_name(m_dir, *k, m_id).c_str());
+        }
+    }
+    if (!m_kept.empty()) {
+        utime(manifest_file_name().c_str(), NULL); // mark as recently used
+    }
+}
+
+bool construction_workspace::write_manifest()const
+{
+    if (m_kept.empty()) {
+        std::remove(manifest_file_name().c_str());
+        return true;
+    }
+    std::ofstream out(manifest_file_name().c_str(), std::ios::trunc | std::ios::out);
+    for (tMSS::const_iterator it=m_kept.begin(); it!=m_kept.end(); ++it) {
+        uint64_t size = 0;
+        file_size(it->second, size);
+        out << it->first << " " << size << "\n";
+    }
+    return out.good();
+}
+
+bool construction_workspace::add_text(const std::string& text_file_name, const std::string& params, bool reverse)
+{
+    unlock();
+    m_finished = false;
+    m_file_map.clear();
+    m_kept.clear();
+    m_reused.clear();
+    if (m_persistent) {
+        checksum64 c;
+        if (!hash_file(text_file_name, c)) {
+            return false;
+        }
+        std::string p = params + (reverse ? "/reversed" : "");
+        c.update(p.c_str(), p.size()+1);
+        std::stringstream ss;
+        ss << std::hex << c.value();
+        m_id = ss.str();
+        if (!lock()) {
+            return false;
+        }
+        read_manifest();
+        m_reused = m_kept;
+        if (m_kept.find("text") != m_kept.end()) {
+            return true;
+        }
+    } else {
+        m_id = util::to_string(util::get_pid())+"_"+util::to_string(util::get_id());
+    }
+
+    char* text = NULL;
+    uint64_t fs = file::read_text(text_file_name.c_str(), text);
+    if (fs == 0) {
+        return false;
+    }
+    uint64_t n = strlen((const char*)text);
+    if (fs != n+1) {
+        std::cerr << "# WARNING: file \"" << text_file_name << "\" contains 0-bytes." << std::endl;
+        algorithm::shift_text(text, fs, true);
+        n = fs-1;
+    }
+    if (reverse) {
+        std::reverse(text, text+n);
+    }
+    std::string name = file_name(m_dir, "text", m_id);
+    bool stored = util::store_to_file(char_array_serialize_wrapper<>((unsigned char*)text, n+1), name.c_str());
+    delete [] text;
+    m_file_map["text"] = name;
+    return stored;
+}
+
+bool construction_workspace::reused(const std::string& key)const
+{
+    return m_reused.find(key) != m_reused.end();
+}
+
+void construction_workspace::finish()
+{
+    if (!m_persistent) {
+        util::delete_all_files(m_file_map);
+        m_finished = true;
+        return;
+    }
+    tMSS file_map;
+    for (tMSS::const_iterator it=m_file_map.begin(); it!=m_file_map.end(); ++it) {
+        uint64_t size;
+        if (is_reusable(it->first) and it->second == file_name(m_dir, it->first, m_id)
+            and file_size(it->second, size)) {
+            m_kept[it->first] = it->second;
+            file_map[it->first] = it->second;
+        } else {
+            std::remove(it->second.c_str());
+        }
+    }
+    m_file_map.swap(file_map);
+    write_manifest();
+    enforce_disk_budget();
+    m_finished = true;
+    unlock();
+}
+
+void construction_workspace::enforce_disk_budget()
+{
+    if (m_disk_budget == 0) {
+        return;
+    }
+    uint64_t total = 0;
+    std::vector<cached_input> others;
+    DIR* d = opendir(m_dir.c_str());
+    if (d != NULL) {
+        for (struct dirent* e = readdir(d); e != NULL; e = readdir(d)) {
+            std::string entry = e->d_name;
+            if (!is_manifest(entry)) {
+                continue;
+            }
+            struct stat s;
+            if (stat((m_dir+entry).c_str(), &s) != 0) {
+                continue;
+            }
+            cached_input c;
+            c.id    = entry.substr(manifest_prefix.size());
+            c.size  = 0;
+            c.mtime = s.st_mtime;
+            tArtifactList artifacts = read_artifact_list(m_dir+entry);
+            for (size_t i=0; i < artifacts.size(); ++i) {
+                c.size += artifacts[i].second;
+            }
+            total += c.size;
+            if (c.id != m_id) {
+                others.push_back(c);
+            }
+        }
+        closedir(d);
+    }
+    // evict the artifacts of other inputs, least recently used first, unless
+    // another construction uses them
+    std::sort(others.begin(), others.end());
+    for (size_t i=0; i < others.size() and total > m_disk_budget; ++i) {
+        int fd = open((m_dir + lock_prefix + others[i].id).c_str(), O_RDWR);
+        if (fd >= 0 and flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            close(fd);
+            continue;
+        }
+        tArtifactList artifacts = read_artifact_list(m_dir + manifest_prefix + others[i].id);
+        for (size_t j=0; j < artifacts.size(); ++j) {
+            std::remove(file_name(m_dir, artifacts[j].first, others[i].id).c_str());
+        }
+        std::remove((m_dir + manifest_prefix + others[i].id).c_str());
+        total -= others[i].size;
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    // do not keep the largest artifacts of the current input if it alone exceeds the budget
+    while (total > m_disk_budget and !m_kept.empty()) {
+        tMSS::iterator largest = m_kept.end();
+        uint64_t largest_size = 0;
+        for (tMSS::iterator it=m_kept.begin(); it!=m_kept.end(); ++it) {
+            uint64_t size = 0;
+            file_size(it->second, size);
+            if (largest == m_kept.end() or size > largest_size) {
+                largest = it;
+                largest_size = size;
+            }
+        }
+        std::remove(largest->second.c_str());
+        m_file_map.erase(largest->first);
+        m_kept.erase(largest);
+        total -= std::min(total, largest_size);
+    }
+    write_manifest();
+}
+
+} // end namespace sdsl
@@ -0,0 +1,443 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/container.hpp"
+#include "sdsl/util.hpp" // for set_aligned_serialization
+#include <cstring> // for memcpy, memcmp
+#include <sstream>
+
+namespace sdsl
+{
+
+namespace
+{
+
+const char     container_magic[8] = {'S','D','S','L','C','O','N','T'};
+const uint64_t container_header_size = 64;
+const uint64_t container_alignment   = 64;
+
+// Layout of the first 64 bytes of a container file.
+struct container_header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t toc_offset;
+    uint64_t toc_size;
+    uint64_t toc_checksum;
+    uint64_t member_cnt;
+    uint64_t reserved[2];
+};
+
+uint64_t checksum_of(const char* data, uint64_t len)
+{
+    checksum64 c;
+    c.update(data, len);
+    return c.value();
+}
+
+void write_toc_entry(std::ostream& out, const container_member& m)
+{
+    uint64_t len = m.name.size();
+    out.write((const char*)&len, sizeof(len));
+    out.write(m.name.c_str(), len);
+    out.write((const char*)&m.offset, sizeof(m.offset));
+    out.write((const char*)&m.size, sizeof(m.size));
+    out.write((const char*)&m.checksum, sizeof(m.checksum));
+}
+
+} // end anonymous namespace
+
+void checksum64::update(const char* data, uint64_t len)
+{
+    // complete the last word
+    while ((m_len&7) and len > 0) {
+        m_tail |= ((uint64_t)(uint8_t)*(data++)) << ((m_len&7)<<3);
+        ++m_len; --len;
+        if ((m_len&7) == 0) {
+            add_word(m_tail);
+            m_tail = 0;
+        }
+    }
+    uint64_t w;
+    for (; len >= 8; len -= 8, data += 8, m_len += 8) {
+        memcpy(&w, data, 8);
+        add_word(w);
+    }
+    while (len > 0) {
+        m_tail |= ((uint64_t)(uint8_t)*(data++)) << ((m_len&7)<<3);
+        ++m_len; --len;
+    }
+}
+
+uint64_t checksum64::value()const
+{
+    uint64_t h = m_hash;
+    if (m_len&7) {
+        h = (h ^ m_tail) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+    }
+    h = (h ^ m_len) * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+}
+
+checksum_streambuf::checksum_streambuf(std::streambuf* sink):m_sink(sink), m_written(0)
+{
+    setp(m_buf, m_buf+sizeof(m_buf));
+}
+
+bool checksum_streambuf::flush_buffer()
+{
+    std::streamsize n = pptr()-pbase();
+    if (n > 0) {
+        m_checksum.update(pbase(), n);
+        m_written += n;
+        setp(m_buf, m_buf+sizeof(m_buf));
+        return m_sink->sputn(m_buf, n) == n;
+    }
+    return true;
+}
+
+checksum_streambuf::int_type checksum_streambuf::overflow(int_type c)
+{
+    if (!flush_buffer()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize checksum_streambuf::xsputn(const char* s, std::streamsize n)
+{
+    if (n <= epptr()-pptr()) {
+        memcpy(pptr(), s, n);
+        pbump(n);
+        return n;
+    }
+    // large writes bypass the buffer
+    if (!flush_buffer()) {
+        return 0;
+    }
+    m_checksum.update(s, n);
+    std::streamsize written = m_sink->sputn(s, n);
+    m_written += written;
+    return written;
+}
+
+checksum_streambuf::pos_type checksum_streambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (off != 0 or dir != std::ios_base::cur or !(which & std::ios_base::out)) {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(off_type(written()));
+}
+
+int checksum_streambuf::sync()
+{
+    return flush_buffer() ? m_sink->pubsync() : -1;
+}
+
+uint64_t checksum_streambuf::checksum()
+{
+    flush_buffer();
+    return m_checksum.value();
+}
+
+container_writer::container_writer():m_pos(0), m_buf(NULL), m_section(NULL) {}
+
+container_writer::~container_writer()
+{
+    if (is_open()) {
+        close();
+    }
+}
+
+bool container_writer::open(const char* file_name)
+{
+    if (is_open()) {
+        close();
+    }
+    m_toc.clear();
+    m_out.open(file_name, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!m_out) {
+        return false;
+    }
+    // the header is written by close; reserve its space
+    char header[container_header_size];
+    memset(header, 0, sizeof(header));
+    m_out.write(header, sizeof(header));
+    m_pos = container_header_size;
+    return m_out.good();
+}
+
+std::ostream* container_writer::begin_member(const std::string& name)
+{
+    if (!is_open() or m_section != NULL) {
+        return NULL;
+    }
+    for (size_t i=0; i < m_toc.size(); ++i) {
+        if (m_toc[i].name == name) {
+            return NULL;
+        }
+    }
+    // align the section
+    char zeros[container_alignment];
+    memset(zeros, 0, sizeof(zeros));
+    uint64_t padding = (container_alignment - (m_pos % container_alignment)) % container_alignment;
+    m_out.write(zeros, padding);
+    m_pos += padding;
+
+    container_member m;
+    m.name     = name;
+    m.offset   = m_pos;
+    m.size     = 0;
+    m.checksum = 0;
+    m_toc.push_back(m);
+    m_buf     = new checksum_streambuf(m_out.rdbuf());
+    m_section = new std::ostream(m_buf);
+    // Sections start at aligned offsets, so the positions in the section
+    // have the same alignment as in the file.
+    util::set_aligned_serialization(*m_section);
+    return m_section;
+}
+
+bool container_writer::end_member()
+{
+    if (m_section == NULL) {
+        return false;
+    }
+    m_section->flush();
+    bool ok = m_section->good();
+    m_toc.back().checksum = m_buf->checksum();
+    m_toc.back().size     = m_buf->written();
+    m_pos += m_toc.back().size;
+    delete m_section;
+    delete m_buf;
+    m_section = NULL;
+    m_buf     = NULL;
+    return ok and m_out.good();
+}
+
+bool container_writer::close()
+{
+    if (!is_open()) {
+        return false;
+    }
+    if (m_section != NULL) {
+        end_member();
+    }
+    std::ostringstream toc;
+    for (size_t i=0; i < m_toc.size(); ++i) {
+        write_toc_entry(toc, m_toc[i]);
+    }
+    std::string toc_str = toc.str();
+
+    container_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, container_magic, sizeof(container_magic));
+    header.version      = version;
+    header.toc_offset   = m_pos;
+    header.toc_size     = toc_str.size();
+    header.toc_checksum = checksum_of(toc_str.c_str(), toc_str.size());
+    header.member_cnt   = m_toc.size();
+
+    m_out.write(toc_str.c_str(), toc_str.size());
+    m_out.seekp(0);
+    m_out.write((const char*)&header, sizeof(header));
+    bool ok = m_out.good();
+    m_out.close();
+    return ok;
+}
+
+container_reader::container_reader():m_mapping(NULL), m_mapped_buf(NULL), m_mapped_in(NULL),
+    m_file_size(0), m_version(0) {}
+
+container_reader::~container_reader()
+{
+    close();
+}
+
+bool container_reader::read_toc(std::istream& in)
+{
+    container_header header;
+    in.seekg(0);
+    if (m_file_size < sizeof(header) or !in.read((char*)&header, sizeof(header))) {
+        return false;
+    }
+    if (memcmp(header.magic, container_magic, sizeof(container_magic)) != 0 or
+        header.version == 0 or header.version > container_writer::version or
+        header.toc_offset > m_file_size or header.toc_size > m_file_size - header.toc_offset) {
+        return false;
+    }
+    std::string toc_str(header.toc_size, '\0');
+    in.seekg(header.toc_offset);
+    if (header.toc_size > 0 and !in.read(&toc_str[0], header.toc_size)) {
+        return false;
+    }
+    if (checksum_of(toc_str.c_str(), toc_str.size()) != header.toc_checksum) {
+        return false;
+    }
+    std::istringstream toc(toc_str);
+    for (uint64_t i=0; i < header.member_cnt; ++i) {
+        container_member m;
+        uint64_t len = 0;
+        if (!toc.read((char*)&len, sizeof(len)) or len > header.toc_size) {
+            return false;
+        }
+        m.name.resize(len);
+        if (len > 0 and !toc.read(&m.name[0], len)) {
+            return false;
+        }
+        if (!toc.read((char*)&m.offset, sizeof(m.offset)) or
+            !toc.read((char*)&m.size, sizeof(m.size)) or
+            !toc.read((char*)&m.checksum, sizeof(m.checksum))) {
+            return false;
+        }
+        if (m.offset > header.toc_offset or m.size > header.toc_offset - m.offset) {
+            return false; // section outside of the data area
+        }
+        m_index[m.name] = m_toc.size();
+        m_toc.push_back(m);
+    }
+    m_version = header.version;
+    return true;
+}
+
+bool container_reader::open(const char* file_name, bool mapped)
+{
+    close();
+    if (mapped) {
+        m_mapping = mm_file::open(file_name);
+        if (m_mapping == NULL) {
+            return false;
+        }
+        m_file_size  = m_mapping->size();
+        m_mapped_buf = new mm_streambuf(m_mapping);
+        m_mapped_in  = new std::istream(m_mapped_buf);
+        if (!read_toc(*m_mapped_in)) {
+            close();
+            return false;
+        }
+    } else {
+        m_file.open(file_name, std::ios::binary | std::ios::in);
+        if (!m_file) {
+            return false;
+        }
+        m_file.seekg(0, std::ios::end);
+        m_file_size = m_file.tellg();
+        if (!read_toc(m_file)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void container_reader::close()
+{
+    delete m_mapped_in;
+    delete m_mapped_buf;
+    m_mapped_in  = NULL;
+    m_mapped_buf = NULL;
+    if (m_mapping != NULL) {
+        m_mapping->release();
+        m_mapping = NULL;
+    }
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+    m_toc.clear();
+    m_index.clear();
+    m_file_size = 0;
+    m_version   = 0;
+}
+
+const container_member* container_reader::find(const std::string& name)const
+{
+    tNameMap::const_iterator it = m_index.find(name);
+    if (it == m_index.end()) {
+        return NULL;
+    }
+    return &m_toc[it->second];
+}
+
+std::istream* container_reader::seek(const std::string& name)
+{
+    const container_member* m = find(name);
+    if (m == NULL) {
+        return NULL;
+    }
+    std::istream* in = (m_mapped_in != NULL) ? m_mapped_in : (std::istream*)&m_file;
+    in->clear();
+    in->seekg(m->offset);
+    return in;
+}
+
+bool container_reader::section_ok(const std::string& name)
+{
+    const container_member* m = find(name);
+    if (m == NULL) {
+        return false;
+    }
+    std::istream* in = (m_mapped_in != NULL) ? m_mapped_in : (std::istream*)&m_file;
+    if (in->fail()) {
+        return false;
+    }
+    std::streamoff pos = in->tellg();
+    return pos >= 0 and (uint64_t)pos >= m->offset and (uint64_t)pos <= m->offset + m->size;
+}
+
+bool container_reader::verify(const std::string& name)
+{
+    const container_member* m = find(name);
+    if (m == NULL) {
+        return false;
+    }
+    if (m_mapping != NULL) {
+        return checksum_of(m_mapping->data()+m->offset, m->size) == m->checksum;
+    }
+    checksum64 c;
+    std::vector<char> buf(1<<20);
+    m_file.clear();
+    m_file.seekg(m->offset);
+    for (uint64_t read_bytes=0; read_bytes < m->size;) {
+        uint64_t n = m->size - read_bytes;
+        if (n > buf.size()) {
+            n = buf.size();
+        }
+        if (!m_file.read(&buf[0], n)) {
+            return false;
+        }
+        c.update(&buf[0], n);
+        read_bytes += n;
+    }
+    return c.value() == m->checksum;
+}
+
+bool container_reader::verify()
+{
+    for (size_t i=0; i < m_toc.size(); ++i) {
+        if (!verify(m_toc[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // end namespace sdsl
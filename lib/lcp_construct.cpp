@@ -52,7 +52,7 @@ bool construct_lcp_kasai(tMSS& file_map, const std::string& dir, const std::stri
             r = isa_buf.load_next_block();
         }
         delete [] text; text = NULL;
-        if (!util::store_to_file(sa, (dir+"lcp_"+id).c_str())) {
+        if (!util::store_to_temp_file(sa, (dir+"lcp_"+id).c_str())) {
             throw std::ios_base::failure("cst_construct: Cannot store LCP to file system!");
             return false;
         } else {
@@ -75,7 +75,7 @@ bool construct_lcp_kasai(tMSS& file_map, const std::string& dir, const std::stri
                 r = lcp_buf.load_next_block();
             }
         } // destructor of lcp_buf is called
-        if (!util::store_to_file(sa, file_map["lcp"].c_str())) {
+        if (!util::store_to_temp_file(sa, file_map["lcp"].c_str())) {
             throw std::ios_base::failure("cst_construct: Cannot store ISA to file system!");
             return false;
         }
@@ -93,7 +93,8 @@ bool construct_lcp_semi_extern_PHI(tMSS& file_map, const std::string& dir, const
     if (n==0) {
         file_map["lcp"] = dir+"lcp_"+id;
         int_vector<> lcp(0);
-        util::store_to_file(lcp, file_map["lcp"].c_str());
+        util::store_to_temp_file(lcp, file_map["lcp"].c_str());
+        write_R_output("lcp", "construct LCP", "end", 1, 0);
         return true;
     }
     const uint8_t log_q = 6; // => q=64
@@ -119,7 +120,7 @@ bool construct_lcp_semi_extern_PHI(tMSS& file_map, const std::string& dir, const
         }
         r_sum += r; r = sa_buf.load_next_block();
     }
-    write_R_output("lcp", "calculate sparse phi", "begin", 1, 0);
+    write_R_output("lcp", "calculate sparse phi", "end", 1, 0);
 
     write_R_output("lcp", "load text", "begin", 1, 0);
     unsigned char* text = NULL;
@@ -147,20 +148,16 @@ bool construct_lcp_semi_extern_PHI(tMSS& file_map, const std::string& dir, const
 
 
     file_map["lcp"] = dir+"lcp_"+id;
-    std::ofstream lcp_out_buf(file_map["lcp"].c_str(), std::ios::binary | std::ios::app | std::ios::out);   // open buffer for plcp
-    size_type bit_size = n*sa_buf.int_width;
-    lcp_out_buf.write((char*) &(bit_size), sizeof(sa_buf.int_vector_size));		// write size of vector
-    lcp_out_buf.write((char*) &(sa_buf.int_width), sizeof(sa_buf.int_width));       // write int_width of vector
-    size_type wb = 0;
-
-    size_type buffer_size = 4000000; // buffer_size is a multiple of 8!
+    int_vector_file_writer<> lcp_out(file_map["lcp"].c_str(), sa_buf.int_width, 1000000,
+                                     util::file_buffer_prefetch(), util::temp_file_compression());
+    size_type buffer_size = 4000000;
     sa_buf.reset(buffer_size);
     for (size_type i=0, r=0, r_sum=0, sai_1=0,l=0, sai=0,iq=0; r_sum < n;) {
         for (; i < r_sum+r; ++i) {
             /*size_type*/ sai = sa_buf[i-r_sum];
 //				std::cerr<<"i="<<i<<" sai="<<sai<<std::endl;
             if ((sai & modq) == 0) { // we have already worked the value out ;)
-                sa_buf.set_int(i-r_sum, l=plcp[sai>>log_q]);
+                l = plcp[sai>>log_q];
             } else {
                 /*size_type*/ iq = sai & bit_magic::Li0Mask[log_q];
                 l  = plcp[sai>>log_q];
@@ -170,8 +167,8 @@ bool construct_lcp_semi_extern_PHI(tMSS& file_map, const std::string& dir, const
                     l=0;
                 while (text[ sai+l ] == text[ sai_1+l ])
                     ++l;
-                sa_buf.set_int(i-r_sum, l);
             }
+            lcp_out.push_back(l);
 #ifdef CHECK_LCP
             size_type j=0;
             for (j=0; j<l; ++j) {
@@ -185,18 +182,11 @@ bool construct_lcp_semi_extern_PHI(tMSS& file_map, const std::string& dir, const
 #endif
             sai_1 = sai;
         }
-        if (r > 0) {
-            size_type cur_wb = (r*sa_buf.int_width+7)/8;
-            lcp_out_buf.write((const char*)sa_buf.data(), cur_wb);
-            wb += cur_wb;
-        }
         r_sum += r; r = sa_buf.load_next_block();
     }
-
-    if (wb%8) {
-        lcp_out_buf.write("\0\0\0\0\0\0\0\0", 8-wb%8);
+    if (!lcp_out.close()) {
+        throw std::ios_base::failure("construct_lcp_semi_extern_PHI: Cannot write LCP array to "+file_map["lcp"]);
     }
-    lcp_out_buf.close();
     delete [] text;
     write_R_output("lcp", "construct LCP", "end", 1, 0);
     return true;
@@ -246,43 +236,27 @@ bool construct_lcp_PHI(tMSS& file_map, const std::string& dir, const std::string
                 --l;
         }
     } else { // external version is about 20 % slower than normal version
-        std::ofstream plcp_out_buf(file_name_PLCP.c_str(), std::ios::binary | std::ios::app | std::ios::out);   // open buffer for plcp
-
-        size_type bit_size = n*sa_buf.int_width;
-        plcp_out_buf.write((char*) &(bit_size), sizeof(sa_buf.int_vector_size));		// write size of vector
-        plcp_out_buf.write((char*) &(sa_buf.int_width), sizeof(sa_buf.int_width));       // write int_width of vector
-        size_type wb = 0;
-
-        size_type buffer_size = 1000000; // buffer_size is a multiple of 8!
+        int_vector_file_writer<> plcp_out(file_name_PLCP.c_str(), sa_buf.int_width);
+        size_type buffer_size = 1000000;
         int_vector_file_buffer<> phi_buf(file_name_PHI.c_str(), buffer_size);
-//			int_vector<> plcp_buf(buffer_size, 0, phi_buf.int_width );
-//			size_type phii_1 = phi_buf[0];
         for (size_type i=0, l=0, r=0, r_sum=0; r_sum < n-1;) { // TODO: case plcp[n-1]?
             for (; i < r_sum + r ; ++i) {
                 size_type phii = phi_buf[i-r_sum];
-//					if(phii != phii_1+1){
                 while (text[i+l] == text[phii+l])
                     ++l;
-//					}
-//					plcp_buf[i-r_sum] = l; // TODO: change int_vector_file_buffer so that we can assign phi_buf the new value
-                phi_buf.set_int(i-r_sum, l);
+                plcp_out.push_back(l);
                 if (l)
                     --l;
-//					phii_1 = phii;
-            }
-            if (r > 0) {
-                size_type cur_wb = (r*phi_buf.int_width+7)/8;
-//					plcp_out_buf.write((const char*)plcp_buf.data(), cur_wb );
-                plcp_out_buf.write((const char*)phi_buf.data(), cur_wb);
-                wb += cur_wb;
             }
             r_sum += r; r = phi_buf.load_next_block();
         }
-
-        if (wb%8) {
-            plcp_out_buf.write("\0\0\0\0\0\0\0\0", 8-wb%8);
+        // PLCP has the same size as SA, i.e. the unprocessed entries are zero
+        for (size_type i=plcp_out.size(); i < n; ++i) {
+            plcp_out.push_back(0);
+        }
+        if (!plcp_out.close()) {
+            throw std::ios_base::failure("construct_lcp_PHI: Cannot write PLCP array to "+file_name_PLCP);
         }
-        plcp_out_buf.close();
     }
 
     delete [] text;
@@ -293,46 +267,36 @@ bool construct_lcp_PHI(tMSS& file_map, const std::string& dir, const std::string
         std::remove(file_name_PLCP.c_str());
     }
 
-    std::ofstream lcp_out_buf((dir+"lcp_"+id).c_str(), std::ios::binary | std::ios::app | std::ios::out);   // open buffer for lcp
     file_map["lcp"] = dir+"lcp_"+id;
-
-    size_type bit_size = n*sa_buf.int_width;
-    lcp_out_buf.write((char*) &(bit_size), sizeof(sa_buf.int_vector_size));		// write size of vector
-    lcp_out_buf.write((char*) &(sa_buf.int_width), sizeof(sa_buf.int_width));       // write int_width of vector
-    size_type wb = 0;
-
-    size_type buffer_size = 1000000; // buffer_size is a multiple of 8!
-
-    int_vector<> lcp_buf(buffer_size, 0, sa_buf.int_width);
-    lcp_buf[0] = 0;
+    int_vector_file_writer<> lcp_out(file_map["lcp"].c_str(), sa_buf.int_width, 1000000,
+                                     util::file_buffer_prefetch(), util::temp_file_compression());
+    size_type buffer_size = 1000000;
     sa_buf.reset(buffer_size);
+    if (n > 0) {
+        lcp_out.push_back(0); // lcp[0]=0
+    }
     size_type r = 0;// sa_buf.load_next_block();
     for (size_type i=1, r_sum=0; r_sum < n;) {
         for (; i < r_sum+r; ++i) {
             size_type sai = sa_buf[i-r_sum];
-            lcp_buf[ i-r_sum ] = plcp[sai];
-        }
-        if (r > 0) {
-            size_type cur_wb = (r*lcp_buf.get_int_width()+7)/8;
-            lcp_out_buf.write((const char*)lcp_buf.data(), cur_wb);
-            wb += cur_wb;
+            lcp_out.push_back(plcp[sai]);
         }
         r_sum += r; r = sa_buf.load_next_block();
     }
-    if (wb%8) {
-        lcp_out_buf.write("\0\0\0\0\0\0\0\0", 8-wb%8);
+    if (!lcp_out.close()) {
+        throw std::ios_base::failure("construct_lcp_PHI: Cannot write LCP array to "+file_map["lcp"]);
     }
-    lcp_out_buf.close();
 
     write_R_output("lcp", "construct LCP", "end", 1, 0);
     return true;
 }
 
-buffered_char_queue::buffered_char_queue():m_widx(0), m_ridx(0), m_sync(true), m_disk_buffered_blocks(0), m_c('?'),m_rb(0), m_wb(0) {};
+buffered_char_queue::buffered_char_queue():m_widx(0), m_ridx(0), m_sync(true), m_disk_buffered_blocks(0), m_c('?'),m_rpos(0), m_wpos(0), m_compress(false) {};
 
-void buffered_char_queue::init(const std::string& dir, char c)
+void buffered_char_queue::init(const std::string& dir, char c, bool compress)
 {
     m_c = c;
+    m_compress = compress;
     m_file_name = dir+"buffered_char_queue_"+util::to_string(util::get_id());
 //		m_stream.rdbuf()->pubsetbuf(0, 0);
 }
@@ -355,9 +319,14 @@ void buffered_char_queue::push_back(uint8_t x)
             if (!m_stream.is_open()) {
                 m_stream.open(m_file_name.c_str(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
             }
-            m_stream.seekp(m_buffer_size * (m_wb++), std::ios::beg);
+            m_stream.seekp(m_wpos, std::ios::beg);
 //				std::cout<<"tellg="<<m_stream.tellg()<<" tellp"<<m_stream.tellp()<<std::endl;
-            m_stream.write((char*) m_write_buf, m_buffer_size);
+            if (m_compress) {
+                m_wpos += block_codec::write_bytes(m_stream, m_write_buf, m_buffer_size);
+            } else {
+                m_stream.write((char*) m_write_buf, m_buffer_size);
+                m_wpos += m_buffer_size;
+            }
 //				std::cout<<"tellg="<<m_stream.tellg()<<" tellp"<<m_stream.tellp()<<std::endl;
             ++m_disk_buffered_blocks;
         }
@@ -372,8 +341,17 @@ uint8_t buffered_char_queue::pop_front()
     ++m_ridx;
     if (m_ridx ==  m_buffer_size) {
         if (m_disk_buffered_blocks > 0) {
-            m_stream.seekg(m_buffer_size * (m_rb++), std::ios::beg);
-            m_stream.read((char*) m_read_buf, m_buffer_size);
+            m_stream.seekg(m_rpos, std::ios::beg);
+            bool ok;
+            if (m_compress) {
+                ok = block_codec::read_bytes(m_stream, m_buffer_size, m_read_buf);
+            } else {
+                ok = !m_stream.read((char*) m_read_buf, m_buffer_size).fail();
+            }
+            if (!ok) {
+                throw std::ios_base::failure("buffered_char_queue: cannot read block from temporary file");
+            }
+            m_rpos = m_stream.tellg();
             --m_disk_buffered_blocks;
         } else { // m_disk_buffered_blocks == 0
             m_sync = 1;
@@ -503,7 +481,7 @@ calculated_l:
         sa_buf.load_next_block();
     }
     std::cout<<"# comparisons: "<<comps<<std::endl;
-    if (!util::store_to_file(lcp, (dir+"lcp_"+id).c_str())) {  // store the LCP values
+    if (!util::store_to_temp_file(lcp, (dir+"lcp_"+id).c_str())) {  // store the LCP values
         throw std::ios_base::failure("cst_construct: Cannot store LCP_sml to file system!");
         return false;
     } else {
@@ -582,7 +560,7 @@ bool construct_lcp_simple2_9n(tMSS& file_map, const std::string& dir, const std:
         ++m;
     }
 
-    if (!util::store_to_file(lcp, (dir+"lcp_"+id).c_str())) {  // store the LCP values
+    if (!util::store_to_temp_file(lcp, (dir+"lcp_"+id).c_str())) {  // store the LCP values
         throw std::ios_base::failure("cst_construct: Cannot store LCP_sml to file system!");
         return false;
     } else {
@@ -756,7 +734,7 @@ bool construct_lcp_go(tMSS& file_map, const std::string& dir, const std::string&
             return res;
         }
 
-        if (!util::store_to_file(lcp_sml, (dir+"lcp_sml_"+id).c_str())) {  // store the small LCP values
+        if (!util::store_to_temp_file(lcp_sml, (dir+"lcp_sml_"+id).c_str())) {  // store the small LCP values
             throw std::ios_base::failure("cst_construct: Cannot store LCP_sml to file system!");
             return false;
         } else {
@@ -906,7 +884,7 @@ bool construct_lcp_go(tMSS& file_map, const std::string& dir, const std::string&
 
         }
 
-        if (!util::store_to_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
+        if (!util::store_to_temp_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
             throw std::ios_base::failure("cst_construct: Cannot store LCP_big to file system!");
             return false;
         } else {
@@ -1127,7 +1105,7 @@ bool construct_lcp_goPHI(tMSS& file_map, const std::string& dir, const std::stri
         				return res;
         			}
         */
-        if (!util::store_to_file(lcp_sml, (dir+"lcp_sml_"+id).c_str())) {  // store the small LCP values
+        if (!util::store_to_temp_file(lcp_sml, (dir+"lcp_sml_"+id).c_str())) {  // store the small LCP values
             throw std::ios_base::failure("cst_construct: Cannot store LCP_sml to file system!");
             return false;
         } else {
@@ -1251,7 +1229,7 @@ bool construct_lcp_goPHI(tMSS& file_map, const std::string& dir, const std::stri
             write_R_output("lcp","calc lcp","end");
         }
 
-        if (!util::store_to_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
+        if (!util::store_to_temp_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
             throw std::ios_base::failure("cst_construct: Cannot store LCP_big to file system!");
             return false;
         } else {
@@ -1632,7 +1610,7 @@ bool construct_lcp_go2(tMSS& file_map, const std::string& dir, const std::string
 
         }
 
-        if (!util::store_to_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
+        if (!util::store_to_temp_file(lcp_big, (dir+"lcp_big_"+id).c_str())) {  // store the big LCP values
             throw std::ios_base::failure("cst_construct: Cannot store LCP_big to file system!");
             return false;
         } else {
@@ -0,0 +1,533 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/memory_management.hpp"
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/types.h>
+#include <sys/stat.h>  // for fstat
+#include <fcntl.h>     // for open
+#include <unistd.h>    // for close, sysconf
+#include <sys/syscall.h> // for SYS_mbind
+#include <pthread.h>
+#include <cstdlib>     // for malloc, realloc, free
+#ifdef __GLIBC__
+#include <malloc.h>    // for malloc_usable_size
+#endif
+#include <cstring>     // for memcpy
+#include <map>
+#include <vector>
+#include <fstream>     // for reading the possible NUMA nodes
+
+namespace sdsl
+{
+
+mm_file::mm_file():m_data(NULL), m_size(0), m_reserved(0), m_refs(1) {}
+
+mm_file::~mm_file()
+{
+    if (m_data != NULL) {
+        munmap(m_data, m_reserved);
+    }
+}
+
+mm_file* mm_file::open(const char* file_name)
+{
+    int fd = ::open(file_name, O_RDONLY);
+    if (fd == -1) {
+        return NULL;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1) {
+        ::close(fd);
+        return NULL;
+    }
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    mm_file* f = new mm_file();
+    f->m_size = file_stat.st_size;
+    // Reserve the file size plus one page. The page behind the file is
+    // anonymous and therefore zero filled. So a read of the padding word
+    // behind the last int_vector in the file never faults.
+    f->m_reserved = ((f->m_size + page_size - 1)/page_size + 1)*page_size;
+    void* region = mmap(NULL, f->m_reserved, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        ::close(fd);
+        delete f;
+        return NULL;
+    }
+    f->m_data = (char*)region;
+    if (f->m_size > 0) {
+        void* file_region = mmap(region, f->m_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_FIXED, fd, 0);
+        if (file_region == MAP_FAILED) {
+            ::close(fd);
+            delete f;
+            return NULL;
+        }
+        madvise(region, f->m_size, MADV_WILLNEED);
+    }
+    ::close(fd); // the mapping stays valid after closing the descriptor
+    return f;
+}
+
+void mm_file::add_ref()
+{
+    __sync_add_and_fetch(&m_refs, 1);
+}
+
+void mm_file::release()
+{
+    if (__sync_sub_and_fetch(&m_refs, 1) == 0) {
+        delete this;
+    }
+}
+
+mm_streambuf::mm_streambuf(mm_file* file):m_file(file)
+{
+    m_file->add_ref();
+    char* begin = const_cast<char*>(m_file->data());
+    setg(begin, begin, begin + m_file->size());
+}
+
+mm_streambuf::~mm_streambuf()
+{
+    m_file->release();
+}
+
+mm_streambuf::pos_type mm_streambuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+    off_type pos = off;
+    if (dir == std::ios_base::cur) {
+        pos += gptr()-eback();
+    } else if (dir == std::ios_base::end) {
+        pos += egptr()-eback();
+    }
+    if (pos < 0 or pos > egptr()-eback()) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), eback()+pos, egptr());
+    return pos_type(pos);
+}
+
+mm_streambuf::pos_type mm_streambuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+std::string alloc_policy::to_string()const
+{
+    std::string res;
+    switch (pages()) {
+        case HUGE_PAGES_2MB: res = "huge_2MB"; break;
+        case HUGE_PAGES_1GB: res = "huge_1GB"; break;
+        default: res = "small_pages";
+    }
+    switch (numa()) {
+        case NUMA_INTERLEAVE: res += "/interleave"; break;
+        case NUMA_LOCAL: res += "/local"; break;
+        default: res += "/default";
+    }
+    return res;
+}
+
+namespace
+{
+
+// Flags of mmap and mbind which are missing in older headers.
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+const int MPOL_INTERLEAVE_MODE = 3; // MPOL_INTERLEAVE of numaif.h
+const int MPOL_LOCAL_MODE      = 4; // MPOL_LOCAL of numaif.h
+
+enum memory_backing {
+    BACKING_SMALL_PAGES,
+    BACKING_THP,
+    BACKING_HUGE_2MB,
+    BACKING_HUGE_1GB
+};
+
+struct mapped_block {
+    uint64_t            reserved; // size of the mapping
+    memory_backing      backing;
+    numa_placement_type numa;     // placement which the kernel accepted for the mapping
+};
+
+typedef std::map<const uint64_t*, mapped_block> tBlockMap;
+
+alloc_policy    default_alloc_policy;
+uint64_t        policy_min_bytes = (1ULL<<20);
+tBlockMap       mapped_blocks;    // all blocks which were allocated by mmap
+uint64_t        mapped_block_cnt = 0; // allows to skip the lock for heap blocks
+pthread_mutex_t mapped_blocks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+bool use_mapping(uint64_t bytes, const alloc_policy& policy)
+{
+    return !policy.is_default() and bytes >= policy_min_bytes;
+}
+
+uint64_t round_up(uint64_t bytes, uint64_t page_size)
+{
+    return ((bytes+page_size-1)/page_size)*page_size;
+}
+
+uint64_t allocated_byte_cnt = 0;
+uint64_t peak_byte_cnt      = 0;
+
+void add_allocated(uint64_t bytes)
+{
+    uint64_t cur  = __sync_add_and_fetch(&allocated_byte_cnt, bytes);
+    uint64_t peak = peak_byte_cnt;
+    while (cur > peak and !__sync_bool_compare_and_swap(&peak_byte_cnt, peak, cur)) {
+        peak = peak_byte_cnt;
+    }
+}
+
+void sub_allocated(uint64_t bytes)
+{
+    __sync_sub_and_fetch(&allocated_byte_cnt, bytes);
+}
+
+void* map_anonymous(uint64_t bytes, int flags)
+{
+    void* p = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|flags, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+// Returns the mask of the possible NUMA nodes, parsed from a list like "0-3,5" in
+// /sys/devices/system/node/possible. The mask is empty if the list is not available.
+std::vector<unsigned long> read_possible_nodes()
+{
+    std::vector<unsigned long> mask;
+    std::ifstream in("/sys/devices/system/node/possible");
+    const uint64_t bits = sizeof(unsigned long)*8;
+    uint64_t first = 0, last = 0;
+    while (in >> first) {
+        last = first;
+        if (in.peek() == '-') {
+            in.get();
+            if (!(in >> last) or last < first) {
+                return std::vector<unsigned long>();
+            }
+        }
+        if (last >= (1ULL<<16)) { // more than the kernel supports
+            return std::vector<unsigned long>();
+        }
+        if (mask.size() <= last/bits) {
+            mask.resize(last/bits+1, 0);
+        }
+        for (uint64_t node=first; node <= last; ++node) {
+            mask[node/bits] |= 1UL << (node%bits);
+        }
+        if (in.peek() == ',') {
+            in.get();
+        }
+    }
+    return mask;
+}
+
+const std::vector<unsigned long>& possible_nodes()
+{
+    static std::vector<unsigned long> mask = read_possible_nodes();
+    return mask;
+}
+
+// Binds [p, p+bytes) to the NUMA nodes according to numa and returns the placement
+// which the kernel accepted; NUMA_DEFAULT if mbind is not available or failed.
+numa_placement_type place_on_nodes(void* p, uint64_t bytes, numa_placement_type numa)
+{
+#ifdef SYS_mbind
+    if (numa == NUMA_INTERLEAVE) {
+        // The mask covers only the possible nodes, as the kernel rejects masks with
+        // bits beyond its node limit. maxnode is one more than the number of bits,
+        // since the kernel ignores the last bit.
+        const std::vector<unsigned long>& nodes = possible_nodes();
+        if (!nodes.empty() and
+            syscall(SYS_mbind, p, bytes, MPOL_INTERLEAVE_MODE, &nodes[0], nodes.size()*sizeof(unsigned long)*8+1, 0) == 0) {
+            return NUMA_INTERLEAVE;
+        }
+    } else if (numa == NUMA_LOCAL) {
+        if (syscall(SYS_mbind, p, bytes, MPOL_LOCAL_MODE, NULL, 0, 0) == 0) {
+            return NUMA_LOCAL;
+        }
+    }
+#endif
+    return NUMA_DEFAULT;
+}
+
+// Maps bytes bytes according to policy. Stores the size, backing and placement of the mapping in block.
+void* map_block(uint64_t bytes, const alloc_policy& policy, mapped_block& block)
+{
+    void* p = NULL;
+#ifdef MAP_HUGETLB
+    if (policy.pages() == HUGE_PAGES_1GB) {
+        block.reserved = round_up(bytes, 1ULL<<30);
+        block.backing  = BACKING_HUGE_1GB;
+        p = map_anonymous(block.reserved, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT));
+    }
+    if (p == NULL and policy.pages() != SMALL_PAGES) {
+        block.reserved = round_up(bytes, 1ULL<<21);
+        block.backing  = BACKING_HUGE_2MB;
+        p = map_anonymous(block.reserved, MAP_HUGETLB | (21 << MAP_HUGE_SHIFT));
+    }
+#endif
+    if (p == NULL and policy.pages() != SMALL_PAGES) {
+        block.reserved = round_up(bytes, 1ULL<<21);
+        block.backing  = BACKING_SMALL_PAGES;
+        p = map_anonymous(block.reserved, 0);
+#ifdef MADV_HUGEPAGE
+        if (p != NULL and madvise(p, block.reserved, MADV_HUGEPAGE) == 0) {
+            block.backing = BACKING_THP;
+        }
+#endif
+    }
+    if (p == NULL and policy.pages() == SMALL_PAGES) {
+        block.reserved = round_up(bytes, sysconf(_SC_PAGESIZE));
+        block.backing  = BACKING_SMALL_PAGES;
+        p = map_anonymous(block.reserved, 0);
+    }
+    block.numa = NUMA_DEFAULT;
+    if (p != NULL) {
+        block.numa = place_on_nodes(p, block.reserved, policy.numa());
+    }
+    return p;
+}
+
+// Returns true and the description of data if data is a mapped block.
+bool find_block(const uint64_t* data, mapped_block& block)
+{
+    if (__sync_fetch_and_add(&mapped_block_cnt, 0) == 0) {
+        return false;
+    }
+    pthread_mutex_lock(&mapped_blocks_mutex);
+    tBlockMap::const_iterator it = mapped_blocks.find(data);
+    bool found = (it != mapped_blocks.end());
+    if (found) {
+        block = it->second;
+    }
+    pthread_mutex_unlock(&mapped_blocks_mutex);
+    return found;
+}
+
+void register_block(const uint64_t* data, const mapped_block& block)
+{
+    pthread_mutex_lock(&mapped_blocks_mutex);
+    if (mapped_blocks.insert(std::make_pair(data, block)).second) {
+        __sync_add_and_fetch(&mapped_block_cnt, 1);
+    } else {
+        mapped_blocks[data] = block;
+    }
+    pthread_mutex_unlock(&mapped_blocks_mutex);
+}
+
+void unregister_block(const uint64_t* data)
+{
+    pthread_mutex_lock(&mapped_blocks_mutex);
+    if (mapped_blocks.erase(data) > 0) {
+        __sync_sub_and_fetch(&mapped_block_cnt, 1);
+    }
+    pthread_mutex_unlock(&mapped_blocks_mutex);
+}
+
+#ifdef __GLIBC__
+// Heap blocks are counted with their usable size.
+uint64_t* heap_alloc(uint64_t bytes)
+{
+    uint64_t* data = (uint64_t*)malloc(bytes);
+    if (data != NULL) {
+        add_allocated(malloc_usable_size(data));
+    }
+    return data;
+}
+
+uint64_t* heap_realloc(uint64_t* data, uint64_t bytes)
+{
+    uint64_t old_size = malloc_usable_size(data);
+    uint64_t* new_data = (uint64_t*)realloc(data, bytes);
+    if (new_data != NULL) {
+        sub_allocated(old_size);
+        add_allocated(malloc_usable_size(new_data));
+    }
+    return new_data;
+}
+
+void heap_free(uint64_t* data)
+{
+    sub_allocated(malloc_usable_size(data));
+    free(data);
+}
+#else
+// Without malloc_usable_size heap blocks are counted with the requested size,
+// which is stored in a header of two words (this keeps the alignment of malloc).
+const uint64_t heap_header_words = 2;
+
+uint64_t* heap_alloc(uint64_t bytes)
+{
+    uint64_t* block = (uint64_t*)malloc(bytes + heap_header_words*8);
+    if (block == NULL) {
+        return NULL;
+    }
+    block[0] = bytes;
+    add_allocated(bytes);
+    return block + heap_header_words;
+}
+
+uint64_t* heap_realloc(uint64_t* data, uint64_t bytes)
+{
+    uint64_t old_size = (data - heap_header_words)[0];
+    uint64_t* block = (uint64_t*)realloc(data - heap_header_words, bytes + heap_header_words*8);
+    if (block == NULL) {
+        return NULL;
+    }
+    block[0] = bytes;
+    sub_allocated(old_size);
+    add_allocated(bytes);
+    return block + heap_header_words;
+}
+
+void heap_free(uint64_t* data)
+{
+    uint64_t* block = data - heap_header_words;
+    sub_allocated(block[0]);
+    free(block);
+}
+#endif
+
+} // end anonymous namespace
+
+uint64_t* memory_manager::alloc_mem(uint64_t bytes, const alloc_policy& policy)
+{
+    if (use_mapping(bytes, policy)) {
+        mapped_block block;
+        uint64_t* data = (uint64_t*)map_block(bytes, policy, block);
+        if (data != NULL) {
+            register_block(data, block);
+            add_allocated(block.reserved);
+            return data;
+        }
+    }
+    return heap_alloc(bytes);
+}
+
+uint64_t* memory_manager::realloc_mem(uint64_t* data, uint64_t bytes, uint64_t old_bytes, const alloc_policy& policy)
+{
+    if (data == NULL) {
+        return alloc_mem(bytes, policy);
+    }
+    mapped_block block;
+    bool mapped = find_block(data, block);
+    bool map    = use_mapping(bytes, policy);
+    if (!mapped and !map) {
+        return heap_realloc(data, bytes);
+    }
+    if (mapped and map and bytes <= block.reserved and bytes > block.reserved/2) {
+        return data; // the mapping is large enough and not too large
+    }
+#if defined(MREMAP_MAYMOVE)
+    if (mapped and map and block.backing != BACKING_HUGE_2MB and block.backing != BACKING_HUGE_1GB) {
+        uint64_t reserved = round_up(bytes, 1ULL<<21);
+        void* p = mremap(data, block.reserved, reserved, MREMAP_MAYMOVE);
+        if (p != MAP_FAILED) {
+            unregister_block(data);
+            sub_allocated(block.reserved);
+            add_allocated(reserved);
+            block.reserved = reserved;
+            register_block((uint64_t*)p, block);
+            return (uint64_t*)p;
+        }
+    }
+#endif
+    uint64_t* new_data = alloc_mem(bytes, policy);
+    if (new_data != NULL) {
+        memcpy(new_data, data, old_bytes < bytes ? old_bytes : bytes);
+        free_mem(data);
+    }
+    return new_data;
+}
+
+void memory_manager::free_mem(uint64_t* data)
+{
+    if (data == NULL) {
+        return;
+    }
+    mapped_block block;
+    if (find_block(data, block)) {
+        unregister_block(data);
+        munmap(data, block.reserved);
+        sub_allocated(block.reserved);
+    } else {
+        heap_free(data);
+    }
+}
+
+std::string memory_manager::memory_type(const uint64_t* data)
+{
+    mapped_block block;
+    if (!find_block(data, block)) {
+        return "heap";
+    }
+    std::string res;
+    switch (block.backing) {
+        case BACKING_THP: res = "thp"; break;
+        case BACKING_HUGE_2MB: res = "huge_2MB"; break;
+        case BACKING_HUGE_1GB: res = "huge_1GB"; break;
+        default: res = "small_pages";
+    }
+    switch (block.numa) {
+        case NUMA_INTERLEAVE: res += "/interleave"; break;
+        case NUMA_LOCAL: res += "/local"; break;
+        default: break;
+    }
+    return res;
+}
+
+void memory_manager::set_default_policy(const alloc_policy& policy)
+{
+    default_alloc_policy = policy;
+}
+
+alloc_policy memory_manager::default_policy()
+{
+    return default_alloc_policy;
+}
+
+void memory_manager::set_min_bytes(uint64_t bytes)
+{
+    policy_min_bytes = bytes;
+}
+
+uint64_t memory_manager::min_bytes()
+{
+    return policy_min_bytes;
+}
+
+uint64_t memory_manager::allocated_bytes()
+{
+    return __sync_fetch_and_add(&allocated_byte_cnt, 0);
+}
+
+uint64_t memory_manager::peak_bytes()
+{
+    return __sync_fetch_and_add(&peak_byte_cnt, 0);
+}
+
+void memory_manager::reset_peak_bytes()
+{
+    peak_byte_cnt = allocated_bytes();
+}
+
+} // end namespace sdsl
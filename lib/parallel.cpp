@@ -0,0 +1,44 @@
+/* sdsl - succinct data structures library
+    Copyright (C) 2012 Simon Gog
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see http://www.gnu.org/licenses/ .
+*/
+#include "sdsl/parallel.hpp"
+#include <unistd.h> // for sysconf
+
+namespace sdsl
+{
+
+namespace util
+{
+
+static uint32_t max_threads = 1; // 0 stands for the number of online processors
+
+void set_thread_count(uint32_t threads)
+{
+    max_threads = threads;
+}
+
+uint32_t thread_count()
+{
+    if (max_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        return cpus > 0 ? (uint32_t)cpus : 1;
+    }
+    return max_threads;
+}
+
+} // end namespace util
+
+} // end namespace sdsl
@@ -14,4 +14,75 @@ int_vector<64> get_rnd_positions(uint8_t log_s, uint64_t& mask, uint64_t mod, ui
     return rands;
 }
 
+namespace
+{
+
+struct b1Cnt_bw {
+    uint64_t operator()(uint64_t x, uint32_t)const { return bit_magic::b1CntBW(x); }
+};
+struct b1Cnt_popcnt {
+    uint64_t operator()(uint64_t x, uint32_t)const { return bit_magic::b1CntPopcnt(x); }
+};
+struct b1Cnt_dispatch {
+    uint64_t operator()(uint64_t x, uint32_t)const { return bit_magic::b1Cnt(x); }
+};
+struct i1BP_bw {
+    uint64_t operator()(uint64_t x, uint32_t i)const { return bit_magic::i1BP2(x, i); }
+};
+struct i1BP_ctz {
+    uint64_t operator()(uint64_t x, uint32_t i)const { return bit_magic::k1BP(x, i); }
+};
+struct i1BP_pdep {
+    uint64_t operator()(uint64_t x, uint32_t i)const { return bit_magic::i1BPPdep(x, i); }
+};
+struct i1BP_dispatch {
+    uint64_t operator()(uint64_t x, uint32_t i)const { return bit_magic::i1BP(x, i); }
+};
+struct l1BP_dispatch {
+    uint64_t operator()(uint64_t x, uint32_t)const { return bit_magic::l1BP(x); }
+};
+struct r1BP_dispatch {
+    uint64_t operator()(uint64_t x, uint32_t)const { return bit_magic::r1BP(x); }
+};
+
+template<class Primitive>
+void test_primitive(const char* action, Primitive p, const int_vector<64>& x, const std::vector<uint32_t>& args,
+                    uint64_t mask, uint64_t times)
+{
+    uint64_t cnt = 0;
+    write_R_output("bit_magic", action, "begin", times, cnt);
+    for (uint64_t i=0; i < times; ++i) {
+        cnt += p(x[i&mask], args[i&mask]);
+    }
+    write_R_output("bit_magic", action, "end", times, cnt);
+}
+
+} // end anonymous namespace
+
+void test_bit_magic_performance(uint64_t times)
+{
+    uint64_t mask;
+    int_vector<64> x = get_rnd_positions(16, mask);
+    std::vector<uint32_t> args(x.size());
+    for (uint64_t i=0; i < x.size(); ++i) {
+        if (x[i] == 0) {
+            x[i] = 1;
+        }
+        args[i] = 1 + x[i] % bit_magic::b1CntBW(x[i]); // argument of i1BP
+    }
+    test_primitive("b1Cnt broadword", b1Cnt_bw(), x, args, mask, times);
+    if (bit_magic::cpu.popcnt) {
+        test_primitive("b1Cnt popcnt", b1Cnt_popcnt(), x, args, mask, times);
+    }
+    test_primitive("b1Cnt", b1Cnt_dispatch(), x, args, mask, times);
+    test_primitive("i1BP broadword", i1BP_bw(), x, args, mask, times);
+    test_primitive("i1BP ctz", i1BP_ctz(), x, args, mask, times);
+    if (bit_magic::cpu.bmi2) {
+        test_primitive("i1BP pdep", i1BP_pdep(), x, args, mask, times);
+    }
+    test_primitive("i1BP", i1BP_dispatch(), x, args, mask, times);
+    test_primitive("l1BP", l1BP_dispatch(), x, args, mask, times);
+    test_primitive("r1BP", r1BP_dispatch(), x, args, mask, times);
+}
+
 }
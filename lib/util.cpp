@@ -174,6 +174,23 @@ bool load_from_file(char*& v, const char* file_name)
         return false;
 }
 
+// Index of the flag in the iword array of a stream which enables the aligned serialization
+static int aligned_serialization_index()
+{
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+void set_aligned_serialization(std::ios_base& out, bool aligned)
+{
+    out.iword(aligned_serialization_index()) = aligned;
+}
+
+bool aligned_serialization(std::ios_base& out)
+{
+    return out.iword(aligned_serialization_index()) != 0;
+}
+
 void set_verbose(){
 	verbose = true;
 }
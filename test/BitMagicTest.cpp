@@ -68,6 +68,67 @@ TEST_F(BitMagicTest, Select)
     }
 }
 
+//! Test that all implementations which are selected at runtime agree
+TEST_F(BitMagicTest, RuntimeDispatch)
+{
+    typedef sdsl::bit_magic bm;
+    bm::cpu_features detected = bm::cpu;
+    for (size_type f=0; f < 2; ++f) {
+        if (f == 1) { // force the fallback implementations
+            bm::cpu.popcnt = bm::cpu.bmi2 = bm::cpu.fast_pdep = bm::cpu.avx2 = false;
+        }
+        for (size_type i=0; i < 1000000; ++i) {
+            uint64_t x = (((uint64_t)rand())<<33) ^ (((uint64_t)rand())<<11) ^ rand();
+            x >>= (i%64); // also words with few bits set
+            uint32_t ones = bm::b1CntNaive(x);
+            ASSERT_EQ(ones, bm::b1Cnt(x));
+            ASSERT_EQ(ones, bm::b1CntBW(x));
+            if (detected.popcnt) {
+                ASSERT_EQ(ones, bm::b1CntPopcnt(x));
+            }
+            if (x == 0) {
+                ASSERT_EQ((uint32_t)0, bm::l1BP(x));
+                ASSERT_EQ((uint32_t)0, bm::r1BP(x));
+                continue;
+            }
+            ASSERT_EQ(bm::i1BPNaive(x, ones), bm::l1BP(x));
+            ASSERT_EQ(bm::i1BPNaive(x, 1), bm::r1BP(x));
+            uint32_t j = 1 + rand()%ones;
+            uint32_t pos = bm::i1BPNaive(x, j);
+            ASSERT_EQ(pos, bm::i1BP(x, j));
+            if (detected.bmi2) {
+                ASSERT_EQ(pos, bm::i1BPPdep(x, j));
+            }
+        }
+    }
+    bm::cpu = detected;
+}
+
+//! Test that the kernels of read_ints, which are selected at runtime, agree with read_int
+TEST_F(BitMagicTest, ReadIntsDispatch)
+{
+    typedef sdsl::bit_magic bm;
+    bm::cpu_features detected = bm::cpu;
+    sdsl::int_vector<64> words(300);
+    sdsl::util::set_random_bits(words);
+    std::vector<uint64_t> out(200);
+    for (size_type f=0; f < 2; ++f) {
+        if (f == 1) { // force the scalar kernels
+            bm::cpu.avx2 = false;
+        }
+        for (uint8_t len=1; len <= 64; ++len) {
+            for (uint64_t offset=0; offset < 130; offset += 1 + rand()%9) {
+                bm::read_ints(words.data(), offset, len, out.size(), &out[0]);
+                for (size_type i=0; i < out.size(); ++i) {
+                    uint64_t pos = offset + i*len;
+                    ASSERT_EQ(bm::read_int(words.data() + (pos>>6), pos&0x3F, len), out[i])
+                            << " at index "<<i<<" with length "<<(int)len<<" and offset "<<offset;
+                }
+            }
+        }
+    }
+    bm::cpu = detected;
+}
 
 }  // namespace
 
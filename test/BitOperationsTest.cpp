@@ -0,0 +1,92 @@
+#include "sdsl/bit_vectors.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::bit_vector bit_vector;
+typedef sdsl::bit_vector::size_type size_type;
+typedef sdsl::bit_operations bit_operations;
+
+template<class T>
+class BitOperationsTest : public ::testing::Test { };
+
+using testing::Types;
+
+typedef Types<sdsl::bit_vector,
+        sdsl::sd_vector<>,
+        sdsl::gap_vector<>,
+        sdsl::rrr_vector<15>,
+        sdsl::rrr_vector<63>,
+        sdsl::rrr_vector<127>,
+        sdsl::rrr_vector<256>
+        > Implementations;
+
+TYPED_TEST_CASE(BitOperationsTest, Implementations);
+
+// Random bit vector of length n in which every k-th bit is set on average; runs of ones for k=0.
+bit_vector random_bv(size_type n, size_type k)
+{
+    bit_vector bv(n, 0);
+    for (size_type i=0; i < n; ++i) {
+        if (k == 0)
+            bv[i] = (i/200)%2;
+        else
+            bv[i] = (rand()%k == 0);
+    }
+    return bv;
+}
+
+bool reference(bool x, bool y, bit_operations::operation op)
+{
+    switch (op) {
+        case bit_operations::AND:    return x and y;
+        case bit_operations::OR:     return x or y;
+        case bit_operations::XOR:    return x != y;
+        case bit_operations::ANDNOT: return x and !y;
+    }
+    return false;
+}
+
+//! Compare the result of all operations with the bitwise reference
+TYPED_TEST(BitOperationsTest, Apply)
+{
+    srand(17);
+    size_type sizes[][2] = {{0,0}, {0,100}, {1,1}, {64,64}, {1000,999}, {70000,100000}, {100000,70000}, {1000000,1000000}};
+    size_type densities[] = {0, 2, 50};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        for (size_type d=0; d < sizeof(densities)/sizeof(densities[0]); ++d) {
+            bit_vector bv_a = random_bv(sizes[s][0], densities[d]);
+            bit_vector bv_b = random_bv(sizes[s][1], densities[(d+1)%3]);
+            TypeParam a(bv_a), b(bv_b);
+            for (int o=0; o < 4; ++o) {
+                bit_operations::operation op = (bit_operations::operation)o;
+                TypeParam res;
+                bit_operations::apply(a, b, op, res);
+                ASSERT_EQ(std::max(bv_a.size(), bv_b.size()), res.size());
+                for (size_type i=0; i < res.size(); ++i) {
+                    bool x = i < bv_a.size() and bv_a[i];
+                    bool y = i < bv_b.size() and bv_b[i];
+                    ASSERT_EQ(reference(x, y, op), (bool)res[i]) << " op="<<o<<" i="<<i<<" size="<<res.size();
+                }
+            }
+            // the result may be an operand
+            TypeParam c(bv_a);
+            bit_operations::apply(c, b, bit_operations::XOR, c);
+            bit_operations::apply(c, b, bit_operations::XOR, c);
+            for (size_type i=0; i < c.size(); ++i) {
+                ASSERT_EQ(i < bv_a.size() and bv_a[i], (bool)c[i]) << " i="<<i;
+            }
+        }
+    }
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
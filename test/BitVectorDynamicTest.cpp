@@ -0,0 +1,109 @@
+#include "sdsl/bit_vector_dynamic.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <sstream>
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::bit_vector_dynamic::size_type size_type;
+typedef sdsl::bit_vector bit_vector;
+
+class BitVectorDynamicTest : public ::testing::Test
+{
+    protected:
+        // Checks access, rank and select of bv against the reference vector.
+        template<class Reference>
+        void check(const sdsl::bit_vector_dynamic& bv, const Reference& ref) {
+            ASSERT_EQ(ref.size(), bv.size());
+            sdsl::bit_vector_dynamic::rank_1_type rank1(&bv);
+            sdsl::bit_vector_dynamic::rank_0_type rank0(&bv);
+            sdsl::bit_vector_dynamic::select_1_type select1(&bv);
+            sdsl::bit_vector_dynamic::select_0_type select0(&bv);
+            size_type ones = 0;
+            for (size_type i=0; i < ref.size(); ++i) {
+                ASSERT_EQ(ones, rank1(i)) << " at index "<<i;
+                ASSERT_EQ(i-ones, rank0(i)) << " at index "<<i;
+                ASSERT_EQ((bool)ref[i], (bool)bv[i]) << " at index "<<i;
+                if (ref[i]) {
+                    ASSERT_EQ(i, select1(++ones));
+                } else {
+                    ASSERT_EQ(i, select0(i+1-ones));
+                }
+            }
+            ASSERT_EQ(ones, rank1(ref.size()));
+            ASSERT_EQ(ones, bv.ones());
+        }
+};
+
+//! Test construction from a bit_vector and the serialization
+TEST_F(BitVectorDynamicTest, ConstructAndSerialize)
+{
+    srand(13);
+    size_type sizes[] = {0, 1, 64, 2048, 2049, 100000, 3000000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        bit_vector v(sizes[s]);
+        std::vector<bool> ref(v.size());
+        for (size_type i=0; i < v.size(); ++i) {
+            ref[i] = v[i] = (rand()%3 == 0);
+        }
+        sdsl::bit_vector_dynamic bv(v);
+        check(bv, ref);
+        ASSERT_EQ(v, bv.to_bit_vector());
+        std::stringstream ss;
+        bv.serialize(ss);
+        sdsl::bit_vector_dynamic loaded;
+        loaded.load(ss);
+        ASSERT_EQ(bv, loaded);
+    }
+}
+
+//! Test random insert, erase and set operations
+TEST_F(BitVectorDynamicTest, InsertEraseSet)
+{
+    srand(17);
+    // start with more leaves than fit into one inner node
+    bit_vector v(100000);
+    std::vector<char> ref(v.size()); // insert and erase of std::vector<bool> are slow
+    for (size_type i=0; i < v.size(); ++i) {
+        ref[i] = v[i] = rand()%2;
+    }
+    sdsl::bit_vector_dynamic bv(v);
+    // grow by inserts at random positions and appends, then shrink
+    for (size_type round=0; round < 3; ++round) {
+        for (size_type k=0; k < 15000; ++k) {
+            bool bit = rand()%2;
+            size_type i = (k%3 == 0) ? ref.size() : rand()%(ref.size()+1);
+            bv.insert(i, bit);
+            ref.insert(ref.begin()+i, bit);
+            if (k%7 == 0) {
+                i = rand()%ref.size();
+                bit = rand()%2;
+                bv.set(i, bit);
+                ref[i] = bit;
+            }
+        }
+        check(bv, ref);
+        for (size_type k=0; k < 11000+round*1000; ++k) {
+            size_type i = (k%5 == 0) ? ref.size()-1 : rand()%ref.size();
+            bv.erase(i);
+            ref.erase(ref.begin()+i);
+        }
+        check(bv, ref);
+    }
+    while (!ref.empty()) {
+        size_type i = rand()%ref.size();
+        bv.erase(i);
+        ref.erase(ref.begin()+i);
+    }
+    check(bv, ref);
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
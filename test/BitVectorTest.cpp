@@ -1,11 +1,14 @@
 #include "sdsl/int_vector.hpp" // vor bit_vector
 #include "sdsl/rrr_vector.hpp" // for rrr_vector
 #include "sdsl/bit_vector_interleaved.hpp" // for rank_support_interleaved
+#include "sdsl/bit_vector_interleaved_cl.hpp" // for rank_support_interleaved_cl
 #include "sdsl/sd_vector.hpp" // for sd_vector
 #include "sdsl/gap_vector.hpp" // for gap_vector
+#include "sdsl/bit_vector_dynamic.hpp" // for bit_vector_dynamic
 #include "sdsl/bitmagic.hpp"
 #include "gtest/gtest.h"
 #include <vector>
+#include <sstream>
 #include <cstdlib> // for rand()
 
 namespace
@@ -90,6 +93,7 @@ sdsl::bit_vector,
      sdsl::bit_vector_interleaved<256>,
      sdsl::bit_vector_interleaved<512>,
      sdsl::bit_vector_interleaved<1024>,
+     sdsl::bit_vector_interleaved_cl<>,
      sdsl::rrr_vector<64>,
      sdsl::rrr_vector<256>,
      sdsl::rrr_vector<129>,
@@ -103,7 +107,8 @@ sdsl::bit_vector,
      sdsl::rrr_vector<128>,
      sdsl::sd_vector<>,
      sdsl::sd_vector<sdsl::rrr_vector<63> >,
-     sdsl::gap_vector<>
+     sdsl::gap_vector<>,
+     sdsl::bit_vector_dynamic
      > Implementations;
 
 TYPED_TEST_CASE(BitVectorTest, Implementations);
@@ -138,6 +143,24 @@ TYPED_TEST(BitVectorTest, Swap)
     }
 }
 
+//! Test the copy constructor and the serialization
+TYPED_TEST(BitVectorTest, CopyAndLoad)
+{
+    for (size_type i=0; i<this->n; ++i) {
+        TypeParam bv(this->bs[i]);
+        TypeParam copied_bv(bv);
+        std::stringstream ss;
+        copied_bv.serialize(ss);
+        TypeParam loaded_bv;
+        loaded_bv.load(ss);
+        ASSERT_EQ(this->bs[i].size(), loaded_bv.size());
+        for (size_type j=0; j < (this->bs[i]).size(); ++j) {
+            ASSERT_EQ((bool)(this->bs[i][j]), (bool)(copied_bv[j])) << " at index "<<j<<" of vector "<<i;
+            ASSERT_EQ((bool)(this->bs[i][j]), (bool)(loaded_bv[j])) << " at index "<<j<<" of vector "<<i;
+        }
+    }
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
@@ -0,0 +1,125 @@
+#include "sdsl/construction_log.hpp"
+#include "sdsl/suffixarrays.hpp"
+#include "sdsl/csa_construct.hpp"
+#include "sdsl/lcp_construct.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <cstdio> // for remove
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+class ConstructionLogTest : public ::testing::Test
+{
+    protected:
+        std::string m_text_file;
+        sdsl::tMSS  m_file_map;
+
+        ConstructionLogTest():m_text_file("tmp_construction_log_test.txt") {}
+
+        virtual void SetUp() {
+            srand(51);
+            std::ofstream out(m_text_file.c_str(), std::ios::binary);
+            for (size_type i=0; i < 200000; ++i)
+                out.put((char)('a' + rand()%5));
+        }
+
+        virtual void TearDown() {
+            sdsl::construction_log::enable(false);
+            sdsl::util::delete_all_files(m_file_map);
+            std::remove(m_text_file.c_str());
+        }
+};
+
+// Returns the number of occurrences of pattern in s
+size_type count(const std::string& s, const std::string& pattern)
+{
+    size_type n = 0;
+    for (size_t pos = s.find(pattern); pos != std::string::npos; pos = s.find(pattern, pos+1))
+        ++n;
+    return n;
+}
+
+//! Test that the construction of a CSA and an LCP array is recorded as nested phases
+TEST_F(ConstructionLogTest, NestedPhases)
+{
+    sdsl::construction_log::enable();
+    sdsl::csa_wt<> csa;
+    std::string id = "log_test";
+    ASSERT_TRUE(sdsl::construct_csa(m_text_file, csa, m_file_map, false, "./", id));
+    ASSERT_TRUE(sdsl::construct_lcp_kasai(m_file_map, "./", id));
+
+    const std::vector<sdsl::construction_phase>& phases = sdsl::construction_log::phases();
+    ASSERT_FALSE(phases.empty());
+    size_type csa_phases = 0, lcp_phases = 0, nested = 0;
+    std::vector<size_type> open; // index of the enclosing phase of each depth
+    for (size_type i=0; i < phases.size(); ++i) {
+        const sdsl::construction_phase& p = phases[i];
+        ASSERT_TRUE(p.complete) << p.action;
+        ASSERT_LE(p.begin, p.end) << p.action;
+        ASSERT_GE(p.user_time, 0.0) << p.action;
+        ASSERT_GE(p.sys_time, 0.0) << p.action;
+        ASSERT_GT(p.rss_begin, 0ULL) << p.action;
+        ASSERT_GE(p.peak_rss, p.rss_begin) << p.action;
+        ASSERT_GE(p.peak_rss, p.rss_end) << p.action;
+        ASSERT_GE(p.peak_heap, p.heap_begin) << p.action;
+        ASSERT_GE(p.peak_heap, p.heap_end) << p.action;
+        ASSERT_LE(p.depth, open.size()) << p.action;
+        open.resize(p.depth);
+        if (p.depth > 0) { // the phase lies inside of its enclosing phase
+            const sdsl::construction_phase& parent = phases[open.back()];
+            ASSERT_LE(parent.begin, p.begin) << p.action;
+            ASSERT_GE(parent.end, p.end) << p.action;
+            ASSERT_GE(parent.peak_rss, p.peak_rss) << p.action;
+            ++nested;
+        }
+        open.push_back(i);
+        if (p.data_structure == "csa" and p.depth == 0)
+            ++csa_phases;
+        if (p.data_structure == "lcp" and p.depth == 0)
+            ++lcp_phases;
+    }
+    ASSERT_EQ((size_type)1, csa_phases);
+    ASSERT_EQ((size_type)1, lcp_phases);
+    ASSERT_GT(nested, (size_type)0);
+
+    std::stringstream ss;
+    sdsl::construction_log::write_json(ss);
+    std::string json = ss.str();
+    ASSERT_EQ(phases.size(), count(json, "\"action\": "));
+    ASSERT_EQ((size_type)1, count(json, "\"action\": \"construct CSA\""));
+    ASSERT_EQ((size_type)1, count(json, "\"action\": \"construct LCP\""));
+    ASSERT_EQ(nested, phases.size()-count(json, "\"depth\": 0,"));
+    const char* fields[] = {"wall_ms", "user_ms", "sys_ms", "rss_begin", "rss_end", "peak_rss",
+                            "heap_begin", "heap_end", "peak_heap", "bytes_read", "bytes_written",
+                            "disk_read", "disk_written"
+                           };
+    for (size_type i=0; i < sizeof(fields)/sizeof(fields[0]); ++i) {
+        ASSERT_EQ(phases.size(), count(json, "\"" + std::string(fields[i]) + "\": ")) << fields[i];
+        ASSERT_EQ((size_type)0, count(json, "\"" + std::string(fields[i]) + "\": -")) << fields[i];
+    }
+}
+
+//! Test that nothing is recorded if the log is disabled
+TEST_F(ConstructionLogTest, Disabled)
+{
+    sdsl::construction_log::enable();
+    sdsl::construction_log::enable(false);
+    sdsl::csa_wt<> csa;
+    ASSERT_TRUE(sdsl::construct_csa(m_text_file, csa, m_file_map, false, "./", "log_test"));
+    ASSERT_TRUE(sdsl::construction_log::phases().empty());
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,171 @@
+#include "sdsl/construction_workspace.hpp"
+#include "sdsl/suffixarrays.hpp"
+#include "sdsl/csa_construct.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio> // for remove
+#include <cstdlib> // for rand()
+#include <dirent.h> // for opendir, readdir
+#include <sys/stat.h> // for mkdir, stat
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+class ConstructionWorkspaceTest : public ::testing::Test
+{
+    protected:
+        std::string m_dir;
+
+        ConstructionWorkspaceTest():m_dir("tmp_construction_workspace_test/") {}
+
+        virtual void SetUp() {
+            mkdir(m_dir.c_str(), 0755);
+            clear_dir();
+        }
+
+        virtual void TearDown() {
+            clear_dir();
+            rmdir(m_dir.c_str());
+        }
+
+        void clear_dir() {
+            DIR* d = opendir(m_dir.c_str());
+            if (d == NULL)
+                return;
+            for (struct dirent* e = readdir(d); e != NULL; e = readdir(d)) {
+                std::string entry = e->d_name;
+                if (entry != "." and entry != "..")
+                    std::remove((m_dir+entry).c_str());
+            }
+            closedir(d);
+        }
+
+        // Number of files in the directory, which are not lock files
+        size_type files() {
+            size_type n = 0;
+            DIR* d = opendir(m_dir.c_str());
+            for (struct dirent* e = readdir(d); e != NULL; e = readdir(d)) {
+                std::string entry = e->d_name;
+                if (entry != "." and entry != ".." and entry.find("lock") == std::string::npos)
+                    ++n;
+            }
+            closedir(d);
+            return n;
+        }
+
+        // Writes a random text of length n to file_name
+        std::string write_text(const std::string& file_name, size_type n, unsigned seed) {
+            srand(seed);
+            std::string name = m_dir + file_name;
+            std::ofstream out(name.c_str(), std::ios::binary);
+            for (size_type i=0; i < n; ++i)
+                out.put((char)('a' + rand()%4));
+            return name;
+        }
+
+        bool exists(const std::string& file_name) {
+            struct stat s;
+            return stat(file_name.c_str(), &s) == 0;
+        }
+};
+
+//! Test that a second construction over the same input reuses the artifacts of the first
+TEST_F(ConstructionWorkspaceTest, Reuse)
+{
+    std::string text = write_text("text_a.txt", 10000, 41);
+    sdsl::csa_wt<> csa1, csa2;
+    {
+        sdsl::construction_workspace ws(m_dir, true);
+        ASSERT_TRUE(sdsl::construct_csa(text, csa1, ws));
+        ASSERT_FALSE(ws.reused("sa"));
+        ASSERT_FALSE(ws.reused("text"));
+    }
+    {
+        sdsl::construction_workspace ws(m_dir, true);
+        ASSERT_TRUE(sdsl::construct_csa(text, csa2, ws));
+        ASSERT_TRUE(ws.reused("text"));
+        ASSERT_TRUE(ws.reused("sa"));
+        ASSERT_TRUE(ws.reused("bwt"));
+    }
+    ASSERT_EQ(csa1.size(), csa2.size());
+    for (size_type i=0; i < csa1.size(); ++i) {
+        ASSERT_EQ(csa1[i], csa2[i]) << " at index "<<i;
+    }
+    // The artifacts of another input are not reused
+    sdsl::construction_workspace ws(m_dir, true);
+    ASSERT_TRUE(ws.add_text(write_text("text_b.txt", 10000, 42)));
+    ASSERT_FALSE(ws.reused("text"));
+    ASSERT_FALSE(ws.reused("sa"));
+    ws.finish();
+}
+
+//! Test that a workspace which is destroyed without finish() removes the files which are not in the manifest
+TEST_F(ConstructionWorkspaceTest, CleanupAfterException)
+{
+    std::string text = write_text("text_a.txt", 10000, 43);
+    std::string sa_file;
+    try {
+        sdsl::construction_workspace ws(m_dir, true);
+        ASSERT_TRUE(ws.add_text(text));
+        ASSERT_TRUE(exists(ws.file_map()["text"]));
+        sa_file = sdsl::construction_workspace::file_name(m_dir, "sa", ws.id());
+        std::ofstream(sa_file.c_str()) << "incomplete";
+        ws.file_map()["sa"] = sa_file;
+        throw std::runtime_error("construction failed");
+    } catch (const std::runtime_error&) {
+    }
+    ASSERT_FALSE(exists(sa_file));
+    ASSERT_EQ((size_type)1, files()); // only the input text is left
+    // A later construction starts from scratch
+    sdsl::construction_workspace ws(m_dir, true);
+    ASSERT_TRUE(ws.add_text(text));
+    ASSERT_FALSE(ws.reused("text"));
+    ASSERT_TRUE(ws.file_map().find("sa") == ws.file_map().end());
+    ws.finish();
+}
+
+//! Test that the disk budget evicts the artifacts of other inputs, unless they are used by another construction
+TEST_F(ConstructionWorkspaceTest, DiskBudget)
+{
+    std::string text_a = write_text("text_a.txt", 10000, 44);
+    std::string text_b = write_text("text_b.txt", 10000, 45);
+    std::string text_c = write_text("text_c.txt", 10000, 46);
+    sdsl::csa_wt<> csa;
+    {
+        sdsl::construction_workspace ws(m_dir, true);
+        ASSERT_TRUE(sdsl::construct_csa(text_a, csa, ws));
+    }
+    uint64_t budget = 1; // less than the artifacts of one input
+    {
+        // A is in use, so the construction of B does not evict it
+        sdsl::construction_workspace ws_a(m_dir, true);
+        ASSERT_TRUE(ws_a.add_text(text_a));
+        ASSERT_TRUE(ws_a.reused("sa"));
+        sdsl::construction_workspace ws_b(m_dir, true, budget);
+        ASSERT_TRUE(sdsl::construct_csa(text_b, csa, ws_b));
+        ASSERT_TRUE(exists(ws_a.file_map()["sa"]));
+        ws_a.finish();
+    }
+    {
+        // B alone exceeds the budget, so C evicts all artifacts of A and B
+        sdsl::construction_workspace ws_c(m_dir, true, budget);
+        ASSERT_TRUE(sdsl::construct_csa(text_c, csa, ws_c));
+    }
+    ASSERT_EQ((size_type)3, files()); // only the three input texts are left
+    sdsl::construction_workspace ws(m_dir, true);
+    ASSERT_TRUE(ws.add_text(text_a));
+    ASSERT_FALSE(ws.reused("sa"));
+    ws.finish();
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,167 @@
+#include "sdsl/container.hpp"
+#include "sdsl/int_vector.hpp"
+#include "sdsl/util.hpp"
+#include "gtest/gtest.h"
+#include <cstdlib> // for rand()
+#include <cstdio>  // for remove
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+// The fixture for testing the container format.
+class ContainerTest : public ::testing::Test
+{
+    protected:
+
+        ContainerTest():file_name("/tmp/sdsl_container_test") {}
+
+        virtual void SetUp() {
+            iv = sdsl::int_vector<>(1000000, 0, 27);
+            for (size_type i=0; i < iv.size(); ++i) {
+                iv[i] = rand();
+            }
+            bv = sdsl::bit_vector(123457, 0);
+            for (size_type i=0; i < bv.size(); ++i) {
+                bv[i] = rand()%2;
+            }
+            number = 0x0123456789ABCDEFULL;
+            sdsl::container_writer out;
+            ASSERT_TRUE(out.open(file_name.c_str()));
+            ASSERT_TRUE(out.add(iv, "iv"));
+            ASSERT_TRUE(out.add(bv, "bv"));
+            ASSERT_TRUE(out.add_member(number, "number"));
+            ASSERT_FALSE(out.add(bv, "bv")); // names are unique
+            ASSERT_TRUE(out.close());
+        }
+
+        virtual void TearDown() {
+            std::remove(file_name.c_str());
+        }
+
+        std::string       file_name;
+        sdsl::int_vector<> iv;
+        sdsl::bit_vector  bv;
+        uint64_t          number;
+};
+
+//! Test that each member can be loaded on its own
+TEST_F(ContainerTest, LoadMembers)
+{
+    for (size_type mapped=0; mapped < 2; ++mapped) {
+        sdsl::container_reader in;
+        ASSERT_TRUE(in.open(file_name.c_str(), mapped));
+        ASSERT_EQ((uint32_t)sdsl::container_writer::version, in.version());
+        ASSERT_EQ((size_t)3, in.members().size());
+        for (size_t i=0; i < in.members().size(); ++i) {
+            EXPECT_EQ((uint64_t)0, in.members()[i].offset % 64); // sections are aligned
+        }
+        sdsl::bit_vector bv2;
+        ASSERT_TRUE(in.load(bv2, "bv"));
+        ASSERT_TRUE(bv == bv2);
+        ASSERT_EQ((bool)mapped, bv2.mapped());
+        uint64_t number2 = 0;
+        ASSERT_TRUE(in.load_member(number2, "number"));
+        ASSERT_EQ(number, number2);
+        sdsl::int_vector<> iv2;
+        ASSERT_TRUE(in.load(iv2, "iv"));
+        ASSERT_EQ((bool)mapped, iv2.mapped()); // sections are written in the aligned format
+        in.close();
+        ASSERT_TRUE(iv == iv2);
+        ASSERT_TRUE(bv == bv2); // mapped members outlive the reader
+        ASSERT_FALSE(in.load(iv2, "iv"));
+    }
+}
+
+TEST_F(ContainerTest, MissingMember)
+{
+    sdsl::container_reader in;
+    ASSERT_TRUE(in.open(file_name.c_str()));
+    ASSERT_TRUE(in.find("lcp") == NULL);
+    sdsl::int_vector<> iv2;
+    ASSERT_FALSE(in.load(iv2, "lcp"));
+}
+
+//! Test that corrupted sections and headers are detected
+TEST_F(ContainerTest, Validation)
+{
+    {
+        sdsl::container_reader in;
+        ASSERT_TRUE(in.open(file_name.c_str()));
+        ASSERT_TRUE(in.verify());
+        uint64_t offset = in.find("iv")->offset + 4711;
+        in.close();
+        std::fstream f(file_name.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(offset);
+        f.put('x');
+        f.close();
+    }
+    for (size_type mapped=0; mapped < 2; ++mapped) {
+        sdsl::container_reader in;
+        ASSERT_TRUE(in.open(file_name.c_str(), mapped));
+        EXPECT_FALSE(in.verify("iv"));
+        EXPECT_TRUE(in.verify("bv"));
+        EXPECT_FALSE(in.verify());
+    }
+    {
+        std::fstream f(file_name.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(0);
+        f.put('x');
+        f.close();
+        sdsl::container_reader in;
+        ASSERT_FALSE(in.open(file_name.c_str()));
+    }
+    {
+        // a plain serialized file is not a container
+        sdsl::util::store_to_file(iv, file_name.c_str());
+        sdsl::container_reader in;
+        ASSERT_FALSE(in.open(file_name.c_str()));
+    }
+}
+
+//! Test that a load which reads beyond its section fails
+TEST_F(ContainerTest, TruncatedSection)
+{
+    {
+        std::stringstream ss;
+        iv.serialize(ss);
+        std::string iv_str = ss.str();
+        sdsl::container_writer out;
+        ASSERT_TRUE(out.open(file_name.c_str()));
+        std::ostream* section = out.begin_member("iv");
+        ASSERT_TRUE(section != NULL);
+        section->write(iv_str.c_str(), iv_str.size()/2);
+        ASSERT_TRUE(out.end_member());
+        ASSERT_TRUE(out.add(bv, "bv"));
+        uint32_t small = 42;
+        ASSERT_TRUE(out.add_member(small, "small"));
+        ASSERT_TRUE(out.add(iv, "iv_after"));
+        ASSERT_TRUE(out.close());
+    }
+    for (size_type mapped=0; mapped < 2; ++mapped) {
+        sdsl::container_reader in;
+        ASSERT_TRUE(in.open(file_name.c_str(), mapped));
+        ASSERT_TRUE(in.verify()); // the checksums match the truncated content
+        sdsl::int_vector<> iv2;
+        EXPECT_FALSE(in.load(iv2, "iv"));
+        uint64_t small = 0;
+        EXPECT_FALSE(in.load_member(small, "small"));
+        sdsl::bit_vector bv2;
+        EXPECT_TRUE(in.load(bv2, "bv"));
+        EXPECT_TRUE(bv == bv2);
+        EXPECT_TRUE(in.load(iv2, "iv_after"));
+        EXPECT_TRUE(iv == iv2);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
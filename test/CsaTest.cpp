@@ -0,0 +1,54 @@
+#include "sdsl/suffixarrays.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <fstream>
+#include <cstdio> // for remove
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+//! Test that all int_vectors of a csa_wt, which was stored aligned, are mapped by load_from_file_mapped
+TEST(CsaTest, LoadMapped)
+{
+    std::string text_file = "tmp_csa_test.txt", csa_file = "tmp_csa_test.sdsl";
+    srand(31);
+    {
+        std::ofstream out(text_file.c_str(), std::ios::binary);
+        for (size_type i=0; i < 100000; ++i)
+            out.put((char)('a' + (rand()%7)*(rand()%3)));
+    }
+    sdsl::csa_wt<> csa;
+    ASSERT_TRUE(sdsl::construct_csa(text_file, csa));
+    ASSERT_TRUE(sdsl::util::store_to_file_aligned(csa, csa_file.c_str()));
+    sdsl::csa_wt<> csa_mapped;
+    ASSERT_TRUE(sdsl::util::load_from_file_mapped(csa_mapped, csa_file.c_str()));
+    ASSERT_TRUE(csa_mapped.sa_sample.mapped());
+    ASSERT_TRUE(csa_mapped.isa_sample.mapped());
+    ASSERT_TRUE(csa_mapped.C.mapped());
+    ASSERT_TRUE(csa_mapped.char2comp.mapped());
+    ASSERT_TRUE(csa_mapped.comp2char.mapped());
+    ASSERT_TRUE(csa_mapped.wavelet_tree.tree.mapped());
+    ASSERT_EQ(csa.size(), csa_mapped.size());
+    for (size_type i=0; i < csa.size(); ++i) {
+        ASSERT_EQ(csa[i], csa_mapped[i]) << " at index "<<i;
+    }
+    sdsl::csa_wt<> csa_loaded; // the aligned format can also be read without mapping
+    ASSERT_TRUE(sdsl::util::load_from_file(csa_loaded, csa_file.c_str()));
+    ASSERT_FALSE(csa_loaded.sa_sample.mapped());
+    for (size_type i=0; i < csa.size(); ++i) {
+        ASSERT_EQ(csa[i], csa_loaded[i]) << " at index "<<i;
+    }
+    std::remove(text_file.c_str());
+    std::remove(csa_file.c_str());
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
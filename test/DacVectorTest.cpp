@@ -0,0 +1,138 @@
+#include "sdsl/dac_vector.hpp"
+#include "sdsl/rank_support_v.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <algorithm> // for std::min
+#include <sstream>
+#include <string>
+#include <cstdio> // for remove
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+template<class T>
+class DacVectorTest : public ::testing::Test { };
+
+using testing::Types;
+
+typedef Types<sdsl::dac_vector<>,
+        sdsl::dac_vector<0, sdsl::rank_support_v<> >,
+        sdsl::dac_vector<1>,
+        sdsl::dac_vector<4>,
+        sdsl::dac_vector<64>
+        > Implementations;
+
+TYPED_TEST_CASE(DacVectorTest, Implementations);
+
+// Mostly small values with some large ones, up to 64 bits
+std::vector<uint64_t> generate(size_type n)
+{
+    std::vector<uint64_t> v(n);
+    for (size_type i=0; i < n; ++i) {
+        uint32_t r = rand()%100;
+        if (r < 70)
+            v[i] = rand()%16;
+        else if (r < 95)
+            v[i] = rand()%5000;
+        else if (r < 99)
+            v[i] = ((uint64_t)rand() << 31) | rand();
+        else
+            v[i] = ~(uint64_t)rand();
+    }
+    return v;
+}
+
+//! Test access, the iterator, decode and serialization
+TYPED_TEST(DacVectorTest, Access)
+{
+    srand(17);
+    size_type sizes[] = {0, 1, 63, 64, 65, 1000, 100000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        std::vector<uint64_t> v = generate(sizes[s]);
+        TypeParam dv(v);
+        std::stringstream ss;
+        dv.serialize(ss);
+        TypeParam loaded;
+        loaded.load(ss);
+        ASSERT_EQ(v.size(), loaded.size());
+        ASSERT_TRUE(dv == loaded);
+        for (size_type i=0; i < v.size(); ++i) {
+            ASSERT_EQ(v[i], loaded[i]) << " at index "<<i;
+        }
+        size_type i = 0;
+        for (typename TypeParam::const_iterator it=loaded.begin(), end=loaded.end(); it != end; ++it, ++i) {
+            ASSERT_EQ(v[i], *it) << " at index "<<i;
+        }
+        std::vector<uint64_t> buf(v.size());
+        for (size_type q=0; q < 100 and !v.empty(); ++q) {
+            size_type begin = rand()%v.size(), end = begin + rand()%(v.size()-begin+1);
+            loaded.decode(begin, end, &buf[0]);
+            for (size_type j=begin; j < end; ++j) {
+                ASSERT_EQ(v[j], buf[j-begin]) << " at index "<<j<<" in ["<<begin<<","<<end<<")";
+            }
+        }
+    }
+}
+
+// Number of bits of the chunks and overflow bits for the given level widths
+uint64_t dac_bits(const std::vector<uint64_t>& v, const std::vector<uint8_t>& widths)
+{
+    uint64_t bits = 0;
+    for (size_type i=0; i < v.size(); ++i) {
+        uint8_t len = v[i] ? sdsl::bit_magic::l1BP(v[i])+1 : 1;
+        for (size_type l=0, s=0; l < widths.size() and (l == 0 or s < len); s += widths[l], ++l)
+            bits += widths[l] + (l+1 < widths.size());
+    }
+    return bits;
+}
+
+//! Test that the optimal level widths do not take more space than fixed widths
+TEST(DacVectorOptimalTest, Widths)
+{
+    srand(5);
+    std::vector<uint64_t> v = generate(100000);
+    sdsl::dac_vector<> opt(v);
+    std::vector<uint8_t> opt_widths;
+    for (uint8_t l=0; l < opt.levels(); ++l)
+        opt_widths.push_back(opt.level_width(l));
+    uint64_t opt_bits = dac_bits(v, opt_widths);
+    for (uint8_t b=1; b <= 64; ++b) {
+        std::vector<uint8_t> widths;
+        for (uint8_t s=0; s < 64; s += b)
+            widths.push_back(std::min(b, (uint8_t)(64-s)));
+        ASSERT_LE(opt_bits, dac_bits(v, widths)) << " for b="<<(int)b;
+    }
+}
+
+//! Test the construction from an int_vector_file_buffer, which is used by lcp_dac
+TEST(DacVectorFileBufferTest, Construct)
+{
+    srand(3);
+    std::vector<uint64_t> v = generate(50000);
+    sdsl::int_vector<> iv(v.size(), 0, 64);
+    for (size_type i=0; i < v.size(); ++i)
+        iv[i] = v[i];
+    std::string file_name = "tmp_dac_vector_test.int_vector";
+    ASSERT_TRUE(sdsl::util::store_to_file(iv, file_name.c_str()));
+    sdsl::int_vector_file_buffer<> buf(file_name.c_str());
+    sdsl::dac_vector<> dv(buf);
+    sdsl::dac_vector<4> dv4(buf);
+    ASSERT_EQ(v.size(), dv.size());
+    ASSERT_EQ(v.size(), dv4.size());
+    for (size_type i=0; i < v.size(); ++i) {
+        ASSERT_EQ(v[i], dv[i]) << " at index "<<i;
+        ASSERT_EQ(v[i], dv4[i]) << " at index "<<i;
+    }
+    std::remove(file_name.c_str());
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
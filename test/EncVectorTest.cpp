@@ -0,0 +1,170 @@
+#include "sdsl/enc_vector.hpp"
+#include "sdsl/vlc_vector.hpp"
+#include "sdsl/enc_vector_dna.hpp"
+#include "sdsl/coder.hpp"
+#include "sdsl/util.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdio> // for remove
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+template<class T>
+class EncVectorTest : public ::testing::Test
+{
+    protected:
+        uint32_t    m_threads; // thread count before the test
+        std::string m_file_name;
+
+        EncVectorTest():m_threads(sdsl::util::thread_count()), m_file_name("tmp_enc_vector_test.int_vector") {}
+
+        virtual void TearDown() {
+            sdsl::util::set_thread_count(m_threads);
+            std::remove(m_file_name.c_str());
+        }
+
+        // Random values; increasing for enc_vector, which encodes differences.
+        std::vector<uint64_t> random_values(size_type n, bool increasing) {
+            std::vector<uint64_t> v(n);
+            uint64_t x = 0;
+            for (size_type i=0; i < n; ++i) {
+                uint64_t r = rand();
+                uint64_t d = (r%4 == 0) ? (r>>2)%1000000 : (r>>2)%4; // mostly short codes
+                if (increasing) {
+                    x += d+1;
+                    v[i] = x;
+                } else {
+                    v[i] = d;
+                }
+            }
+            return v;
+        }
+
+        bool increasing(const sdsl::enc_vector<typename T::coder, T::sample_dens>*) {
+            return true;
+        }
+
+        bool increasing(const void*) {
+            return false;
+        }
+};
+
+using testing::Types;
+
+typedef Types<sdsl::enc_vector<sdsl::coder::elias_delta, 8>,
+        sdsl::enc_vector<sdsl::coder::elias_delta, 64>,
+        sdsl::enc_vector<sdsl::coder::fibonacci, 8>,
+        sdsl::enc_vector<sdsl::coder::fibonacci, 128>,
+        sdsl::enc_vector<sdsl::coder::vbyte, 32>,
+        sdsl::enc_vector<sdsl::coder::pfor<4>, 32>,
+        sdsl::vlc_vector<sdsl::coder::elias_delta, 16>,
+        sdsl::vlc_vector<sdsl::coder::fibonacci, 16>,
+        sdsl::vlc_vector<sdsl::coder::vbyte, 16>,
+        sdsl::vlc_vector<sdsl::coder::pfor<2>, 16>
+        > Implementations;
+
+TYPED_TEST_CASE(EncVectorTest, Implementations);
+
+//! Test random access, the iterator and decode_block
+TYPED_TEST(EncVectorTest, DecodeBlock)
+{
+    srand(21);
+    size_type sizes[] = {1, 2, 7, 8, 9, 100, 100000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        std::vector<uint64_t> v = this->random_values(sizes[s], this->increasing((TypeParam*)NULL));
+        TypeParam ev(v);
+        ASSERT_EQ(v.size(), ev.size());
+        for (size_type i=0; i < v.size(); ++i) {
+            ASSERT_EQ(v[i], ev[i]) << " at index "<<i;
+        }
+        size_type i = 0;
+        for (typename TypeParam::const_iterator it=ev.begin(), end=ev.end(); it != end; ++it, ++i) {
+            ASSERT_EQ(v[i], *it) << " at index "<<i;
+        }
+        ASSERT_EQ(v.size(), i);
+        typename TypeParam::const_iterator it = ev.begin();
+        for (i=0; i < v.size(); i += 1+rand()%(2*TypeParam::sample_dens)) {
+            ASSERT_EQ(v[i], it[i]) << " at index "<<i;
+            typename TypeParam::const_iterator it2 = it + i;
+            ASSERT_EQ(v[i], *it2) << " at index "<<i;
+            it2 = it;
+            ASSERT_EQ(v[0], *(it2++));
+        }
+        std::vector<uint64_t> buf(TypeParam::sample_dens);
+        for (size_type k=0; k*TypeParam::sample_dens < v.size(); ++k) {
+            size_type n = ev.decode_block(k, &buf[0]);
+            ASSERT_EQ(std::min((size_type)TypeParam::sample_dens, v.size()-k*TypeParam::sample_dens), n);
+            for (size_type j=0; j < n; ++j) {
+                ASSERT_EQ(v[k*TypeParam::sample_dens+j], buf[j]) << " in block "<<k;
+            }
+        }
+    }
+}
+
+// Serializes v into a string
+template<class T>
+std::string serialized(const T& v)
+{
+    std::stringstream ss;
+    v.serialize(ss);
+    return ss.str();
+}
+
+//! Test that the construction with several threads and from an int_vector_file_buffer yields the same vector
+TYPED_TEST(EncVectorTest, ParallelConstruction)
+{
+    srand(22);
+    size_type sizes[] = {1, 1000, sdsl::coder::block_encoder<sdsl::coder::elias_delta, true>::chunk_size + 1001};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        std::vector<uint64_t> v = this->random_values(sizes[s], this->increasing((TypeParam*)NULL));
+        sdsl::int_vector<> iv(v.size(), 0, 64);
+        for (size_type i=0; i < v.size(); ++i)
+            iv[i] = v[i];
+        ASSERT_TRUE(sdsl::util::store_to_file(iv, this->m_file_name.c_str()));
+        sdsl::util::set_thread_count(1);
+        TypeParam ev(v);
+        std::string expected = serialized(ev);
+        sdsl::util::set_thread_count(7);
+        TypeParam ev_par(v);
+        ASSERT_EQ(expected, serialized(ev_par));
+        sdsl::int_vector_file_buffer<> buf(this->m_file_name.c_str());
+        TypeParam ev_buf(buf);
+        ASSERT_EQ(expected, serialized(ev_buf));
+        for (size_type i=0; i < v.size(); ++i) {
+            ASSERT_EQ(v[i], ev_buf[i]) << " at index "<<i;
+        }
+    }
+}
+
+//! Test the construction of enc_vector_dna from an int_vector_file_buffer
+TEST(EncVectorDnaTest, FileBuffer)
+{
+    srand(23);
+    sdsl::int_vector<> iv(100000, 0, 64);
+    for (size_type i=0, x=0; i < iv.size(); ++i)
+        iv[i] = (x += 1 + rand()%50);
+    std::string file_name = "tmp_enc_vector_dna_test.int_vector";
+    ASSERT_TRUE(sdsl::util::store_to_file(iv, file_name.c_str()));
+    sdsl::enc_vector_dna<> ev(iv);
+    sdsl::int_vector_file_buffer<> buf(file_name.c_str());
+    sdsl::enc_vector_dna<> ev_buf(buf);
+    ASSERT_EQ(serialized(ev), serialized(ev_buf));
+    for (size_type i=0; i < iv.size(); ++i) {
+        ASSERT_EQ(iv[i], ev_buf[i]) << " at index "<<i;
+    }
+    std::remove(file_name.c_str());
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
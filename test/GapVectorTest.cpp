@@ -0,0 +1,53 @@
+#include "sdsl/gap_vector.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::bit_vector bit_vector;
+typedef sdsl::bit_vector::size_type size_type;
+
+class GapVectorTest : public ::testing::Test { };
+
+//! Test access, rank and select for different sizes and densities
+TEST_F(GapVectorTest, RankSelect)
+{
+    srand(19);
+    size_type sizes[] = {0, 1, 63, 64, 65, 1000, 100000, 2000000};
+    size_type densities[] = {1, 2, 20, 1000, 1000000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        for (size_type d=0; d < sizeof(densities)/sizeof(densities[0]); ++d) {
+            bit_vector bv(sizes[s], 0);
+            for (size_type i=0; i < bv.size(); ++i) {
+                bv[i] = (rand()%densities[d] == 0);
+            }
+            sdsl::gap_vector<> gv(bv);
+            std::stringstream ss;
+            gv.serialize(ss);
+            sdsl::gap_vector<> loaded;
+            loaded.load(ss);
+            sdsl::gap_vector<>::rank_1_type rank(&loaded);
+            sdsl::gap_vector<>::select_1_type select(&loaded);
+            ASSERT_EQ(bv.size(), loaded.size());
+            size_type ones = 0;
+            for (size_type i=0; i < bv.size(); ++i) {
+                ASSERT_EQ(ones, rank(i)) << " at index "<<i;
+                ASSERT_EQ((bool)bv[i], (bool)loaded[i]) << " at index "<<i;
+                if (bv[i]) {
+                    ASSERT_EQ(i, select(++ones));
+                }
+            }
+            ASSERT_EQ(ones, rank(bv.size()));
+        }
+    }
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
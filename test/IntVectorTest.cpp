@@ -1,10 +1,15 @@
 #include "sdsl/int_vector.hpp"
 #include "sdsl/bitmagic.hpp"
+#include "sdsl/block_codec.hpp"
 #include "sdsl/util.hpp"
 #include "gtest/gtest.h"
 #include <vector>
 #include <cstdlib> // for rand()
 #include <string>
+#include <fstream>
+#include <sstream>
+#include <unistd.h> // for syscall
+#include <sys/syscall.h> // for SYS_get_mempolicy
 
 namespace
 {
@@ -16,7 +21,7 @@ class IntVectorTest : public ::testing::Test
 {
     protected:
 
-        IntVectorTest() {
+        IntVectorTest():m_threads(sdsl::util::thread_count()) {
             // You can do set-up work for each test here.
         }
 
@@ -45,10 +50,12 @@ class IntVectorTest : public ::testing::Test
         virtual void TearDown() {
             // Code here will be called immediately after each test (right
             // before the destructor).
+            sdsl::util::set_thread_count(m_threads);
         }
 
         // Objects declared here can be used by all tests in the test case for Foo.
         std::vector<size_type> vec_sizes; // different sizes for the vectors
+        uint32_t               m_threads; // thread count before the test
 };
 
 //! Test the default constructor
@@ -150,6 +157,405 @@ TEST_F(IntVectorTest, SerializeAndLoad)
         EXPECT_EQ(iv[i], iv2[i]);
 }
 
+TEST_F(IntVectorTest, SerializeAndLoadMapped)
+{
+    std::string file_name = "/tmp/int_vector_mapped";
+    for (size_type i=0; i < vec_sizes.size(); i+=8) {
+        sdsl::int_vector<64> iv(vec_sizes[i]);
+        for (size_type j=0; j<iv.size(); ++j)
+            iv[j] = rand();
+        sdsl::util::store_to_file(iv, file_name.c_str());
+        sdsl::int_vector<64> iv2;
+        ASSERT_TRUE(sdsl::util::load_from_file_mapped(iv2, file_name.c_str()));
+        ASSERT_TRUE(iv2.mapped());
+        ASSERT_EQ(iv.size(), iv2.size());
+        for (size_type j=0; j<iv.size(); ++j)
+            EXPECT_EQ(iv[j], iv2[j]);
+        if (iv2.size() > 0) {
+            // writes to the mapping are private to the process
+            iv2[0] = iv2[0]+1;
+            sdsl::int_vector<64> iv3;
+            ASSERT_TRUE(sdsl::util::load_from_file_mapped(iv3, file_name.c_str()));
+            EXPECT_EQ(iv[0], iv3[0]);
+        }
+        // resizing copies the data to the heap
+        sdsl::int_vector<64> iv4;
+        sdsl::util::load_from_file_mapped(iv4, file_name.c_str());
+        iv4.resize(iv4.size()+1);
+        ASSERT_FALSE(iv4.mapped());
+        for (size_type j=0; j<iv.size(); ++j)
+            EXPECT_EQ(iv[j], iv4[j]);
+    }
+    for (size_type i=0; i < vec_sizes.size(); i+=8) {
+        // the data of an int_vector<0> starts at byte 9 and is copied to the heap
+        sdsl::int_vector<> iv(vec_sizes[i], 0, 1 + (i%64));
+        for (size_type j=0; j<iv.size(); ++j)
+            iv[j] = rand();
+        sdsl::util::store_to_file(iv, file_name.c_str());
+        sdsl::int_vector<> iv2;
+        ASSERT_TRUE(sdsl::util::load_from_file_mapped(iv2, file_name.c_str()));
+        ASSERT_FALSE(iv2.mapped());
+        ASSERT_EQ(iv.size(), iv2.size());
+        ASSERT_EQ(iv.get_int_width(), iv2.get_int_width());
+        for (size_type j=0; j<iv.size(); ++j)
+            EXPECT_EQ(iv[j], iv2[j]);
+    }
+    std::remove(file_name.c_str());
+}
+
+TEST_F(IntVectorTest, LoadMappedPadding)
+{
+    // The word behind a bit_vector whose size is a multiple of 64 has to be zero.
+    std::string file_name = "/tmp/int_vector_mapped_padding";
+    sdsl::bit_vector bv1(128, 1), bv2(64, 1);
+    {
+        std::ofstream out(file_name.c_str());
+        bv1.serialize(out);
+        bv2.serialize(out);
+    }
+    sdsl::mm_file* file = sdsl::mm_file::open(file_name.c_str());
+    ASSERT_TRUE(file != NULL);
+    {
+        sdsl::mm_streambuf buf(file);
+        std::istream in(&buf);
+        sdsl::bit_vector bv3, bv4;
+        bv3.load(in);
+        bv4.load(in);
+        ASSERT_TRUE(bv3 == bv1);
+        ASSERT_TRUE(bv4 == bv2);
+        EXPECT_FALSE(bv3.mapped()); // followed by the size of bv2
+        EXPECT_TRUE(bv4.mapped());  // followed by the zero padding behind the file
+        EXPECT_EQ(0ULL, bv3.data()[2]);
+        EXPECT_EQ(0ULL, bv4.data()[1]);
+    }
+    file->release();
+    std::remove(file_name.c_str());
+}
+
+TEST_F(IntVectorTest, LoadMappedAligned)
+{
+    // In the aligned format each int_vector is mapped, also an int_vector<0> and the vectors behind it.
+    std::string file_name = "/tmp/int_vector_mapped_aligned";
+    sdsl::bit_vector bv1(128, 1), bv2(0);
+    sdsl::int_vector<> iv1(1000, 3, 7), iv2(64, 5, 13);
+    {
+        std::ofstream out(file_name.c_str());
+        sdsl::util::set_aligned_serialization(out);
+        bv1.serialize(out);
+        iv1.serialize(out);
+        bv2.serialize(out);
+        iv2.serialize(out);
+    }
+    sdsl::mm_file* file = sdsl::mm_file::open(file_name.c_str());
+    ASSERT_TRUE(file != NULL);
+    {
+        sdsl::mm_streambuf buf(file);
+        std::istream in(&buf);
+        sdsl::bit_vector bv3, bv4;
+        sdsl::int_vector<> iv3, iv4;
+        bv3.load(in);
+        iv3.load(in);
+        bv4.load(in);
+        iv4.load(in);
+        ASSERT_TRUE(bv3 == bv1);
+        ASSERT_TRUE(iv3 == iv1);
+        ASSERT_TRUE(bv4 == bv2);
+        ASSERT_TRUE(iv4 == iv2);
+        EXPECT_TRUE(bv3.mapped());
+        EXPECT_TRUE(iv3.mapped());
+        EXPECT_TRUE(bv4.mapped());
+        EXPECT_TRUE(iv4.mapped());
+        EXPECT_EQ(buf.remaining(), 0ULL);
+    }
+    file->release();
+    // The aligned format can also be read by load and int_vector_file_buffer
+    sdsl::int_vector<> iv5;
+    ASSERT_TRUE(sdsl::util::store_to_file_aligned(iv1, file_name.c_str()));
+    ASSERT_TRUE(sdsl::util::load_from_file(iv5, file_name.c_str()));
+    ASSERT_TRUE(iv5 == iv1);
+    sdsl::int_vector_file_buffer<> iv_buf(file_name.c_str(), 100);
+    ASSERT_EQ(iv1.size(), iv_buf.int_vector_size);
+    for (size_type i=0, r_sum=0, r=iv_buf.load_next_block(); i < iv1.size();) {
+        for (; i < r_sum+r; ++i) {
+            ASSERT_EQ(iv1[i], iv_buf[i-r_sum]);
+        }
+        r_sum += r;
+        r = iv_buf.load_next_block();
+    }
+    std::remove(file_name.c_str());
+}
+
+TEST_F(IntVectorTest, FileBuffer)
+{
+    std::string file_name = "/tmp/int_vector_file_buffer";
+    ASSERT_FALSE(sdsl::util::file_buffer_prefetch()); // background I/O is opt-in
+    for (size_type i=0; i < vec_sizes.size(); i+=16) {
+        sdsl::int_vector<> iv(vec_sizes[i], 0, 1 + (i%64));
+        for (size_type j=0; j<iv.size(); ++j)
+            iv[j] = rand();
+        sdsl::util::store_to_file(iv, file_name.c_str());
+        for (size_type prefetch=0; prefetch < 2; ++prefetch) {
+            size_type len = 1 + rand()%200000;
+            sdsl::int_vector_file_buffer<> buf(file_name.c_str(), len, 0, prefetch);
+            ASSERT_EQ(iv.size(), buf.int_vector_size);
+            for (size_type round=0; round < 2; ++round) { // second round tests reset
+                buf.reset();
+                for (size_type j=0, r_sum=0, r=buf.load_next_block(); j < iv.size();) {
+                    for (; j < r_sum+r; ++j) {
+                        ASSERT_EQ(iv[j], buf[j-r_sum]) << " at index " << j << " with block length " << len;
+                    }
+                    r_sum += r; r = buf.load_next_block();
+                }
+            }
+        }
+    }
+    std::remove(file_name.c_str());
+}
+
+//! Test that compressed temporary files can be read by load and int_vector_file_buffer
+TEST_F(IntVectorTest, CompressedTempFile)
+{
+    std::string file_name = "/tmp/int_vector_compressed";
+    sdsl::util::set_temp_file_compression(true);
+    for (size_type i=0; i < vec_sizes.size(); i+=16) {
+        uint8_t w = 1 + (i%64);
+        sdsl::int_vector<> iv(vec_sizes[i], 0, w);
+        for (size_type j=0; j<iv.size(); ++j) // mix of small, increasing and random values
+            iv[j] = (j/1000)%3==0 ? rand()%8 : ((j/1000)%3==1 ? j : rand());
+        ASSERT_TRUE(sdsl::util::store_to_temp_file(iv, file_name.c_str()));
+        sdsl::int_vector<> iv2;
+        ASSERT_TRUE(sdsl::util::load_from_file(iv2, file_name.c_str()));
+        ASSERT_EQ(w, iv2.get_int_width());
+        ASSERT_TRUE(iv == iv2);
+        size_type len = 1 + rand()%200000;
+        sdsl::int_vector_file_buffer<> buf(file_name.c_str(), len);
+        ASSERT_EQ(iv.size(), buf.int_vector_size);
+        for (size_type round=0; round < 2; ++round) { // second round tests reset
+            buf.reset();
+            for (size_type j=0, r_sum=0, r=buf.load_next_block(); j < iv.size();) {
+                for (; j < r_sum+r; ++j) {
+                    ASSERT_EQ(iv[j], buf[j-r_sum]) << " at index " << j << " with block length " << len;
+                }
+                r_sum += r; r = buf.load_next_block();
+            }
+        }
+    }
+    sdsl::int_vector<32> iv32(123457);
+    for (size_type j=0; j<iv32.size(); ++j)
+        iv32[j] = rand();
+    ASSERT_TRUE(sdsl::util::store_to_temp_file(iv32, file_name.c_str()));
+    sdsl::int_vector<32> iv32_2;
+    ASSERT_TRUE(sdsl::util::load_from_file(iv32_2, file_name.c_str()));
+    ASSERT_TRUE(iv32 == iv32_2);
+    sdsl::util::set_temp_file_compression(false);
+    std::remove(file_name.c_str());
+}
+
+//! Test that run-length encoded bytes with runs beyond the output or the input are rejected
+TEST_F(IntVectorTest, CorruptedByteBlock)
+{
+    std::vector<uint8_t> bytes(1000), enc(sdsl::block_codec::max_encoded_bytes_size(bytes.size())), dec(bytes.size());
+    for (size_type i=0; i < bytes.size(); ++i)
+        bytes[i] = (i/100)%2 ? 'a' : rand();
+    uint64_t len = sdsl::block_codec::encode_bytes(&bytes[0], bytes.size(), &enc[0]);
+    ASSERT_EQ(len, sdsl::block_codec::decode_bytes(&enc[0], len, bytes.size(), &dec[0]));
+    ASSERT_TRUE(bytes == dec);
+    // the input ends early
+    ASSERT_EQ(0ULL, sdsl::block_codec::decode_bytes(&enc[0], len/2, bytes.size(), &dec[0]));
+    // the runs produce more than n bytes
+    ASSERT_EQ(0ULL, sdsl::block_codec::decode_bytes(&enc[0], len, bytes.size()-1, &dec[0]));
+    uint8_t run[] = {255, 'x'}, literals[] = {127, 'x'};
+    ASSERT_EQ(0ULL, sdsl::block_codec::decode_bytes(run, sizeof(run), 10, &dec[0]));
+    ASSERT_EQ(0ULL, sdsl::block_codec::decode_bytes(literals, sizeof(literals), 1000, &dec[0]));
+    // read_bytes rejects a block which claims to be longer than the stream
+    std::stringstream ss;
+    sdsl::block_codec::write_bytes(ss, &bytes[0], bytes.size());
+    std::string block = ss.str();
+    std::stringstream truncated(block.substr(0, block.size()/2));
+    ASSERT_FALSE(sdsl::block_codec::read_bytes(truncated, bytes.size(), &dec[0]));
+}
+
+//! Test that int_vector_file_writer writes files which can be loaded
+TEST_F(IntVectorTest, FileWriter)
+{
+    std::string file_name = "/tmp/int_vector_file_writer";
+    for (size_type i=0; i < vec_sizes.size(); i+=8) {
+        uint8_t w = 1 + (i%64);
+        sdsl::int_vector<> iv(vec_sizes[i], 0, w);
+        for (size_type j=0; j<iv.size(); ++j)
+            iv[j] = rand();
+        std::vector<uint64_t> values(iv.size());
+        iv.decode(0, iv.size(), values.empty() ? NULL : &values[0]);
+        for (size_type c=0; c < 4; ++c) { // raw/compressed and synchronous/asynchronous
+            bool async = c&1, compress = c&2;
+            {
+                sdsl::int_vector_file_writer<> out(file_name.c_str(), w, 1+rand()%100000, async, compress);
+                ASSERT_TRUE(out.is_open());
+                size_type j = 0;
+                while (j < iv.size()) { // mix of push_back and append
+                    size_type cnt = std::min((size_type)rand()%5000, iv.size()-j);
+                    if (rand()%2) {
+                        out.append(&values[j], cnt);
+                    } else {
+                        for (size_type k=j; k < j+cnt; ++k)
+                            out.push_back(values[k] | (1ULL<<63)); // bits above w are ignored
+                    }
+                    j += cnt;
+                }
+                ASSERT_EQ(iv.size(), out.size());
+                ASSERT_TRUE(out.close());
+            }
+            sdsl::int_vector<> iv2;
+            ASSERT_TRUE(sdsl::util::load_from_file(iv2, file_name.c_str()));
+            ASSERT_EQ(w, iv2.get_int_width());
+            ASSERT_TRUE(iv == iv2) << "async=" << async << " compress=" << compress;
+        }
+    }
+    { // fixed width vector written by the destructor
+        sdsl::bit_vector bv(1000003);
+        {
+            sdsl::int_vector_file_writer<1> out(file_name.c_str());
+            for (size_type j=0; j<bv.size(); ++j)
+                out.push_back(bv[j] = rand()%2);
+        }
+        sdsl::bit_vector bv2;
+        ASSERT_TRUE(sdsl::util::load_from_file(bv2, file_name.c_str()));
+        ASSERT_TRUE(bv == bv2);
+    }
+    std::remove(file_name.c_str());
+}
+
+//! Test the in place width change and the parallel util methods
+TEST_F(IntVectorTest, Repack)
+{
+    sdsl::util::set_thread_count(4);
+    for (size_type i=0; i < vec_sizes.size(); i+=8) {
+        uint8_t w1 = 1 + rand()%64, w2 = 1 + rand()%64;
+        if (w1 > w2) {
+            std::swap(w1, w2);
+        }
+        sdsl::int_vector<> iv(vec_sizes[i], 0, w1);
+        sdsl::util::set_random_bits(iv);
+        sdsl::int_vector<> iv2(iv);
+        iv2.repack(w2); // expand
+        ASSERT_EQ(w2, iv2.get_int_width());
+        ASSERT_EQ(iv.size(), iv2.size());
+        for (size_type j=0; j < iv.size(); ++j) {
+            ASSERT_EQ(iv[j], iv2[j]) << " at index " << j << " width " << (int)w1 << " -> " << (int)w2;
+        }
+        iv2.repack(w1); // shrink
+        ASSERT_TRUE(iv == iv2);
+        sdsl::util::set_to_id(iv2);
+        for (size_type j=0; j < iv2.size(); ++j) {
+            ASSERT_EQ(j & sdsl::bit_magic::Li1Mask[w1], iv2[j]);
+        }
+        sdsl::util::set_all_values_to_k(iv2, 5);
+        for (size_type j=0; j < iv2.size(); ++j) {
+            ASSERT_EQ((uint64_t)5 & sdsl::bit_magic::Li1Mask[w1], iv2[j]);
+        }
+        size_type ones = 0;
+        for (size_type j=0; j < iv.size(); ++j) {
+            ones += sdsl::bit_magic::b1Cnt(iv[j]);
+        }
+        ASSERT_EQ(ones, sdsl::util::get_one_bits(iv));
+        iv2 = iv;
+        iv2.repack(64);
+        sdsl::util::bit_compress(iv2);
+        ASSERT_EQ(iv.size(), iv2.size());
+        for (size_type j=0; j < iv.size(); ++j) {
+            ASSERT_EQ(iv[j], iv2[j]);
+        }
+    }
+}
+
+TEST_F(IntVectorTest, DecodeAndEncode)
+{
+    for (unsigned char w=1; w <= 64; ++w) { // for each possible width
+        sdsl::int_vector<> iv(10000, 0, w);
+        for (size_type i=0; i < iv.size(); ++i) {
+            iv[i] = rand();
+        }
+        sdsl::int_vector<> iv2(iv);
+        std::vector<uint64_t> buf(iv.size());
+        for (size_type r=0; r < 20; ++r) {
+            size_type begin = rand() % iv.size();
+            size_type end   = begin + rand() % (iv.size()-begin+1);
+            iv.decode(begin, end, &buf[0]);
+            for (size_type i=begin; i < end; ++i) {
+                ASSERT_EQ(iv[i], buf[i-begin]) << " width=" << (int)w << " begin=" << begin << " end=" << end;
+            }
+            for (size_type i=begin; i < end; ++i) {
+                buf[i-begin] = rand();
+                iv2[i] = buf[i-begin];
+            }
+            iv.encode(begin, end, &buf[0]);
+            for (size_type i=0; i < iv.size(); ++i) { // elements outside the range stay unchanged
+                ASSERT_EQ(iv2[i], iv[i]) << " width=" << (int)w << " begin=" << begin << " end=" << end;
+            }
+        }
+    }
+}
+
+// Returns the NUMA placement which the kernel applies to the page at p
+sdsl::numa_placement_type placement(const void* p)
+{
+#ifdef SYS_get_mempolicy
+    int mode = 0;
+    if (syscall(SYS_get_mempolicy, &mode, NULL, 0, p, 2 /*MPOL_F_ADDR*/) == 0) {
+        if (mode == 3) return sdsl::NUMA_INTERLEAVE;
+        if (mode == 4) return sdsl::NUMA_LOCAL;
+    }
+#endif
+    return sdsl::NUMA_DEFAULT;
+}
+
+// Returns the NUMA placement which memory_type reports
+sdsl::numa_placement_type reported_placement(const std::string& type)
+{
+    if (type.find("/interleave") != std::string::npos) return sdsl::NUMA_INTERLEAVE;
+    if (type.find("/local") != std::string::npos) return sdsl::NUMA_LOCAL;
+    return sdsl::NUMA_DEFAULT;
+}
+
+//! Test the allocation policies; memory_type reports the placement which the kernel applied
+TEST_F(IntVectorTest, AllocPolicy)
+{
+    sdsl::page_size_type pages[] = {sdsl::SMALL_PAGES, sdsl::HUGE_PAGES_2MB, sdsl::HUGE_PAGES_1GB};
+    sdsl::numa_placement_type numa[] = {sdsl::NUMA_DEFAULT, sdsl::NUMA_INTERLEAVE, sdsl::NUMA_LOCAL};
+    for (size_type p=0; p < 3; ++p) {
+        for (size_type n=0; n < 3; ++n) {
+            sdsl::alloc_policy policy(pages[p], numa[n]);
+            sdsl::memory_manager::set_default_policy(policy);
+            sdsl::int_vector<> iv(1000000, 0, 33);
+            ASSERT_EQ(policy, iv.get_alloc_policy());
+            if (!policy.is_default()) {
+                ASSERT_NE(std::string("heap"), sdsl::memory_manager::memory_type(iv.data()));
+                ASSERT_EQ(placement(iv.data()), reported_placement(sdsl::memory_manager::memory_type(iv.data())));
+            }
+            for (size_type i=0; i < iv.size(); ++i) {
+                iv[i] = i;
+            }
+            for (size_type i=0; i < 5; ++i) { // grow and shrink; the content is preserved
+                size_type new_size = rand() % 2000000;
+                size_type old_size = iv.size();
+                iv.resize(new_size);
+                for (size_type j=old_size; j < new_size; ++j) {
+                    iv[j] = j;
+                }
+                for (size_type j=0; j < new_size; ++j) {
+                    ASSERT_EQ(j, iv[j]);
+                }
+            }
+            sdsl::int_vector<> iv2(iv);
+            ASSERT_EQ(policy, iv2.get_alloc_policy());
+            iv2.set_alloc_policy(sdsl::alloc_policy());
+            ASSERT_EQ(std::string("heap"), sdsl::memory_manager::memory_type(iv2.data()));
+            ASSERT_TRUE(iv == iv2);
+        }
+    }
+    sdsl::memory_manager::set_default_policy(sdsl::alloc_policy());
+}
+
 // Tests that the Foo::Bar() method does Abc.
 //TEST_F(FooTest, MethodBarDoesAbc) {
 //	const string input_filepath = "test_cases/100a.txt";
@@ -0,0 +1,141 @@
+#include "sdsl/pef_vector.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <algorithm> // for std::lower_bound
+#include <sstream>
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+template<class T>
+class PefVectorTest : public ::testing::Test { };
+
+using testing::Types;
+
+typedef Types<sdsl::pef_vector<>,
+        sdsl::pef_vector<1>,
+        sdsl::pef_vector<64>,
+        sdsl::pef_vector<1000>
+        > Implementations;
+
+TYPED_TEST_CASE(PefVectorTest, Implementations);
+
+//! Test access, the iterator, next_geq and serialization for sequences with runs, dense and sparse regions
+TYPED_TEST(PefVectorTest, AccessAndNextGeq)
+{
+    srand(23);
+    size_type sizes[] = {0, 1, 2, 127, 128, 129, 100000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        std::vector<uint64_t> v(sizes[s]);
+        uint64_t x = rand()%100;
+        for (size_type i=0; i < v.size(); ++i) {
+            size_type region = (i/300)%4; // runs, duplicates, dense and sparse gaps
+            if (region == 0)
+                x += 1;
+            else if (region == 1)
+                x += rand()%2;
+            else if (region == 2)
+                x += 1 + rand()%3;
+            else
+                x += rand()%100000;
+            v[i] = x;
+        }
+        TypeParam pv(v);
+        std::stringstream ss;
+        pv.serialize(ss);
+        TypeParam loaded;
+        loaded.load(ss);
+        ASSERT_EQ(v.size(), loaded.size());
+        for (size_type i=0; i < v.size(); ++i) {
+            ASSERT_EQ(v[i], loaded[i]) << " at index "<<i;
+        }
+        size_type i = 0;
+        for (typename TypeParam::const_iterator it=loaded.begin(), end=loaded.end(); it != end; ++it, ++i) {
+            ASSERT_EQ(v[i], *it) << " at index "<<i;
+        }
+        uint64_t max_x = v.empty() ? 10 : v.back()+10;
+        for (size_type q=0; q < 10000; ++q) {
+            uint64_t y = q < 100 ? q : rand()%max_x;
+            ASSERT_EQ((size_type)(std::lower_bound(v.begin(), v.end(), y)-v.begin()), loaded.next_geq(y)) << " for "<<y;
+        }
+    }
+}
+
+//! Test next_geq for the largest value, also if the bucket index has one bucket per value
+TYPED_TEST(PefVectorTest, NextGeqMax)
+{
+    uint64_t max_x = ~0ULL;
+    size_type sizes[] = {0, 1, 300, 5000};
+    for (size_type s=0; s < sizeof(sizes)/sizeof(sizes[0]); ++s) {
+        std::vector<uint64_t> v(sizes[s]);
+        for (size_type i=0; i < v.size(); ++i)
+            v[i] = i/3; // less than one value per element, so the bucket index is not shifted
+        TypeParam pv(v);
+        ASSERT_EQ(v.size(), pv.next_geq(max_x));
+        if (!v.empty()) {
+            v.back() = max_x;
+            TypeParam pv_max(v);
+            ASSERT_EQ(v.size()-1, pv_max.next_geq(max_x));
+            if (v.size() > 1) {
+                ASSERT_EQ(v.size()-1, pv_max.next_geq(v[v.size()-2]+1));
+            }
+        }
+    }
+}
+
+//! Test that decreasing sequences are rejected
+TYPED_TEST(PefVectorTest, Decreasing)
+{
+    std::vector<uint64_t> v(300, 5);
+    v[200] = 4;
+    ASSERT_THROW(TypeParam pv(v), std::logic_error);
+    v[200] = 5;
+    v[128] = 4; // first element of a block
+    ASSERT_THROW(TypeParam pv(v), std::logic_error);
+}
+
+//! Test that the chunks follow the regions of the sequence and that copies are independent
+TYPED_TEST(PefVectorTest, Partition)
+{
+    size_type chunk_size = TypeParam::sample_dens;
+    std::vector<uint64_t> v(20000);
+    for (size_type i=0, x=0; i < v.size(); ++i) {
+        x += (i < 10000) ? 1 : 1000; // a run followed by a sparse region
+        v[i] = x;
+    }
+    TypeParam pv(v);
+    // The run needs one chunk per ChunkSize elements; the chunks of the sparse
+    // region are not longer than ChunkSize either.
+    ASSERT_LE((10000+chunk_size-1)/chunk_size + (10000+chunk_size-1)/chunk_size, pv.chunks());
+    // Chunks spanning both regions cost more than a chunk boundary, so the
+    // run takes about 8 bits per ChunkSize elements.
+    std::vector<uint64_t> run(v.begin(), v.begin()+10000), sparse(v.begin()+10000, v.end());
+    TypeParam pv_run(run), pv_sparse(sparse);
+    ASSERT_EQ(pv_run.chunks() + pv_sparse.chunks(), pv.chunks());
+    ASSERT_EQ((10000+chunk_size-1)/chunk_size, pv_run.chunks());
+
+    TypeParam copy(pv), assigned;
+    assigned = pv;
+    TypeParam swapped;
+    swapped.swap(assigned);
+    pv = TypeParam(); // copies and swapped vectors do not refer to pv
+    ASSERT_EQ(v.size(), copy.size());
+    ASSERT_EQ(v.size(), swapped.size());
+    ASSERT_EQ((size_type)0, assigned.size());
+    for (size_type i=0; i < v.size(); i += 1+rand()%50) {
+        ASSERT_EQ(v[i], copy[i]) << " at index "<<i;
+        ASSERT_EQ(v[i], swapped[i]) << " at index "<<i;
+        ASSERT_EQ(i, copy.next_geq(v[i]));
+    }
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
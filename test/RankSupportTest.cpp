@@ -4,6 +4,7 @@
 #include "sdsl/rank_support_jmc.hpp" // for rank_support_jmc
 #include "sdsl/rrr_vector.hpp" // for rrr_rank_support
 #include "sdsl/bit_vector_interleaved.hpp" // for rank_support_interleaved
+#include "sdsl/bit_vector_interleaved_cl.hpp" // for rank_support_interleaved_cl
 #include "sdsl/sd_vector.hpp" // for sd_rank_support
 #include "sdsl/gap_vector.hpp" // for gap_rank_support
 #include "sdsl/bitmagic.hpp"
@@ -92,6 +93,7 @@ typedef Types<
 sdsl::rank_support_interleaved<1,256>,
      sdsl::rank_support_interleaved<1, 512>,
      sdsl::rank_support_interleaved<1, 1024>,
+     sdsl::rank_support_interleaved_cl<1>,
      sdsl::rrr_rank_support<>,
      sdsl::rank_support_v<>,
      sdsl::rank_support_v5<>,
@@ -131,6 +133,48 @@ TYPED_TEST(RankSupportTest, RankMethod)
     }
 }
 
+template<class T>
+class RankSupportBatchTest : public RankSupportTest<T> {};
+
+typedef Types<
+sdsl::rank_support_v<>,
+     sdsl::rank_support_v5<>,
+     sdsl::rank_support_jmc
+     > BatchImplementations;
+
+TYPED_TEST_CASE(RankSupportBatchTest, BatchImplementations);
+
+//! Test the batch version of rank
+TYPED_TEST(RankSupportBatchTest, BatchRankMethod)
+{
+    for (size_type i=0; i<this->n; ++i) {
+        typename TypeParam::bit_vector_type bv(this->bs[i]);
+        TypeParam rs(&bv);
+        std::vector<size_type> idx(rand()%5000), out(idx.size()+1);
+        for (size_type k=0; k < idx.size(); ++k) {
+            idx[k] = rand() % (bv.size()+1);
+        }
+        rs.rank(idx.empty() ? NULL : &idx[0], idx.size(), &out[0]);
+        for (size_type k=0; k < idx.size(); ++k) {
+            ASSERT_EQ(rs.rank(idx[k]), out[k]) << " at index "<< idx[k] <<" of vector "<<i;
+        }
+    }
+}
+
+//! Test that the parallel construction does not depend on the number of threads
+TYPED_TEST(RankSupportBatchTest, ParallelConstruction)
+{
+    bit_vector bv(10000000);
+    sdsl::util::set_random_bits(bv, 3);
+    uint32_t threads = sdsl::util::thread_count();
+    sdsl::util::set_thread_count(1);
+    TypeParam rs1(&bv);
+    sdsl::util::set_thread_count(7);
+    TypeParam rs7(&bv);
+    sdsl::util::set_thread_count(threads);
+    ASSERT_TRUE(rs1 == rs7);
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
@@ -0,0 +1,118 @@
+#include "sdsl/sd_vector.hpp"
+#include "sdsl/rrr_vector.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <cstdlib> // for rand()
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+typedef sdsl::bit_vector bit_vector;
+
+template<class T>
+class SdVectorTest : public ::testing::Test
+{
+    protected:
+
+        static const size_t n = 6;
+
+        virtual void SetUp() {
+            srand(17);
+            bs[0] = bit_vector(0);
+            bs[1] = bit_vector(1, 1);
+            bs[2] = bit_vector(100000, 0);
+            bs[3] = bit_vector(100000, 0);
+            bs[4] = bit_vector(100000, 0);
+            bs[5] = bit_vector(100000, 0);
+            bs[2][0] = bs[2][99999] = 1;
+            for (size_type i=0; i < bs[3].size(); ++i) {
+                if (rand()%2) bs[3][i] = 1;
+                if (rand()%100 == 0) bs[4][i] = 1;
+            }
+            // clustered ones with large gaps between the clusters
+            for (size_type i=0; i < 20; ++i) {
+                size_type x = rand()%bs[5].size();
+                for (size_type j=x; j < x+50 and j < bs[5].size(); ++j)
+                    bs[5][j] = 1;
+            }
+        }
+
+        bit_vector bs[n];
+};
+
+using testing::Types;
+
+typedef Types<
+sdsl::sd_vector<>,
+     sdsl::sd_vector<sdsl::rrr_vector<63> >
+     > Implementations;
+
+TYPED_TEST_CASE(SdVectorTest, Implementations);
+
+//! Test next_geq and prev_leq
+TYPED_TEST(SdVectorTest, NextGeqPrevLeq)
+{
+    for (size_type i=0; i < this->n; ++i) {
+        const bit_vector& bv = this->bs[i];
+        TypeParam sd(bv);
+        size_type next = bv.size();
+        std::vector<size_type> next_geq(bv.size()+1, bv.size());
+        for (size_type j=bv.size(); j > 0; --j) {
+            if (bv[j-1]) next = j-1;
+            next_geq[j-1] = next;
+        }
+        size_type prev = bv.size(), ones = 0, idx = 0;
+        for (size_type j=0; j < bv.size(); ++j) {
+            if (bv[j]) {
+                prev = j;
+                ++ones;
+            }
+            ASSERT_EQ(next_geq[j], sd.next_geq(j)) << " at index "<<j<<" of vector "<<i;
+            ASSERT_EQ(prev, sd.prev_leq(j)) << " at index "<<j<<" of vector "<<i;
+            if (ones > 0) {
+                ASSERT_EQ(prev, sd.prev_leq(j, idx)) << " at index "<<j<<" of vector "<<i;
+                ASSERT_EQ(ones-1, idx) << " at index "<<j<<" of vector "<<i;
+            }
+        }
+        ASSERT_EQ(bv.size(), sd.next_geq(bv.size()));
+        ASSERT_EQ(prev, sd.prev_leq(bv.size()));
+    }
+}
+
+//! Test the cursor
+TYPED_TEST(SdVectorTest, Cursor)
+{
+    for (size_type i=0; i < this->n; ++i) {
+        const bit_vector& bv = this->bs[i];
+        TypeParam sd(bv);
+        typename TypeParam::cursor c(&sd);
+        size_type rank = 0;
+        for (size_type j=0; j < bv.size(); ++j) {
+            if (bv[j]) {
+                ASSERT_FALSE(c.end());
+                ASSERT_EQ(j, c.value());
+                ASSERT_EQ(rank++, c.index());
+                c.next();
+            }
+        }
+        ASSERT_TRUE(c.end());
+        ASSERT_EQ(bv.size(), c.value());
+        // skip with random distances
+        typename TypeParam::cursor s(&sd);
+        for (size_type x=0; x < bv.size(); x += 1 + rand()%(1+rand()%5000)) {
+            s.skip_to(x);
+            ASSERT_EQ(sd.next_geq(x), s.value()) << " skip to "<<x<<" in vector "<<i;
+        }
+        s.skip_to(bv.size());
+        ASSERT_TRUE(s.end());
+    }
+}
+
+}// end namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,13 +1,16 @@
 
 #include "sdsl/int_vector.hpp"
 #include "sdsl/select_support_mcl.hpp" // for select_support_mcl
+#include "sdsl/select_support_rank.hpp" // for select_support_rank
 #include "sdsl/bit_vector_interleaved.hpp" // for rank_support_interleaved
+#include "sdsl/bit_vector_interleaved_cl.hpp" // for rank_support_interleaved_cl
 #include "sdsl/rrr_vector.hpp" // for rrr_select_support
 #include "sdsl/sd_vector.hpp" // for sd_select_support
 #include "sdsl/gap_vector.hpp" // for gap_select_suport
 #include "sdsl/bitmagic.hpp"
 #include "gtest/gtest.h"
 #include <vector>
+#include <sstream>
 #include <cstdlib> // for rand()
 
 namespace
@@ -101,7 +104,9 @@ typedef Types<sdsl::select_support_mcl<>,
         sdsl::gap_select_support<>,
         sdsl::select_support_interleaved<1, 256>,
         sdsl::select_support_interleaved<1, 512>,
-        sdsl::select_support_interleaved<1, 1024>
+        sdsl::select_support_interleaved<1, 1024>,
+        sdsl::select_support_interleaved_cl<1, 512>,
+        sdsl::select_support_interleaved_cl<1, 64>
         > Implementations;
 
 TYPED_TEST_CASE(SelectSupportTest, Implementations);
@@ -122,6 +127,152 @@ TYPED_TEST(SelectSupportTest, SelectMethod)
     }
 }
 
+template<class T>
+class SelectSupportRankTest : public SelectSupportTest<T> {};
+
+typedef Types<sdsl::select_support_rank<1, sdsl::rank_support_v<> >,
+        sdsl::select_support_rank<1, sdsl::rank_support_v5<> >
+        > RankImplementations;
+
+TYPED_TEST_CASE(SelectSupportRankTest, RankImplementations);
+
+//! Test the select method of the select supports which use the counters of a rank support
+TYPED_TEST(SelectSupportRankTest, SelectMethod)
+{
+    for (size_type i=0; i<this->n; ++i) {
+        typename TypeParam::bit_vector_type bv(this->bs[i]);
+        typename TypeParam::rank_support_type rs(&bv);
+        TypeParam ss(&bv, &rs);
+        for (size_type j=0, select=0; j < (this->bs[i]).size(); ++j) {
+            if (this->bs[i][j]) {
+                ++select;
+                ASSERT_EQ(ss.select(select), j) << " at query "<<select<<" of vector "<<i<<" of length "<<(this->bs[i]).size();
+            }
+        }
+    }
+}
+
+//! Test the batch version of select
+TEST(SelectSupportBatchTest, BatchSelectMethod)
+{
+    srand(17);
+    for (size_type len=0; len < 3000000; len = 2*len+1000) {
+        bit_vector bv(len, 0);
+        for (size_type j=0; j < len; ++j) {
+            if (rand() % (j < len/2 ? 2 : 500) == 0) // dense and sparse parts
+                bv[j] = 1;
+        }
+        sdsl::select_support_mcl<> ss(&bv);
+        size_type ones = sdsl::util::get_one_bits(bv);
+        std::vector<size_type> idx(ones ? 5000 : 0), out(idx.size()+1);
+        for (size_type k=0; k < idx.size(); ++k) {
+            idx[k] = rand() % ones + 1;
+        }
+        ss.select(idx.empty() ? NULL : &idx[0], idx.size(), &out[0]);
+        for (size_type k=0; k < idx.size(); ++k) {
+            ASSERT_EQ(ss.select(idx[k]), out[k]) << " at query "<< idx[k] <<" of vector of length "<< len;
+        }
+    }
+}
+
+//! Test that the parallel construction does not depend on the number of threads
+TEST(SelectSupportParallelTest, ParallelConstruction)
+{
+    bit_vector bv(10000000, 0);
+    for (size_type j=0; j < bv.size(); ++j) {
+        if (rand() % (j < bv.size()/2 ? 2 : 5000) == 0) // dense part and long superblocks
+            bv[j] = 1;
+    }
+    uint32_t threads = sdsl::util::thread_count();
+    sdsl::util::set_thread_count(1);
+    sdsl::select_support_mcl<> ss1(&bv);
+    sdsl::util::set_thread_count(7);
+    sdsl::select_support_mcl<> ss7(&bv);
+    sdsl::util::set_thread_count(threads);
+    ASSERT_TRUE(ss1 == ss7);
+    for (size_type j=0, select=0; j < bv.size(); ++j) {
+        if (bv[j]) {
+            ++select;
+            ASSERT_EQ(ss7.select(select), j) << " at query "<<select;
+        }
+    }
+}
+
+template<class T>
+class RrrSelectTest : public ::testing::Test {};
+
+template<uint16_t BlockSize>
+struct rrr_with_block_size {
+    typedef sdsl::rrr_vector<BlockSize> type;
+    static const uint16_t block_size = BlockSize;
+};
+
+typedef Types<rrr_with_block_size<15>,
+        rrr_with_block_size<31>,
+        rrr_with_block_size<63>,
+        rrr_with_block_size<127>
+        > RrrImplementations;
+
+TYPED_TEST_CASE(RrrSelectTest, RrrImplementations);
+
+//! Test select if the length is a multiple of block_size*sample_rate, i.e. the empty block behind the last block starts a rank sample
+TYPED_TEST(RrrSelectTest, TrailingEmptyBlock)
+{
+    typedef typename TypeParam::type rrr_type;
+    srand(11);
+    const size_type sample_rate = 32;
+    for (size_type k=1; k <= 3; ++k) {
+        bit_vector bv(TypeParam::block_size*sample_rate*k, 0);
+        for (size_type j=0; j < bv.size(); ++j)
+            bv[j] = rand()%2;
+        for (uint8_t last=0; last < 2; ++last) {
+            bv[bv.size()-1] = last;
+            rrr_type rrr(bv, sample_rate);
+            typename rrr_type::select_1_type ss1(&rrr);
+            typename rrr_type::select_0_type ss0(&rrr);
+            for (size_type j=0, ones=0; j < bv.size(); ++j) {
+                if (bv[j]) {
+                    ASSERT_EQ(j, ss1.select(++ones)) << " of vector of length "<<bv.size();
+                } else {
+                    ASSERT_EQ(j, ss0.select(j+1-ones)) << " of vector of length "<<bv.size();
+                }
+            }
+        }
+    }
+}
+
+//! Test that the select hints survive serialization
+TYPED_TEST(RrrSelectTest, SerializeAndLoad)
+{
+    typedef typename TypeParam::type rrr_type;
+    srand(19);
+    bit_vector bv(100000, 0);
+    for (size_type j=0; j < bv.size(); ++j)
+        bv[j] = (rand() % (j < bv.size()/2 ? 2 : 100) == 0);
+    rrr_type rrr(bv);
+    typename rrr_type::select_1_type ss1(&rrr);
+    typename rrr_type::select_0_type ss0(&rrr);
+    std::stringstream ss;
+    rrr.serialize(ss);
+    ss1.serialize(ss);
+    ss0.serialize(ss);
+    rrr_type rrr2;
+    typename rrr_type::select_1_type ss1_2;
+    typename rrr_type::select_0_type ss0_2;
+    rrr2.load(ss);
+    ss1_2.load(ss, &rrr2);
+    ss0_2.load(ss, &rrr2);
+    ASSERT_TRUE(ss1 == ss1_2);
+    ASSERT_TRUE(ss0 == ss0_2);
+    for (size_type j=0, ones=0; j < bv.size(); ++j) {
+        if (bv[j]) {
+            ASSERT_EQ(j, ss1_2.select(++ones));
+        } else {
+            ASSERT_EQ(j, ss0_2.select(j+1-ones));
+        }
+    }
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
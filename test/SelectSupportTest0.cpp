@@ -1,7 +1,9 @@
 
 #include "sdsl/int_vector.hpp"
 #include "sdsl/select_support_mcl.hpp" // for select_support_mcl
+#include "sdsl/select_support_rank.hpp" // for select_support_rank
 #include "sdsl/bit_vector_interleaved.hpp" // for rank_support_interleaved
+#include "sdsl/bit_vector_interleaved_cl.hpp" // for rank_support_interleaved_cl
 #include "sdsl/rrr_vector.hpp" // for rrr_select_support
 #include "sdsl/sd_vector.hpp" // for sd_select_support
 #include "sdsl/gap_vector.hpp" // for gap_select_suport
@@ -96,7 +98,9 @@ typedef Types<sdsl::select_support_mcl<0>,
         sdsl::rrr_select_support<0, 127>,
         sdsl::select_support_interleaved<0, 256>,
         sdsl::select_support_interleaved<0, 512>,
-        sdsl::select_support_interleaved<0, 1024>
+        sdsl::select_support_interleaved<0, 1024>,
+        sdsl::select_support_interleaved_cl<0, 512>,
+        sdsl::select_support_interleaved_cl<0, 64>
         > Implementations;
 
 TYPED_TEST_CASE(SelectSupportTest, Implementations);
@@ -117,6 +121,31 @@ TYPED_TEST(SelectSupportTest, SelectMethod)
     }
 }
 
+template<class T>
+class SelectSupportRankTest : public SelectSupportTest<T> {};
+
+typedef Types<sdsl::select_support_rank<0, sdsl::rank_support_v<> >,
+        sdsl::select_support_rank<0, sdsl::rank_support_v5<> >
+        > RankImplementations;
+
+TYPED_TEST_CASE(SelectSupportRankTest, RankImplementations);
+
+//! Test the select method of the select supports which use the counters of a rank support
+TYPED_TEST(SelectSupportRankTest, SelectMethod)
+{
+    for (size_type i=0; i<this->n; ++i) {
+        typename TypeParam::bit_vector_type bv(this->bs[i]);
+        typename TypeParam::rank_support_type rs(&bv);
+        TypeParam ss(&bv, &rs);
+        for (size_type j=0, select=0; j < (this->bs[i]).size(); ++j) {
+            if (!(this->bs[i][j])) {
+                ++select;
+                ASSERT_EQ(ss.select(select), j) << " at query "<<select<<" of vector "<<i<<" of length "<<(this->bs[i]).size();
+            }
+        }
+    }
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
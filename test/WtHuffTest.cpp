@@ -0,0 +1,73 @@
+#include "sdsl/wt_huff.hpp"
+#include "sdsl/rrr_vector.hpp"
+#include "sdsl/bit_vector_interleaved.hpp"
+#include "sdsl/util.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+#include <cstdlib> // for rand()
+#include <string>
+#include <fstream>
+#include <cstdio> // for remove
+
+namespace
+{
+
+typedef sdsl::int_vector<>::size_type size_type;
+
+template<class T>
+class WtHuffTest : public ::testing::Test
+{
+    protected:
+        std::string tmp_file;
+
+        virtual void SetUp() {
+            tmp_file = "tmp_wt_huff_test_" + sdsl::util::to_string(sdsl::util::get_pid()) + "_";
+        }
+};
+
+using testing::Types;
+
+typedef Types<
+sdsl::wt_huff<sdsl::bit_vector_interleaved<> >,
+     sdsl::wt_huff<sdsl::bit_vector, sdsl::rank_support_v<> >,
+     sdsl::wt_huff<sdsl::bit_vector, sdsl::rank_support_v5<> >,
+     sdsl::wt_huff<sdsl::rrr_vector<63> >
+     > Implementations;
+
+TYPED_TEST_CASE(WtHuffTest, Implementations);
+
+//! Test the batch version of rank
+TYPED_TEST(WtHuffTest, BatchRank)
+{
+    srand(29);
+    std::string file_name = this->tmp_file + "batch_rank.txt";
+    for (size_type t=0; t < 2; ++t) {
+        {
+            std::ofstream out(file_name.c_str());
+            for (size_type j=0; j < 100000; ++j) // skewed distribution; one symbol in the second text
+                out.put(t ? 'a' : (char)(1 + (rand() % (1 + rand() % 200))));
+        }
+        sdsl::int_vector_file_buffer<8> text_buf;
+        text_buf.load_from_plain(file_name.c_str());
+        TypeParam wt(text_buf, text_buf.int_vector_size);
+        std::vector<size_type> idx(10000), out(idx.size());
+        std::vector<typename TypeParam::value_type> c(idx.size());
+        for (size_type k=0; k < idx.size(); ++k) {
+            idx[k] = rand() % (wt.size()+1);
+            c[k]   = rand() % 256; // includes symbols which do not occur
+        }
+        wt.rank(&idx[0], &c[0], idx.size(), &out[0]);
+        for (size_type k=0; k < idx.size(); ++k) {
+            ASSERT_EQ(wt.rank(idx[k], c[k]), out[k]) << " at query " << k << " of text " << t;
+        }
+    }
+    std::remove(file_name.c_str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
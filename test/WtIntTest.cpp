@@ -75,6 +75,30 @@ TYPED_TEST(WtIntTest, Constructor)
     std::remove((this->tmp_file+suffix).c_str());
 }
 
+//! Test the batch version of rank
+TYPED_TEST(WtIntTest, BatchRank)
+{
+    std::string suffix = "batch_rank";
+    sdsl::int_vector<> iv(100000,0,6);
+    sdsl::util::set_random_bits(iv, 23);
+    sdsl::util::store_to_file(iv, (this->tmp_file+suffix).c_str());
+    {
+        sdsl::int_vector_file_buffer<> buf((this->tmp_file+suffix).c_str());
+        TypeParam wt(buf);
+        std::vector<size_type> idx(10000), out(idx.size());
+        std::vector<typename TypeParam::value_type> c(idx.size());
+        for (size_type k=0; k < idx.size(); ++k) {
+            idx[k] = rand() % (wt.size()+1);
+            c[k]   = rand() % 70; // includes symbols which do not occur
+        }
+        wt.rank(&idx[0], &c[0], idx.size(), &out[0]);
+        for (size_type k=0; k < idx.size(); ++k) {
+            ASSERT_EQ(wt.rank(idx[k], c[k]), out[k]) << " at query " << k;
+        }
+    }
+    std::remove((this->tmp_file+suffix).c_str());
+}
+
 }  // namespace
 
 int main(int argc, char** argv)